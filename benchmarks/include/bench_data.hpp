@@ -0,0 +1,227 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <system_error>  // error_code
+#include <utility>       // make_pair, move
+
+#include "databento/constants.hpp"
+#include "databento/dbn.hpp"
+#include "databento/dbn_encoder.hpp"
+#include "databento/detail/zstd_stream.hpp"
+#include "databento/enums.hpp"
+#include "databento/file_stream.hpp"
+#include "databento/flag_set.hpp"
+#include "databento/iwritable.hpp"
+#include "databento/publishers.hpp"
+#include "databento/record.hpp"
+
+namespace databento::benchmarks {
+// Generates an MBO record resembling those in `tests/data/test_data.mbo.dbn`.
+inline MboMsg GenerateMbo(std::size_t i) {
+  constexpr Action kActions[] = {Action::Add, Action::Add, Action::Cancel,
+                                 Action::Modify, Action::Trade};
+  constexpr Side kSides[] = {Side::Ask, Side::Bid, Side::None};
+  const auto ts = UnixNanos{std::chrono::nanoseconds{
+      1'609'160'400'000'000'000 + static_cast<std::int64_t>(i) * 1'000}};
+  return MboMsg{RecordHeader{sizeof(MboMsg) / RecordHeader::kLengthMultiplier,
+                             RType::Mbo,
+                             static_cast<std::uint16_t>(Publisher::GlbxMdp3Glbx),
+                             5482 + static_cast<std::uint32_t>(i % 16), ts},
+                647'784'973'705 + i,
+                3'722'750'000'000 + static_cast<std::int64_t>(i % 100) * 250'000'000,
+                static_cast<std::uint32_t>(1 + i % 10),
+                FlagSet{FlagSet::kLast},
+                0,
+                kActions[i % 5],
+                kSides[i % 3],
+                ts + std::chrono::nanoseconds{100},
+                std::chrono::nanoseconds{22'993},
+                static_cast<std::uint32_t>(i)};
+}
+
+// Generates a book update for the MBP schemas, or a trade with `L = 0`.
+template <typename R, std::size_t L>
+R GenerateMbp(RType rtype, std::size_t i) {
+  const auto ts = UnixNanos{std::chrono::nanoseconds{
+      1'609'160'400'000'000'000 + static_cast<std::int64_t>(i) * 1'000}};
+  const auto mid = 3'722'750'000'000 + static_cast<std::int64_t>(i % 100) * 250'000'000;
+  R rec{};
+  rec.hd = RecordHeader{sizeof(R) / RecordHeader::kLengthMultiplier, rtype,
+                        static_cast<std::uint16_t>(Publisher::GlbxMdp3Glbx),
+                        5482 + static_cast<std::uint32_t>(i % 16), ts};
+  rec.price = mid;
+  rec.size = static_cast<std::uint32_t>(1 + i % 10);
+  rec.action = L == 0 ? Action::Trade : Action::Add;
+  rec.side = i % 2 == 0 ? Side::Bid : Side::Ask;
+  rec.flags = FlagSet{FlagSet::kLast};
+  rec.ts_recv = ts + std::chrono::nanoseconds{100};
+  rec.ts_in_delta = std::chrono::nanoseconds{22'993};
+  rec.sequence = static_cast<std::uint32_t>(i);
+  if constexpr (L > 0) {
+    for (std::size_t level = 0; level < L; ++level) {
+      const auto offset = static_cast<std::int64_t>(level + 1) * 250'000'000;
+      rec.levels[level] = BidAskPair{mid - offset,
+                                     mid + offset,
+                                     static_cast<std::uint32_t>(10 + level),
+                                     static_cast<std::uint32_t>(12 + level),
+                                     static_cast<std::uint32_t>(1 + level),
+                                     static_cast<std::uint32_t>(2 + level)};
+    }
+  }
+  return rec;
+}
+
+inline OhlcvMsg GenerateOhlcv(std::size_t i) {
+  const auto open = 3'722'750'000'000 + static_cast<std::int64_t>(i % 100) * 250'000'000;
+  return OhlcvMsg{RecordHeader{sizeof(OhlcvMsg) / RecordHeader::kLengthMultiplier,
+                               RType::Ohlcv1S,
+                               static_cast<std::uint16_t>(Publisher::GlbxMdp3Glbx),
+                               5482 + static_cast<std::uint32_t>(i % 16),
+                               UnixNanos{std::chrono::seconds{
+                                   1'609'160'400 + static_cast<std::int64_t>(i / 16)}}},
+                  open,
+                  open + 1'000'000'000,
+                  open - 500'000'000,
+                  open + 250'000'000,
+                  100 + i % 50};
+}
+
+// The schema and generator for each record type used in benchmarks.
+template <typename R>
+struct RecordGenerator;
+
+template <>
+struct RecordGenerator<MboMsg> {
+  static constexpr Schema kSchema = Schema::Mbo;
+  static MboMsg Generate(std::size_t i) { return GenerateMbo(i); }
+};
+
+template <>
+struct RecordGenerator<TradeMsg> {
+  static constexpr Schema kSchema = Schema::Trades;
+  static TradeMsg Generate(std::size_t i) {
+    return GenerateMbp<TradeMsg, 0>(RType::Mbp0, i);
+  }
+};
+
+template <>
+struct RecordGenerator<Mbp1Msg> {
+  static constexpr Schema kSchema = Schema::Mbp1;
+  static Mbp1Msg Generate(std::size_t i) {
+    return GenerateMbp<Mbp1Msg, 1>(RType::Mbp1, i);
+  }
+};
+
+template <>
+struct RecordGenerator<Mbp10Msg> {
+  static constexpr Schema kSchema = Schema::Mbp10;
+  static Mbp10Msg Generate(std::size_t i) {
+    return GenerateMbp<Mbp10Msg, 10>(RType::Mbp10, i);
+  }
+};
+
+template <>
+struct RecordGenerator<OhlcvMsg> {
+  static constexpr Schema kSchema = Schema::Ohlcv1S;
+  static OhlcvMsg Generate(std::size_t i) { return GenerateOhlcv(i); }
+};
+
+inline Metadata GenerateMetadata(Schema schema) {
+  return Metadata{kDbnVersion,
+                  ToString(Dataset::GlbxMdp3),
+                  schema,
+                  {},
+                  {},
+                  {},
+                  SType::RawSymbol,
+                  SType::InstrumentId,
+                  false,
+                  kSymbolCstrLen,
+                  {},
+                  {},
+                  {},
+                  {}};
+}
+
+// Discards all data written to it, counting the bytes.
+class NullWritable : public IWritable {
+ public:
+  void WriteAll(const std::byte*, std::size_t length) override { size_ += length; }
+
+  std::size_t Size() const { return size_; }
+
+ private:
+  std::size_t size_{};
+};
+
+// Lazily writes DBN files of `R` records to the temp directory, one per record
+// count and compression, and removes them on destruction. Compressed files are
+// made up of multiple independent Zstd frames, like those from batch downloads.
+template <typename R>
+class RecordFiles {
+ public:
+  RecordFiles() = default;
+  RecordFiles(const RecordFiles&) = delete;
+  RecordFiles& operator=(const RecordFiles&) = delete;
+  ~RecordFiles() {
+    for (const auto& [_, path] : paths_) {
+      std::error_code ec;
+      std::filesystem::remove(path, ec);
+    }
+  }
+
+  // Shared across benchmarks so each file is only written once.
+  static RecordFiles& Instance() {
+    static RecordFiles files;
+    return files;
+  }
+
+  static constexpr std::size_t kFrameRecordCount = 1 << 16;
+
+  const std::filesystem::path& Get(std::size_t record_count) {
+    return Get(record_count, Compression::None);
+  }
+  const std::filesystem::path& Get(std::size_t record_count, Compression compression) {
+    const auto key = std::make_pair(record_count, compression);
+    auto it = paths_.find(key);
+    if (it != paths_.end()) {
+      return it->second;
+    }
+    auto path = std::filesystem::temp_directory_path() /
+                ("databento_bench_" + std::string{ToString(Generator::kSchema)} + "_" +
+                 std::to_string(record_count) +
+                 (compression == Compression::Zstd ? ".dbn.zst" : ".dbn"));
+    {
+      OutFileStream file_output{path};
+      std::optional<detail::ZstdCompressStream> zstd_output;
+      IWritable* output = &file_output;
+      if (compression == Compression::Zstd) {
+        zstd_output.emplace(&file_output);
+        output = &*zstd_output;
+      }
+      DbnEncoder encoder{GenerateMetadata(Generator::kSchema), output};
+      for (std::size_t i = 0; i < record_count; ++i) {
+        encoder.EncodeRecord(Generator::Generate(i));
+        if (zstd_output && (i + 1) % kFrameRecordCount == 0) {
+          // Ends the current frame
+          zstd_output->Flush();
+        }
+      }
+    }
+    return paths_.emplace(key, std::move(path)).first->second;
+  }
+
+ private:
+  using Generator = RecordGenerator<R>;
+
+  std::map<std::pair<std::size_t, Compression>, std::filesystem::path> paths_;
+};
+
+using MboFiles = RecordFiles<MboMsg>;
+}  // namespace databento::benchmarks
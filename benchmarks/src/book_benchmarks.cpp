@@ -0,0 +1,162 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <system_error>  // error_code
+#include <vector>
+
+#include "databento/book.hpp"
+#include "databento/book_manager.hpp"
+#include "databento/dbn_store.hpp"
+#include "databento/enums.hpp"
+#include "databento/file_stream.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"
+#include "databento/synth.hpp"
+#include "databento/timeseries.hpp"  // KeepGoing
+
+namespace databento::benchmarks {
+namespace {
+NullLogReceiver null_logger;
+
+constexpr std::size_t kRecordCount = 1 << 21;
+constexpr std::size_t kInstrumentCount = 16;
+constexpr std::uint32_t kPublisherCount = 4;
+
+// A DBN file of synthetic MBO records, removed when the benchmarks finish.
+class MboFile {
+ public:
+  explicit MboFile(std::size_t max_orders)
+      : path_{std::filesystem::temp_directory_path() /
+              ("databento_bench_book_" + std::to_string(max_orders) + ".dbn")} {
+    synth::GeneratorConf conf{};
+    conf.instrument_count = kInstrumentCount;
+    // So instrument IDs are book indices
+    conf.first_instrument_id = 0;
+    conf.max_orders = max_orders;
+    OutFileStream output{path_};
+    synth::Generator{Schema::Mbo, conf}.WriteDbn(kRecordCount, &output);
+  }
+  MboFile(const MboFile&) = delete;
+  MboFile& operator=(const MboFile&) = delete;
+  ~MboFile() {
+    std::error_code ec;
+    std::filesystem::remove(path_, ec);
+  }
+
+  const std::filesystem::path& Path() const { return path_; }
+  // The records of the file, decoded once.
+  const std::vector<MboMsg>& Records() {
+    if (records_.empty()) {
+      DbnStore store{&null_logger, path_, VersionUpgradePolicy::AsIs};
+      store.Replay([this](const Record& record) {
+        records_.emplace_back(record.Get<MboMsg>());
+        return KeepGoing::Continue;
+      });
+    }
+    return records_;
+  }
+
+  // Shared across benchmarks so each file is only written once.
+  static MboFile& Get(std::size_t max_orders) {
+    static std::map<std::size_t, MboFile> files;
+    return files.try_emplace(max_orders, max_orders).first->second;
+  }
+
+ private:
+  const std::filesystem::path path_;
+  std::vector<MboMsg> records_;
+};
+
+// Applies the records of an MBO file already in memory to a book per instrument,
+// with books of up to `state.range(0)` resting orders. Items per second are book
+// updates per second on one core.
+void BM_OrderBookApply(benchmark::State& state) {
+  auto& file = MboFile::Get(static_cast<std::size_t>(state.range(0)));
+  const auto& records = file.Records();
+  for (auto _ : state) {
+    std::vector<book::OrderBook> books(kInstrumentCount);
+    for (const auto& mbo : records) {
+      books[mbo.hd.instrument_id].Apply(mbo);
+    }
+    benchmark::DoNotOptimize(books.front().Bbo());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(records.size()));
+}
+
+// Applies the records of an MBO file already in memory to a `BookManager`, with the
+// synthetic instruments split across publishers, and reads the consolidated BBO of
+// the changed instruments every `kDrainInterval` records like a consumer
+// publishing a consolidated feed.
+void BM_BookManagerApply(benchmark::State& state) {
+  constexpr std::size_t kDrainInterval = 64;
+  auto records = MboFile::Get(static_cast<std::size_t>(state.range(0))).Records();
+  for (auto& mbo : records) {
+    mbo.hd.publisher_id =
+        static_cast<std::uint16_t>(1 + mbo.hd.instrument_id % kPublisherCount);
+    mbo.hd.instrument_id /= kPublisherCount;
+  }
+  for (auto _ : state) {
+    book::BookManager manager;
+    std::int64_t sum{};
+    for (std::size_t i = 0; i < records.size(); ++i) {
+      manager.Apply(records[i]);
+      if (i % kDrainInterval == kDrainInterval - 1) {
+        manager.ForEachChanged(
+            [&sum](std::uint32_t, const ConsolidatedBidAskPair& bbo) {
+              sum += bbo.bid_sz;
+            });
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(records.size()));
+}
+
+// Replays an MBO file from disk into a book per instrument, including decoding,
+// reading the top 10 levels of the book after each event like an MBP-10 consumer.
+void BM_OrderBookReplay(benchmark::State& state) {
+  const auto& path = MboFile::Get(static_cast<std::size_t>(state.range(0))).Path();
+  for (auto _ : state) {
+    std::vector<book::OrderBook> books(kInstrumentCount);
+    DbnStore store{&null_logger, path, VersionUpgradePolicy::AsIs};
+    std::int64_t sum{};
+    store.Replay([&books, &sum](const Record& record) {
+      const auto& mbo = record.Get<MboMsg>();
+      auto& book = books[mbo.hd.instrument_id];
+      book.Apply(mbo);
+      if (book.IsConsistent()) {
+        for (const auto& level : book.Levels<10>()) {
+          sum += level.bid_sz;
+        }
+      }
+      return KeepGoing::Continue;
+    });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(kRecordCount));
+}
+}  // namespace
+
+BENCHMARK(BM_OrderBookApply)
+    ->ArgName("max_orders")
+    ->Arg(64)
+    ->Arg(4'096)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BookManagerApply)
+    ->ArgName("max_orders")
+    ->Arg(64)
+    ->Arg(4'096)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_OrderBookReplay)
+    ->ArgName("max_orders")
+    ->Arg(64)
+    ->Arg(4'096)
+    ->Unit(benchmark::kMillisecond);
+}  // namespace databento::benchmarks
@@ -0,0 +1,168 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>  // min
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>  // make_unique
+#include <vector>
+
+#include "bench_data.hpp"
+#include "databento/dbn.hpp"
+#include "databento/dbn_decoder.hpp"
+#include "databento/dbn_encoder.hpp"
+#include "databento/detail/dbn_buffer_decoder.hpp"
+#include "databento/detail/zstd_stream.hpp"
+#include "databento/enums.hpp"
+#include "databento/file_stream.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"
+#include "databento/timeseries.hpp"  // KeepGoing
+
+namespace databento::benchmarks {
+namespace {
+NullLogReceiver null_logger;
+
+std::vector<std::byte> ReadFile(const std::filesystem::path& path) {
+  std::vector<std::byte> data(std::filesystem::file_size(path));
+  InFileStream input{path};
+  input.ReadExact(data.data(), data.size());
+  return data;
+}
+
+void SetCounters(benchmark::State& state, std::size_t record_size) {
+  const auto iterations = state.iterations();
+  state.SetItemsProcessed(iterations * state.range(0));
+  state.SetBytesProcessed(iterations * state.range(0) *
+                          static_cast<std::int64_t>(record_size));
+}
+
+// Decodes a file of each schema, uncompressed or Zstd-compressed
+template <typename R, Compression C>
+void BM_DecodeSchema(benchmark::State& state) {
+  const auto& path = RecordFiles<R>::Instance().Get(
+      static_cast<std::size_t>(state.range(0)), C);
+  for (auto _ : state) {
+    DbnDecoder decoder{&null_logger, std::make_unique<InFileStream>(path),
+                       VersionUpgradePolicy::UpgradeToV3};
+    decoder.DecodeMetadata();
+    std::uint64_t sum{};
+    while (true) {
+      const auto& batch = decoder.DecodeBatch();
+      if (batch.Empty()) {
+        break;
+      }
+      for (const auto& record : batch) {
+        sum += record.Header().instrument_id;
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  SetCounters(state, sizeof(R));
+}
+
+template <typename R>
+void BM_Encode(benchmark::State& state) {
+  const auto record_count = static_cast<std::size_t>(state.range(0));
+  std::vector<R> records;
+  records.reserve(record_count);
+  for (std::size_t i = 0; i < record_count; ++i) {
+    records.emplace_back(RecordGenerator<R>::Generate(i));
+  }
+  const auto metadata = GenerateMetadata(RecordGenerator<R>::kSchema);
+  for (auto _ : state) {
+    NullWritable output;
+    DbnEncoder encoder{metadata, &output};
+    for (const auto& record : records) {
+      encoder.EncodeRecord(record);
+    }
+    benchmark::DoNotOptimize(output.Size());
+  }
+  SetCounters(state, sizeof(R));
+}
+
+// Compresses MBO DBN data in memory
+void BM_ZstdCompress(benchmark::State& state) {
+  const auto data = ReadFile(MboFiles::Instance().Get(
+      static_cast<std::size_t>(state.range(0)), Compression::None));
+  for (auto _ : state) {
+    NullWritable output;
+    {
+      detail::ZstdCompressStream zstd_output{&null_logger, &output};
+      zstd_output.WriteAll(data.data(), data.size());
+    }
+    benchmark::DoNotOptimize(output.Size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(data.size()));
+}
+
+// Decompresses a multi-frame MBO file without decoding
+void BM_ZstdDecode(benchmark::State& state) {
+  const auto& path = MboFiles::Instance().Get(static_cast<std::size_t>(state.range(0)),
+                                              Compression::Zstd);
+  std::vector<std::byte> buffer(64 * std::size_t{1 << 10});
+  for (auto _ : state) {
+    detail::ZstdDecodeStream input{std::make_unique<InFileStream>(path)};
+    std::size_t size{};
+    while (const auto read_size = input.ReadSome(buffer.data(), buffer.size())) {
+      size += read_size;
+    }
+    benchmark::DoNotOptimize(size);
+  }
+  SetCounters(state, sizeof(MboMsg));
+}
+
+// Decodes Zstd-compressed MBO data from memory in chunks of `state.range(1)` bytes,
+// like the historical API's streaming responses
+void BM_BufferDecode(benchmark::State& state) {
+  const auto data = ReadFile(MboFiles::Instance().Get(
+      static_cast<std::size_t>(state.range(0)), Compression::Zstd));
+  const auto chunk_size = static_cast<std::size_t>(state.range(1));
+  const MetadataCallback metadata_callback = [](Metadata&&) {};
+  std::uint64_t sum{};
+  const RecordCallback record_callback = [&sum](const Record& record) {
+    sum += record.Header().instrument_id;
+    return KeepGoing::Continue;
+  };
+  for (auto _ : state) {
+    detail::DbnBufferDecoder decoder{VersionUpgradePolicy::UpgradeToV3,
+                                     metadata_callback, record_callback};
+    for (std::size_t offset = 0; offset < data.size(); offset += chunk_size) {
+      decoder.Process(reinterpret_cast<const char*>(data.data()) + offset,
+                      (std::min)(chunk_size, data.size() - offset));
+    }
+  }
+  benchmark::DoNotOptimize(sum);
+  SetCounters(state, sizeof(MboMsg));
+}
+
+// From about 50 MiB to over 1 GiB of records depending on the schema
+void RecordCounts(benchmark::internal::Benchmark* bench) {
+  bench->RangeMultiplier(16)
+      ->Range(std::int64_t{1} << 20, std::int64_t{1} << 24)
+      ->Unit(benchmark::kMillisecond);
+}
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_DecodeSchema, MboMsg, Compression::None)->Apply(RecordCounts);
+BENCHMARK_TEMPLATE(BM_DecodeSchema, Mbp1Msg, Compression::None)->Apply(RecordCounts);
+BENCHMARK_TEMPLATE(BM_DecodeSchema, Mbp10Msg, Compression::None)
+    ->Arg(std::int64_t{1} << 20)
+    ->Arg(std::int64_t{1} << 22)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_DecodeSchema, TradeMsg, Compression::None)->Apply(RecordCounts);
+BENCHMARK_TEMPLATE(BM_DecodeSchema, OhlcvMsg, Compression::None)->Apply(RecordCounts);
+BENCHMARK_TEMPLATE(BM_DecodeSchema, MboMsg, Compression::Zstd)->Apply(RecordCounts);
+BENCHMARK_TEMPLATE(BM_DecodeSchema, Mbp1Msg, Compression::Zstd)->Apply(RecordCounts);
+BENCHMARK_TEMPLATE(BM_DecodeSchema, TradeMsg, Compression::Zstd)->Apply(RecordCounts);
+BENCHMARK_TEMPLATE(BM_Encode, MboMsg)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Encode, Mbp10Msg)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Encode, TradeMsg)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ZstdCompress)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ZstdDecode)->Apply(RecordCounts);
+BENCHMARK(BM_BufferDecode)
+    ->ArgsProduct({{1 << 20}, {4 << 10, 64 << 10}})
+    ->ArgNames({"records", "chunk"})
+    ->Unit(benchmark::kMillisecond);
+}  // namespace databento::benchmarks
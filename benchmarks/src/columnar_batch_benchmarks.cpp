@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "bench_data.hpp"
+#include "databento/columnar_batch.hpp"
+#include "databento/dbn_store.hpp"
+#include "databento/enums.hpp"
+#include "databento/file_stream.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"
+
+namespace databento::benchmarks {
+namespace {
+NullLogReceiver null_logger;
+
+// Volume-weighted average price from the records of each batch
+void BM_VwapRecords(benchmark::State& state) {
+  const auto& path = MboFiles::Instance().Get(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    DbnStore store{&null_logger, InMmapFileStream{path},
+                   VersionUpgradePolicy::UpgradeToV3};
+    double notional{};
+    std::uint64_t volume{};
+    while (true) {
+      const auto& batch = store.NextBatch();
+      if (batch.Empty()) {
+        break;
+      }
+      for (const auto& record : batch) {
+        if (const auto* mbo = record.GetIf<MboMsg>()) {
+          notional += static_cast<double>(mbo->price) * mbo->size;
+          volume += mbo->size;
+        }
+      }
+    }
+    benchmark::DoNotOptimize(notional / static_cast<double>(volume));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Volume-weighted average price from the `price` and `size` columns of batches of
+// `state.range(1)` records
+void BM_VwapColumnar(benchmark::State& state) {
+  const auto& path = MboFiles::Instance().Get(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    DbnStore store{&null_logger, InMmapFileStream{path},
+                   VersionUpgradePolicy::UpgradeToV3};
+    ColumnarBatch<MboMsg> batch{static_cast<std::size_t>(state.range(1))};
+    double notional{};
+    std::uint64_t volume{};
+    while (batch.Fill(store) > 0) {
+      const auto& columns = batch.Columns();
+      for (std::size_t i = 0; i < batch.Size(); ++i) {
+        notional += static_cast<double>(columns.price[i]) * columns.size[i];
+        volume += columns.size[i];
+      }
+    }
+    benchmark::DoNotOptimize(notional / static_cast<double>(volume));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+}  // namespace
+
+BENCHMARK(BM_VwapRecords)
+    ->Arg(std::int64_t{1} << 22)
+    ->ArgName("records")
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_VwapColumnar)
+    ->ArgsProduct({{std::int64_t{1} << 22}, {1 << 10, 1 << 14}})
+    ->ArgNames({"records", "capacity"})
+    ->Unit(benchmark::kMillisecond);
+}  // namespace databento::benchmarks
@@ -0,0 +1,187 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>  // make_unique
+
+#include "bench_data.hpp"
+#include "databento/datetime.hpp"
+#include "databento/dbn_decoder.hpp"
+#include "databento/dbn_index.hpp"
+#include "databento/dbn_store.hpp"
+#include "databento/enums.hpp"
+#include "databento/file_stream.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"
+#include "databento/timeseries.hpp"  // KeepGoing
+
+namespace databento::benchmarks {
+namespace {
+NullLogReceiver null_logger;
+
+struct BufferedInput {
+  static DbnDecoder Decoder(const std::filesystem::path& path) {
+    return DbnDecoder{&null_logger, std::make_unique<InFileStream>(path),
+                      VersionUpgradePolicy::UpgradeToV3};
+  }
+};
+
+struct MappedInput {
+  static DbnDecoder Decoder(const std::filesystem::path& path) {
+    return DbnDecoder{&null_logger, InMmapFileStream{path},
+                      VersionUpgradePolicy::UpgradeToV3};
+  }
+};
+
+void SetCounters(benchmark::State& state, const std::filesystem::path& path) {
+  const auto iterations = state.iterations();
+  state.SetItemsProcessed(iterations * state.range(0));
+  state.SetBytesProcessed(iterations *
+                          static_cast<std::int64_t>(std::filesystem::file_size(path)));
+}
+
+template <typename I>
+void BM_DecodeRecord(benchmark::State& state) {
+  const auto& path = MboFiles::Instance().Get(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    auto decoder = I::Decoder(path);
+    decoder.DecodeMetadata();
+    std::uint64_t sum{};
+    while (const auto* record = decoder.DecodeRecord()) {
+      sum += record->Header().instrument_id;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  SetCounters(state, path);
+}
+
+template <typename I>
+void BM_DecodeBatch(benchmark::State& state) {
+  const auto& path = MboFiles::Instance().Get(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    auto decoder = I::Decoder(path);
+    decoder.DecodeMetadata();
+    std::uint64_t sum{};
+    while (true) {
+      const auto& batch = decoder.DecodeBatch();
+      if (batch.Empty()) {
+        break;
+      }
+      for (const auto& record : batch) {
+        sum += record.Header().instrument_id;
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  SetCounters(state, path);
+}
+
+// Decodes a multi-frame Zstd-compressed file with `state.range(1)` decompression
+// threads
+void BM_DecodeZstd(benchmark::State& state) {
+  const auto& path = MboFiles::Instance().Get(static_cast<std::size_t>(state.range(0)),
+                                              Compression::Zstd);
+  for (auto _ : state) {
+    DbnDecoder decoder{&null_logger, std::make_unique<InFileStream>(path),
+                       VersionUpgradePolicy::UpgradeToV3,
+                       DecodeConf{static_cast<std::size_t>(state.range(1))}};
+    decoder.DecodeMetadata();
+    std::uint64_t sum{};
+    while (true) {
+      const auto& batch = decoder.DecodeBatch();
+      if (batch.Empty()) {
+        break;
+      }
+      for (const auto& record : batch) {
+        sum += record.Header().instrument_id;
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  const auto iterations = state.iterations();
+  state.SetItemsProcessed(iterations * state.range(0));
+  state.SetBytesProcessed(iterations * state.range(0) *
+                          static_cast<std::int64_t>(sizeof(MboMsg)));
+}
+
+// Replays a multi-frame Zstd-compressed file with `state.range(1)` read-ahead
+// buffers, reporting how often each side of the pipeline waited on the other
+void BM_ReplayReadAhead(benchmark::State& state) {
+  const auto& path = MboFiles::Instance().Get(static_cast<std::size_t>(state.range(0)),
+                                              Compression::Zstd);
+  DecodeConf decode_conf{};
+  decode_conf.read_ahead_depth = static_cast<std::size_t>(state.range(1));
+  ReadAheadStats stats{0, 0};
+  for (auto _ : state) {
+    DbnStore store{&null_logger, path, VersionUpgradePolicy::UpgradeToV3,
+                   decode_conf};
+    std::uint64_t sum{};
+    store.Replay([&sum](const Record& record) {
+      sum += record.Header().instrument_id;
+      return KeepGoing::Continue;
+    });
+    benchmark::DoNotOptimize(sum);
+    const auto iter_stats = store.ReadAheadStats();
+    stats.producer_stalls += iter_stats.producer_stalls;
+    stats.consumer_stalls += iter_stats.consumer_stalls;
+  }
+  state.counters["producer_stalls"] = benchmark::Counter(
+      static_cast<double>(stats.producer_stalls), benchmark::Counter::kAvgIterations);
+  state.counters["consumer_stalls"] = benchmark::Counter(
+      static_cast<double>(stats.consumer_stalls), benchmark::Counter::kAvgIterations);
+  const auto iterations = state.iterations();
+  state.SetItemsProcessed(iterations * state.range(0));
+}
+
+// Reads the first record at or after three quarters of the way through the file,
+// either by seeking with a `DbnIndex` when `state.range(1)` is nonzero, or by
+// decoding every record before it
+void BM_SeekTo(benchmark::State& state) {
+  const auto record_count = static_cast<std::size_t>(state.range(0));
+  const bool use_index = state.range(1) != 0;
+  const auto& path = MboFiles::Instance().Get(record_count, Compression::Zstd);
+  const auto index = DbnIndexer{}.Index(path);
+  const auto target = GenerateMbo(record_count / 4 * 3).ts_recv;
+  for (auto _ : state) {
+    DbnStore store{&null_logger, path, VersionUpgradePolicy::UpgradeToV3};
+    if (use_index) {
+      store.SeekTo(index, target);
+    } else {
+      store.GetMetadata();
+    }
+    const auto* record = store.NextRecord();
+    while (record != nullptr && record->IndexTs() < target) {
+      record = store.NextRecord();
+    }
+    benchmark::DoNotOptimize(record);
+  }
+}
+
+// From 56 MiB to 896 MiB of records
+void RecordCounts(benchmark::internal::Benchmark* bench) {
+  bench->RangeMultiplier(16)
+      ->Range(std::int64_t{1} << 20, std::int64_t{1} << 24)
+      ->Unit(benchmark::kMillisecond);
+}
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_DecodeRecord, BufferedInput)->Apply(RecordCounts);
+BENCHMARK_TEMPLATE(BM_DecodeBatch, BufferedInput)->Apply(RecordCounts);
+BENCHMARK_TEMPLATE(BM_DecodeRecord, MappedInput)->Apply(RecordCounts);
+BENCHMARK_TEMPLATE(BM_DecodeBatch, MappedInput)->Apply(RecordCounts);
+BENCHMARK(BM_DecodeZstd)
+    ->ArgsProduct({{std::int64_t{1} << 22}, {1, 2, 4, 8}})
+    ->ArgNames({"records", "threads"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_ReplayReadAhead)
+    ->ArgsProduct({{std::int64_t{1} << 22}, {0, 4}})
+    ->ArgNames({"records", "depth"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_SeekTo)
+    ->ArgsProduct({{std::int64_t{1} << 22}, {0, 1}})
+    ->ArgNames({"records", "index"})
+    ->Unit(benchmark::kMillisecond);
+}  // namespace databento::benchmarks
@@ -0,0 +1,165 @@
+#include <benchmark/benchmark.h>
+
+#ifdef __linux__
+#include <fcntl.h>   // open, posix_fadvise
+#include <unistd.h>  // close
+#endif
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>  // make_unique
+#include <string>
+#include <thread>  // this_thread
+
+#include "bench_data.hpp"
+#include "databento/constants.hpp"
+#include "databento/dbn_decoder.hpp"
+#include "databento/enums.hpp"
+#include "databento/file_stream.hpp"
+#include "databento/live.hpp"
+#include "databento/live_blocking.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"
+#include "mock/mock_lsg_server.hpp"
+
+// Compares the `io_uring` backend enabled with `DATABENTO_ENABLE_IO_URING` against
+// the default one. Without it, only the default backend is measured.
+namespace databento::benchmarks {
+namespace {
+NullLogReceiver null_logger;
+
+constexpr auto kKey = "32-character-with-lots-of-filler";
+
+struct StreamInput {
+  static DbnDecoder Decoder(const std::filesystem::path& path) {
+    return DbnDecoder{&null_logger, std::make_unique<InFileStream>(path),
+                      VersionUpgradePolicy::UpgradeToV3};
+  }
+};
+
+#ifdef DATABENTO_IO_URING
+struct UringInput {
+  static DbnDecoder Decoder(const std::filesystem::path& path) {
+    return DbnDecoder{&null_logger, std::make_unique<InUringFileStream>(path),
+                      VersionUpgradePolicy::UpgradeToV3};
+  }
+};
+#endif
+
+// Evicts the file from the page cache so reads have to go to storage
+void DropFromPageCache([[maybe_unused]] const std::filesystem::path& path) {
+#ifdef __linux__
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  ::fdatasync(fd);
+  ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  ::close(fd);
+#endif
+}
+
+// Arg `cold` 1 evicts the file from the page cache before each iteration. Only
+// supported on Linux.
+template <typename I>
+void BM_ReadFile(benchmark::State& state) {
+  const auto& path = MboFiles::Instance().Get(static_cast<std::size_t>(state.range(0)));
+  const bool cold = state.range(1) != 0;
+  for (auto _ : state) {
+    if (cold) {
+      state.PauseTiming();
+      DropFromPageCache(path);
+      state.ResumeTiming();
+    }
+    auto decoder = I::Decoder(path);
+    decoder.DecodeMetadata();
+    std::uint64_t sum{};
+    while (const auto* record = decoder.DecodeRecord()) {
+      sum += record->Header().instrument_id;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  const auto iterations = state.iterations();
+  state.SetItemsProcessed(iterations * state.range(0));
+  state.SetBytesProcessed(iterations *
+                          static_cast<std::int64_t>(std::filesystem::file_size(path)));
+}
+
+// Measures how quickly `NextRecord` drains records the mock gateway writes in
+// batches of `state.range(0)`. Arg `io_uring` 0 reads with `poll` and `recv`.
+void BM_LiveThroughput(benchmark::State& state) {
+  const auto batch_size = static_cast<std::size_t>(state.range(0));
+  std::string batch;
+  for (std::size_t i = 0; i < batch_size; ++i) {
+    const auto mbo = GenerateMbo(i);
+    batch.append(reinterpret_cast<const char*>(&mbo), sizeof(mbo));
+  }
+  std::atomic<std::uint64_t> requested{};
+  std::atomic<bool> is_done{};
+  const tests::mock::MockLsgServer server{
+      dataset::kGlbxMdp3, false,
+      [&batch, &requested, &is_done](tests::mock::MockLsgServer& self) {
+        self.Accept();
+        self.Authenticate();
+        self.Start();
+        std::uint64_t sent{};
+        while (!is_done.load(std::memory_order_acquire)) {
+          if (requested.load(std::memory_order_acquire) == sent) {
+            std::this_thread::yield();
+            continue;
+          }
+          self.Send(batch);
+          ++sent;
+        }
+      }};
+
+  LowLatencyConf low_latency_conf{};
+  low_latency_conf.io_uring = state.range(1) != 0;
+  auto client = LiveBuilder{}
+                    .SetLogReceiver(&null_logger)
+                    .SetKey(kKey)
+                    .SetDataset(dataset::kGlbxMdp3)
+                    .SetAddress("127.0.0.1", server.Port())
+                    .SetLowLatencyConf(low_latency_conf)
+                    .BuildBlocking();
+  client.Start();
+
+  for (auto _ : state) {
+    requested.fetch_add(1, std::memory_order_release);
+    std::uint64_t sum{};
+    for (std::size_t i = 0; i < batch_size; ++i) {
+      sum += client.NextRecord().Header().instrument_id;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  // Stop the gateway before the client disconnects
+  is_done.store(true, std::memory_order_release);
+  const auto iterations = state.iterations();
+  state.SetItemsProcessed(iterations * state.range(0));
+  state.SetBytesProcessed(iterations * static_cast<std::int64_t>(batch.size()));
+}
+
+void FileArgs(benchmark::internal::Benchmark* bench) {
+  bench->ArgNames({"records", "cold"})->Unit(benchmark::kMillisecond);
+  bench->Args({std::int64_t{1} << 22, 0});
+#ifdef __linux__
+  bench->Args({std::int64_t{1} << 22, 1});
+#endif
+}
+
+void LiveArgs(benchmark::internal::Benchmark* bench) {
+  bench->ArgNames({"batch", "io_uring"})->Unit(benchmark::kMicrosecond);
+  for (const std::int64_t batch_size : {64, 1024}) {
+    bench->Args({batch_size, 0});
+#ifdef DATABENTO_IO_URING
+    bench->Args({batch_size, 1});
+#endif
+  }
+}
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_ReadFile, StreamInput)->Apply(FileArgs);
+#ifdef DATABENTO_IO_URING
+BENCHMARK_TEMPLATE(BM_ReadFile, UringInput)->Apply(FileArgs);
+#endif
+BENCHMARK(BM_LiveThroughput)->Apply(LiveArgs);
+}  // namespace databento::benchmarks
@@ -0,0 +1,168 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>  // sort
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>  // this_thread
+#include <vector>
+
+#include "bench_data.hpp"  // GenerateMbo
+#include "databento/constants.hpp"
+#include "databento/enums.hpp"
+#include "databento/live.hpp"
+#include "databento/live_blocking.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"
+#include "databento/synth.hpp"
+#include "mock/mock_lsg_server.hpp"
+
+namespace databento::benchmarks {
+namespace {
+NullLogReceiver null_logger;
+
+constexpr auto kKey = "32-character-with-lots-of-filler";
+
+std::int64_t SteadyNow() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Reports percentiles of the per-record latencies in nanoseconds
+void ReportHistogram(benchmark::State& state, std::vector<std::int64_t>& latencies) {
+  if (latencies.empty()) {
+    return;
+  }
+  std::sort(latencies.begin(), latencies.end());
+  const auto percentile = [&latencies](double pct) {
+    const auto idx = static_cast<std::size_t>(
+        pct / 100.0 * static_cast<double>(latencies.size() - 1));
+    return static_cast<double>(latencies[idx]);
+  };
+  state.counters["p50_ns"] = percentile(50);
+  state.counters["p90_ns"] = percentile(90);
+  state.counters["p99_ns"] = percentile(99);
+  state.counters["p99.9_ns"] = percentile(99.9);
+  state.counters["max_ns"] = static_cast<double>(latencies.back());
+}
+
+// Measures the time from the mock gateway writing a record to the socket until
+// `NextRecord` returns it. The gateway sends one record at a time, only after the
+// previous one was received, so each measurement includes a full wakeup. Arg 0
+// waits in `poll`, arg 1 spins.
+void BM_LiveNextRecordLatency(benchmark::State& state) {
+  const bool spin = state.range(0) != 0;
+  // The number of records requested from the gateway
+  std::atomic<std::uint64_t> requested{};
+  std::atomic<bool> is_done{};
+  const tests::mock::MockLsgServer server{
+      dataset::kGlbxMdp3, false,
+      [&requested, &is_done](tests::mock::MockLsgServer& self) {
+        self.Accept();
+        self.Authenticate();
+        self.Start();
+        std::uint64_t sent{};
+        while (!is_done.load(std::memory_order_acquire)) {
+          if (requested.load(std::memory_order_acquire) == sent) {
+            std::this_thread::yield();
+            continue;
+          }
+          auto mbo = GenerateMbo(sent);
+          // Repurposed to carry the send time
+          mbo.hd.ts_event = UnixNanos{std::chrono::nanoseconds{SteadyNow()}};
+          self.SendRecord(mbo);
+          ++sent;
+        }
+      }};
+
+  LowLatencyConf low_latency_conf{};
+  low_latency_conf.spin = spin;
+  auto client = LiveBuilder{}
+                    .SetLogReceiver(&null_logger)
+                    .SetKey(kKey)
+                    .SetDataset(dataset::kGlbxMdp3)
+                    .SetAddress("127.0.0.1", server.Port())
+                    .SetLowLatencyConf(low_latency_conf)
+                    .BuildBlocking();
+  client.Start();
+
+  std::vector<std::int64_t> latencies;
+  for (auto _ : state) {
+    requested.fetch_add(1, std::memory_order_release);
+    const auto& rec = client.NextRecord();
+    // `ts_event` was set from `SteadyNow`, so it fits in a signed count
+    const auto sent_at =
+        static_cast<std::int64_t>(rec.Header().ts_event.time_since_epoch().count());
+    const auto latency = SteadyNow() - sent_at;
+    latencies.push_back(latency);
+    state.SetIterationTime(static_cast<double>(latency) / 1e9);
+  }
+  // Stop the gateway before the client disconnects
+  is_done.store(true, std::memory_order_release);
+  ReportHistogram(state, latencies);
+}
+
+// Streams synthetic MBO records from the gateway in batches of `state.range(0)`
+// as fast as the client reads them
+void BM_LiveThroughput(benchmark::State& state) {
+  const auto batch_size = static_cast<std::uint64_t>(state.range(0));
+  // The number of records requested from the gateway
+  std::atomic<std::uint64_t> requested{};
+  std::atomic<bool> is_done{};
+  synth::Generator generator{Schema::Mbo, synth::GeneratorConf{}};
+  const tests::mock::MockLsgServer server{
+      dataset::kGlbxMdp3, false,
+      [&requested, &is_done, &generator](tests::mock::MockLsgServer& self) {
+        self.Accept();
+        self.Authenticate();
+        self.Start();
+        std::uint64_t sent{};
+        while (!is_done.load(std::memory_order_acquire)) {
+          const auto to_send = requested.load(std::memory_order_acquire) - sent;
+          if (to_send == 0) {
+            std::this_thread::yield();
+            continue;
+          }
+          self.SendRecords(generator, to_send);
+          sent += to_send;
+        }
+      }};
+
+  auto client = LiveBuilder{}
+                    .SetLogReceiver(&null_logger)
+                    .SetKey(kKey)
+                    .SetDataset(dataset::kGlbxMdp3)
+                    .SetAddress("127.0.0.1", server.Port())
+                    .BuildBlocking();
+  client.Start();
+
+  for (auto _ : state) {
+    requested.fetch_add(batch_size, std::memory_order_release);
+    std::uint64_t sum{};
+    for (std::uint64_t i = 0; i < batch_size; ++i) {
+      sum += client.NextRecord().Header().instrument_id;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  // Stop the gateway before the client disconnects
+  is_done.store(true, std::memory_order_release);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          static_cast<std::int64_t>(sizeof(MboMsg)));
+}
+}  // namespace
+
+BENCHMARK(BM_LiveNextRecordLatency)
+    ->Arg(0)
+    ->Arg(1)
+    ->ArgName("spin")
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_LiveThroughput)
+    ->Arg(1 << 16)
+    ->ArgName("batch")
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+}  // namespace databento::benchmarks
@@ -0,0 +1,106 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>  // setprecision
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench_data.hpp"
+#include "databento/constants.hpp"  // kUndefPrice
+#include "databento/datetime.hpp"
+#include "databento/pretty.hpp"
+#include "databento/record.hpp"
+
+namespace databento::benchmarks {
+namespace {
+constexpr std::size_t kValueCount = 1 << 16;
+
+std::vector<std::int64_t> GeneratePrices() {
+  std::vector<std::int64_t> prices;
+  prices.reserve(kValueCount);
+  for (std::size_t i = 0; i < kValueCount; ++i) {
+    // Include some negative and undefined prices
+    prices.emplace_back(i % 64 == 0   ? kUndefPrice
+                        : i % 16 == 0 ? -GenerateMbo(i).price
+                                      : GenerateMbo(i).price);
+  }
+  return prices;
+}
+
+void BM_FormatPx(benchmark::State& state) {
+  const auto prices = GeneratePrices();
+  std::ostringstream stream;
+  stream << std::setprecision(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    stream.str({});
+    for (const auto price : prices) {
+      stream << pretty::Px{price} << ' ';
+    }
+    benchmark::DoNotOptimize(stream.tellp());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(prices.size()));
+}
+
+void BM_PxToString(benchmark::State& state) {
+  const auto prices = GeneratePrices();
+  for (auto _ : state) {
+    std::size_t size{};
+    for (const auto price : prices) {
+      size += pretty::PxToString(price).size();
+    }
+    benchmark::DoNotOptimize(size);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(prices.size()));
+}
+
+void BM_FormatTs(benchmark::State& state) {
+  std::vector<UnixNanos> timestamps;
+  timestamps.reserve(kValueCount);
+  for (std::size_t i = 0; i < kValueCount; ++i) {
+    timestamps.emplace_back(GenerateMbo(i).ts_recv + std::chrono::seconds{static_cast<std::int64_t>(i)});
+  }
+  std::ostringstream stream;
+  for (auto _ : state) {
+    stream.str({});
+    for (const auto ts : timestamps) {
+      stream << pretty::Ts{ts} << ' ';
+    }
+    benchmark::DoNotOptimize(stream.tellp());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(timestamps.size()));
+}
+
+// Formats whole records with `operator<<`
+template <typename R>
+void BM_FormatRecord(benchmark::State& state) {
+  std::vector<R> records;
+  records.reserve(kValueCount);
+  for (std::size_t i = 0; i < kValueCount; ++i) {
+    records.emplace_back(RecordGenerator<R>::Generate(i));
+  }
+  std::ostringstream stream;
+  for (auto _ : state) {
+    stream.str({});
+    for (const auto& record : records) {
+      stream << record;
+    }
+    benchmark::DoNotOptimize(stream.tellp());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(records.size()));
+}
+}  // namespace
+
+// 6 is the default precision, which prints all 9 decimal places
+BENCHMARK(BM_FormatPx)->Arg(2)->Arg(6)->ArgName("precision");
+BENCHMARK(BM_PxToString);
+BENCHMARK(BM_FormatTs);
+BENCHMARK_TEMPLATE(BM_FormatRecord, MboMsg);
+BENCHMARK_TEMPLATE(BM_FormatRecord, TradeMsg);
+}  // namespace databento::benchmarks
@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "bench_data.hpp"
+#include "databento/dbn_store.hpp"
+#include "databento/enums.hpp"
+#include "databento/file_stream.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"
+#include "databento/timeseries.hpp"  // KeepGoing
+
+namespace databento::benchmarks {
+namespace {
+NullLogReceiver null_logger;
+
+// The typical `RecordCallback`: a type-erased call followed by a checked `Get`
+void BM_ReplayCallback(benchmark::State& state) {
+  const auto& path = MboFiles::Instance().Get(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    DbnStore store{&null_logger, InMmapFileStream{path},
+                   VersionUpgradePolicy::UpgradeToV3};
+    std::int64_t sum{};
+    store.Replay([&sum](const Record& record) {
+      if (const auto* mbo = record.GetIf<MboMsg>()) {
+        sum += mbo->price;
+      } else if (const auto* trade = record.GetIf<TradeMsg>()) {
+        sum += trade->price;
+      }
+      return KeepGoing::Continue;
+    });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+struct PriceVisitor {
+  void operator()(const MboMsg& mbo) { sum += mbo.price; }
+  void operator()(const TradeMsg& trade) { sum += trade.price; }
+
+  std::int64_t sum{};
+};
+
+void BM_ReplayVisitor(benchmark::State& state) {
+  const auto& path = MboFiles::Instance().Get(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    DbnStore store{&null_logger, InMmapFileStream{path},
+                   VersionUpgradePolicy::UpgradeToV3};
+    PriceVisitor visitor;
+    store.Replay(visitor);
+    benchmark::DoNotOptimize(visitor.sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+}  // namespace
+
+BENCHMARK(BM_ReplayCallback)
+    ->Arg(std::int64_t{1} << 22)
+    ->ArgName("records")
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ReplayVisitor)
+    ->Arg(std::int64_t{1} << 22)
+    ->ArgName("records")
+    ->Unit(benchmark::kMillisecond);
+}  // namespace databento::benchmarks
@@ -0,0 +1,285 @@
+#include <benchmark/benchmark.h>
+#include <date/date.h>
+#ifdef __GLIBC__
+#include <malloc.h>  // mallinfo2
+#endif
+
+#include <algorithm>  // shuffle
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>  // make_shared
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_data.hpp"
+#include "databento/constants.hpp"
+#include "databento/datetime.hpp"
+#include "databento/enums.hpp"
+#include "databento/publishers.hpp"
+#include "databento/record.hpp"
+#include "databento/symbol_map.hpp"
+
+namespace databento::benchmarks {
+namespace {
+constexpr date::year_month_day kStartDate{date::year{2023}, date::month{1},
+                                          date::day{2}};
+constexpr std::size_t kDayCount = 30;
+constexpr std::size_t kLookupCount = 1 << 20;
+
+std::string Symbol(std::size_t instrument) {
+  return "SYM" + std::to_string(instrument);
+}
+
+// The bytes allocated on the heap, or 0 where this isn't available.
+std::size_t HeapBytesInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  const auto info = mallinfo2();
+  // Large blocks are mapped separately
+  return info.uordblks + info.hblkhd;
+#else
+  return 0;
+#endif
+}
+
+// Sets a counter of the heap memory used per instrument by the symbol map built by
+// `generate`.
+template <typename F>
+void CountBytesPerInstrument(benchmark::State& state, F&& generate) {
+  const auto before = HeapBytesInUse();
+  const auto symbol_map = generate();
+  const auto after = HeapBytesInUse();
+  if (after > before) {
+    state.counters["bytes_per_instrument"] =
+        static_cast<double>(after - before) / static_cast<double>(state.range(0));
+  }
+}
+
+TsSymbolMap GenerateTsSymbolMap(std::size_t instrument_count) {
+  const date::year_month_day end_date{date::sys_days{kStartDate} +
+                                      date::days{kDayCount}};
+  TsSymbolMap symbol_map;
+  for (std::size_t i = 0; i < instrument_count; ++i) {
+    symbol_map.Insert(static_cast<std::uint32_t>(i), kStartDate, end_date,
+                      std::make_shared<const std::string>(Symbol(i)));
+  }
+  return symbol_map;
+}
+
+FlatTsSymbolMap GenerateFlatTsSymbolMap(std::size_t instrument_count) {
+  const date::year_month_day end_date{date::sys_days{kStartDate} +
+                                      date::days{kDayCount}};
+  FlatTsSymbolMap symbol_map;
+  for (std::size_t i = 0; i < instrument_count; ++i) {
+    symbol_map.Insert(static_cast<std::uint32_t>(i), kStartDate, end_date, Symbol(i));
+  }
+  return symbol_map;
+}
+
+// Trades spread evenly over the instruments and days of the symbol map
+std::vector<TradeMsg> GenerateLookups(std::size_t instrument_count) {
+  std::vector<TradeMsg> trades;
+  trades.reserve(kLookupCount);
+  const UnixNanos start{date::sys_days{kStartDate}};
+  const auto step = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        date::days{kDayCount}) /
+                    kLookupCount;
+  for (std::size_t i = 0; i < kLookupCount; ++i) {
+    auto trade = RecordGenerator<TradeMsg>::Generate(i);
+    trade.hd.instrument_id = static_cast<std::uint32_t>((i * 7919) % instrument_count);
+    trade.ts_recv = start + step * static_cast<std::int64_t>(i);
+    trades.emplace_back(trade);
+  }
+  return trades;
+}
+
+void BM_TsSymbolMapInsert(benchmark::State& state) {
+  const auto instrument_count = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    auto symbol_map = GenerateTsSymbolMap(instrument_count);
+    benchmark::DoNotOptimize(symbol_map.Size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  CountBytesPerInstrument(
+      state, [instrument_count] { return GenerateTsSymbolMap(instrument_count); });
+}
+
+void BM_FlatTsSymbolMapInsert(benchmark::State& state) {
+  const auto instrument_count = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    auto symbol_map = GenerateFlatTsSymbolMap(instrument_count);
+    benchmark::DoNotOptimize(symbol_map.IntervalCount());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  CountBytesPerInstrument(
+      state, [instrument_count] { return GenerateFlatTsSymbolMap(instrument_count); });
+}
+
+void BM_TsSymbolMapFind(benchmark::State& state) {
+  const auto instrument_count = static_cast<std::size_t>(state.range(0));
+  const auto symbol_map = GenerateTsSymbolMap(instrument_count);
+  const auto trades = GenerateLookups(instrument_count);
+  for (auto _ : state) {
+    std::size_t size{};
+    for (const auto& trade : trades) {
+      size += symbol_map.Find(trade)->second->size();
+    }
+    benchmark::DoNotOptimize(size);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(trades.size()));
+}
+
+void BM_FlatTsSymbolMapFind(benchmark::State& state) {
+  const auto instrument_count = static_cast<std::size_t>(state.range(0));
+  const auto symbol_map = GenerateFlatTsSymbolMap(instrument_count);
+  const auto trades = GenerateLookups(instrument_count);
+  for (auto _ : state) {
+    std::size_t size{};
+    for (const auto& trade : trades) {
+      size += symbol_map.Find(trade)->size();
+    }
+    benchmark::DoNotOptimize(size);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(trades.size()));
+}
+
+// Mappings of OPRA-style option symbols, too long for the small-string
+// optimization, in shuffled order like a live session's symbology
+std::vector<SymbolMappingMsg> GenerateSymbolMappings(std::size_t instrument_count) {
+  std::vector<SymbolMappingMsg> mappings;
+  mappings.reserve(instrument_count);
+  for (std::size_t i = 0; i < instrument_count; ++i) {
+    SymbolMappingMsg mapping{};
+    mapping.hd = RecordHeader{sizeof(SymbolMappingMsg) / RecordHeader::kLengthMultiplier,
+                              RType::SymbolMapping,
+                              static_cast<std::uint16_t>(Publisher::OpraPillarXcbo),
+                              static_cast<std::uint32_t>(i),
+                              {}};
+    mapping.stype_in = SType::RawSymbol;
+    mapping.stype_out = SType::InstrumentId;
+    const auto strike = std::to_string(100'000 + i % 900'000);
+    const auto symbol = "SPY   240119C00" + strike;
+    symbol.copy(mapping.stype_in_symbol.data(), kSymbolCstrLen - 1);
+    symbol.copy(mapping.stype_out_symbol.data(), kSymbolCstrLen - 1);
+    mappings.emplace_back(mapping);
+  }
+  std::shuffle(mappings.begin(), mappings.end(), std::mt19937{42});
+  return mappings;
+}
+
+// The burst of symbol mappings at the start of a live session
+void BM_PitSymbolMapOnSymbolMapping(benchmark::State& state) {
+  const auto mappings = GenerateSymbolMappings(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    PitSymbolMap symbol_map;
+    for (const auto& mapping : mappings) {
+      symbol_map.OnSymbolMapping(mapping);
+    }
+    benchmark::DoNotOptimize(symbol_map.Size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  CountBytesPerInstrument(state, [&mappings] {
+    PitSymbolMap symbol_map;
+    for (const auto& mapping : mappings) {
+      symbol_map.OnSymbolMapping(mapping);
+    }
+    return symbol_map;
+  });
+}
+
+void BM_FlatPitSymbolMapOnSymbolMapping(benchmark::State& state) {
+  const auto mappings = GenerateSymbolMappings(static_cast<std::size_t>(state.range(0)));
+  const auto generate = [&mappings] {
+    FlatPitSymbolMap symbol_map;
+    for (const auto& mapping : mappings) {
+      symbol_map.OnSymbolMapping(mapping);
+    }
+    return symbol_map;
+  };
+  for (auto _ : state) {
+    auto symbol_map = generate();
+    benchmark::DoNotOptimize(symbol_map.Size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  CountBytesPerInstrument(state, generate);
+}
+
+// With the table reserved up front, e.g. from `Metadata::mappings`
+void BM_FlatPitSymbolMapOnSymbolMappingReserved(benchmark::State& state) {
+  const auto mappings = GenerateSymbolMappings(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    FlatPitSymbolMap symbol_map{mappings.size()};
+    for (const auto& mapping : mappings) {
+      symbol_map.OnSymbolMapping(mapping);
+    }
+    benchmark::DoNotOptimize(symbol_map.Size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_PitSymbolMapFind(benchmark::State& state) {
+  const auto instrument_count = static_cast<std::size_t>(state.range(0));
+  PitSymbolMap symbol_map;
+  for (const auto& mapping : GenerateSymbolMappings(instrument_count)) {
+    symbol_map.OnSymbolMapping(mapping);
+  }
+  const auto trades = GenerateLookups(instrument_count);
+  for (auto _ : state) {
+    std::size_t size{};
+    for (const auto& trade : trades) {
+      size += symbol_map.Find(trade.hd.instrument_id)->second.size();
+    }
+    benchmark::DoNotOptimize(size);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(trades.size()));
+}
+
+void BM_FlatPitSymbolMapFind(benchmark::State& state) {
+  const auto instrument_count = static_cast<std::size_t>(state.range(0));
+  FlatPitSymbolMap symbol_map;
+  for (const auto& mapping : GenerateSymbolMappings(instrument_count)) {
+    symbol_map.OnSymbolMapping(mapping);
+  }
+  const auto trades = GenerateLookups(instrument_count);
+  for (auto _ : state) {
+    std::size_t size{};
+    for (const auto& trade : trades) {
+      size += symbol_map.Find(trade.hd.instrument_id)->size();
+    }
+    benchmark::DoNotOptimize(size);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(trades.size()));
+}
+
+// From a single futures product to an options chain
+void InstrumentCounts(benchmark::internal::Benchmark* bench) {
+  bench->RangeMultiplier(32)
+      ->Range(32, std::int64_t{1} << 15)
+      ->ArgName("instruments")
+      ->Unit(benchmark::kMillisecond);
+}
+
+// Up to a live session subscribed to all of OPRA
+void LiveInstrumentCounts(benchmark::internal::Benchmark* bench) {
+  bench->RangeMultiplier(32)
+      ->Range(32, std::int64_t{1} << 20)
+      ->ArgName("instruments")
+      ->Unit(benchmark::kMillisecond);
+}
+}  // namespace
+
+BENCHMARK(BM_TsSymbolMapInsert)->Apply(InstrumentCounts);
+BENCHMARK(BM_TsSymbolMapFind)->Apply(InstrumentCounts);
+BENCHMARK(BM_FlatTsSymbolMapInsert)->Apply(InstrumentCounts);
+BENCHMARK(BM_FlatTsSymbolMapFind)->Apply(InstrumentCounts);
+BENCHMARK(BM_PitSymbolMapOnSymbolMapping)->Apply(LiveInstrumentCounts);
+BENCHMARK(BM_FlatPitSymbolMapOnSymbolMapping)->Apply(LiveInstrumentCounts);
+BENCHMARK(BM_FlatPitSymbolMapOnSymbolMappingReserved)->Apply(LiveInstrumentCounts);
+BENCHMARK(BM_PitSymbolMapFind)->Apply(LiveInstrumentCounts);
+BENCHMARK(BM_FlatPitSymbolMapFind)->Apply(LiveInstrumentCounts);
+}  // namespace databento::benchmarks
@@ -0,0 +1,133 @@
+#include <benchmark/benchmark.h>
+#include <date/date.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "databento/dbn.hpp"
+#include "databento/enums.hpp"
+#include "databento/symbology.hpp"
+#include "databento/symbology_cache.hpp"
+
+namespace databento::benchmarks {
+namespace {
+constexpr date::year_month_day kStartDate{date::year{2023}, date::month{1},
+                                          date::day{2}};
+constexpr date::year_month_day kEndDate{date::year{2023}, date::month{2},
+                                        date::day{1}};
+constexpr date::year_month_day kMidDate{date::year{2023}, date::month{1},
+                                        date::day{16}};
+
+// A resolution of raw symbols to instrument IDs that change halfway through, like
+// an options chain rolling
+SymbologyResolution GenerateResolution(std::size_t symbol_count) {
+  SymbologyResolution res{{}, {}, {}, SType::RawSymbol, SType::InstrumentId};
+  res.mappings.reserve(symbol_count);
+  for (std::size_t i = 0; i < symbol_count; ++i) {
+    res.mappings.emplace(
+        "SPY   240119C" + std::to_string(10'000'000 + i),
+        std::vector<MappingInterval>{
+            {kStartDate, kMidDate, std::to_string(i)},
+            {kMidDate, kEndDate, std::to_string(symbol_count + i)}});
+  }
+  return res;
+}
+
+// Writes the resolution of `state.range(0)` symbols to a temporary file that's
+// removed when it goes out of scope
+class ResolutionFile {
+ public:
+  explicit ResolutionFile(const benchmark::State& state)
+      : path_{std::filesystem::temp_directory_path() /
+              ("databento_symbology_cache_bench_" +
+               std::to_string(state.range(0)) + ".dbsym")} {
+    SymbologyFile::Write(path_, "bench",
+                         GenerateResolution(static_cast<std::size_t>(state.range(0))),
+                         kStartDate, kEndDate);
+  }
+  ResolutionFile(const ResolutionFile&) = delete;
+  ResolutionFile& operator=(const ResolutionFile&) = delete;
+  ~ResolutionFile() { std::filesystem::remove(path_); }
+
+  const std::filesystem::path& Path() const { return path_; }
+
+ private:
+  std::filesystem::path path_;
+};
+
+// The baseline after a resolution has been requested and parsed from JSON
+void BM_SymbologyResolutionCreateSymbolMap(benchmark::State& state) {
+  const auto res = GenerateResolution(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    auto symbol_map = res.CreateSymbolMap();
+    benchmark::DoNotOptimize(symbol_map.Size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_SymbologyFileWrite(benchmark::State& state) {
+  const auto res = GenerateResolution(static_cast<std::size_t>(state.range(0)));
+  const auto path =
+      std::filesystem::temp_directory_path() / "databento_symbology_cache_bench.dbsym";
+  for (auto _ : state) {
+    SymbologyFile::Write(path, "bench", res, kStartDate, kEndDate);
+  }
+  std::filesystem::remove(path);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_SymbologyFileToResolution(benchmark::State& state) {
+  const ResolutionFile file{state};
+  for (auto _ : state) {
+    auto res = SymbologyFile{file.Path()}.ToResolution();
+    benchmark::DoNotOptimize(res.mappings.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_SymbologyFileCreateSymbolMap(benchmark::State& state) {
+  const ResolutionFile file{state};
+  for (auto _ : state) {
+    auto symbol_map = SymbologyFile{file.Path()}.CreateSymbolMap();
+    benchmark::DoNotOptimize(symbol_map.Size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_SymbologyFileCreateFlatSymbolMap(benchmark::State& state) {
+  const ResolutionFile file{state};
+  for (auto _ : state) {
+    auto symbol_map = SymbologyFile{file.Path()}.CreateFlatSymbolMap();
+    benchmark::DoNotOptimize(symbol_map.IntervalCount());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_SymbologyFileCreateSymbolMapForDate(benchmark::State& state) {
+  const ResolutionFile file{state};
+  for (auto _ : state) {
+    auto symbol_map = SymbologyFile{file.Path()}.CreateSymbolMapForDate(kMidDate);
+    benchmark::DoNotOptimize(symbol_map.Size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// From a single futures product to a large options universe
+void SymbolCounts(benchmark::internal::Benchmark* bench) {
+  bench->RangeMultiplier(32)
+      ->Range(32, std::int64_t{1} << 15)
+      ->ArgName("symbols")
+      ->Unit(benchmark::kMillisecond);
+}
+}  // namespace
+
+BENCHMARK(BM_SymbologyResolutionCreateSymbolMap)->Apply(SymbolCounts);
+BENCHMARK(BM_SymbologyFileWrite)->Apply(SymbolCounts);
+BENCHMARK(BM_SymbologyFileToResolution)->Apply(SymbolCounts);
+BENCHMARK(BM_SymbologyFileCreateSymbolMap)->Apply(SymbolCounts);
+BENCHMARK(BM_SymbologyFileCreateFlatSymbolMap)->Apply(SymbolCounts);
+BENCHMARK(BM_SymbologyFileCreateSymbolMapForDate)->Apply(SymbolCounts);
+}  // namespace databento::benchmarks
@@ -0,0 +1,177 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>  // copy
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <system_error>  // error_code
+#include <utility>       // move
+
+#include "databento/compat.hpp"  // kSymbolCstrLenV1
+#include "databento/constants.hpp"
+#include "databento/dbn.hpp"
+#include "databento/dbn_decoder.hpp"
+#include "databento/dbn_encoder.hpp"
+#include "databento/detail/buffer.hpp"
+#include "databento/enums.hpp"
+#include "databento/file_stream.hpp"
+#include "databento/log.hpp"
+#include "databento/publishers.hpp"
+#include "databento/record.hpp"
+#include "databento/v1.hpp"
+#include "databento/v2.hpp"
+#include "databento/v3.hpp"
+
+namespace databento::benchmarks {
+namespace {
+NullLogReceiver null_logger;
+
+constexpr std::size_t kRecordCount = 1 << 18;
+
+template <typename D>
+D GenerateDefinition(std::size_t i) {
+  D def{};
+  def.hd = RecordHeader{sizeof(D) / RecordHeader::kLengthMultiplier,
+                        RType::InstrumentDef,
+                        static_cast<std::uint16_t>(Publisher::GlbxMdp3Glbx),
+                        static_cast<std::uint32_t>(i),
+                        {}};
+  def.min_price_increment = 250'000'000;
+  def.display_factor = kFixedPriceScale;
+  def.raw_instrument_id = static_cast<std::uint32_t>(i);
+  def.instrument_class = InstrumentClass::Future;
+  return def;
+}
+
+// Writes a definition file of the given DBN version. Files are removed on exit.
+class DefinitionFiles {
+ public:
+  ~DefinitionFiles() {
+    for (const auto& [_, path] : paths_) {
+      std::error_code ec;
+      std::filesystem::remove(path, ec);
+    }
+  }
+
+  static DefinitionFiles& Instance() {
+    static DefinitionFiles files;
+    return files;
+  }
+
+  const std::filesystem::path& Get(std::uint8_t version) {
+    auto it = paths_.find(version);
+    if (it != paths_.end()) {
+      return it->second;
+    }
+    auto path = std::filesystem::temp_directory_path() /
+                ("databento_bench_definition_v" + std::to_string(version) + ".dbn");
+    {
+      OutFileStream output{path};
+      DbnEncoder encoder{Metadata{version,
+                                  ToString(Dataset::GlbxMdp3),
+                                  Schema::Definition,
+                                  {},
+                                  {},
+                                  {},
+                                  SType::RawSymbol,
+                                  SType::InstrumentId,
+                                  false,
+                                  version == 1 ? kSymbolCstrLenV1 : kSymbolCstrLen,
+                                  {},
+                                  {},
+                                  {},
+                                  {}},
+                         &output};
+      for (std::size_t i = 0; i < kRecordCount; ++i) {
+        if (version == 1) {
+          encoder.EncodeRecord(GenerateDefinition<v1::InstrumentDefMsg>(i));
+        } else if (version == 2) {
+          encoder.EncodeRecord(GenerateDefinition<v2::InstrumentDefMsg>(i));
+        } else {
+          encoder.EncodeRecord(GenerateDefinition<v3::InstrumentDefMsg>(i));
+        }
+      }
+    }
+    return paths_.emplace(version, std::move(path)).first->second;
+  }
+
+ private:
+  std::map<std::uint8_t, std::filesystem::path> paths_;
+};
+
+// Decodes definitions of DBN version `state.range(0)` upgrading them to version 3.
+// Version 3 is the baseline without any upgrade.
+void BM_DecodeUpgradeToV3(benchmark::State& state) {
+  const auto& path =
+      DefinitionFiles::Instance().Get(static_cast<std::uint8_t>(state.range(0)));
+  for (auto _ : state) {
+    DbnDecoder decoder{&null_logger, InMmapFileStream{path},
+                       VersionUpgradePolicy::UpgradeToV3};
+    decoder.DecodeMetadata();
+    std::int64_t sum{};
+    while (true) {
+      const auto& batch = decoder.DecodeBatch();
+      if (batch.Empty()) {
+        break;
+      }
+      for (const auto& record : batch) {
+        sum += record.Get<v3::InstrumentDefMsg>().min_price_increment;
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kRecordCount));
+}
+
+template <typename D>
+detail::Buffer DefinitionBuffer() {
+  detail::Buffer buffer{kRecordCount * sizeof(D)};
+  for (std::size_t i = 0; i < kRecordCount; ++i) {
+    const auto def = GenerateDefinition<D>(i);
+    buffer.WriteAll(reinterpret_cast<const std::byte*>(&def), sizeof(def));
+  }
+  return buffer;
+}
+
+// Upgrades version 1 definitions in memory into a caller-provided buffer
+void BM_UpgradeRecords(benchmark::State& state) {
+  const auto input = DefinitionBuffer<v1::InstrumentDefMsg>();
+  detail::Buffer output{kRecordCount * sizeof(v3::InstrumentDefMsg)};
+  for (auto _ : state) {
+    const auto res = DbnDecoder::UpgradeRecords(
+        1, VersionUpgradePolicy::UpgradeToV3, false, input.ReadBegin(),
+        input.ReadEnd(), output.WriteBegin(),
+        output.WriteBegin() + output.WriteCapacity());
+    benchmark::DoNotOptimize(output.WriteBegin());
+    benchmark::DoNotOptimize(res);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kRecordCount));
+  state.SetBytesProcessed(
+      state.iterations() *
+      static_cast<std::int64_t>(kRecordCount * sizeof(v3::InstrumentDefMsg)));
+}
+
+// Copies the same number of version 3 definitions: the upper bound for
+// `BM_UpgradeRecords`
+void BM_CopyRecords(benchmark::State& state) {
+  const auto input = DefinitionBuffer<v3::InstrumentDefMsg>();
+  detail::Buffer output{kRecordCount * sizeof(v3::InstrumentDefMsg)};
+  for (auto _ : state) {
+    std::copy(input.ReadBegin(), input.ReadEnd(), output.WriteBegin());
+    benchmark::DoNotOptimize(output.WriteBegin());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kRecordCount));
+  state.SetBytesProcessed(
+      state.iterations() *
+      static_cast<std::int64_t>(kRecordCount * sizeof(v3::InstrumentDefMsg)));
+}
+}  // namespace
+
+BENCHMARK(BM_DecodeUpgradeToV3)
+    ->DenseRange(1, 3)
+    ->ArgName("version")
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_UpgradeRecords)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CopyRecords)->Unit(benchmark::kMillisecond);
+}  // namespace databento::benchmarks
@@ -1,5 +1,8 @@
 set(headers
   include/databento/batch.hpp
+  include/databento/book.hpp
+  include/databento/book_manager.hpp
+  include/databento/columnar_batch.hpp
   include/databento/compat.hpp
   include/databento/constants.hpp
   include/databento/datetime.hpp
@@ -7,14 +10,20 @@ set(headers
   include/databento/dbn_decoder.hpp
   include/databento/dbn_encoder.hpp
   include/databento/dbn_file_store.hpp
+  include/databento/dbn_index.hpp
   include/databento/dbn_store.hpp
   include/databento/detail/buffer.hpp
   include/databento/detail/dbn_buffer_decoder.hpp
+  include/databento/detail/fixed_length_records.hpp
+  include/databento/detail/flat_hash_map.hpp
   include/databento/detail/http_client.hpp
   include/databento/detail/json_helpers.hpp
+  include/databento/detail/live_stats_recorder.hpp
+  include/databento/detail/read_ahead_stream.hpp
   include/databento/detail/scoped_fd.hpp
   include/databento/detail/scoped_thread.hpp
   include/databento/detail/sha256_hasher.hpp
+  include/databento/detail/slab_pool.hpp
   include/databento/detail/tcp_client.hpp
   include/databento/detail/zstd_stream.hpp
   include/databento/enums.hpp
@@ -26,6 +35,8 @@ set(headers
   include/databento/ireadable.hpp
   include/databento/live.hpp
   include/databento/live_blocking.hpp
+  include/databento/live_multiplexer.hpp
+  include/databento/live_stats.hpp
   include/databento/live_subscription.hpp
   include/databento/live_threaded.hpp
   include/databento/log.hpp
@@ -33,33 +44,49 @@ set(headers
   include/databento/pretty.hpp
   include/databento/publishers.hpp
   include/databento/record.hpp
+  include/databento/record_batch.hpp
+  include/databento/record_queue.hpp
+  include/databento/record_ref.hpp
+  include/databento/record_visitor.hpp
   include/databento/symbol_map.hpp
   include/databento/symbology.hpp
+  include/databento/symbology_cache.hpp
+  include/databento/synth.hpp
   include/databento/timeseries.hpp
   include/databento/v1.hpp
   include/databento/v2.hpp
   include/databento/v3.hpp
   include/databento/with_ts_out.hpp
   src/detail/http_stream_reader.hpp
+  src/detail/io_uring.hpp
   src/detail/stream_op_helper.hpp
 )
 
 set(sources
   src/batch.cpp
+  src/book.cpp
+  src/book_manager.cpp
+  src/columnar_batch.cpp
   src/datetime.cpp
   src/dbn.cpp
   src/dbn_constants.hpp
   src/dbn_decoder.cpp
   src/dbn_encoder.cpp
+  src/dbn_index.cpp
   src/dbn_store.cpp
   src/detail/buffer.cpp
   src/detail/dbn_buffer_decoder.cpp
+  src/detail/fixed_length_records.cpp
   src/detail/http_client.cpp
   src/detail/http_stream_reader.cpp
+  src/detail/io_uring.cpp
   src/detail/json_helpers.cpp
   src/detail/live_connection.cpp
+  src/detail/live_stats_recorder.cpp
+  src/detail/read_ahead_stream.cpp
   src/detail/scoped_fd.cpp
   src/detail/sha256_hasher.cpp
+  src/detail/slab_pool.cpp
   src/detail/tcp_client.cpp
   src/detail/tcp_readable.cpp
   src/detail/zstd_stream.cpp
@@ -70,14 +97,19 @@ set(sources
   src/historical.cpp
   src/live.cpp
   src/live_blocking.cpp
+  src/live_multiplexer.cpp
+  src/live_stats.cpp
   src/live_threaded.cpp
   src/log.cpp
   src/metadata.cpp
   src/pretty.cpp
   src/publishers.cpp
   src/record.cpp
+  src/record_queue.cpp
   src/symbol_map.cpp
   src/symbology.cpp
+  src/symbology_cache.cpp
+  src/synth.cpp
   src/v1.cpp
   src/v2.cpp
 )
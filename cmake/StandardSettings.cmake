@@ -6,6 +6,8 @@ option(${PROJECT_NAME_UPPERCASE}_USE_EXTERNAL_DATE "Use an external date library
 option(${PROJECT_NAME_UPPERCASE}_USE_EXTERNAL_JSON "Use an external JSON library" OFF)
 option(${PROJECT_NAME_UPPERCASE}_USE_EXTERNAL_HTTPLIB "Use an external httplib library" OFF)
 option(${PROJECT_NAME_UPPERCASE}_USE_EXTERNAL_GTEST "Use an external google test (gtest) library" ON)
+option(${PROJECT_NAME_UPPERCASE}_USE_EXTERNAL_BENCHMARK "Use an external google benchmark library" ON)
+option(${PROJECT_NAME_UPPERCASE}_ENABLE_IO_URING "Read live sockets and files with io_uring. Only supported on Linux." OFF)
 
 #
 # Compiler options
@@ -20,6 +22,8 @@ option(${PROJECT_NAME_UPPERCASE}_WARNINGS_AS_ERRORS "Treat compiler warnings as
 # Default to ON if main project, otherwise OFF
 option(${PROJECT_NAME_UPPERCASE}_ENABLE_UNIT_TESTING "Enable unit tests for the projects (from the `test` subfolder)." OFF)
 option(${PROJECT_NAME_UPPERCASE}_ENABLE_EXAMPLES "Enable building examples for the project." OFF)
+option(${PROJECT_NAME_UPPERCASE}_ENABLE_BENCHMARKS "Enable building benchmarks for the project (from the `benchmarks` subfolder)." OFF)
+option(${PROJECT_NAME_UPPERCASE}_ENABLE_TOOLS "Enable building tools, such as dbn-replay-gateway, for the project (from the `tools` subfolder). Only supported on Linux." OFF)
 
 #
 # Static analyzers
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <array>
+#include <cstddef>  // size_t
+#include <cstdint>  // int64_t, uint32_t, uint64_t
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "databento/constants.hpp"             // kUndefPrice
+#include "databento/datetime.hpp"              // UnixNanos
+#include "databento/detail/flat_hash_map.hpp"  // FlatHashMap
+#include "databento/enums.hpp"                 // Side
+#include "databento/record.hpp"                // BidAskPair, MboMsg, Record
+
+// Limit order books built from MBO data.
+namespace databento::book {
+// The aggregate of the resting orders at a price.
+struct PriceLevel {
+  std::int64_t price{kUndefPrice};
+  // The total size of the orders.
+  std::uint32_t size{};
+  // The number of orders.
+  std::uint32_t count{};
+
+  bool IsEmpty() const { return price == kUndefPrice; }
+};
+
+inline bool operator==(const PriceLevel& lhs, const PriceLevel& rhs) {
+  return lhs.price == rhs.price && lhs.size == rhs.size && lhs.count == rhs.count;
+}
+inline bool operator!=(const PriceLevel& lhs, const PriceLevel& rhs) {
+  return !(lhs == rhs);
+}
+std::string ToString(const PriceLevel& level);
+std::ostream& operator<<(std::ostream& stream, const PriceLevel& level);
+
+// A resting order.
+struct Order {
+  std::int64_t price;
+  std::uint32_t size;
+  Side side;
+};
+
+// A limit order book for a single instrument from a single publisher, built by
+// applying its MBO records in order.
+//
+// Each side's price levels are kept in a sorted array with the best level last, so
+// the top of the book and each level of depth are read in constant time. Levels are
+// found by scanning down from the top, where most updates are. Resting orders are
+// found by ID in an open-addressing hash table. The book aggregates orders into
+// levels but doesn't track their queue priority.
+//
+// A venue event can span several records, such as a trade and the resulting fill
+// and cancel, and the book is only consistent with the venue's once every record
+// of the event has been applied: check `IsConsistent` before reading it. A clear
+// followed by a snapshot is handled like any other event.
+class OrderBook {
+ public:
+  OrderBook() = default;
+
+  // Applies an MBO record. Throws `InvalidArgumentError` if the record can't be
+  // applied to the book, such as a cancel for an unknown order.
+  void Apply(const MboMsg& mbo);
+  // Applies `record` if it's an MBO record and ignores it otherwise.
+  void Apply(const Record& record);
+  // Removes every order and resets the book to its initial state, e.g. for reuse
+  // with another instrument. Keeps the book's memory for reuse.
+  void Clear();
+  // Ensures `order_count` resting orders and `level_count` levels on each side can
+  // be stored without allocating.
+  void Reserve(std::size_t order_count, std::size_t level_count) {
+    orders_.Reserve(order_count);
+    bids_.reserve(level_count);
+    asks_.reserve(level_count);
+  }
+
+  // Whether the last record applied was the last of its event, i.e. had `F_LAST`
+  // set. True for a new book.
+  bool IsConsistent() const { return is_consistent_; }
+  // The `ts_recv` of the last record applied.
+  UnixNanos TsRecv() const { return ts_recv_; }
+  // The `sequence` of the last record applied.
+  std::uint32_t Sequence() const { return sequence_; }
+
+  std::size_t BidLevelCount() const { return bids_.size(); }
+  std::size_t AskLevelCount() const { return asks_.size(); }
+  std::size_t OrderCount() const { return orders_.Size(); }
+  // The bid level `idx` levels from the top, or an empty level if there are
+  // fewer.
+  PriceLevel Bid(std::size_t idx = 0) const { return LevelAt(bids_, idx); }
+  // The ask level `idx` levels from the top, or an empty level if there are
+  // fewer.
+  PriceLevel Ask(std::size_t idx = 0) const { return LevelAt(asks_, idx); }
+  // The best bid and offer.
+  BidAskPair Bbo() const { return Level(0); }
+  // The pair of levels `idx` levels from the top, like the `levels` of MBP
+  // records.
+  BidAskPair Level(std::size_t idx) const;
+  // The top `N` levels, like the `levels` of an `Mbp10Msg` for an `N` of 10.
+  template <std::size_t N>
+  std::array<BidAskPair, N> Levels() const {
+    std::array<BidAskPair, N> levels;
+    for (std::size_t i = 0; i < N; ++i) {
+      levels[i] = Level(i);
+    }
+    return levels;
+  }
+  // Returns the resting order with `order_id` or `nullptr` if there's none. Valid
+  // until the next record is applied.
+  const Order* FindOrder(std::uint64_t order_id) const {
+    return orders_.Find(order_id);
+  }
+
+ private:
+  static PriceLevel LevelAt(const std::vector<PriceLevel>& levels, std::size_t idx) {
+    return idx < levels.size() ? levels[levels.size() - 1 - idx] : PriceLevel{};
+  }
+
+  std::vector<PriceLevel>& SideLevels(Side side) {
+    return side == Side::Bid ? bids_ : asks_;
+  }
+  // Returns the level at `price`, inserting an empty one if there's none.
+  PriceLevel& GetOrInsertLevel(Side side, std::int64_t price);
+  // Removes `size` and `count` from the level at `price`, removing the level if
+  // it's left with no orders.
+  void ReduceLevel(Side side, std::int64_t price, std::uint32_t size,
+                   std::uint32_t count);
+  // Removes every order, such as for a clear action.
+  void ClearOrders();
+  void Add(const MboMsg& mbo);
+  void AddOrder(const MboMsg& mbo);
+  void Cancel(const MboMsg& mbo);
+  void Modify(const MboMsg& mbo);
+  void ReplaceTop(const MboMsg& mbo);
+
+  // Sorted with the best price last: ascending for bids, descending for asks
+  std::vector<PriceLevel> bids_;
+  std::vector<PriceLevel> asks_;
+  detail::FlatHashMap<std::uint64_t, Order> orders_;
+  UnixNanos ts_recv_{};
+  std::uint32_t sequence_{};
+  bool is_consistent_{true};
+};
+}  // namespace databento::book
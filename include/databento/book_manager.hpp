@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint16_t, uint32_t, uint64_t
+#include <memory>   // unique_ptr
+#include <vector>
+
+#include "databento/book.hpp"                  // OrderBook
+#include "databento/detail/flat_hash_map.hpp"  // FlatHashMap
+#include "databento/record.hpp"  // BidAskPair, ConsolidatedBidAskPair, MboMsg, Record
+
+namespace databento::book {
+struct BookManagerConf {
+  // The number of books allocated up front. Once they're all in use, more are
+  // allocated in blocks of the same size.
+  std::size_t book_capacity{1'024};
+  // The number of resting orders each book can hold before allocating.
+  std::size_t order_capacity{64};
+  // The number of price levels on each side of each book before allocating.
+  std::size_t level_capacity{16};
+};
+
+// Order books for many instruments across publishers, keyed by instrument ID and
+// publisher ID, with a consolidated best bid and offer for each instrument.
+//
+// Books are taken from a pool allocated up front with room for orders and levels,
+// so books for instruments that first appear mid-session, e.g. after a
+// `SymbolMappingMsg`, are created without allocating. `Clear` returns every book to
+// the pool.
+//
+// The consolidated BBO of an instrument is built from the BBO of each of its
+// books as of the book's last record with `F_LAST`, so books in the middle of an
+// event are never read. It's only recomputed when one of these BBOs has changed.
+class BookManager {
+ public:
+  BookManager();
+  // Throws `InvalidArgumentError` if `conf.book_capacity` is 0.
+  explicit BookManager(const BookManagerConf& conf);
+
+  // Applies an MBO record to the book of its instrument and publisher, creating
+  // the book if it's the first record for them. Throws `InvalidArgumentError` if
+  // the book can't apply the record.
+  void Apply(const MboMsg& mbo);
+  // Applies `record` if it's an MBO record and ignores it otherwise.
+  void Apply(const Record& record);
+  // Removes every book, returning them to the pool.
+  void Clear();
+
+  // The number of books in use.
+  std::size_t BookCount() const { return book_count_; }
+  // The number of books that can be in use without allocating.
+  std::size_t BookCapacity() const { return chunks_.size() * chunk_size_; }
+  // Returns the book for `instrument_id` from `publisher_id` or `nullptr` if no
+  // records have been applied for them. The book's address is stable until
+  // `Clear` is called.
+  const OrderBook* Find(std::uint32_t instrument_id, std::uint16_t publisher_id) const;
+
+  // The consolidated BBO of `instrument_id`: the best price on each side across
+  // publishers, the total size at that price, and the publisher with the most
+  // size there, with ties going to the lowest publisher ID. Empty sides have an
+  // undefined price.
+  ConsolidatedBidAskPair ConsolidatedBbo(std::uint32_t instrument_id);
+  // Calls `func(instrument_id, consolidated_bbo)` for each instrument whose
+  // consolidated BBO may have changed since the last call, in the order they
+  // changed. `func` must not apply records.
+  template <typename F>
+  void ForEachChanged(F&& func) {
+    for (const auto idx : changed_) {
+      auto& instrument = instruments_[idx];
+      instrument.is_changed = false;
+      func(instrument.instrument_id, Refresh(instrument));
+    }
+    changed_.clear();
+  }
+
+ private:
+  static constexpr std::uint32_t kNoBook = UINT32_MAX;
+
+  struct BookEntry {
+    OrderBook book;
+    // The BBO of `book` as of its last record with `F_LAST`
+    BidAskPair bbo;
+    std::uint32_t instrument_idx;
+    // The next book of the same instrument by publisher ID, or `kNoBook`
+    std::uint32_t next;
+    std::uint16_t publisher_id;
+  };
+  struct InstrumentEntry {
+    std::uint32_t instrument_id;
+    // The instrument's book with the lowest publisher ID
+    std::uint32_t first_book;
+    ConsolidatedBidAskPair bbo;
+    // Whether `bbo` needs to be recomputed
+    bool is_stale;
+    // Whether the instrument is in `changed_`
+    bool is_changed;
+  };
+
+  static std::uint64_t BookKey(std::uint32_t instrument_id,
+                               std::uint16_t publisher_id) {
+    return (static_cast<std::uint64_t>(publisher_id) << 32) | instrument_id;
+  }
+
+  BookEntry& Entry(std::uint32_t idx) {
+    return chunks_[idx / chunk_size_][idx % chunk_size_];
+  }
+  const BookEntry& Entry(std::uint32_t idx) const {
+    return chunks_[idx / chunk_size_][idx % chunk_size_];
+  }
+  void AddChunk();
+  BookEntry& GetOrInsertBook(std::uint32_t instrument_id, std::uint16_t publisher_id);
+  std::uint32_t GetOrInsertInstrument(std::uint32_t instrument_id);
+  const ConsolidatedBidAskPair& Refresh(InstrumentEntry& instrument);
+
+  BookManagerConf conf_;
+  std::size_t chunk_size_;
+  std::vector<std::unique_ptr<BookEntry[]>> chunks_;
+  std::size_t book_count_{};
+  // Book key to index of the book
+  detail::FlatHashMap<std::uint64_t, std::uint32_t> book_idxs_;
+  // Instrument ID to index in `instruments_`
+  detail::FlatHashMap<std::uint32_t, std::uint32_t> instrument_idxs_;
+  std::vector<InstrumentEntry> instruments_;
+  // Indices in `instruments_`
+  std::vector<std::uint32_t> changed_;
+};
+}  // namespace databento::book
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>  // size_t
+#include <cstdint>
+#include <vector>
+
+#include "databento/datetime.hpp"  // TimeDeltaNanos, UnixNanos
+#include "databento/dbn_store.hpp"
+#include "databento/enums.hpp"  // Action, Side
+#include "databento/flag_set.hpp"
+#include "databento/record.hpp"  // MboMsg, Mbp1Msg, TradeMsg
+#include "databento/record_batch.hpp"
+
+namespace databento {
+// The fields of records of type `R` stored as one contiguous column per field. Each
+// column holds `ColumnarBatch::Size()` elements. Specialized for `MboMsg`,
+// `TradeMsg`, and `Mbp1Msg`.
+template <typename R>
+struct RecordColumns;
+
+template <>
+struct RecordColumns<MboMsg> {
+  std::vector<UnixNanos> ts_event;
+  std::vector<std::uint16_t> publisher_id;
+  std::vector<std::uint32_t> instrument_id;
+  std::vector<std::uint64_t> order_id;
+  std::vector<std::int64_t> price;
+  std::vector<std::uint32_t> size;
+  std::vector<FlagSet> flags;
+  std::vector<std::uint8_t> channel_id;
+  std::vector<Action> action;
+  std::vector<Side> side;
+  std::vector<UnixNanos> ts_recv;
+  std::vector<TimeDeltaNanos> ts_in_delta;
+  std::vector<std::uint32_t> sequence;
+};
+
+template <>
+struct RecordColumns<TradeMsg> {
+  std::vector<UnixNanos> ts_event;
+  std::vector<std::uint16_t> publisher_id;
+  std::vector<std::uint32_t> instrument_id;
+  std::vector<std::int64_t> price;
+  std::vector<std::uint32_t> size;
+  std::vector<Action> action;
+  std::vector<Side> side;
+  std::vector<FlagSet> flags;
+  std::vector<std::uint8_t> depth;
+  std::vector<UnixNanos> ts_recv;
+  std::vector<TimeDeltaNanos> ts_in_delta;
+  std::vector<std::uint32_t> sequence;
+};
+
+template <>
+struct RecordColumns<Mbp1Msg> {
+  std::vector<UnixNanos> ts_event;
+  std::vector<std::uint16_t> publisher_id;
+  std::vector<std::uint32_t> instrument_id;
+  std::vector<std::int64_t> price;
+  std::vector<std::uint32_t> size;
+  std::vector<Action> action;
+  std::vector<Side> side;
+  std::vector<FlagSet> flags;
+  std::vector<std::uint8_t> depth;
+  std::vector<UnixNanos> ts_recv;
+  std::vector<TimeDeltaNanos> ts_in_delta;
+  std::vector<std::uint32_t> sequence;
+  // The top of book level
+  std::vector<std::int64_t> bid_px;
+  std::vector<std::int64_t> ask_px;
+  std::vector<std::uint32_t> bid_sz;
+  std::vector<std::uint32_t> ask_sz;
+  std::vector<std::uint32_t> bid_ct;
+  std::vector<std::uint32_t> ask_ct;
+};
+
+// A structure-of-arrays view of up to `Capacity()` records of type `R` decoded from
+// a `DbnStore`, for vectorized analytics over individual fields. Supported for
+// `MboMsg`, `TradeMsg`, and `Mbp1Msg` (including TBBO).
+//
+// A batch keeps its position within the store's last decoded `RecordBatch`, so it
+// shouldn't be filled from a store that's also being read with `NextRecord` or
+// `NextBatch`.
+template <typename R>
+class ColumnarBatch {
+ public:
+  explicit ColumnarBatch(std::size_t capacity);
+
+  // Replaces the contents of the batch with the next records of type `R` in
+  // `store`. Records of other types are skipped. Returns the number of records,
+  // which is less than `Capacity()` only once the end of `store` has been reached.
+  std::size_t Fill(DbnStore& store);
+
+  std::size_t Capacity() const { return capacity_; }
+  std::size_t Size() const { return size_; }
+  bool Empty() const { return size_ == 0; }
+  const RecordColumns<R>& Columns() const { return columns_; }
+
+ private:
+  // Copies the fields of `rows_` into the columns following the first `size_`
+  // records.
+  void TransposeRows();
+
+  std::size_t capacity_;
+  std::size_t size_{};
+  RecordColumns<R> columns_{};
+  // Records of type `R` to transpose into `columns_`
+  std::vector<const R*> rows_;
+  DbnStore* store_{};
+  const RecordBatch* pending_{};
+  std::size_t pending_idx_{};
+};
+
+// Forward declare explicit instantiation
+extern template class ColumnarBatch<MboMsg>;
+extern template class ColumnarBatch<TradeMsg>;
+extern template class ColumnarBatch<Mbp1Msg>;
+}  // namespace databento
@@ -2,18 +2,54 @@
 
 #include <cstddef>  // size_t
 #include <cstdint>  // uint8_t
-#include <memory>   // unique_ptr
+#include <memory>   // make_shared, shared_ptr, unique_ptr
+#include <optional>
 #include <string>
+#include <utility>  // pair
 
+#include "databento/datetime.hpp"  // UnixNanos
 #include "databento/dbn.hpp"
 #include "databento/detail/buffer.hpp"
+#include "databento/detail/fixed_length_records.hpp"
+#include "databento/detail/slab_pool.hpp"  // SlabPool
 #include "databento/enums.hpp"  // Upgrade Policy
 #include "databento/file_stream.hpp"
 #include "databento/ireadable.hpp"
 #include "databento/log.hpp"
-#include "databento/record.hpp"  // Record, RecordHeader
+#include "databento/record.hpp"        // Record, RecordHeader
+#include "databento/record_batch.hpp"  // RecordBatch
+#include "databento/record_ref.hpp"    // RecordRef, RecordSlabCopier
 
 namespace databento {
+// Options for decoding DBN data.
+struct DecodeConf {
+  // The number of threads used to decompress Zstd-compressed input made up of
+  // multiple frames. With 1, input is decompressed on the calling thread. With 0,
+  // one thread per hardware thread is used.
+  std::size_t zstd_threads{1};
+  // The number of buffers read and decompressed ahead of decoding on a background
+  // thread. With 0, input is read on the decoding thread. Uncompressed
+  // memory-mapped files are always read in place.
+  std::size_t read_ahead_depth{};
+  // The size in bytes of each read-ahead buffer.
+  std::size_t read_ahead_buffer_size{detail::Buffer::kDefaultBufSize};
+};
+
+// Counters for the background read-ahead thread enabled with
+// `DecodeConf::read_ahead_depth`.
+struct ReadAheadStats {
+  // The number of times the read-ahead thread waited for decoding to free a
+  // buffer. A high count indicates decoding is the bottleneck.
+  std::uint64_t producer_stalls;
+  // The number of times decoding waited for the read-ahead thread to fill a
+  // buffer. A high count indicates reading or decompression is the bottleneck.
+  std::uint64_t consumer_stalls;
+};
+
+namespace detail {
+class ReadAheadStream;
+}  // namespace detail
+
 // DBN decoder. Set upgrade_policy to control how DBN version 1 data should be
 // handled. Defaults to upgrading DBN versions 1 and 2 to version 3 (the current
 // version).
@@ -23,6 +59,15 @@ class DbnDecoder {
   DbnDecoder(ILogReceiver* log_receiver, std::unique_ptr<IReadable> input);
   DbnDecoder(ILogReceiver* log_receiver, std::unique_ptr<IReadable> input,
              VersionUpgradePolicy upgrade_policy);
+  DbnDecoder(ILogReceiver* log_receiver, std::unique_ptr<IReadable> input,
+             VersionUpgradePolicy upgrade_policy, DecodeConf decode_conf);
+  // Decodes from a memory-mapped file. If the file is uncompressed and its records
+  // are 8-byte aligned, records are decoded in place from the mapping without
+  // copying. Otherwise this behaves like decoding any other input.
+  DbnDecoder(ILogReceiver* log_receiver, InMmapFileStream file_stream,
+             VersionUpgradePolicy upgrade_policy);
+  DbnDecoder(ILogReceiver* log_receiver, InMmapFileStream file_stream,
+             VersionUpgradePolicy upgrade_policy, DecodeConf decode_conf);
 
   static std::pair<std::uint8_t, std::size_t> DecodeMetadataVersionAndSize(
       const std::byte* buffer, std::size_t size);
@@ -35,15 +80,66 @@ class DbnDecoder {
                                    VersionUpgradePolicy upgrade_policy, bool ts_out,
                                    std::array<std::byte, kMaxRecordLen>* compat_buffer,
                                    Record rec);
+  // Upgrades `record` by constructing the upgraded record in `out`, which must be
+  // 8-byte aligned with space for `kMaxRecordLen` bytes. Returns the length of the
+  // upgraded record, or 0 if the record is unchanged and nothing was written.
+  using UpgradeFn = std::size_t (*)(const RecordHeader& record, bool ts_out,
+                                    std::byte* out);
+  // Returns the upgrade function specialized for `version`-formatted data under
+  // `upgrade_policy`, or nullptr if no upgrade is needed. Selecting it once avoids
+  // dispatching on the version and policy for every record.
+  static UpgradeFn SelectUpgrade(std::uint8_t version,
+                                 VersionUpgradePolicy upgrade_policy);
+  // Upgrades the complete records in [`begin`, `end`) into [`out`, `out_end`),
+  // copying runs of records unchanged by the upgrade in bulk. Stops at the first
+  // record that doesn't fit. Returns the number of bytes consumed from the input and
+  // the number of bytes written to the output. Both must be 8-byte aligned.
+  static std::pair<std::size_t, std::size_t> UpgradeRecords(
+      std::uint8_t version, VersionUpgradePolicy upgrade_policy, bool ts_out,
+      const std::byte* begin, const std::byte* end, std::byte* out,
+      const std::byte* out_end);
   // Returns whether a record from `version`-formatted data requires runtime
   // upgrade dispatch under `upgrade_policy`.
   static bool NeedsUpgrade(VersionUpgradePolicy upgrade_policy, std::uint8_t version);
+  // Returns the length in bytes of every record in `version`-formatted data of
+  // `schema`, or 0 if the schema is unset or its records vary in length.
+  static std::size_t FixedRecordLength(std::uint8_t version,
+                                       std::optional<Schema> schema, bool ts_out);
+  // Returns the number of complete records of `record_len` bytes at the start of
+  // [`begin`, `end`), stopping at the first record with a different length.
+  static std::size_t CountFixedLengthRecords(const std::byte* begin,
+                                             const std::byte* end,
+                                             std::size_t record_len);
 
   // Should be called exactly once.
   Metadata DecodeMetadata();
   // Lifetime of returned Record is until next call to DecodeRecord. Returns
   // nullptr once the end of the input has been reached.
   const Record* DecodeRecord();
+  // Like `DecodeRecord`, but returns a handle that keeps the record valid after
+  // later calls, so it can be handed off to another thread. Records are pinned in
+  // the slab of the decoding buffer they were read into. Upgraded records and
+  // records from a memory-mapped file are copied into a pooled slab. Returns an
+  // empty handle once the end of the input has been reached.
+  RecordRef DecodeRecordRef();
+  // Decodes every complete record currently buffered, reading more input only if
+  // no complete record is buffered. The returned batch is valid until the next call
+  // to DecodeBatch or DecodeRecord. Returns an empty batch once the end of the input
+  // has been reached.
+  const RecordBatch& DecodeBatch();
+  // Continues decoding from `input`, discarding its first `skip_size` bytes of DBN
+  // data, for seeking within a file. `input` must be positioned at the start of a
+  // Zstd frame if the original input was compressed, or at the start of a record
+  // otherwise. Must be called after `DecodeMetadata`. See `DbnIndex`.
+  void ResetInput(std::unique_ptr<IReadable> input, std::size_t skip_size);
+  // Discards records with an index timestamp before `ts`, stopping at the first
+  // record at or after it. Must be called after `DecodeMetadata`.
+  void SkipBefore(UnixNanos ts);
+  // Whether records are decoded in place from a memory-mapped file. Only valid
+  // after `DecodeMetadata` has been called.
+  bool IsZeroCopy() const { return decode_in_place_; }
+  // Returns zeroed stats if read-ahead isn't enabled.
+  databento::ReadAheadStats ReadAheadStats() const;
 
  private:
   static std::string DecodeSymbol(std::size_t symbol_cstr_len,
@@ -58,18 +154,47 @@ class DbnDecoder {
                                            const std::byte*& buffer,
                                            const std::byte* buffer_end);
   bool DetectCompression();
+  void WrapZstdInput();
+  void MaybeReadAhead();
   std::size_t FillBuffer();
   RecordHeader* BufferRecordHeader();
+  const Record* DecodeMappedRecord();
+  RecordRef PinRecord(const Record& record);
+  // Returns whether a complete record is buffered after reading more input if
+  // necessary.
+  bool FillRecord();
+  // Adds all complete records in [`begin`, `end`) to `batch_`, returning the
+  // number of bytes consumed.
+  std::size_t BatchRecords(std::byte* begin, const std::byte* end);
 
   ILogReceiver* log_receiver_;
   std::uint8_t version_{};
   VersionUpgradePolicy upgrade_policy_;
-  bool needs_upgrade_{true};
+  DecodeConf decode_conf_;
+  bool is_compressed_{};
+  // Selected in `DecodeMetadata`. nullptr if no upgrade is needed
+  UpgradeFn upgrade_record_{};
   bool ts_out_{};
+  // Initialized in `DecodeMetadata`
+  detail::FixedLengthRecords fixed_records_{};
   std::unique_ptr<IReadable> input_;
-  detail::Buffer buffer_{};
+  // Non-owning. Set when `input_` is an uncompressed memory-mapped file
+  InMmapFileStream* mapped_input_{};
+  bool decode_in_place_{};
+  // Non-owning. Set when read-ahead is enabled
+  detail::ReadAheadStream* read_ahead_input_{};
+  // Backs `buffer_` and is shared with any outstanding `RecordRef`s
+  std::shared_ptr<detail::SlabPool> slab_pool_{
+      std::make_shared<detail::SlabPool>(detail::Buffer::kDefaultBufSize)};
+  detail::Buffer buffer_{slab_pool_};
   // Must be 8-byte aligned for records
   alignas(RecordHeader) std::array<std::byte, kMaxRecordLen> compat_buffer_{};
   Record current_record_{nullptr};
+  // Where records that can't be pinned in `buffer_` are copied for
+  // `DecodeRecordRef`
+  detail::RecordSlabCopier ref_copier_;
+  RecordBatch batch_{};
+  // Holds upgraded records in `batch_`
+  detail::Buffer compat_batch_buffer_{};
 };
 }  // namespace databento
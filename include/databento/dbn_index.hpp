@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>     // size_t
+#include <cstdint>     // uint64_t
+#include <filesystem>  // path
+#include <vector>
+
+#include "databento/datetime.hpp"  // UnixNanos
+
+namespace databento {
+// A position in a DBN file that decoding can resume from without reading what
+// precedes it.
+struct DbnCheckpoint {
+  // The latest index timestamp of the records before the checkpoint. Every record
+  // with a later index timestamp is at or after the checkpoint, even if the file
+  // isn't sorted.
+  UnixNanos ts;
+  // The offset of the checkpoint's record in the uncompressed DBN data.
+  std::uint64_t offset;
+  // The offset in the file to start reading from: the start of the Zstd frame
+  // containing the record, or `offset` if the file is uncompressed.
+  std::uint64_t frame_offset;
+  // The offset in the uncompressed DBN data of `frame_offset`.
+  std::uint64_t frame_data_offset;
+};
+
+bool operator==(const DbnCheckpoint& lhs, const DbnCheckpoint& rhs);
+inline bool operator!=(const DbnCheckpoint& lhs, const DbnCheckpoint& rhs) {
+  return !(lhs == rhs);
+}
+
+// An index of checkpoints in a DBN file for seeking to a timestamp with
+// `DbnStore::SeekTo`. Built by `DbnIndexer` and usually stored in a sidecar file
+// next to the DBN file.
+//
+// Seeking into a Zstd-compressed file starts decompressing at the frame containing
+// the checkpoint, so it's fastest for files made up of many frames, like those from
+// batch downloads. A single-frame file can only be decompressed from the start.
+class DbnIndex {
+ public:
+  // The default path of the index for the DBN file at `dbn_path`: the same path with
+  // `.idx` appended.
+  static std::filesystem::path SidecarPath(const std::filesystem::path& dbn_path);
+  // Reads an index written by `Write`. Throws `DbnResponseError` if the file isn't
+  // a valid index.
+  static DbnIndex Read(const std::filesystem::path& index_path);
+
+  DbnIndex(bool is_compressed, std::uint64_t file_size,
+           std::vector<DbnCheckpoint> checkpoints);
+
+  void Write(const std::filesystem::path& index_path) const;
+
+  // Whether the indexed file is Zstd-compressed.
+  bool IsCompressed() const { return is_compressed_; }
+  // The size in bytes of the indexed file, for detecting when the index is stale.
+  std::uint64_t FileSize() const { return file_size_; }
+  // Ordered by offset. The first checkpoint is at the first record.
+  const std::vector<DbnCheckpoint>& Checkpoints() const { return checkpoints_; }
+  // Returns the last checkpoint before which every record has an index timestamp
+  // before `ts`, or the first checkpoint if there's none.
+  const DbnCheckpoint& Find(UnixNanos ts) const;
+
+ private:
+  bool is_compressed_;
+  std::uint64_t file_size_;
+  std::vector<DbnCheckpoint> checkpoints_;
+};
+
+// Builds a `DbnIndex` for a DBN file, optionally Zstd-compressed, by reading it
+// once.
+class DbnIndexer {
+ public:
+  static constexpr std::size_t kDefaultCheckpointInterval = 10'000;
+
+  DbnIndexer();
+  // Places a checkpoint every `checkpoint_interval` records. Smaller intervals
+  // make seeking skip fewer records at the cost of a larger index.
+  explicit DbnIndexer(std::size_t checkpoint_interval);
+
+  DbnIndex Index(const std::filesystem::path& dbn_path) const;
+
+ private:
+  std::size_t checkpoint_interval_;
+};
+}  // namespace databento
@@ -1,15 +1,24 @@
 #pragma once
 
-#include <filesystem>  // path
-#include <memory>      // unique_ptr
+#include <filesystem>   // path
+#include <memory>       // unique_ptr
+#include <optional>     // optional
+#include <type_traits>  // enable_if_t
+#include <utility>      // forward, move
 
+#include "databento/datetime.hpp"     // UnixNanos
 #include "databento/dbn.hpp"          // DecodeMetadata
-#include "databento/dbn_decoder.hpp"  // DbnDecoder
+#include "databento/dbn_decoder.hpp"  // DbnDecoder, DecodeConf
+#include "databento/dbn_index.hpp"    // DbnIndex
 #include "databento/enums.hpp"        // VersionUpgradePolicy
+#include "databento/file_stream.hpp"  // InMmapFileStream
 #include "databento/ireadable.hpp"
 #include "databento/log.hpp"
 #include "databento/record.hpp"
-#include "databento/timeseries.hpp"  // MetadataCallback, RecordCallback
+#include "databento/record_batch.hpp"    // RecordBatch
+#include "databento/record_ref.hpp"      // RecordRef
+#include "databento/record_visitor.hpp"  // is_record_visitor_v, VisitRecord
+#include "databento/timeseries.hpp"      // MetadataCallback, RecordCallback
 
 namespace databento {
 // A reader for DBN data from files or streams. This class provides both a callback API
@@ -20,22 +29,82 @@ class DbnStore {
   explicit DbnStore(const std::filesystem::path& file_path);
   DbnStore(ILogReceiver* log_receiver, const std::filesystem::path& file_path,
            VersionUpgradePolicy upgrade_policy);
+  DbnStore(ILogReceiver* log_receiver, const std::filesystem::path& file_path,
+           VersionUpgradePolicy upgrade_policy, DecodeConf decode_conf);
+  DbnStore(ILogReceiver* log_receiver, std::unique_ptr<IReadable> input,
+           VersionUpgradePolicy upgrade_policy);
   DbnStore(ILogReceiver* log_receiver, std::unique_ptr<IReadable> input,
+           VersionUpgradePolicy upgrade_policy, DecodeConf decode_conf);
+  // Reads from a memory-mapped file. Uncompressed DBN files are decoded in place
+  // without copying records. See `DbnDecoder`.
+  DbnStore(ILogReceiver* log_receiver, InMmapFileStream file_stream,
            VersionUpgradePolicy upgrade_policy);
+  DbnStore(ILogReceiver* log_receiver, InMmapFileStream file_stream,
+           VersionUpgradePolicy upgrade_policy, DecodeConf decode_conf);
 
   // Callback API: calling Replay consumes the input.
   void Replay(const MetadataCallback& metadata_callback,
               const RecordCallback& record_callback);
   void Replay(const RecordCallback& record_callback);
+  // Replays records to a visitor with an overload for each record struct of
+  // interest, without type erasure. See `VisitRecord`.
+  template <typename V, typename = std::enable_if_t<is_record_visitor_v<V>>>
+  void Replay(const MetadataCallback& metadata_callback, V&& visitor) {
+    auto metadata = decoder_.DecodeMetadata();
+    if (metadata_callback) {
+      metadata_callback(std::move(metadata));
+    }
+    while (true) {
+      const auto& batch = decoder_.DecodeBatch();
+      if (batch.Empty()) {
+        return;
+      }
+      for (const auto& record : batch) {
+        if (VisitRecord(record, visitor) == KeepGoing::Stop) {
+          return;
+        }
+      }
+    }
+  }
+  template <typename V, typename = std::enable_if_t<is_record_visitor_v<V>>>
+  void Replay(V&& visitor) {
+    Replay(MetadataCallback{}, std::forward<V>(visitor));
+  }
 
   // Blocking API
   const databento::Metadata& GetMetadata();
   // Returns the next record or `nullptr` if there are no remaining records.
   const Record* NextRecord();
+  // Returns the next record as a handle that keeps it valid after later calls, or
+  // an empty handle if there are no remaining records. See
+  // `DbnDecoder::DecodeRecordRef`.
+  RecordRef NextRecordRef();
+  // Returns every record currently buffered. The batch is valid until the next call
+  // to `NextBatch` or `NextRecord`, and is empty once there are no remaining
+  // records.
+  const RecordBatch& NextBatch();
+  // Positions the store so the next record is the first with an index timestamp at
+  // or after `ts`, using the `DbnIndex` in the file's sidecar file. The index is read
+  // on the first call. Seeking can move backwards as well as forwards. Only supported
+  // by stores constructed from a file path and not with `Replay`: throws
+  // `Exception` for stores reading from a buffer or other stream.
+  //
+  // Throws `InvalidArgumentError` if the index doesn't match the file. A stale index
+  // is only detected by the file's size, so rebuild the index whenever the file is
+  // rewritten.
+  void SeekTo(UnixNanos ts);
+  // Like `SeekTo(ts)`, but with an index from anywhere.
+  void SeekTo(const DbnIndex& index, UnixNanos ts);
+  // Counters for the background read-ahead thread. See `DecodeConf`.
+  databento::ReadAheadStats ReadAheadStats() const;
 
  private:
+  void CheckSeekable() const;
   void MaybeDecodeMetadata();
 
+  // Empty unless constructed from a file path
+  std::filesystem::path file_path_;
+  std::optional<DbnIndex> index_;
   DbnDecoder decoder_;
   databento::Metadata metadata_{};
   bool has_decoded_metadata_{false};
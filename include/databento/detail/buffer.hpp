@@ -4,7 +4,9 @@
 #include <memory>
 #include <new>
 #include <ostream>
+#include <utility>  // move
 
+#include "databento/detail/slab_pool.hpp"  // SlabPool, SlabRef
 #include "databento/ireadable.hpp"
 #include "databento/iwritable.hpp"
 
@@ -19,6 +21,16 @@ class Buffer : public IReadable, public IWritable {
         end_{buf_.get() + init_capacity},
         read_pos_{buf_.get()},
         write_pos_{buf_.get()} {}
+  // Backs the buffer with slabs from `slab_pool`. Holding a copy of `Slab()` keeps
+  // the data in the buffer valid after it's consumed, because the buffer moves to
+  // a new slab instead of overwriting a shared one.
+  explicit Buffer(std::shared_ptr<SlabPool> slab_pool)
+      : slab_pool_{std::move(slab_pool)},
+        slab_{slab_pool_->Acquire(slab_pool_->SlabSize())},
+        buf_{slab_.Get()->Data(), NoDelete},
+        end_{buf_.get() + slab_.Get()->Size()},
+        read_pos_{buf_.get()},
+        write_pos_{buf_.get()} {}
 
   size_t Write(const char* data, std::size_t length);
   size_t Write(const std::byte* data, std::size_t length);
@@ -52,10 +64,7 @@ class Buffer : public IReadable, public IWritable {
   }
 
   std::size_t Capacity() const { return static_cast<std::size_t>(end_ - buf_.get()); }
-  void Clear() {
-    read_pos_ = buf_.get();
-    write_pos_ = buf_.get();
-  }
+  void Clear();
   void Reserve(std::size_t capacity);
   void Shift();
   // Shifts unread data to offset 0 if writable space is less than `needed`,
@@ -66,6 +75,9 @@ class Buffer : public IReadable, public IWritable {
     }
   }
 
+  // The slab backing the buffer, if constructed with a `SlabPool`.
+  const SlabRef& Slab() const { return slab_; }
+
   friend std::ostream& operator<<(std::ostream& stream, const Buffer& buffer);
 
  private:
@@ -80,7 +92,16 @@ class Buffer : public IReadable, public IWritable {
     return static_cast<std::byte*>(operator new[](capacity, kAlignment));
   }
   static void AlignedDelete(std::byte* p) { operator delete[](p, kAlignment); }
+  // Slab memory is owned by `slab_`
+  static void NoDelete(std::byte*) {}
+
+  // Whether a reference to the current slab is held outside the buffer
+  bool IsSlabShared() const { return slab_.UseCount() > 1; }
+  // Moves the unread data to the start of `slab`
+  void MoveToSlab(SlabRef slab);
 
+  std::shared_ptr<SlabPool> slab_pool_;
+  SlabRef slab_;
   UniqueBufPtr buf_;
   std::byte* end_;
   std::byte* read_pos_;
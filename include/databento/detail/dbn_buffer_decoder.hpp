@@ -5,7 +5,9 @@
 #include <memory>
 #include <ostream>
 
+#include "databento/dbn_decoder.hpp"  // DbnDecoder::UpgradeFn
 #include "databento/detail/buffer.hpp"
+#include "databento/detail/fixed_length_records.hpp"
 #include "databento/detail/zstd_stream.hpp"
 #include "databento/enums.hpp"
 #include "databento/record.hpp"
@@ -61,7 +63,9 @@ class DbnBufferDecoder {
   alignas(RecordHeader) std::array<std::byte, kMaxRecordLen> compat_buffer_{};
   std::uint8_t input_version_{};
   bool ts_out_{};
-  bool needs_upgrade_{true};
+  // See `DbnDecoder::SelectUpgrade`
+  DbnDecoder::UpgradeFn upgrade_record_{};
+  FixedLengthRecords fixed_records_{};
   DecoderState state_{DecoderState::Init};
 };
 }  // namespace databento::detail
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint8_t
+#include <optional>
+
+#include "databento/enums.hpp"  // Schema
+
+namespace databento::detail {
+// Tracks whether every record in DBN data has the same length, so the decoders
+// can locate records by stride without reading each header.
+class FixedLengthRecords {
+ public:
+  // Enables the fast path when `schema` has fixed-length records in
+  // `version`-formatted data and records are decoded without being upgraded.
+  void Init(std::uint8_t version, std::optional<Schema> schema, bool ts_out,
+            bool needs_upgrade);
+
+  // The length of every record, or 0 if the fast path is disabled.
+  std::size_t RecordLength() const { return record_len_; }
+  // Returns the number of complete records of `RecordLength()` bytes at the start
+  // of [`begin`, `end`). If the record after them has a different length, the
+  // fast path is disabled for the rest of the input, so callers should read
+  // `RecordLength()` beforehand.
+  std::size_t Count(const std::byte* begin, const std::byte* end);
+
+ private:
+  std::size_t record_len_{};
+};
+}  // namespace databento::detail
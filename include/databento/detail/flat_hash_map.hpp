@@ -0,0 +1,191 @@
+#pragma once
+
+#include <cstddef>      // size_t
+#include <cstdint>      // uint64_t
+#include <type_traits>  // is_integral_v
+#include <utility>      // exchange, move, pair
+#include <vector>
+
+namespace databento::detail {
+// An open-addressing hash map from integer keys, such as order and instrument IDs,
+// to values stored inline in a single array. Collisions are resolved by linear
+// probing and erasing shifts later entries back instead of leaving tombstones, so
+// lookups never slow down as entries come and go. Inserting may move every value,
+// so pointers to values are only valid until the next insertion.
+template <typename K, typename V>
+class FlatHashMap {
+  static_assert(std::is_integral_v<K>, "keys must be integers");
+
+ public:
+  FlatHashMap() = default;
+  explicit FlatHashMap(std::size_t capacity) { Reserve(capacity); }
+  FlatHashMap(const FlatHashMap&) = default;
+  FlatHashMap& operator=(const FlatHashMap&) = default;
+  // Leaves `other` empty
+  FlatHashMap(FlatHashMap&& other) noexcept
+      : slots_{std::move(other.slots_)},
+        size_{std::exchange(other.size_, 0)},
+        mask_{std::exchange(other.mask_, 0)},
+        shift_{std::exchange(other.shift_, 64)} {
+    other.slots_.clear();
+  }
+  FlatHashMap& operator=(FlatHashMap&& rhs) noexcept {
+    if (this != &rhs) {
+      slots_ = std::move(rhs.slots_);
+      rhs.slots_.clear();
+      size_ = std::exchange(rhs.size_, 0);
+      mask_ = std::exchange(rhs.mask_, 0);
+      shift_ = std::exchange(rhs.shift_, 64);
+    }
+    return *this;
+  }
+  ~FlatHashMap() = default;
+
+  bool IsEmpty() const { return size_ == 0; }
+  std::size_t Size() const { return size_; }
+  // Ensures `count` entries can be stored without rehashing.
+  void Reserve(std::size_t count) {
+    std::size_t slot_count = kMinSlotCount;
+    while (slot_count * kMaxLoadNum < count * kMaxLoadDenom) {
+      slot_count *= 2;
+    }
+    if (slot_count > slots_.size()) {
+      Rehash(slot_count);
+    }
+  }
+  // Removes all entries, keeping the allocated slots.
+  void Clear() {
+    for (auto& slot : slots_) {
+      slot = Slot{};
+    }
+    size_ = 0;
+  }
+
+  V* Find(K key) {
+    if (size_ == 0) {
+      return nullptr;
+    }
+    for (std::size_t idx = Home(key);; idx = (idx + 1) & mask_) {
+      auto& slot = slots_[idx];
+      if (!slot.is_occupied) {
+        return nullptr;
+      }
+      if (slot.key == key) {
+        return &slot.value;
+      }
+    }
+  }
+  const V* Find(K key) const { return const_cast<FlatHashMap*>(this)->Find(key); }
+  // Returns the value for `key`, inserting `value` if there's none, and whether it
+  // was inserted.
+  std::pair<V*, bool> Insert(K key, V value) {
+    if ((size_ + 1) * kMaxLoadDenom > slots_.size() * kMaxLoadNum) {
+      Rehash(slots_.empty() ? kMinSlotCount : slots_.size() * 2);
+    }
+    for (std::size_t idx = Home(key);; idx = (idx + 1) & mask_) {
+      auto& slot = slots_[idx];
+      if (!slot.is_occupied) {
+        slot.key = key;
+        slot.is_occupied = true;
+        slot.value = std::move(value);
+        ++size_;
+        return {&slot.value, true};
+      }
+      if (slot.key == key) {
+        return {&slot.value, false};
+      }
+    }
+  }
+  // Returns whether there was an entry for `key`.
+  bool Erase(K key) {
+    if (size_ == 0) {
+      return false;
+    }
+    std::size_t idx = Home(key);
+    while (true) {
+      if (!slots_[idx].is_occupied) {
+        return false;
+      }
+      if (slots_[idx].key == key) {
+        break;
+      }
+      idx = (idx + 1) & mask_;
+    }
+    // Shift back later entries of the probe sequence that would otherwise become
+    // unreachable
+    std::size_t hole = idx;
+    for (std::size_t next = (idx + 1) & mask_; slots_[next].is_occupied;
+         next = (next + 1) & mask_) {
+      const auto home = Home(slots_[next].key);
+      // Whether `home` lies cyclically in (hole, next], in which case the entry
+      // can't move to the hole
+      const bool is_reachable = hole <= next ? (hole < home && home <= next)
+                                             : (hole < home || home <= next);
+      if (!is_reachable) {
+        slots_[hole] = std::move(slots_[next]);
+        hole = next;
+      }
+    }
+    slots_[hole] = Slot{};
+    --size_;
+    return true;
+  }
+  // Calls `func` with the key and value of every entry in an unspecified order.
+  template <typename F>
+  void ForEach(F&& func) const {
+    for (const auto& slot : slots_) {
+      if (slot.is_occupied) {
+        func(slot.key, slot.value);
+      }
+    }
+  }
+  template <typename F>
+  void ForEach(F&& func) {
+    for (auto& slot : slots_) {
+      if (slot.is_occupied) {
+        func(slot.key, slot.value);
+      }
+    }
+  }
+
+ private:
+  struct Slot {
+    K key{};
+    bool is_occupied{};
+    V value{};
+  };
+
+  static constexpr std::size_t kMinSlotCount = 16;
+  // A maximum load factor of 1/2 keeps probe sequences short
+  static constexpr std::size_t kMaxLoadNum = 1;
+  static constexpr std::size_t kMaxLoadDenom = 2;
+
+  std::size_t Home(K key) const {
+    // Fibonacci hashing spreads sequential IDs across the table, taking the high
+    // bits of the product, which depend on every bit of the key
+    return static_cast<std::size_t>(
+        (static_cast<std::uint64_t>(key) * 0x9E3779B97F4A7C15ULL) >> shift_);
+  }
+
+  void Rehash(std::size_t slot_count) {
+    std::vector<Slot> old_slots(slot_count);
+    old_slots.swap(slots_);
+    mask_ = slot_count - 1;
+    shift_ = 64;
+    for (std::size_t count = slot_count; count > 1; count /= 2) {
+      --shift_;
+    }
+    size_ = 0;
+    for (auto& slot : old_slots) {
+      if (slot.is_occupied) {
+        Insert(slot.key, std::move(slot.value));
+      }
+    }
+  }
+
+  std::vector<Slot> slots_;
+  std::size_t size_{};
+  std::size_t mask_{};
+  unsigned shift_{64};
+};
+}  // namespace databento::detail
@@ -7,6 +7,7 @@
 #include <string>
 #include <string_view>
 
+#include "databento/datetime.hpp"  // UnixNanos
 #include "databento/detail/tcp_client.hpp"
 #include "databento/detail/zstd_stream.hpp"
 #include "databento/enums.hpp"
@@ -27,6 +28,9 @@ class LiveConnection : IWritable {
                  std::uint16_t port);
   LiveConnection(ILogReceiver* log_receiver, const std::string& gateway,
                  std::uint16_t port, TcpClient::RetryConf retry_conf);
+  LiveConnection(ILogReceiver* log_receiver, const std::string& gateway,
+                 std::uint16_t port, TcpClient::RetryConf retry_conf,
+                 TcpClient::SocketConf socket_conf);
 
   void WriteAll(std::string_view str);
   void WriteAll(const std::byte* buffer, std::size_t size);
@@ -36,8 +40,17 @@ class LiveConnection : IWritable {
                              std::chrono::milliseconds timeout);
   // Closes the socket.
   void Close();
-  // Sets compression for subsequent reads.
-  void SetCompression(Compression compression);
+  Socket Fd() const { return client_.Fd(); }
+  // Whether received data is ready to be read without polling `Fd()`.
+  bool HasBufferedData() const { return client_.HasBufferedData(); }
+  // When the last data read from the socket was received. With compression, this
+  // can be later than the data returned by `ReadSome`.
+  UnixNanos LastRxTs() const { return client_.LastRxTs(); }
+  // Sets compression for subsequent reads. With `is_timed`, measures the time spent
+  // decompressing.
+  void SetCompression(Compression compression, bool is_timed);
+  // Returns the time spent decompressing since the last call.
+  std::chrono::nanoseconds TakeDecompressTime();
 
  private:
   TcpClient client_;
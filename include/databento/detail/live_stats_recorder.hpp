@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "databento/datetime.hpp"    // UnixNanos
+#include "databento/live_stats.hpp"  // LiveHistogram, LiveStats
+
+// Forward declare
+namespace databento {
+class Record;
+}
+
+namespace databento::detail {
+// Collects `LiveStats` for a live client. Only the thread reading from the gateway
+// records values, so counters are updated with plain relaxed loads and stores
+// instead of read-modify-write operations. `Snapshot()` can be called from any
+// thread without locking, though counters updated while it runs may be
+// inconsistent with each other.
+class LiveStatsRecorder {
+ public:
+  void RecordRead(std::size_t size);
+  // `rx_ts` is when the record was received, or `UnixNanos{}` if unknown.
+  void RecordRecord(const Record& record, bool has_ts_out, UnixNanos rx_ts);
+  void RecordCallback(std::chrono::nanoseconds duration);
+  void AddDecompressTime(std::chrono::nanoseconds duration);
+  LiveStats Snapshot() const;
+
+ private:
+  class AtomicHistogram {
+   public:
+    void Record(std::uint64_t value);
+    void CopyTo(LiveHistogram& histogram) const;
+
+   private:
+    std::array<std::atomic<std::uint64_t>, LiveHistogram::kBucketCount> counts_{};
+    std::atomic<std::uint64_t> count_{};
+    std::atomic<std::uint64_t> sum_{};
+    std::atomic<std::uint64_t> max_{};
+  };
+
+  std::atomic<std::uint64_t> reads_{};
+  std::atomic<std::uint64_t> bytes_read_{};
+  std::atomic<std::uint64_t> records_{};
+  std::array<std::atomic<std::uint64_t>, 256> records_by_rtype_{};
+  std::array<std::atomic<std::uint64_t>, 256> bytes_by_rtype_{};
+  std::atomic<std::int64_t> decompress_time_{};
+  AtomicHistogram read_sizes_;
+  AtomicHistogram callback_times_;
+  AtomicHistogram gateway_latencies_;
+  AtomicHistogram transit_latencies_;
+};
+}  // namespace databento::detail
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>    // size_t
+#include <cstdint>    // uint64_t
+#include <exception>  // exception_ptr
+#include <memory>     // unique_ptr
+#include <mutex>
+#include <vector>
+
+#include "databento/detail/buffer.hpp"
+#include "databento/detail/scoped_thread.hpp"
+#include "databento/ireadable.hpp"
+
+namespace databento::detail {
+// Reads `input` ahead of the consumer on a background thread into a ring of
+// `depth` buffers, so reading and decompressing overlaps with decoding.
+class ReadAheadStream : public IReadable {
+ public:
+  ReadAheadStream(std::unique_ptr<IReadable> input, std::size_t depth,
+                  std::size_t buffer_size);
+  ReadAheadStream(const ReadAheadStream&) = delete;
+  ReadAheadStream& operator=(const ReadAheadStream&) = delete;
+  ReadAheadStream(ReadAheadStream&&) = delete;
+  ReadAheadStream& operator=(ReadAheadStream&&) = delete;
+  ~ReadAheadStream() override;
+
+  // Read exactly `length` bytes into `buffer`.
+  void ReadExact(std::byte* buffer, std::size_t length) override;
+  // Read at most `max_length` bytes. Returns the number of bytes read. Will only
+  // return 0 if the end of the stream is reached.
+  std::size_t ReadSome(std::byte* buffer, std::size_t max_length) override;
+  // Read at most `max_length` bytes, waiting at most `timeout` for the background
+  // thread to fill a buffer.
+  IReadable::Result ReadSome(std::byte* buffer, std::size_t max_length,
+                             std::chrono::milliseconds timeout) override;
+
+  // The number of times the background thread waited for the consumer to free a
+  // buffer, i.e. decoding was the bottleneck.
+  std::uint64_t ProducerStalls() const {
+    return producer_stalls_.load(std::memory_order_relaxed);
+  }
+  // The number of times the consumer waited for the background thread to fill a
+  // buffer, i.e. reading was the bottleneck.
+  std::uint64_t ConsumerStalls() const {
+    return consumer_stalls_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  void ProducerThread();
+
+  std::unique_ptr<IReadable> input_;
+  std::vector<Buffer> ring_;
+  // Only accessed from the consumer
+  std::size_t read_idx_{};
+  // Only accessed from the producer
+  std::size_t write_idx_{};
+  std::mutex mutex_;
+  std::condition_variable not_full_cv_;
+  std::condition_variable not_empty_cv_;
+  // Guarded by `mutex_`
+  std::size_t filled_count_{};
+  bool is_input_done_{};
+  bool is_stopping_{};
+  std::exception_ptr exception_;
+  std::atomic<std::uint64_t> producer_stalls_{};
+  std::atomic<std::uint64_t> consumer_stalls_{};
+  ScopedThread producer_;
+};
+}  // namespace databento::detail
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>  // byte, size_t
+#include <cstdint>  // uint32_t
+#include <memory>   // enable_shared_from_this, shared_ptr, unique_ptr
+#include <mutex>
+#include <vector>
+
+namespace databento::detail {
+class SlabPool;
+class SlabRef;
+
+// A reference-counted block of memory handed out by a `SlabPool`.
+class Slab {
+ public:
+  std::byte* Data() const { return data_.get(); }
+  std::size_t Size() const { return size_; }
+
+ private:
+  friend SlabPool;
+  friend SlabRef;
+
+  explicit Slab(std::size_t size)
+      : data_{std::make_unique<std::byte[]>(size)}, size_{size} {}
+
+  std::atomic<std::uint32_t> ref_count_{};
+  // Only set while the slab is checked out so the pool outlives it
+  std::shared_ptr<SlabPool> pool_;
+  std::unique_ptr<std::byte[]> data_;
+  const std::size_t size_;
+};
+
+// A counted reference to a `Slab`. Copying the reference increments the count,
+// and the slab is returned to its pool when the last reference is released.
+// Different references to the same slab may be copied and released on different
+// threads.
+class SlabRef {
+ public:
+  SlabRef() noexcept = default;
+  SlabRef(const SlabRef& other) noexcept;
+  SlabRef& operator=(const SlabRef& rhs) noexcept;
+  SlabRef(SlabRef&& other) noexcept : slab_{other.slab_} { other.slab_ = nullptr; }
+  SlabRef& operator=(SlabRef&& rhs) noexcept;
+  ~SlabRef() { Release(); }
+
+  Slab* Get() const { return slab_; }
+  explicit operator bool() const { return slab_ != nullptr; }
+  // The number of references to the slab. Only a count of one is stable, and only
+  // when no other references can be created concurrently.
+  std::uint32_t UseCount() const;
+
+ private:
+  friend SlabPool;
+
+  // Takes ownership of one reference to `slab`
+  explicit SlabRef(Slab* slab) noexcept : slab_{slab} {}
+  void Release() noexcept;
+
+  Slab* slab_{};
+};
+
+// A thread-safe pool of fixed-size slabs, which are reused once all references to
+// them have been released. Must be owned by a `std::shared_ptr`.
+class SlabPool : public std::enable_shared_from_this<SlabPool> {
+ public:
+  explicit SlabPool(std::size_t slab_size);
+  SlabPool(const SlabPool&) = delete;
+  SlabPool& operator=(const SlabPool&) = delete;
+  SlabPool(SlabPool&&) = delete;
+  SlabPool& operator=(SlabPool&&) = delete;
+  ~SlabPool();
+
+  std::size_t SlabSize() const { return slab_size_; }
+  // The number of slabs waiting to be reused.
+  std::size_t FreeCount() const;
+  // Returns a slab of `SlabSize()` bytes, or a slab of exactly `min_size` bytes if
+  // `min_size` is greater. Larger slabs aren't reused.
+  SlabRef Acquire(std::size_t min_size);
+
+ private:
+  friend SlabRef;
+
+  void Return(Slab* slab);
+
+  const std::size_t slab_size_;
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<Slab>> free_slabs_;
+};
+}  // namespace databento::detail
@@ -3,9 +3,11 @@
 #include <chrono>  // milliseconds
 #include <cstddef>
 #include <cstdint>
+#include <memory>  // unique_ptr
 #include <string>
 #include <string_view>
 
+#include "databento/datetime.hpp"          // UnixNanos
 #include "databento/detail/scoped_fd.hpp"  // ScopedFd
 #include "databento/ireadable.hpp"
 
@@ -15,6 +17,8 @@ class ILogReceiver;
 }
 
 namespace databento::detail {
+class UringSocketReader;
+
 class TcpClient {
  public:
   struct RetryConf {
@@ -22,10 +26,33 @@ class TcpClient {
     std::chrono::seconds max_wait{std::chrono::minutes{1}};
     std::chrono::seconds connect_timeout{std::chrono::seconds{10}};
   };
+  // Receive tuning applied after connecting.
+  struct SocketConf {
+    // Whether reads with a timeout spin on a non-blocking `recv` instead of
+    // waiting in `poll`.
+    bool spin{false};
+    // Sets `SO_BUSY_POLL` when nonzero. Only supported on Linux.
+    std::chrono::microseconds busy_poll{};
+    // Sets `SO_RCVLOWAT` when nonzero.
+    int rcv_lowat{};
+    // Whether to read through `io_uring` when built with
+    // `DATABENTO_ENABLE_IO_URING`. Ignored when spinning.
+    bool io_uring{false};
+    // Enables `SO_TIMESTAMPING` receive timestamps, reported by `LastRxTs()`. Reads
+    // with `recvmsg`, so disables `io_uring`. Only supported on Linux.
+    bool rx_timestamps{false};
+  };
 
   TcpClient(ILogReceiver* log_receiver, const std::string& gateway, std::uint16_t port);
   TcpClient(ILogReceiver* log_receiver, const std::string& gateway, std::uint16_t port,
             RetryConf retry_conf);
+  TcpClient(ILogReceiver* log_receiver, const std::string& gateway, std::uint16_t port,
+            RetryConf retry_conf, SocketConf socket_conf);
+  TcpClient(const TcpClient&) = delete;
+  TcpClient& operator=(const TcpClient&) = delete;
+  TcpClient(TcpClient&&) noexcept;
+  TcpClient& operator=(TcpClient&&) noexcept;
+  ~TcpClient();
 
   void WriteAll(std::string_view str);
   void WriteAll(const std::byte* buffer, std::size_t size);
@@ -37,11 +64,31 @@ class TcpClient {
                              std::chrono::milliseconds timeout);
   // Closes the socket.
   void Close();
+  // The descriptor to poll for readability. When reading through `io_uring`, this
+  // is the ring's descriptor rather than the socket's.
+  Socket Fd() const;
+  // Whether data has already been received that can be read without waiting. Only
+  // possible when reading through `io_uring`.
+  bool HasBufferedData() const;
+  // When the kernel received the data returned by the last successful `ReadSome`,
+  // preferring the network device's timestamp when it generates them. Returns
+  // `UnixNanos{}` if receive timestamps aren't enabled or available.
+  UnixNanos LastRxTs() const { return last_rx_ts_; }
 
  private:
   static ScopedFd InitSocket(ILogReceiver* log_receiver, const std::string& gateway,
                              std::uint16_t port, RetryConf retry_conf);
+  void ApplySocketConf(ILogReceiver* log_receiver, SocketConf socket_conf);
+  IReadable::Result SpinReadSome(std::byte* buffer, std::size_t max_size,
+                                 std::chrono::milliseconds timeout);
+
+  void InitUringReader(ILogReceiver* log_receiver);
 
   ScopedFd socket_;
+  bool spin_{false};
+  bool rx_timestamps_{false};
+  UnixNanos last_rx_ts_{};
+  // Only set when built with `DATABENTO_ENABLE_IO_URING` and supported by the kernel
+  std::unique_ptr<UringSocketReader> uring_reader_;
 };
 }  // namespace databento::detail
@@ -3,11 +3,16 @@
 #include <zstd.h>
 
 #include <chrono>
+#include <condition_variable>
 #include <cstddef>  // size_t
-#include <memory>   // unique_ptr
+#include <deque>
+#include <exception>  // exception_ptr
+#include <memory>     // unique_ptr
+#include <mutex>
 #include <vector>
 
 #include "databento/detail/buffer.hpp"
+#include "databento/detail/scoped_thread.hpp"
 #include "databento/ireadable.hpp"
 #include "databento/iwritable.hpp"
 #include "databento/log.hpp"
@@ -28,13 +33,91 @@ class ZstdDecodeStream : public IReadable {
                              std::chrono::milliseconds timeout) override;
 
   IReadable* Input() const { return input_.get(); }
+  // Starts measuring the time spent decompressing.
+  void EnableTiming() { is_timed_ = true; }
+  // Returns the time spent decompressing since the last call. Only measured after
+  // `EnableTiming()`.
+  std::chrono::nanoseconds TakeDecompressTime();
 
  private:
+  // Decompresses from `z_in_buffer_` into `z_out_buffer`.
+  void Decompress(ZSTD_outBuffer* z_out_buffer);
+
   std::unique_ptr<IReadable> input_;
   std::unique_ptr<ZSTD_DStream, std::size_t (*)(ZSTD_DStream*)> z_dstream_;
   std::size_t read_suggestion_;
   std::vector<std::byte> in_buffer_;
   ZSTD_inBuffer z_in_buffer_;
+  bool is_output_pending_{};
+  bool is_timed_{};
+  std::chrono::nanoseconds decompress_time_{};
+};
+
+// Decompresses input made up of multiple independent Zstd frames on a pool of
+// worker threads, returning the decompressed data in the original order. Frame
+// boundaries are found by scanning the compressed input. If a single frame grows
+// larger than `max_frame_size`, the rest of the input is decompressed serially.
+class ParallelZstdDecodeStream : public IReadable {
+ public:
+  static constexpr std::size_t kDefaultMaxFrameSize = 64 * std::size_t{1 << 20};
+
+  ParallelZstdDecodeStream(std::unique_ptr<IReadable> input, std::size_t thread_count);
+  ParallelZstdDecodeStream(std::unique_ptr<IReadable> input, std::size_t thread_count,
+                           std::size_t max_frame_size);
+  ParallelZstdDecodeStream(std::unique_ptr<IReadable> input, detail::Buffer& in_buffer,
+                           std::size_t thread_count);
+  ParallelZstdDecodeStream(std::unique_ptr<IReadable> input, detail::Buffer& in_buffer,
+                           std::size_t thread_count, std::size_t max_frame_size);
+  ParallelZstdDecodeStream(const ParallelZstdDecodeStream&) = delete;
+  ParallelZstdDecodeStream& operator=(const ParallelZstdDecodeStream&) = delete;
+  ParallelZstdDecodeStream(ParallelZstdDecodeStream&&) = delete;
+  ParallelZstdDecodeStream& operator=(ParallelZstdDecodeStream&&) = delete;
+  ~ParallelZstdDecodeStream() override;
+
+  // Read exactly `length` bytes into `buffer`.
+  void ReadExact(std::byte* buffer, std::size_t length) override;
+  // Read at most `max_length` bytes. Returns the number of bytes read. Will only
+  // return 0 if the end of the stream is reached.
+  std::size_t ReadSome(std::byte* buffer, std::size_t max_length) override;
+  // timeout is ignored
+  IReadable::Result ReadSome(std::byte* buffer, std::size_t max_length,
+                             std::chrono::milliseconds timeout) override;
+
+ private:
+  struct Frame {
+    std::vector<std::byte> compressed;
+    detail::Buffer decompressed{0};
+    bool is_done{};
+    std::exception_ptr exception;
+  };
+
+  static void DecompressFrame(ZSTD_DCtx* dctx, Frame* frame);
+
+  void WorkerThread();
+  // Scans the input for the next complete frame and queues it for decompression.
+  // Returns false if no frame could be queued.
+  bool QueueFrame();
+  void Submit(const std::byte* data, std::size_t size);
+
+  std::unique_ptr<IReadable> input_;
+  const std::size_t max_in_flight_;
+  const std::size_t max_frame_size_;
+  // Compressed input not yet queued as a frame
+  std::vector<std::byte> scan_buffer_;
+  std::size_t scan_pos_{};
+  bool is_input_done_{};
+  // Set once a frame exceeds `max_frame_size_`
+  bool needs_serial_{};
+  std::unique_ptr<ZstdDecodeStream> serial_stream_;
+  // In input order. Only accessed from the reading thread
+  std::deque<std::unique_ptr<Frame>> frames_;
+  std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::condition_variable done_cv_;
+  // Frames waiting for a worker
+  std::deque<Frame*> work_queue_;
+  bool is_stopping_{};
+  std::vector<ScopedThread> workers_;
 };
 
 class ZstdCompressStream : public IWritable {
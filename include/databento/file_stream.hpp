@@ -1,12 +1,19 @@
 #pragma once
 
 #include <cstddef>     // byte, size_t
+#include <cstdint>     // uint64_t
 #include <filesystem>  // path
 #include <fstream>     // ifstream, ofstream
+#include <memory>      // unique_ptr
 
 #include "databento/ireadable.hpp"
 #include "databento/iwritable.hpp"
 
+// Forward declare
+namespace databento::detail {
+class UringFileReader;
+}
+
 namespace databento {
 class InFileStream : public IReadable {
  public:
@@ -20,11 +27,82 @@ class InFileStream : public IReadable {
   // timeout is ignored
   Result ReadSome(std::byte* buffer, std::size_t max_length,
                   std::chrono::milliseconds timeout) override;
+  // Moves the read position to `offset` bytes from the start of the file.
+  void Seek(std::uint64_t offset);
 
  private:
   std::ifstream stream_;
 };
 
+// A read-only memory mapping of a file. Reads copy out of the
+// mapping like `InFileStream`, but when passed to `DbnDecoder` or `DbnStore`,
+// uncompressed records can be decoded in place without any copying.
+class InMmapFileStream : public IReadable {
+ public:
+  explicit InMmapFileStream(const std::filesystem::path& file_path);
+  InMmapFileStream(const InMmapFileStream&) = delete;
+  InMmapFileStream& operator=(const InMmapFileStream&) = delete;
+  InMmapFileStream(InMmapFileStream&& other) noexcept;
+  InMmapFileStream& operator=(InMmapFileStream&& rhs) noexcept;
+  ~InMmapFileStream() override;
+
+  // Read exactly `length` bytes into `buffer`.
+  void ReadExact(std::byte* buffer, std::size_t length) override;
+  // Read at most `length` bytes. Returns the number of bytes read. Will only
+  // return 0 if the end of the stream is reached.
+  std::size_t ReadSome(std::byte* buffer, std::size_t max_length) override;
+  // timeout is ignored
+  Result ReadSome(std::byte* buffer, std::size_t max_length,
+                  std::chrono::milliseconds timeout) override;
+
+  // Direct access to the unread portion of the mapping, which can't be written to.
+  const std::byte* ReadBegin() const { return read_pos_; }
+  const std::byte* ReadEnd() const { return end_; }
+  // Marks `length` bytes as read. Pages that have been read past are
+  // periodically returned to the OS.
+  void Consume(std::size_t length);
+  std::size_t ReadCapacity() const {
+    return static_cast<std::size_t>(end_ - read_pos_);
+  }
+
+ private:
+  void ReleaseConsumed();
+  void Unmap();
+
+  std::byte* data_{};
+  std::byte* end_{};
+  std::byte* read_pos_{};
+  std::byte* released_pos_{};
+#ifdef _WIN32
+  void* mapping_handle_{};
+#endif
+};
+
+// Reads a file with `io_uring`, keeping several reads into registered buffers in
+// flight ahead of the reader. Only available on Linux when built with
+// `DATABENTO_ENABLE_IO_URING`; otherwise construction throws.
+class InUringFileStream : public IReadable {
+ public:
+  explicit InUringFileStream(const std::filesystem::path& file_path);
+  InUringFileStream(const InUringFileStream&) = delete;
+  InUringFileStream& operator=(const InUringFileStream&) = delete;
+  InUringFileStream(InUringFileStream&&) noexcept;
+  InUringFileStream& operator=(InUringFileStream&&) noexcept;
+  ~InUringFileStream() override;
+
+  // Read exactly `length` bytes into `buffer`.
+  void ReadExact(std::byte* buffer, std::size_t length) override;
+  // Read at most `length` bytes. Returns the number of bytes read. Will only
+  // return 0 if the end of the stream is reached.
+  std::size_t ReadSome(std::byte* buffer, std::size_t max_length) override;
+  // timeout is ignored
+  Result ReadSome(std::byte* buffer, std::size_t max_length,
+                  std::chrono::milliseconds timeout) override;
+
+ private:
+  std::unique_ptr<detail::UringFileReader> reader_;
+};
+
 class OutFileStream : public IWritable {
  public:
   explicit OutFileStream(const std::filesystem::path& file_path);
@@ -14,7 +14,8 @@
 #include "databento/detail/http_client.hpp"  // HttpClient
 #include "databento/enums.hpp"  // BatchState, Delivery, DurationInterval, Schema, SType, VersionUpgradePolicy
 #include "databento/metadata.hpp"  // DatasetConditionDetail, DatasetRange, FieldDetail, PublisherDetail, UnitPricesForMode
-#include "databento/symbology.hpp"   // SymbologyResolution
+#include "databento/symbology.hpp"       // SymbologyResolution
+#include "databento/symbology_cache.hpp"  // SymbologyCache, SymbologyFile
 #include "databento/timeseries.hpp"  // KeepGoing, MetadataCallback, RecordCallback
 
 namespace databento {
@@ -157,6 +158,13 @@ class Historical {
                                        const std::vector<std::string>& symbols,
                                        SType stype_in, SType stype_out,
                                        const DateRange& date_range);
+  // Resolves `symbols` through `cache`, only requesting the dates its file for
+  // them doesn't cover yet. `date_range.end` is required.
+  SymbologyFile SymbologyResolve(const std::string& dataset,
+                                 const std::vector<std::string>& symbols,
+                                 SType stype_in, SType stype_out,
+                                 const DateRange& date_range,
+                                 const SymbologyCache& cache);
 
   /*
    * Timeseries API
@@ -165,7 +173,8 @@ class Historical {
   // Stream historical market data to `record_callback`. `metadata_callback`
   // will be called exactly once, before any calls to `record_callback`.
   // This method will return only after all data has been returned or
-  // `record_callback` returns `KeepGoing::Stop`.
+  // `record_callback` returns `KeepGoing::Stop`. To handle each record struct in a
+  // separate overload, call `VisitRecord` from `record_callback`.
   //
   // NOTE: This method spawns a thread, however, the callbacks will be called
   // from the current thread.
@@ -66,6 +66,12 @@ class LiveBuilder {
   // Sets the timeouts for connecting and authenticating with the gateway.
   // Defaults to 10 seconds for connect and 30 seconds for auth.
   LiveBuilder& SetTimeoutConf(TimeoutConf timeout_conf);
+  // Opts into receiving records with lower latency at the cost of CPU usage. See
+  // `LowLatencyConf`.
+  LiveBuilder& SetLowLatencyConf(LowLatencyConf low_latency_conf);
+  // Sets whether to count bytes, records, and latencies, which can be read with
+  // `Stats()` from any thread. Defaults to false.
+  LiveBuilder& SetCollectStats(bool collect_stats);
 
   /*
    * Build a live client instance
@@ -95,5 +101,7 @@ class LiveBuilder {
   Compression compression_{Compression::None};
   std::optional<SlowReaderBehavior> slow_reader_behavior_{};
   TimeoutConf timeout_conf_{};
+  LowLatencyConf low_latency_conf_{};
+  bool collect_stats_{false};
 };
 }  // namespace databento
@@ -4,18 +4,25 @@
 #include <chrono>  // milliseconds, steady_clock
 #include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <memory>  // shared_ptr, unique_ptr
 #include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
 
-#include "databento/datetime.hpp"  // UnixNanos
-#include "databento/dbn.hpp"       // Metadata
+#include "databento/datetime.hpp"     // UnixNanos
+#include "databento/dbn.hpp"          // Metadata
+#include "databento/dbn_decoder.hpp"  // DbnDecoder::UpgradeFn
 #include "databento/detail/buffer.hpp"
-#include "databento/detail/live_connection.hpp"  // LiveConnection
+#include "databento/detail/live_connection.hpp"      // LiveConnection
+#include "databento/detail/live_stats_recorder.hpp"  // LiveStatsRecorder
+#include "databento/detail/slab_pool.hpp"            // SlabPool, SlabRef
 #include "databento/enums.hpp"  // Schema, SType, VersionUpgradePolicy, Compression
+#include "databento/live_stats.hpp"  // LiveStats
 #include "databento/live_subscription.hpp"
-#include "databento/record.hpp"  // Record, RecordHeader
+#include "databento/record.hpp"      // Record, RecordHeader
+#include "databento/record_ref.hpp"  // RecordRef
 
 namespace databento {
 // Forward declaration
@@ -28,6 +35,33 @@ struct TimeoutConf {
   std::chrono::seconds auth{30};
 };
 
+// Opt-in settings that trade CPU usage for lower latency receiving records.
+struct LowLatencyConf {
+  // Whether to spin on a non-blocking read of the socket instead of waiting for
+  // data in `poll`. The receiving thread occupies a full core.
+  bool spin{false};
+  // When nonzero, sets `SO_BUSY_POLL` so the kernel busy polls the network device
+  // for up to this long on reads. Only supported on Linux, where values above
+  // `net.core.busy_read` require `CAP_NET_ADMIN`.
+  std::chrono::microseconds busy_poll{};
+  // When nonzero, sets `SO_RCVLOWAT`, the minimum number of bytes to buffer before
+  // the socket is reported readable.
+  int rcv_lowat{};
+  // Whether to receive through `io_uring` when built with
+  // `DATABENTO_ENABLE_IO_URING`, so records that have already arrived are read
+  // without any system calls. Ignored when spinning.
+  bool io_uring{false};
+  // Whether to enable kernel receive timestamps with `SO_TIMESTAMPING` so
+  // `LiveBlocking::LastRecordRxTs()` reports when each record reached the host.
+  // Timestamps from the network device are used when it has been configured to
+  // generate them. Disables `io_uring`. Only supported on Linux.
+  bool rx_timestamps{false};
+  // The CPU to pin the `LiveThreaded` processing thread to. Only supported on
+  // Linux.
+  std::optional<std::uint32_t> cpu_affinity{};
+};
+
+class LiveMultiplexer;
 class LiveThreaded;
 
 // A client for interfacing with Databento's real-time and intraday replay
@@ -56,9 +90,18 @@ class LiveBlocking {
     return slow_reader_behavior_;
   }
   const databento::TimeoutConf& TimeoutConf() const { return timeout_conf_; }
+  const databento::LowLatencyConf& LowLatencyConf() const { return low_latency_conf_; }
   std::uint64_t SessionId() const { return session_id_; }
   const std::vector<LiveSubscription>& Subscriptions() const { return subscriptions_; }
   std::vector<LiveSubscription>& Subscriptions() { return subscriptions_; }
+  // When the socket received the data that completed the last record returned by
+  // `NextRecord`, `TryNextRecord`, or `NextRecordRef`. Subtract the record's
+  // `ts_out` or `ts_recv` for the latency from the gateway or venue. Returns
+  // `UnixNanos{}` unless `LowLatencyConf::rx_timestamps` is enabled and supported.
+  UnixNanos LastRecordRxTs() const { return last_record_rx_ts_; }
+  // Returns a snapshot of the client's counters. Can be called from any thread.
+  // Returns zeroed counters unless enabled with `LiveBuilder::SetCollectStats`.
+  LiveStats Stats() const;
 
   /*
    * Methods
@@ -97,6 +140,18 @@ class LiveBlocking {
   //
   // This method should only be called after `Start`.
   const Record* TryNextRecord();
+  // Block on getting the next record. Unlike `NextRecord`, the record isn't
+  // overwritten by later calls and remains valid for as long as the returned handle
+  // or a copy of it exists, which can be passed to another thread. The record isn't
+  // copied unless it was upgraded from an older DBN version.
+  //
+  // This method should only be called after `Start`.
+  RecordRef NextRecordRef();
+  // Block on getting the next record. Returns an empty handle if the `timeout` is
+  // reached. See `NextRecordRef()`.
+  //
+  // This method should only be called after `Start`.
+  RecordRef NextRecordRef(std::chrono::milliseconds timeout);
   // Reads available data from the connection into the internal buffer using
   // the heartbeat timeout. Returns the number of bytes read and the status.
   // A `read_size` of 0 with `Status::Closed` indicates the connection was
@@ -121,15 +176,23 @@ class LiveBlocking {
 
  private:
   friend LiveBuilder;
+  friend LiveMultiplexer;
   friend LiveThreaded;
 
+  struct RxRead {
+    // The stream offset after the read, counted in the same way as `rx_consumed_`
+    std::uint64_t end;
+    UnixNanos rx_ts;
+  };
+
   LiveBlocking(ILogReceiver* log_receiver, std::string key, std::string dataset,
                bool send_ts_out, VersionUpgradePolicy upgrade_policy,
                std::optional<std::chrono::seconds> heartbeat_interval,
                std::size_t buffer_size, std::string user_agent_ext,
                databento::Compression compression,
                std::optional<databento::SlowReaderBehavior> slow_reader_behavior,
-               databento::TimeoutConf timeout_conf);
+               databento::TimeoutConf timeout_conf,
+               databento::LowLatencyConf low_latency_conf, bool collect_stats);
   LiveBlocking(ILogReceiver* log_receiver, std::string key, std::string dataset,
                std::string gateway, std::uint16_t port, bool send_ts_out,
                VersionUpgradePolicy upgrade_policy,
@@ -137,7 +200,8 @@ class LiveBlocking {
                std::size_t buffer_size, std::string user_agent_ext,
                databento::Compression compression,
                std::optional<databento::SlowReaderBehavior> slow_reader_behavior,
-               databento::TimeoutConf timeout_conf);
+               databento::TimeoutConf timeout_conf,
+               databento::LowLatencyConf low_latency_conf, bool collect_stats);
 
   std::string DetermineGateway() const;
   std::uint64_t Authenticate();
@@ -149,6 +213,8 @@ class LiveBlocking {
   void Subscribe(std::string_view sub_msg, const std::vector<std::string>& symbols,
                  bool use_snapshot);
   const Record* ConsumeBufferedRecord();
+  void TrackRxTs(std::size_t record_size);
+  RecordRef PinRecord(const Record& record);
   RecordHeader* BufferRecordHeader();
   std::chrono::milliseconds HeartbeatTimeout() const;
   void CheckHeartbeatTimeout() const;
@@ -167,18 +233,32 @@ class LiveBlocking {
   const bool send_ts_out_;
   std::uint8_t version_{};
   const VersionUpgradePolicy upgrade_policy_;
+  // See `DbnDecoder::SelectUpgrade`
+  DbnDecoder::UpgradeFn upgrade_record_{};
   const std::optional<std::chrono::seconds> heartbeat_interval_;
   const databento::Compression compression_;
   const std::optional<databento::SlowReaderBehavior> slow_reader_behavior_;
   const databento::TimeoutConf timeout_conf_;
+  const databento::LowLatencyConf low_latency_conf_;
   detail::LiveConnection connection_;
   std::uint32_t sub_counter_{};
   std::vector<LiveSubscription> subscriptions_;
+  // Shared with any outstanding `RecordRef`s
+  std::shared_ptr<detail::SlabPool> slab_pool_;
   detail::Buffer buffer_;
   // Must be 8-byte aligned for records
   alignas(RecordHeader) std::array<std::byte, kMaxRecordLen> compat_buffer_{};
+  // Where upgraded records are copied for `NextRecordRef`
+  detail::RecordSlabCopier compat_copier_;
   std::uint64_t session_id_;
   Record current_record_{nullptr};
+  // Reads with data that hasn't been fully consumed. Only tracked with
+  // `LowLatencyConf::rx_timestamps`
+  std::deque<RxRead> rx_reads_;
+  std::uint64_t rx_consumed_{};
+  UnixNanos last_record_rx_ts_{};
+  // Only set when collecting stats
+  std::unique_ptr<detail::LiveStatsRecorder> stats_;
   std::chrono::steady_clock::time_point last_read_time_{
       std::chrono::steady_clock::now()};
 };
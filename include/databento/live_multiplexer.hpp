@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <chrono>  // milliseconds, steady_clock
+#include <cstddef>
+#include <cstdint>
+#include <memory>  // unique_ptr
+#include <optional>
+#include <vector>
+
+#include "databento/datetime.hpp"       // UnixNanos
+#include "databento/dbn.hpp"            // Metadata
+#include "databento/live_blocking.hpp"  // LiveBlocking
+#include "databento/record.hpp"         // kMaxRecordLen, Record, RecordHeader
+#include "databento/timeseries.hpp"     // KeepGoing, RecordCallback
+
+namespace databento {
+// The timestamp `LiveMultiplexer` orders records from different sessions by.
+enum class MergeOrder : std::uint8_t {
+  // Pass on records in the order they're received.
+  Arrival,
+  // Order by each record's index timestamp, usually `ts_recv`.
+  IndexTs,
+  // Order by the gateway send timestamp. Every session must have `send_ts_out`
+  // enabled.
+  TsOut,
+};
+
+// How `LiveMultiplexer` merges records from its sessions.
+struct MergeConf {
+  MergeOrder order{MergeOrder::Arrival};
+  // How long a record may be held back waiting for earlier records from other
+  // sessions. A record is released once a record at least this much later has been
+  // received from any session, or once it's been held this long.
+  std::chrono::milliseconds reorder_window{10};
+  // The maximum number of records to hold back before releasing the earliest
+  // regardless of `reorder_window`.
+  std::size_t max_held{std::size_t{1} << 16};
+};
+
+// A client that receives records from several live sessions, such as one per
+// dataset, on a single thread. Records from all sessions are merged into one
+// stream, optionally ordered by timestamp within a bounded reorder window.
+//
+// Sessions should be subscribed before being passed to the constructor.
+// Reconnecting individual sessions isn't supported.
+class LiveMultiplexer {
+ public:
+  explicit LiveMultiplexer(std::vector<LiveBlocking> sessions);
+  LiveMultiplexer(std::vector<LiveBlocking> sessions,
+                  databento::MergeConf merge_conf);
+
+  /*
+   * Getters
+   */
+
+  const std::vector<LiveBlocking>& Sessions() const { return sessions_; }
+  const databento::MergeConf& MergeConf() const { return merge_conf_; }
+
+  /*
+   * Methods
+   */
+
+  // Notifies the gateways to start sending messages for all subscriptions. Returns
+  // the metadata of each session in the same order as `Sessions()`.
+  //
+  // This method should only be called once per instance.
+  std::vector<Metadata> Start();
+  // Block on getting the next record from any session. The returned reference is
+  // valid until this method is called again.
+  //
+  // This method should only be called after `Start`.
+  const Record& NextRecord();
+  // Block on getting the next record from any session. The returned pointer is
+  // valid until this method is called again. Will return `nullptr` if the
+  // `timeout` is reached.
+  //
+  // This method should only be called after `Start`.
+  const Record* NextRecord(std::chrono::milliseconds timeout);
+  // Calls `record_callback` with the records from all sessions on the calling
+  // thread until it returns `KeepGoing::Stop`, then stops all sessions.
+  //
+  // This method should only be called after `Start`.
+  void Run(const RecordCallback& record_callback);
+  // Stops all sessions. Once stopped, the sessions cannot be restarted.
+  void Stop();
+
+ private:
+  struct alignas(RecordHeader) Slot {
+    std::array<std::byte, kMaxRecordLen> data;
+  };
+  struct HeldRecord {
+    UnixNanos ts;
+    // Breaks ties in arrival order
+    std::uint64_t sequence;
+    std::chrono::steady_clock::time_point held_since;
+    std::size_t slot;
+  };
+
+  const Record* NextBufferedRecord();
+  void Hold(const Record& record);
+  UnixNanos OrderTs(const Record& record) const;
+  const Record* PopReleasable(std::chrono::steady_clock::time_point now);
+  void PollAndFill(std::chrono::milliseconds timeout);
+  void Fill(std::size_t session_idx);
+  void CheckHeartbeatTimeouts() const;
+
+  std::vector<LiveBlocking> sessions_;
+  const databento::MergeConf merge_conf_;
+  // Sessions whose decompressor may have output left over from filling the whole
+  // buffer, which polling the socket wouldn't detect
+  std::vector<bool> pending_;
+  // The session to check first for a buffered record, for fairness
+  std::size_t next_session_{};
+  // Min-heap of held records by `ts`
+  std::vector<HeldRecord> held_;
+  // Owned individually so held records don't move
+  std::vector<std::unique_ptr<Slot>> slots_;
+  std::vector<std::size_t> free_slots_;
+  // The slot of the record last returned, which is freed on the next call
+  std::optional<std::size_t> released_slot_;
+  std::uint64_t sequence_{};
+  UnixNanos max_ts_{};
+  Record current_record_{nullptr};
+};
+}  // namespace databento
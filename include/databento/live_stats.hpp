@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace databento {
+namespace detail {
+class LiveStatsRecorder;
+}  // namespace detail
+
+// A snapshot of a histogram with log-linear buckets in the style of HdrHistogram.
+// Values below 8 are counted exactly. Larger values share a bucket with values
+// within 12.5% of them.
+class LiveHistogram {
+ public:
+  // Each power of two is split into this many buckets
+  static constexpr std::size_t kSubBucketBits = 3;
+  static constexpr std::size_t kSubBucketCount = std::size_t{1} << kSubBucketBits;
+  static constexpr std::size_t kBucketCount = (65 - kSubBucketBits) * kSubBucketCount;
+
+  // Returns the index of the bucket counting `value`.
+  static std::size_t BucketOf(std::uint64_t value);
+  // Returns the smallest value counted in `bucket`.
+  static constexpr std::uint64_t BucketLowerBound(std::size_t bucket) {
+    if (bucket < kSubBucketCount) {
+      return bucket;
+    }
+    const auto shift = bucket / kSubBucketCount - 1;
+    return (kSubBucketCount + bucket % kSubBucketCount) << shift;
+  }
+
+  // The number of values recorded.
+  std::uint64_t Count() const { return count_; }
+  std::uint64_t Sum() const { return sum_; }
+  std::uint64_t Max() const { return max_; }
+  // Returns 0 if no values have been recorded.
+  double Mean() const;
+  // Returns the upper bound of the bucket containing the value at `percentile`,
+  // which must be between 0 and 100, limited by `Max()`. Returns 0 if no values
+  // have been recorded.
+  std::uint64_t ValueAtPercentile(double percentile) const;
+  // The count of each bucket.
+  const std::array<std::uint64_t, kBucketCount>& Counts() const { return counts_; }
+
+ private:
+  friend detail::LiveStatsRecorder;
+
+  std::array<std::uint64_t, kBucketCount> counts_{};
+  std::uint64_t count_{};
+  std::uint64_t sum_{};
+  std::uint64_t max_{};
+};
+
+// A snapshot of the counters of a live client enabled with
+// `LiveBuilder::SetCollectStats`. Counters accumulate across reconnects.
+struct LiveStats {
+  // The number of reads from the gateway connection that returned data.
+  std::uint64_t reads{};
+  // The number of bytes returned by reads, after any decompression.
+  std::uint64_t bytes_read{};
+  std::uint64_t records{};
+  // The number of records of each rtype, indexed by the rtype's value.
+  std::array<std::uint64_t, 256> records_by_rtype{};
+  // The number of bytes of records of each rtype, indexed by the rtype's value.
+  std::array<std::uint64_t, 256> bytes_by_rtype{};
+  // The time spent decompressing Zstd data with `Compression::Zstd`.
+  std::chrono::nanoseconds decompress_time{};
+  // The number of bytes returned by each read.
+  LiveHistogram read_sizes;
+  // The nanoseconds spent in each call of the `LiveThreaded` record callback. In
+  // queue and sharded modes, this is the time to hand off the record.
+  LiveHistogram callback_times;
+  // The nanoseconds between each record's `ts_recv` and `ts_out`: the time the
+  // gateway took to send it. Only recorded with `send_ts_out`. Records without a
+  // `ts_recv` use `ts_event`.
+  LiveHistogram gateway_latencies;
+  // The nanoseconds between each record's `ts_out` and when it was received: the
+  // time it took to reach the client. Only recorded with `send_ts_out`. Uses the
+  // kernel receive timestamp with `LowLatencyConf::rx_timestamps`, otherwise the
+  // time the record was decoded. Negative values from clock differences are
+  // recorded as 0.
+  LiveHistogram transit_latencies;
+};
+}  // namespace databento
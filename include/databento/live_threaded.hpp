@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>  // size_t
 #include <cstdint>
 #include <functional>  // function
 #include <memory>      // unique_ptr
@@ -12,15 +13,27 @@
 #include "databento/datetime.hpp"              // UnixNanos
 #include "databento/detail/scoped_thread.hpp"  // ScopedThread
 #include "databento/enums.hpp"                 // Schema, SType
-#include "databento/live_blocking.hpp"         // TimeoutConf
+#include "databento/live_blocking.hpp"         // LowLatencyConf, TimeoutConf
+#include "databento/live_stats.hpp"            // LiveStats
 #include "databento/live_subscription.hpp"
-#include "databento/timeseries.hpp"  // MetadataCallback, RecordCallback
+#include "databento/record_queue.hpp"    // RecordQueue
+#include "databento/timeseries.hpp"      // MetadataCallback, RecordCallback
 
 namespace databento {
 // Forward declaration
 class ILogReceiver;
 class LiveBuilder;
 
+// How `LiveThreaded` dispatches records to worker threads when started in sharded
+// mode.
+struct ShardConf {
+  // The number of worker threads calling the record callback.
+  std::size_t shard_count{1};
+  // The capacity of the queue between the network thread and each worker. The
+  // network thread waits when a worker's queue is full.
+  std::size_t queue_capacity{std::size_t{1} << 12};
+};
+
 // A client for interfacing with Databento's real-time and intraday replay
 // market data API. This client provides a threaded event-driven API for
 // receiving the next record. Unlike Historical, each instance of LiveThreaded
@@ -58,9 +71,13 @@ class LiveThreaded {
   databento::Compression Compression() const;
   std::optional<databento::SlowReaderBehavior> SlowReaderBehavior() const;
   const databento::TimeoutConf& TimeoutConf() const;
+  const databento::LowLatencyConf& LowLatencyConf() const;
   std::uint64_t SessionId() const;
   const std::vector<LiveSubscription>& Subscriptions() const;
   std::vector<LiveSubscription>& Subscriptions();
+  // Returns a snapshot of the client's counters. Can be called from any thread.
+  // Returns zeroed counters unless enabled with `LiveBuilder::SetCollectStats`.
+  LiveStats Stats() const;
 
   /*
    * Methods
@@ -80,13 +97,34 @@ class LiveThreaded {
   // Notifies the gateway to start sending messages for all subscriptions.
   // `metadata_callback` will be called exactly once, before any calls to
   // `record_callback`. `record_callback` will be called for records from all
-  // subscriptions.
+  // subscriptions. To handle each record struct in a separate overload, call
+  // `VisitRecord` from `record_callback`.
   //
   // This method should only be called once per instance.
   void Start(RecordCallback record_callback);
   void Start(MetadataCallback metadata_callback, RecordCallback record_callback);
   void Start(MetadataCallback metadata_callback, RecordCallback record_callback,
              ExceptionCallback exception_callback);
+  // Hands off records to `queue` instead of calling a callback on the network
+  // thread, so a slow consumer doesn't delay reading from the gateway. Records are
+  // popped from `queue` on a thread of the caller's choosing. `queue` is closed
+  // when the session stops and must outlive this instance.
+  void Start(RecordQueue* queue);
+  void Start(MetadataCallback metadata_callback, RecordQueue* queue);
+  void Start(MetadataCallback metadata_callback, RecordQueue* queue,
+             ExceptionCallback exception_callback);
+  // Calls `record_callback` concurrently on `shard_conf.shard_count` worker
+  // threads. The network thread routes records by `instrument_id`, so the records
+  // of each instrument are passed to the same worker in order. Symbol mapping,
+  // system, and error records are passed to every worker. `record_callback` must
+  // be safe to call from several threads at once. Returning `KeepGoing::Stop` from
+  // any worker stops the session. Exceptions thrown by `record_callback` are passed
+  // to `exception_callback`, which must also be thread safe: `Restart` skips the
+  // record and `Stop` stops the session. Throws `InvalidArgumentError` if sharded
+  // dispatch was already started.
+  void Start(RecordCallback record_callback, ShardConf shard_conf);
+  void Start(MetadataCallback metadata_callback, RecordCallback record_callback,
+             ExceptionCallback exception_callback, ShardConf shard_conf);
   // Closes the current connection, and attempts to reconnect to the gateway.
   void Reconnect();
   void Resubscribe();
@@ -103,6 +141,9 @@ class LiveThreaded {
   static void ProcessingThread(Impl* impl, MetadataCallback&& metadata_callback,
                                RecordCallback&& record_callback,
                                ExceptionCallback&& exception_callback);
+  static void ShardThread(Impl* impl, std::size_t shard_idx);
+  static KeepGoing CallRecordCallback(Impl* impl, const RecordCallback& record_callback,
+                                      const Record& record);
   static ExceptionAction ExceptionHandler(Impl* impl,
                                           const ExceptionCallback& exception_callback,
                                           const std::exception& exc,
@@ -115,7 +156,8 @@ class LiveThreaded {
                std::size_t buffer_size, std::string user_agent_ext,
                databento::Compression compression,
                std::optional<databento::SlowReaderBehavior> slow_reader_behavior,
-               databento::TimeoutConf timeout_conf);
+               databento::TimeoutConf timeout_conf,
+               databento::LowLatencyConf low_latency_conf, bool collect_stats);
   LiveThreaded(ILogReceiver* log_receiver, std::string key, std::string dataset,
                std::string gateway, std::uint16_t port, bool send_ts_out,
                VersionUpgradePolicy upgrade_policy,
@@ -123,7 +165,8 @@ class LiveThreaded {
                std::size_t buffer_size, std::string user_agent_ext,
                databento::Compression compression,
                std::optional<databento::SlowReaderBehavior> slow_reader_behavior,
-               databento::TimeoutConf timeout_conf);
+               databento::TimeoutConf timeout_conf,
+               databento::LowLatencyConf low_latency_conf, bool collect_stats);
 
   // unique_ptr to be movable
   std::unique_ptr<Impl> impl_;
@@ -89,6 +89,9 @@ class Record {
   }
 
   std::size_t Size() const;
+  // The primary timestamp of the record, used for sorting and indexing. Falls back
+  // to `ts_event` for unknown rtypes.
+  UnixNanos IndexTs() const;
   static std::size_t SizeOfSchema(Schema schema);
   static ::databento::RType RTypeFromSchema(Schema schema);
 
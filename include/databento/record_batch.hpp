@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>  // size_t
+#include <vector>
+
+#include "databento/record.hpp"
+
+namespace databento {
+// A contiguous run of decoded records. Records are views into the decoder's buffer
+// and are only valid until the next call to decode a record or batch.
+class RecordBatch {
+ public:
+  using const_iterator = std::vector<Record>::const_iterator;
+
+  const_iterator begin() const { return records_.cbegin(); }
+  const_iterator end() const { return records_.cend(); }
+  const Record& operator[](std::size_t idx) const { return records_[idx]; }
+  const Record* Data() const { return records_.data(); }
+  std::size_t Size() const { return records_.size(); }
+  bool Empty() const { return records_.empty(); }
+
+ private:
+  friend class DbnDecoder;
+
+  std::vector<Record> records_;
+};
+}  // namespace databento
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>  // size_t
+#include <cstdint>  // uint8_t, uint64_t
+#include <memory>   // unique_ptr
+#include <mutex>
+
+#include "databento/record.hpp"      // kMaxRecordLen, Record, RecordHeader
+#include "databento/timeseries.hpp"  // RecordCallback
+
+namespace databento {
+// Counters for a `RecordQueue`.
+struct RecordQueueStats {
+  // The number of records pushed to the queue, including those later dropped by
+  // `OverflowPolicy::DropOldest`.
+  std::uint64_t pushed;
+  // The number of records dropped because the queue was full.
+  std::uint64_t dropped;
+  // The number of times the producer waited for the consumer to free a slot with
+  // `OverflowPolicy::Block`.
+  std::uint64_t producer_stalls;
+  // The greatest number of records queued at once.
+  std::size_t high_water_mark;
+};
+
+// A bounded lock-free queue of records for handing off records from one producer
+// thread to one consumer thread, such as from the `LiveThreaded` network thread to
+// a thread of the user's choosing. Each record is copied into a fixed slot of
+// `kMaxRecordLen` bytes, so pushing never allocates.
+class RecordQueue {
+ public:
+  // What `Push` does when the queue is full.
+  enum class OverflowPolicy : std::uint8_t {
+    // Wait for the consumer to pop a record.
+    Block,
+    // Drop the oldest queued record to make room.
+    DropOldest,
+    // Drop the record being pushed.
+    DropNewest,
+  };
+
+  // `capacity` is rounded up to the next power of two, with a minimum of two.
+  RecordQueue(std::size_t capacity, OverflowPolicy overflow_policy);
+  RecordQueue(const RecordQueue&) = delete;
+  RecordQueue& operator=(const RecordQueue&) = delete;
+  RecordQueue(RecordQueue&&) = delete;
+  RecordQueue& operator=(RecordQueue&&) = delete;
+  ~RecordQueue();
+
+  /*
+   * Producer methods
+   */
+
+  // Copies `record` into the queue. Returns false if the record was dropped or the
+  // queue has been closed.
+  bool Push(const Record& record);
+  // Marks the end of the records. Wakes a producer blocked in `Push` and a
+  // consumer blocked in `WaitForRecord`.
+  void Close();
+
+  /*
+   * Consumer methods
+   */
+
+  // Returns the next record or nullptr if the queue is empty. The record is copied
+  // out of the queue and is valid until the next call to `TryPop`.
+  const Record* TryPop();
+  // Calls `callback` with up to `max_count` queued records in place, without
+  // copying them, stopping early if `callback` returns `KeepGoing::Stop`. Returns
+  // the number of records popped. If `callback` throws, the record it was called
+  // with is still popped.
+  std::size_t PopBatch(const RecordCallback& callback, std::size_t max_count);
+  // Blocks until a record is queued or the queue is closed. Returns false if the
+  // queue is closed and empty.
+  bool WaitForRecord();
+  // Whether `Close` has been called. Records pushed before then may still be
+  // queued.
+  bool IsClosed() const { return is_closed_.load(std::memory_order_acquire); }
+
+  std::size_t Capacity() const { return capacity_; }
+  // The approximate number of queued records.
+  std::size_t Size() const;
+  bool Empty() const { return Size() == 0; }
+  OverflowPolicy GetOverflowPolicy() const { return overflow_policy_; }
+  RecordQueueStats Stats() const;
+
+ private:
+  static constexpr std::size_t kCacheLineSize = 64;
+
+  struct Slot {
+    // Equal to the position of the next push into the slot when it's free, and one
+    // greater than the position of its record when it's full
+    std::atomic<std::uint64_t> sequence;
+    alignas(RecordHeader) std::array<std::byte, kMaxRecordLen> data;
+  };
+
+  // Claims the oldest record. The producer also claims records to drop them with
+  // `OverflowPolicy::DropOldest`, so claiming is the only operation synchronized
+  // between more than one thread.
+  Slot* Claim(std::uint64_t& pos);
+  // Returns a claimed slot to the producer.
+  void Release(Slot* slot, std::uint64_t pos);
+  // Wakes the consumer if it's blocked in `WaitForRecord`.
+  void NotifyConsumer();
+  // Drops the record at `pos` to make room for a push `capacity_` positions later.
+  // Returns false if the consumer has already claimed it.
+  bool TryDropOldest(std::uint64_t pos);
+
+  const std::size_t capacity_;
+  const OverflowPolicy overflow_policy_;
+  std::unique_ptr<Slot[]> slots_;
+  // The position of the next record to claim
+  alignas(kCacheLineSize) std::atomic<std::uint64_t> head_{};
+  // The position of the next push. Only written by the producer
+  alignas(kCacheLineSize) std::atomic<std::uint64_t> tail_{};
+  std::atomic<std::uint64_t> pushed_{};
+  std::atomic<std::uint64_t> dropped_{};
+  std::atomic<std::uint64_t> producer_stalls_{};
+  std::atomic<std::size_t> high_water_mark_{};
+  std::atomic<bool> is_closed_{};
+  // Only locked by the producer when the consumer is waiting
+  std::mutex wait_mutex_;
+  std::condition_variable wait_cv_;
+  std::atomic<bool> is_consumer_waiting_{};
+  // Only accessed from the consumer
+  alignas(kCacheLineSize) std::array<std::byte, kMaxRecordLen> current_{};
+  Record current_record_{nullptr};
+};
+}  // namespace databento
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <algorithm>  // copy
+#include <cstddef>    // byte, size_t
+#include <utility>    // move
+
+#include "databento/detail/slab_pool.hpp"  // SlabPool, SlabRef
+#include "databento/record.hpp"            // Record, RecordHeader
+
+namespace databento {
+// An owning handle to a record in a reference-counted slab of a client's receive
+// buffer, returned by `LiveBlocking::NextRecordRef` and `DbnStore::NextRecordRef`. Unlike the `Record` returned
+// by `NextRecord`, the record remains valid for as long as any copy of its handle
+// exists, so it can be handed off to another thread without copying the record.
+// Handles may be copied and destroyed on any thread.
+//
+// Each handle keeps its whole slab from being reused, so holding handles for long
+// periods increases memory usage.
+class RecordRef {
+ public:
+  RecordRef() = default;
+  RecordRef(detail::SlabRef slab, RecordHeader* header)
+      : slab_{std::move(slab)}, record_{header} {}
+
+  // Whether the handle refers to a record.
+  explicit operator bool() const { return static_cast<bool>(slab_); }
+  const Record& Get() const { return record_; }
+  const Record& operator*() const { return record_; }
+  const Record* operator->() const { return &record_; }
+
+ private:
+  detail::SlabRef slab_;
+  Record record_{nullptr};
+};
+
+namespace detail {
+// Copies records that can't be pinned where they were decoded, such as upgraded
+// records, packing several into each slab.
+class RecordSlabCopier {
+ public:
+  RecordRef Copy(SlabPool& slab_pool, const Record& record) {
+    const auto size = record.Size();
+    if (!slab_ || pos_ + size > slab_.Get()->Size()) {
+      slab_ = slab_pool.Acquire(slab_pool.SlabSize());
+      pos_ = 0;
+    }
+    const auto* record_begin = reinterpret_cast<const std::byte*>(&record.Header());
+    auto* dest = slab_.Get()->Data() + pos_;
+    std::copy(record_begin, record_begin + size, dest);
+    // Keep the next record aligned
+    constexpr auto kAlignMask = alignof(RecordHeader) - 1;
+    pos_ += (size + kAlignMask) & ~kAlignMask;
+    return RecordRef{slab_, reinterpret_cast<RecordHeader*>(dest)};
+  }
+
+ private:
+  SlabRef slab_;
+  std::size_t pos_{};
+};
+}  // namespace detail
+}  // namespace databento
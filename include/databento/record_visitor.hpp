@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>  // size_t
+#include <type_traits>
+
+#include "databento/enums.hpp"       // RType
+#include "databento/record.hpp"      // Record, RecordHeader
+#include "databento/timeseries.hpp"  // KeepGoing, RecordCallback
+#include "databento/v1.hpp"
+#include "databento/v2.hpp"
+
+namespace databento {
+namespace detail {
+template <typename T, typename V>
+KeepGoing VisitAs(const Record& record, V& visitor) {
+  if constexpr (std::is_invocable_v<V&, const T&>) {
+    const auto& rec = *reinterpret_cast<const T*>(&record.Header());
+    if constexpr (std::is_void_v<std::invoke_result_t<V&, const T&>>) {
+      visitor(rec);
+      return KeepGoing::Continue;
+    } else {
+      return visitor(rec);
+    }
+  } else {
+    return KeepGoing::Continue;
+  }
+}
+
+template <typename V, typename... Ts>
+using IsInvocableWithAny = std::disjunction<std::is_invocable<V&, const Ts&>...>;
+}  // namespace detail
+
+// Type trait for callables that should be dispatched with `VisitRecord` rather than
+// type-erased as a `RecordCallback`: those that can be called with at least one
+// concrete record struct. This includes visitors with a generic fallback overload
+// and generic lambdas, which can also be converted to a `RecordCallback`.
+template <typename V>
+struct is_record_visitor
+    : detail::IsInvocableWithAny<
+          std::remove_reference_t<V>, MboMsg, TradeMsg, Mbp1Msg, Mbp10Msg, OhlcvMsg,
+          StatusMsg, InstrumentDefMsg, v2::InstrumentDefMsg, v1::InstrumentDefMsg,
+          ImbalanceMsg, ErrorMsg, v1::ErrorMsg, SymbolMappingMsg,
+          v1::SymbolMappingMsg, SystemMsg, v1::SystemMsg, StatMsg, v1::StatMsg,
+          Cmbp1Msg, CbboMsg, BboMsg> {};
+template <typename V>
+constexpr bool is_record_visitor_v = is_record_visitor<V>::value;
+
+// Calls the overload of `visitor` matching the concrete type of `record`, e.g.
+// `visitor(const MboMsg&)`. The struct version of records that changed between DBN
+// versions is selected based on the record's length, so a visitor can accept
+// `v1::InstrumentDefMsg`, `v2::InstrumentDefMsg`, and `InstrumentDefMsg`. Records
+// without a matching overload are skipped. Overloads may return `void` or
+// `KeepGoing`; `void` is treated as `KeepGoing::Continue`.
+//
+// Dispatch is a single switch on the rtype and doesn't repeat the check performed
+// by `Record::Get`.
+template <typename V>
+KeepGoing VisitRecord(const Record& record, V&& visitor) {
+  const std::size_t size = record.Header().length * RecordHeader::kLengthMultiplier;
+  switch (record.RType()) {
+    case RType::Mbp0: {
+      return detail::VisitAs<TradeMsg>(record, visitor);
+    }
+    case RType::Mbp1: {
+      return detail::VisitAs<Mbp1Msg>(record, visitor);
+    }
+    case RType::Mbp10: {
+      return detail::VisitAs<Mbp10Msg>(record, visitor);
+    }
+    case RType::OhlcvDeprecated:
+    case RType::Ohlcv1S:
+    case RType::Ohlcv1M:
+    case RType::Ohlcv1H:
+    case RType::Ohlcv1D:
+    case RType::OhlcvEod: {
+      return detail::VisitAs<OhlcvMsg>(record, visitor);
+    }
+    case RType::Status: {
+      return detail::VisitAs<StatusMsg>(record, visitor);
+    }
+    case RType::InstrumentDef: {
+      if (size >= sizeof(InstrumentDefMsg)) {
+        return detail::VisitAs<InstrumentDefMsg>(record, visitor);
+      }
+      if (size >= sizeof(v2::InstrumentDefMsg)) {
+        return detail::VisitAs<v2::InstrumentDefMsg>(record, visitor);
+      }
+      return detail::VisitAs<v1::InstrumentDefMsg>(record, visitor);
+    }
+    case RType::Imbalance: {
+      return detail::VisitAs<ImbalanceMsg>(record, visitor);
+    }
+    case RType::Error: {
+      if (size >= sizeof(ErrorMsg)) {
+        return detail::VisitAs<ErrorMsg>(record, visitor);
+      }
+      return detail::VisitAs<v1::ErrorMsg>(record, visitor);
+    }
+    case RType::SymbolMapping: {
+      if (size >= sizeof(SymbolMappingMsg)) {
+        return detail::VisitAs<SymbolMappingMsg>(record, visitor);
+      }
+      return detail::VisitAs<v1::SymbolMappingMsg>(record, visitor);
+    }
+    case RType::System: {
+      if (size >= sizeof(SystemMsg)) {
+        return detail::VisitAs<SystemMsg>(record, visitor);
+      }
+      return detail::VisitAs<v1::SystemMsg>(record, visitor);
+    }
+    case RType::Statistics: {
+      if (size >= sizeof(StatMsg)) {
+        return detail::VisitAs<StatMsg>(record, visitor);
+      }
+      return detail::VisitAs<v1::StatMsg>(record, visitor);
+    }
+    case RType::Mbo: {
+      return detail::VisitAs<MboMsg>(record, visitor);
+    }
+    case RType::Cmbp1:
+    case RType::Tcbbo: {
+      return detail::VisitAs<Cmbp1Msg>(record, visitor);
+    }
+    case RType::Cbbo1S:
+    case RType::Cbbo1M: {
+      return detail::VisitAs<CbboMsg>(record, visitor);
+    }
+    case RType::Bbo1S:
+    case RType::Bbo1M: {
+      return detail::VisitAs<BboMsg>(record, visitor);
+    }
+    default: {
+      return KeepGoing::Continue;
+    }
+  }
+}
+}  // namespace databento
@@ -1,14 +1,20 @@
 #pragma once
 #include <date/date.h>
 
+#include <algorithm>  // upper_bound
+#include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "databento/compat.hpp"
+#include "databento/detail/flat_hash_map.hpp"  // FlatHashMap
 #include "databento/record.hpp"
 
 namespace databento {
@@ -61,6 +67,110 @@ class TsSymbolMap {
   Store map_;
 };
 
+// A timeseries symbol map storing a sorted list of date intervals per instrument
+// instead of an entry per day, with each distinct symbol stored once. Memory is
+// proportional to the number of intervals and a lookup is a hash probe followed by
+// a binary search of the instrument's intervals, usually only one.
+//
+// Like `TsSymbolMap`, dates already mapped for an instrument keep their first
+// symbol when an overlapping interval is inserted.
+class FlatTsSymbolMap {
+ public:
+  FlatTsSymbolMap() = default;
+  explicit FlatTsSymbolMap(const Metadata& metadata);
+  FlatTsSymbolMap(const FlatTsSymbolMap& other);
+  FlatTsSymbolMap& operator=(const FlatTsSymbolMap& other);
+  FlatTsSymbolMap(FlatTsSymbolMap&&) = default;
+  FlatTsSymbolMap& operator=(FlatTsSymbolMap&&) = default;
+  ~FlatTsSymbolMap() = default;
+
+  bool IsEmpty() const { return blocks_.IsEmpty(); }
+  std::size_t InstrumentCount() const { return blocks_.Size(); }
+  // The number of date intervals across all instruments. Adjacent intervals with
+  // the same symbol are merged.
+  std::size_t IntervalCount() const {
+    return intervals_.size() - unused_interval_count_;
+  }
+  // The number of distinct symbols.
+  std::size_t SymbolCount() const { return symbols_.size(); }
+  // Returns the symbol of `instrument_id` on `date` or `nullptr` if there's none.
+  const std::string* Find(date::year_month_day date,
+                          std::uint32_t instrument_id) const {
+    return FindDay(date::sys_days{date}.time_since_epoch().count(), instrument_id);
+  }
+  // Returns the symbol of the instrument of `rec` on the UTC date of its index
+  // timestamp or `nullptr` if there's none.
+  template <typename R>
+  const std::string* Find(const R& rec) const {
+    static_assert(has_header<R>::value,
+                  "must be a DBN record struct with an `hd` RecordHeader field");
+    return FindDay(date::floor<date::days>(rec.IndexTs()).time_since_epoch().count(),
+                   rec.hd.instrument_id);
+  }
+  // Like `Find`, but throws `std::out_of_range` if there's no symbol.
+  const std::string& At(date::year_month_day date, std::uint32_t instrument_id) const {
+    return Checked(Find(date, instrument_id));
+  }
+  template <typename R>
+  const std::string& At(const R& rec) const {
+    return Checked(Find(rec));
+  }
+  // Maps `instrument_id` to `symbol` from `start_date` up to but excluding
+  // `end_date`. Throws `InvalidArgumentError` if `end_date` is before `start_date`.
+  void Insert(std::uint32_t instrument_id, date::year_month_day start_date,
+              date::year_month_day end_date, std::string_view symbol);
+
+ private:
+  // Days since the UNIX epoch
+  using Day = date::days::rep;
+
+  struct Interval {
+    Day start;
+    Day end;
+    std::uint32_t symbol_idx;
+  };
+  // An instrument's intervals in `intervals_`, sorted and non-overlapping
+  struct Block {
+    std::uint32_t offset;
+    std::uint32_t count;
+  };
+
+  static const std::string& Checked(const std::string* symbol);
+
+  const std::string* FindDay(Day day, std::uint32_t instrument_id) const {
+    const auto* block = blocks_.Find(instrument_id);
+    if (block == nullptr) {
+      return nullptr;
+    }
+    const auto* begin = intervals_.data() + block->offset;
+    const auto* end = begin + block->count;
+    // One past the last interval starting on or before `day`
+    const auto* it = std::upper_bound(
+        begin, end, day,
+        [](Day lhs, const Interval& interval) { return lhs < interval.start; });
+    if (it == begin || day >= (it - 1)->end) {
+      return nullptr;
+    }
+    return &symbols_[(it - 1)->symbol_idx];
+  }
+  std::uint32_t Intern(std::string_view symbol);
+  // Moves the intervals of `block` to the end of `intervals_` so it can grow.
+  void MoveToEnd(Block& block);
+  // Inserts `interval` at `idx` of `block`, merging it with its neighbors if they
+  // have the same symbol. Returns the index of the interval containing it.
+  std::size_t InsertAt(Block& block, std::size_t idx, const Interval& interval);
+  // Removes the gaps left by moved blocks.
+  void Compact();
+
+  std::vector<Interval> intervals_;
+  detail::FlatHashMap<std::uint32_t, Block> blocks_;
+  // Intervals in `intervals_` no longer part of a block
+  std::size_t unused_interval_count_{};
+  // A deque so the views in `symbol_idxs_` remain valid as symbols are added
+  std::deque<std::string> symbols_;
+  std::unordered_map<std::string_view, std::uint32_t> symbol_idxs_;
+};
+
 // A point-in-time symbol map. Useful for working with live
 // symbology or a historical request over a single day or other
 // situations where the symbol mappings are known not to change.
@@ -102,6 +212,76 @@ class PitSymbolMap {
   Store map_;
 };
 
+// A point-in-time symbol map with the same interface as `PitSymbolMap` where
+// symbols are returned as views. Instrument IDs are mapped in an open-addressing
+// hash table and symbols are copied into an arena of fixed-size blocks, so a
+// mapping doesn't allocate once there's room for it and the views remain valid for
+// the lifetime of the map, even after an instrument is remapped.
+class FlatPitSymbolMap {
+ public:
+  FlatPitSymbolMap() = default;
+  // Reserves room for `instrument_count` instruments.
+  explicit FlatPitSymbolMap(std::size_t instrument_count);
+  // Reserves room for the instruments in `metadata.mappings`.
+  FlatPitSymbolMap(const Metadata& metadata, date::year_month_day date);
+  FlatPitSymbolMap(const FlatPitSymbolMap& other);
+  FlatPitSymbolMap& operator=(const FlatPitSymbolMap& other);
+  // Leaves `other` empty, without a view into the moved arena.
+  FlatPitSymbolMap(FlatPitSymbolMap&& other) noexcept;
+  FlatPitSymbolMap& operator=(FlatPitSymbolMap&& rhs) noexcept;
+  ~FlatPitSymbolMap() = default;
+
+  bool IsEmpty() const { return map_.IsEmpty(); }
+  std::size_t Size() const { return map_.Size(); }
+  // Ensures `instrument_count` instruments can be mapped without rehashing.
+  void Reserve(std::size_t instrument_count) { map_.Reserve(instrument_count); }
+  // Returns the symbol of `instrument_id` or `nullptr` if there's none. The
+  // pointer is valid until the next instrument is mapped, the view it points to
+  // for the lifetime of the map.
+  const std::string_view* Find(std::uint32_t instrument_id) const {
+    return map_.Find(instrument_id);
+  }
+  const std::string_view* Find(const Record& rec) const {
+    return Find(rec.Header().instrument_id);
+  }
+  // Returns the symbol of the instrument of `rec`. Throws `std::out_of_range` if
+  // there's none.
+  template <typename R>
+  std::string_view At(const R& rec) const {
+    static_assert(has_header<R>::value,
+                  "must be a DBN record struct with an `hd` RecordHeader field");
+    return Checked(Find(rec.hd.instrument_id));
+  }
+  std::string_view At(const Record& rec) const { return Checked(Find(rec)); }
+  // Returns the symbol of `instrument_id` or an empty view if there's none.
+  std::string_view operator[](std::uint32_t instrument_id) const {
+    const auto* symbol = Find(instrument_id);
+    return symbol == nullptr ? std::string_view{} : *symbol;
+  }
+  // Maps `instrument_id` to `symbol`, replacing any existing mapping.
+  void Insert(std::uint32_t instrument_id, std::string_view symbol);
+  void OnRecord(const Record& rec);
+  template <typename SymbolMappingRec>
+  void OnSymbolMapping(const SymbolMappingRec& symbol_mapping) {
+    Insert(symbol_mapping.hd.instrument_id, symbol_mapping.STypeOutSymbol());
+  }
+
+ private:
+  // Fits several hundred symbols
+  static constexpr std::size_t kArenaBlockSize = 16 * 1024;
+
+  static std::string_view Checked(const std::string_view* symbol);
+
+  // Copies `symbol` into the arena.
+  std::string_view Store(std::string_view symbol);
+
+  detail::FlatHashMap<std::uint32_t, std::string_view> map_;
+  std::vector<std::unique_ptr<char[]>> arena_blocks_;
+  // The unused end of the last block
+  char* arena_pos_{};
+  std::size_t arena_remaining_{};
+};
+
 // Forward declare explicit instantiation
 extern template void PitSymbolMap::OnSymbolMapping(
     const SymbolMappingMsgV1& symbol_mapping);
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <date/date.h>
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint32_t
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "databento/enums.hpp"        // SType
+#include "databento/file_stream.hpp"  // InMmapFileStream
+#include "databento/symbol_map.hpp"   // FlatTsSymbolMap, PitSymbolMap, TsSymbolMap
+#include "databento/symbology.hpp"    // SymbologyResolution
+
+namespace databento {
+// A symbology resolution saved in a compact binary file that's memory-mapped when
+// read, so symbol maps can be created from it without a request or JSON parsing.
+// Written by `SymbologyCache`.
+class SymbologyFile {
+ public:
+  // Writes the resolution of the dates from `start_date` up to but excluding
+  // `end_date`, replacing any file at `path` atomically. `key` identifies the
+  // request it was resolved for.
+  static void Write(const std::filesystem::path& path, std::string_view key,
+                    const SymbologyResolution& resolution,
+                    date::year_month_day start_date, date::year_month_day end_date);
+
+  // Throws `DbnResponseError` if the file at `path` isn't a valid symbology file.
+  explicit SymbologyFile(const std::filesystem::path& path);
+
+  std::string_view Key() const { return String(header_.key); }
+  SType StypeIn() const { return header_.stype_in; }
+  SType StypeOut() const { return header_.stype_out; }
+  // The first date resolved.
+  date::year_month_day StartDate() const;
+  // The day after the last date resolved.
+  date::year_month_day EndDate() const;
+  // The number of `stype_in` symbols with mappings.
+  std::size_t MappingCount() const { return header_.mapping_count; }
+  std::size_t IntervalCount() const { return header_.interval_count; }
+
+  SymbologyResolution ToResolution() const;
+  // Equivalent to `ToResolution().CreateSymbolMap()` without creating the
+  // intermediate resolution.
+  TsSymbolMap CreateSymbolMap() const;
+  FlatTsSymbolMap CreateFlatSymbolMap() const;
+  // Throws `InvalidArgumentError` if `date` wasn't resolved.
+  PitSymbolMap CreateSymbolMapForDate(date::year_month_day date) const;
+
+ private:
+  // A string in the file's string table
+  struct StringRef {
+    std::uint32_t offset;
+    std::uint32_t size;
+  };
+  struct Header {
+    SType stype_in;
+    SType stype_out;
+    std::int32_t start_date;
+    std::int32_t end_date;
+    StringRef key;
+    std::uint32_t mapping_count;
+    std::uint32_t interval_count;
+    std::uint32_t partial_count;
+    std::uint32_t not_found_count;
+    std::uint32_t string_table_size;
+  };
+  struct Mapping {
+    StringRef symbol;
+    std::uint32_t first_interval;
+    std::uint32_t interval_count;
+  };
+  struct Interval {
+    std::int32_t start_date;
+    std::int32_t end_date;
+    StringRef symbol;
+  };
+
+  template <typename T>
+  const T& At(std::size_t offset, std::size_t idx) const {
+    return reinterpret_cast<const T*>(file_.ReadBegin() + offset)[idx];
+  }
+  const Mapping& MappingAt(std::size_t idx) const {
+    return At<Mapping>(mappings_offset_, idx);
+  }
+  const Interval& IntervalAt(std::size_t idx) const {
+    return At<Interval>(intervals_offset_, idx);
+  }
+  std::string_view String(StringRef ref) const {
+    const auto* strings =
+        reinterpret_cast<const char*>(file_.ReadBegin()) + strings_offset_;
+    return {strings + ref.offset, ref.size};
+  }
+  void Validate(const std::filesystem::path& path) const;
+  bool IsInverse(std::string_view method_name) const;
+
+  InMmapFileStream file_;
+  Header header_;
+  std::size_t mappings_offset_;
+  std::size_t intervals_offset_;
+  std::size_t partial_offset_;
+  std::size_t not_found_offset_;
+  std::size_t strings_offset_;
+};
+
+// A directory of `SymbologyFile`s, one per dataset, set of symbols, and pair of
+// symbology types, for reusing symbology resolutions across processes. Each file
+// covers a single date range, which is extended by resolving only the dates it
+// doesn't cover yet.
+class SymbologyCache {
+ public:
+  // Resolves the dates from `start_date` up to but excluding `end_date`, e.g. with
+  // `Historical::SymbologyResolve`.
+  using Resolver = std::function<SymbologyResolution(date::year_month_day start_date,
+                                                     date::year_month_day end_date)>;
+
+  // Creates `dir` if it doesn't exist.
+  explicit SymbologyCache(std::filesystem::path dir);
+
+  const std::filesystem::path& Dir() const { return dir_; }
+  // The path of the file for resolving `symbols` in `dataset`, which is the same
+  // for any order of `symbols`.
+  std::filesystem::path FilePath(const std::string& dataset,
+                                 const std::vector<std::string>& symbols,
+                                 SType stype_in, SType stype_out) const;
+  // Returns the cached resolution of `symbols` covering at least the dates from
+  // `start_date` up to but excluding `end_date`. Dates the file doesn't cover are
+  // resolved with `resolver`, with at most one call before and one after the
+  // cached dates, and saved to the file. Files that can't be read are replaced.
+  //
+  // The `partial` and `not_found` symbols of the returned resolution apply to all
+  // of its dates. Throws `InvalidArgumentError` if `end_date` isn't after
+  // `start_date`.
+  SymbologyFile Resolve(const std::string& dataset,
+                        const std::vector<std::string>& symbols, SType stype_in,
+                        SType stype_out, date::year_month_day start_date,
+                        date::year_month_day end_date, const Resolver& resolver) const;
+
+ private:
+  std::filesystem::path dir_;
+};
+}  // namespace databento
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "databento/datetime.hpp"    // UnixNanos
+#include "databento/dbn.hpp"         // Metadata
+#include "databento/enums.hpp"       // Schema, Side
+#include "databento/publishers.hpp"  // Publisher
+#include "databento/record.hpp"      // Record
+
+// Forward declare
+namespace databento {
+class IWritable;
+}  // namespace databento
+
+// Synthetic DBN data for benchmarking and load testing.
+namespace databento::synth {
+struct GeneratorConf {
+  // The number of instruments. Some instruments are much more active than others,
+  // like in real data.
+  std::size_t instrument_count{16};
+  // The instrument ID of the first instrument, with the rest numbered sequentially.
+  std::uint32_t first_instrument_id{1};
+  // The number of records per second across all instruments, which determines the
+  // spacing of `ts_recv`.
+  std::uint64_t message_rate{100'000};
+  // The `ts_recv` of the first record.
+  UnixNanos start{std::chrono::seconds{1'704'205'800}};  // 2024-01-02 14:30 UTC
+  // The publisher of all records. The dataset of the metadata is derived from it.
+  Publisher publisher{Publisher::GlbxMdp3Glbx};
+  // The maximum number of resting orders in each instrument's simulated book.
+  std::size_t max_orders{64};
+  // Generators with the same seed and configuration produce the same records on
+  // every platform.
+  std::uint64_t seed{};
+};
+
+// Generates valid DBN records from a simulated limit order book for each
+// instrument. Supports the MBO, MBP-10, trades, definition, and statistics
+// schemas.
+//
+// MBO records follow the rules for building a book: resting orders are added,
+// modified, and canceled, and a trade is followed by a fill and a modify or cancel
+// of the resting order, with `F_LAST` on the last record of each event. The book
+// is never crossed. MBP-10 records carry the top 10 levels of the same book after
+// each event, and trades are the trades of the book. `sequence` increases with each
+// event of an instrument, and `ts_recv` with each event.
+class Generator {
+ public:
+  // Throws `InvalidArgumentError` for unsupported schemas or an invalid `conf`.
+  Generator(Schema schema, const GeneratorConf& conf);
+
+  Schema GetSchema() const { return schema_; }
+  const GeneratorConf& Conf() const { return conf_; }
+  // The raw symbol of an instrument.
+  std::string Symbol(std::uint32_t instrument_id) const;
+  // Returns metadata for the next `record_count` records, with a symbol mapping
+  // for each instrument.
+  Metadata GenerateMetadata(std::size_t record_count) const;
+
+  // Returns the next record. The reference is valid until the next call.
+  const Record& NextRecord();
+  // The number of records returned or written so far.
+  std::uint64_t RecordCount() const { return record_count_; }
+  // Writes the next `record_count` records to `output`.
+  void WriteRecords(std::size_t record_count, IWritable* output);
+  // Writes DBN metadata followed by the next `record_count` records to `output`,
+  // such as an `OutFileStream`.
+  void WriteDbn(std::size_t record_count, IWritable* output);
+
+ private:
+  struct Order {
+    std::uint64_t order_id;
+    std::int64_t price;
+    std::uint32_t size;
+    Side side;
+  };
+  struct Instrument {
+    std::uint32_t instrument_id;
+    std::int64_t mid;
+    std::uint32_t sequence;
+    std::vector<Order> orders;
+    // Session statistics
+    std::int64_t open;
+    std::int64_t high;
+    std::int64_t low;
+    std::int64_t volume;
+    std::size_t stat_index;
+    std::size_t definition_count;
+  };
+
+  std::uint64_t Rand();
+  // Returns a value in [0, bound).
+  std::uint64_t Uniform(std::uint64_t bound);
+  Instrument& PickInstrument();
+  UnixNanos RecordTs(std::uint64_t record_idx) const;
+  void StartEvent(Instrument& instrument);
+  RecordHeader Header(RType rtype, std::size_t size,
+                      const Instrument& instrument) const;
+  // Returns the index of the order with the best price and time priority on
+  // `side`, or the number of orders if there are none.
+  static std::size_t BestOrder(const Instrument& instrument, Side side);
+
+  void GenerateEvent();
+  // Returns true if the event was a trade.
+  bool GenerateBookEvent(Instrument& instrument);
+  void AddOrder(Instrument& instrument);
+  void CancelOrder(Instrument& instrument, std::size_t idx);
+  void ModifyOrder(Instrument& instrument, std::size_t idx);
+  bool Trade(Instrument& instrument);
+  void GenerateDefinition();
+  void GenerateStatistic();
+  // Each appends a record if it's of the schema
+  void AppendMbo(const Instrument& instrument, Action action, const Order& order,
+                 std::uint8_t flags);
+  void AppendMbp10(const Instrument& instrument, Action action, Side side,
+                   std::int64_t price, std::uint32_t size, std::uint8_t flags);
+  void AppendTrade(const Instrument& instrument, Side side, std::int64_t price,
+                   std::uint32_t size);
+  template <typename R>
+  void Append(const R& rec);
+
+  const Schema schema_;
+  const GeneratorConf conf_;
+  std::uint64_t rng_state_;
+  std::vector<Instrument> instruments_;
+  std::uint64_t next_order_id_{1};
+  std::uint64_t record_count_{};
+  // Timestamps of the current event
+  UnixNanos ts_event_{};
+  UnixNanos ts_recv_{};
+  TimeDeltaNanos ts_in_delta_{};
+  // Sorted copy of a book for aggregating levels
+  std::vector<Order> sorted_orders_;
+  // Records of the current event that haven't been returned yet
+  std::vector<std::byte> pending_;
+  std::size_t pending_pos_{};
+  Record current_{nullptr};
+};
+}  // namespace databento::synth
@@ -0,0 +1,208 @@
+#include "databento/book.hpp"
+
+#include <iterator>  // prev
+#include <string>    // to_string
+
+#include "databento/exceptions.hpp"  // InvalidArgumentError
+#include "databento/pretty.hpp"      // Px
+#include "detail/stream_op_helper.hpp"
+
+namespace databento::book {
+namespace {
+constexpr auto kApplyMethodName = "OrderBook::Apply";
+
+// Returns the first level that isn't better than `price`. Most updates are near the
+// top of the book, so this scans down from the best level instead of bisecting
+std::vector<PriceLevel>::iterator LowerBound(std::vector<PriceLevel>& levels,
+                                             Side side, std::int64_t price) {
+  auto it = levels.end();
+  if (side == Side::Bid) {
+    while (it != levels.begin() && std::prev(it)->price >= price) {
+      --it;
+    }
+  } else {
+    while (it != levels.begin() && std::prev(it)->price <= price) {
+      --it;
+    }
+  }
+  return it;
+}
+
+void CheckSide(const MboMsg& mbo) {
+  if (mbo.side != Side::Bid && mbo.side != Side::Ask) {
+    throw InvalidArgumentError{kApplyMethodName, "mbo",
+                               "Expected a side of bid or ask for order ID " +
+                                   std::to_string(mbo.order_id)};
+  }
+}
+}  // namespace
+
+void OrderBook::Apply(const MboMsg& mbo) {
+  ts_recv_ = mbo.ts_recv;
+  sequence_ = mbo.sequence;
+  is_consistent_ = mbo.flags.IsLast();
+  switch (mbo.action) {
+    case Action::Clear: {
+      ClearOrders();
+      break;
+    }
+    case Action::Add: {
+      Add(mbo);
+      break;
+    }
+    case Action::Cancel: {
+      Cancel(mbo);
+      break;
+    }
+    case Action::Modify: {
+      Modify(mbo);
+      break;
+    }
+    // Trades and fills don't change the book: the resting order is reduced by a
+    // following cancel or modify
+    case Action::Trade:
+    case Action::Fill:
+    case Action::None:
+    default: {
+      break;
+    }
+  }
+}
+
+void OrderBook::Apply(const Record& record) {
+  if (const auto* mbo = record.GetIf<MboMsg>()) {
+    Apply(*mbo);
+  }
+}
+
+void OrderBook::Clear() {
+  ClearOrders();
+  ts_recv_ = {};
+  sequence_ = 0;
+  is_consistent_ = true;
+}
+
+void OrderBook::ClearOrders() {
+  bids_.clear();
+  asks_.clear();
+  orders_.Clear();
+}
+
+BidAskPair OrderBook::Level(std::size_t idx) const {
+  const auto bid = Bid(idx);
+  const auto ask = Ask(idx);
+  return {bid.price, ask.price, bid.size, ask.size, bid.count, ask.count};
+}
+
+PriceLevel& OrderBook::GetOrInsertLevel(Side side, std::int64_t price) {
+  auto& levels = SideLevels(side);
+  auto it = LowerBound(levels, side, price);
+  if (it == levels.end() || it->price != price) {
+    it = levels.insert(it, PriceLevel{price, 0, 0});
+  }
+  return *it;
+}
+
+void OrderBook::ReduceLevel(Side side, std::int64_t price, std::uint32_t size,
+                            std::uint32_t count) {
+  auto& levels = SideLevels(side);
+  const auto it = LowerBound(levels, side, price);
+  // Every resting order is counted in a level
+  if (it == levels.end() || it->price != price) {
+    throw InvalidArgumentError{kApplyMethodName, "mbo",
+                               "No level at price " + std::to_string(price)};
+  }
+  it->size -= size;
+  it->count -= count;
+  if (it->count == 0) {
+    levels.erase(it);
+  }
+}
+
+void OrderBook::Add(const MboMsg& mbo) {
+  if (mbo.flags.IsTob()) {
+    ReplaceTop(mbo);
+  } else {
+    AddOrder(mbo);
+  }
+}
+
+void OrderBook::AddOrder(const MboMsg& mbo) {
+  CheckSide(mbo);
+  const auto inserted =
+      orders_.Insert(mbo.order_id, Order{mbo.price, mbo.size, mbo.side}).second;
+  if (!inserted) {
+    throw InvalidArgumentError{
+        kApplyMethodName, "mbo",
+        "Received add for existing order ID " + std::to_string(mbo.order_id)};
+  }
+  auto& level = GetOrInsertLevel(mbo.side, mbo.price);
+  level.size += mbo.size;
+  ++level.count;
+}
+
+void OrderBook::Cancel(const MboMsg& mbo) {
+  auto* order = orders_.Find(mbo.order_id);
+  if (order == nullptr) {
+    throw InvalidArgumentError{
+        kApplyMethodName, "mbo",
+        "Received cancel for unknown order ID " + std::to_string(mbo.order_id)};
+  }
+  if (mbo.size > order->size) {
+    throw InvalidArgumentError{
+        kApplyMethodName, "mbo",
+        "Received cancel of " + std::to_string(mbo.size) + " for order ID " +
+            std::to_string(mbo.order_id) + " with size " + std::to_string(order->size)};
+  }
+  // Partial cancels reduce the order's size
+  order->size -= mbo.size;
+  const bool is_removed = order->size == 0;
+  ReduceLevel(order->side, order->price, mbo.size, is_removed ? 1 : 0);
+  if (is_removed) {
+    orders_.Erase(mbo.order_id);
+  }
+}
+
+void OrderBook::Modify(const MboMsg& mbo) {
+  auto* order = orders_.Find(mbo.order_id);
+  // Some venues send a modify for an order that hasn't been added
+  if (order == nullptr) {
+    AddOrder(mbo);
+    return;
+  }
+  CheckSide(mbo);
+  if (order->price == mbo.price && order->side == mbo.side) {
+    auto& level = GetOrInsertLevel(mbo.side, mbo.price);
+    level.size = level.size - order->size + mbo.size;
+  } else {
+    ReduceLevel(order->side, order->price, order->size, 1);
+    auto& level = GetOrInsertLevel(mbo.side, mbo.price);
+    level.size += mbo.size;
+    ++level.count;
+  }
+  *order = Order{mbo.price, mbo.size, mbo.side};
+}
+
+void OrderBook::ReplaceTop(const MboMsg& mbo) {
+  CheckSide(mbo);
+  // Top-of-book records replace the whole side, with an undefined price for an
+  // empty side
+  auto& levels = SideLevels(mbo.side);
+  levels.clear();
+  if (mbo.price != kUndefPrice) {
+    levels.push_back(PriceLevel{mbo.price, mbo.size, 1});
+  }
+}
+
+std::string ToString(const PriceLevel& level) { return detail::MakeString(level); }
+std::ostream& operator<<(std::ostream& stream, const PriceLevel& level) {
+  return detail::StreamOpBuilder{stream}
+      .SetSpacer(" ")
+      .SetTypeName("PriceLevel")
+      .Build()
+      .AddField("price", pretty::Px{level.price})
+      .AddField("size", level.size)
+      .AddField("count", level.count)
+      .Finish();
+}
+}  // namespace databento::book
@@ -0,0 +1,174 @@
+#include "databento/book_manager.hpp"
+
+#include <utility>  // move
+
+#include "databento/constants.hpp"   // kUndefPrice
+#include "databento/exceptions.hpp"  // InvalidArgumentError
+
+namespace databento::book {
+namespace {
+ConsolidatedBidAskPair EmptyConsolidatedBbo() {
+  ConsolidatedBidAskPair bbo{};
+  bbo.bid_px = kUndefPrice;
+  bbo.ask_px = kUndefPrice;
+  return bbo;
+}
+}  // namespace
+
+BookManager::BookManager() : BookManager{BookManagerConf{}} {}
+
+BookManager::BookManager(const BookManagerConf& conf)
+    : conf_{conf}, chunk_size_{conf.book_capacity} {
+  if (conf.book_capacity == 0) {
+    throw InvalidArgumentError{"BookManager::BookManager", "conf.book_capacity",
+                               "must be greater than 0"};
+  }
+  AddChunk();
+}
+
+void BookManager::Apply(const MboMsg& mbo) {
+  auto& entry = GetOrInsertBook(mbo.hd.instrument_id, mbo.hd.publisher_id);
+  entry.book.Apply(mbo);
+  if (!entry.book.IsConsistent()) {
+    return;
+  }
+  const auto bbo = entry.book.Bbo();
+  if (bbo == entry.bbo) {
+    return;
+  }
+  entry.bbo = bbo;
+  auto& instrument = instruments_[entry.instrument_idx];
+  instrument.is_stale = true;
+  if (!instrument.is_changed) {
+    instrument.is_changed = true;
+    changed_.push_back(entry.instrument_idx);
+  }
+}
+
+void BookManager::Apply(const Record& record) {
+  if (const auto* mbo = record.GetIf<MboMsg>()) {
+    Apply(*mbo);
+  }
+}
+
+void BookManager::Clear() {
+  for (std::uint32_t idx = 0; idx < book_count_; ++idx) {
+    Entry(idx).book.Clear();
+  }
+  book_count_ = 0;
+  book_idxs_.Clear();
+  instrument_idxs_.Clear();
+  instruments_.clear();
+  changed_.clear();
+}
+
+const OrderBook* BookManager::Find(std::uint32_t instrument_id,
+                                   std::uint16_t publisher_id) const {
+  const auto* idx = book_idxs_.Find(BookKey(instrument_id, publisher_id));
+  return idx == nullptr ? nullptr : &Entry(*idx).book;
+}
+
+ConsolidatedBidAskPair BookManager::ConsolidatedBbo(std::uint32_t instrument_id) {
+  const auto* idx = instrument_idxs_.Find(instrument_id);
+  if (idx == nullptr) {
+    return EmptyConsolidatedBbo();
+  }
+  return Refresh(instruments_[*idx]);
+}
+
+void BookManager::AddChunk() {
+  std::unique_ptr<BookEntry[]> chunk{new BookEntry[chunk_size_]};
+  for (std::size_t i = 0; i < chunk_size_; ++i) {
+    chunk[i].book.Reserve(conf_.order_capacity, conf_.level_capacity);
+  }
+  chunks_.emplace_back(std::move(chunk));
+  // Keep the indices growing with the pool
+  book_idxs_.Reserve(BookCapacity());
+  instrument_idxs_.Reserve(BookCapacity());
+  instruments_.reserve(BookCapacity());
+  changed_.reserve(BookCapacity());
+}
+
+BookManager::BookEntry& BookManager::GetOrInsertBook(std::uint32_t instrument_id,
+                                                     std::uint16_t publisher_id) {
+  const auto key = BookKey(instrument_id, publisher_id);
+  if (auto* idx = book_idxs_.Find(key)) {
+    return Entry(*idx);
+  }
+  if (book_count_ == BookCapacity()) {
+    AddChunk();
+  }
+  const auto book_idx = static_cast<std::uint32_t>(book_count_++);
+  book_idxs_.Insert(key, book_idx);
+  const auto instrument_idx = GetOrInsertInstrument(instrument_id);
+  auto& entry = Entry(book_idx);
+  // Pooled books are cleared when returned, so only the metadata needs resetting
+  entry.bbo = entry.book.Bbo();
+  entry.instrument_idx = instrument_idx;
+  entry.publisher_id = publisher_id;
+  // Keep the instrument's books sorted by publisher ID so ties in the consolidated
+  // BBO are deterministic
+  auto* next = &instruments_[instrument_idx].first_book;
+  while (*next != kNoBook && Entry(*next).publisher_id < publisher_id) {
+    next = &Entry(*next).next;
+  }
+  entry.next = *next;
+  *next = book_idx;
+  return entry;
+}
+
+std::uint32_t BookManager::GetOrInsertInstrument(std::uint32_t instrument_id) {
+  const auto instrument_idx = static_cast<std::uint32_t>(instruments_.size());
+  const auto res = instrument_idxs_.Insert(instrument_id, instrument_idx);
+  if (res.second) {
+    instruments_.push_back(
+        InstrumentEntry{instrument_id, kNoBook, EmptyConsolidatedBbo(), false, false});
+  }
+  return *res.first;
+}
+
+const ConsolidatedBidAskPair& BookManager::Refresh(InstrumentEntry& instrument) {
+  if (!instrument.is_stale) {
+    return instrument.bbo;
+  }
+  auto bbo = EmptyConsolidatedBbo();
+  // The size of `bid_pb` and `ask_pb` at the best prices
+  std::uint32_t bid_pb_sz{};
+  std::uint32_t ask_pb_sz{};
+  for (auto idx = instrument.first_book; idx != kNoBook; idx = Entry(idx).next) {
+    const auto& entry = Entry(idx);
+    const auto& book_bbo = entry.bbo;
+    if (book_bbo.bid_px != kUndefPrice) {
+      if (bbo.bid_px == kUndefPrice || book_bbo.bid_px > bbo.bid_px) {
+        bbo.bid_px = book_bbo.bid_px;
+        bbo.bid_sz = book_bbo.bid_sz;
+        bbo.bid_pb = entry.publisher_id;
+        bid_pb_sz = book_bbo.bid_sz;
+      } else if (book_bbo.bid_px == bbo.bid_px) {
+        bbo.bid_sz += book_bbo.bid_sz;
+        if (book_bbo.bid_sz > bid_pb_sz) {
+          bbo.bid_pb = entry.publisher_id;
+          bid_pb_sz = book_bbo.bid_sz;
+        }
+      }
+    }
+    if (book_bbo.ask_px != kUndefPrice) {
+      if (bbo.ask_px == kUndefPrice || book_bbo.ask_px < bbo.ask_px) {
+        bbo.ask_px = book_bbo.ask_px;
+        bbo.ask_sz = book_bbo.ask_sz;
+        bbo.ask_pb = entry.publisher_id;
+        ask_pb_sz = book_bbo.ask_sz;
+      } else if (book_bbo.ask_px == bbo.ask_px) {
+        bbo.ask_sz += book_bbo.ask_sz;
+        if (book_bbo.ask_sz > ask_pb_sz) {
+          bbo.ask_pb = entry.publisher_id;
+          ask_pb_sz = book_bbo.ask_sz;
+        }
+      }
+    }
+  }
+  instrument.bbo = bbo;
+  instrument.is_stale = false;
+  return instrument.bbo;
+}
+}  // namespace databento::book
@@ -0,0 +1,190 @@
+#include "databento/columnar_batch.hpp"
+
+#include <cstddef>  // size_t
+#include <vector>
+
+#include "databento/exceptions.hpp"  // InvalidArgumentError
+
+using databento::ColumnarBatch;
+
+namespace {
+template <typename... Columns>
+void ResizeColumns(std::size_t size, Columns&... columns) {
+  (columns.resize(size), ...);
+}
+
+// Each field is copied in its own loop so every loop writes a single sequential
+// column, which the compiler can unroll and vectorize.
+template <typename R, typename T>
+void TransposeField(const std::vector<const R*>& rows, T R::*field,
+                    std::vector<T>& column, std::size_t offset) {
+  T* out = column.data() + offset;
+  for (std::size_t i = 0; i < rows.size(); ++i) {
+    out[i] = rows[i]->*field;
+  }
+}
+
+template <typename R, typename T>
+void TransposeHeaderField(const std::vector<const R*>& rows,
+                          T databento::RecordHeader::*field, std::vector<T>& column,
+                          std::size_t offset) {
+  T* out = column.data() + offset;
+  for (std::size_t i = 0; i < rows.size(); ++i) {
+    out[i] = rows[i]->hd.*field;
+  }
+}
+
+template <typename T>
+void TransposeLevelField(const std::vector<const databento::Mbp1Msg*>& rows,
+                         T databento::BidAskPair::*field, std::vector<T>& column,
+                         std::size_t offset) {
+  T* out = column.data() + offset;
+  for (std::size_t i = 0; i < rows.size(); ++i) {
+    out[i] = rows[i]->levels[0].*field;
+  }
+}
+
+template <typename R>
+void TransposeHeader(const std::vector<const R*>& rows,
+                     databento::RecordColumns<R>& columns, std::size_t offset) {
+  using databento::RecordHeader;
+  TransposeHeaderField(rows, &RecordHeader::ts_event, columns.ts_event, offset);
+  TransposeHeaderField(rows, &RecordHeader::publisher_id, columns.publisher_id,
+                       offset);
+  TransposeHeaderField(rows, &RecordHeader::instrument_id, columns.instrument_id,
+                       offset);
+}
+
+void Resize(databento::RecordColumns<databento::MboMsg>& columns, std::size_t size) {
+  ResizeColumns(size, columns.ts_event, columns.publisher_id, columns.instrument_id,
+                columns.order_id, columns.price, columns.size, columns.flags,
+                columns.channel_id, columns.action, columns.side, columns.ts_recv,
+                columns.ts_in_delta, columns.sequence);
+}
+
+void Resize(databento::RecordColumns<databento::TradeMsg>& columns,
+            std::size_t size) {
+  ResizeColumns(size, columns.ts_event, columns.publisher_id, columns.instrument_id,
+                columns.price, columns.size, columns.action, columns.side,
+                columns.flags, columns.depth, columns.ts_recv, columns.ts_in_delta,
+                columns.sequence);
+}
+
+void Resize(databento::RecordColumns<databento::Mbp1Msg>& columns,
+            std::size_t size) {
+  ResizeColumns(size, columns.ts_event, columns.publisher_id, columns.instrument_id,
+                columns.price, columns.size, columns.action, columns.side,
+                columns.flags, columns.depth, columns.ts_recv, columns.ts_in_delta,
+                columns.sequence, columns.bid_px, columns.ask_px, columns.bid_sz,
+                columns.ask_sz, columns.bid_ct, columns.ask_ct);
+}
+
+void Transpose(const std::vector<const databento::MboMsg*>& rows,
+               databento::RecordColumns<databento::MboMsg>& columns,
+               std::size_t offset) {
+  using databento::MboMsg;
+  TransposeHeader(rows, columns, offset);
+  TransposeField(rows, &MboMsg::order_id, columns.order_id, offset);
+  TransposeField(rows, &MboMsg::price, columns.price, offset);
+  TransposeField(rows, &MboMsg::size, columns.size, offset);
+  TransposeField(rows, &MboMsg::flags, columns.flags, offset);
+  TransposeField(rows, &MboMsg::channel_id, columns.channel_id, offset);
+  TransposeField(rows, &MboMsg::action, columns.action, offset);
+  TransposeField(rows, &MboMsg::side, columns.side, offset);
+  TransposeField(rows, &MboMsg::ts_recv, columns.ts_recv, offset);
+  TransposeField(rows, &MboMsg::ts_in_delta, columns.ts_in_delta, offset);
+  TransposeField(rows, &MboMsg::sequence, columns.sequence, offset);
+}
+
+// `TradeMsg` and `Mbp1Msg` share the same fields before `levels`
+template <typename R>
+void TransposeTrade(const std::vector<const R*>& rows,
+                    databento::RecordColumns<R>& columns, std::size_t offset) {
+  TransposeHeader(rows, columns, offset);
+  TransposeField(rows, &R::price, columns.price, offset);
+  TransposeField(rows, &R::size, columns.size, offset);
+  TransposeField(rows, &R::action, columns.action, offset);
+  TransposeField(rows, &R::side, columns.side, offset);
+  TransposeField(rows, &R::flags, columns.flags, offset);
+  TransposeField(rows, &R::depth, columns.depth, offset);
+  TransposeField(rows, &R::ts_recv, columns.ts_recv, offset);
+  TransposeField(rows, &R::ts_in_delta, columns.ts_in_delta, offset);
+  TransposeField(rows, &R::sequence, columns.sequence, offset);
+}
+
+void Transpose(const std::vector<const databento::TradeMsg*>& rows,
+               databento::RecordColumns<databento::TradeMsg>& columns,
+               std::size_t offset) {
+  TransposeTrade(rows, columns, offset);
+}
+
+void Transpose(const std::vector<const databento::Mbp1Msg*>& rows,
+               databento::RecordColumns<databento::Mbp1Msg>& columns,
+               std::size_t offset) {
+  using databento::BidAskPair;
+  TransposeTrade(rows, columns, offset);
+  TransposeLevelField(rows, &BidAskPair::bid_px, columns.bid_px, offset);
+  TransposeLevelField(rows, &BidAskPair::ask_px, columns.ask_px, offset);
+  TransposeLevelField(rows, &BidAskPair::bid_sz, columns.bid_sz, offset);
+  TransposeLevelField(rows, &BidAskPair::ask_sz, columns.ask_sz, offset);
+  TransposeLevelField(rows, &BidAskPair::bid_ct, columns.bid_ct, offset);
+  TransposeLevelField(rows, &BidAskPair::ask_ct, columns.ask_ct, offset);
+}
+}  // namespace
+
+template <typename R>
+ColumnarBatch<R>::ColumnarBatch(std::size_t capacity) : capacity_{capacity} {
+  if (capacity_ == 0) {
+    throw InvalidArgumentError{"ColumnarBatch::ColumnarBatch", "capacity",
+                               "must be greater than 0"};
+  }
+  Resize(columns_, capacity_);
+  rows_.reserve(capacity_);
+}
+
+template <typename R>
+std::size_t ColumnarBatch<R>::Fill(DbnStore& store) {
+  if (store_ != &store) {
+    store_ = &store;
+    pending_ = nullptr;
+    pending_idx_ = 0;
+  }
+  // Only does any work after a partial batch
+  Resize(columns_, capacity_);
+  size_ = 0;
+  while (size_ < capacity_) {
+    if (pending_ == nullptr || pending_idx_ == pending_->Size()) {
+      pending_ = &store.NextBatch();
+      pending_idx_ = 0;
+      if (pending_->Empty()) {
+        break;
+      }
+    }
+    // Records in `pending_` are only valid until the next call to `NextBatch`, so
+    // they're transposed before decoding more
+    const auto remaining = capacity_ - size_;
+    rows_.clear();
+    for (; pending_idx_ < pending_->Size() && rows_.size() < remaining;
+         ++pending_idx_) {
+      const auto& record = (*pending_)[pending_idx_];
+      if (record.Holds<R>()) {
+        rows_.push_back(reinterpret_cast<const R*>(&record.Header()));
+      }
+    }
+    TransposeRows();
+  }
+  Resize(columns_, size_);
+  return size_;
+}
+
+template <typename R>
+void ColumnarBatch<R>::TransposeRows() {
+  Transpose(rows_, columns_, size_);
+  size_ += rows_.size();
+}
+
+namespace databento {
+template class ColumnarBatch<MboMsg>;
+template class ColumnarBatch<TradeMsg>;
+template class ColumnarBatch<Mbp1Msg>;
+}  // namespace databento
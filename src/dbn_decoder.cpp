@@ -2,15 +2,23 @@
 
 #include <date/date.h>
 
-#include <algorithm>  // copy
+#include <algorithm>  // copy, max, min
+#include <cstddef>    // offsetof
+#include <cstdint>    // uintptr_t
 #include <cstring>    // strncmp
+#include <new>        // placement new
 #include <optional>
+#include <string>       // to_string
+#include <thread>       // hardware_concurrency
+#include <type_traits>  // is_same_v
+#include <utility>      // pair
 #include <vector>
 
 #include "databento/compat.hpp"
 #include "databento/constants.hpp"
 #include "databento/datetime.hpp"
 #include "databento/detail/buffer.hpp"
+#include "databento/detail/read_ahead_stream.hpp"
 #include "databento/detail/zstd_stream.hpp"
 #include "databento/enums.hpp"
 #include "databento/exceptions.hpp"
@@ -22,6 +30,13 @@
 using databento::DbnDecoder;
 
 namespace {
+// Records decoded in place from a read-only `InMmapFileStream` are only exposed as
+// `const Record`, so they're never written through.
+databento::RecordHeader* MappedHeader(const std::byte* pos) {
+  return const_cast<databento::RecordHeader*>(
+      reinterpret_cast<const databento::RecordHeader*>(pos));
+}
+
 template <typename T>
 T Consume(const std::byte*& buf) {
   const auto res = *reinterpret_cast<const T*>(buf);
@@ -73,11 +88,17 @@ DbnDecoder::DbnDecoder(ILogReceiver* log_receiver, std::unique_ptr<IReadable> in
 
 DbnDecoder::DbnDecoder(ILogReceiver* log_receiver, std::unique_ptr<IReadable> input,
                        VersionUpgradePolicy upgrade_policy)
+    : DbnDecoder(log_receiver, std::move(input), upgrade_policy, DecodeConf{}) {}
+
+DbnDecoder::DbnDecoder(ILogReceiver* log_receiver, std::unique_ptr<IReadable> input,
+                       VersionUpgradePolicy upgrade_policy, DecodeConf decode_conf)
     : log_receiver_{log_receiver},
       upgrade_policy_{upgrade_policy},
+      decode_conf_{decode_conf},
       input_{std::move(input)} {
-  if (DetectCompression()) {
-    input_ = std::make_unique<detail::ZstdDecodeStream>(std::move(input_), buffer_);
+  is_compressed_ = DetectCompression();
+  if (is_compressed_) {
+    WrapZstdInput();
     input_->ReadExact(buffer_.WriteBegin(), kMagicSize);
     buffer_.Fill(kMagicSize);
     const auto* buf_ptr = buffer_.ReadBegin();
@@ -85,6 +106,103 @@ DbnDecoder::DbnDecoder(ILogReceiver* log_receiver, std::unique_ptr<IReadable> in
       throw DbnResponseError{"Found Zstd input, but not DBN prefix"};
     }
   }
+  MaybeReadAhead();
+}
+
+DbnDecoder::DbnDecoder(ILogReceiver* log_receiver, InMmapFileStream file_stream,
+                       VersionUpgradePolicy upgrade_policy)
+    : DbnDecoder(log_receiver, std::move(file_stream), upgrade_policy, DecodeConf{}) {
+}
+
+DbnDecoder::DbnDecoder(ILogReceiver* log_receiver, InMmapFileStream file_stream,
+                       VersionUpgradePolicy upgrade_policy, DecodeConf decode_conf)
+    : DbnDecoder(log_receiver,
+                 std::make_unique<InMmapFileStream>(std::move(file_stream)),
+                 upgrade_policy, decode_conf) {
+  // Compressed input has already been wrapped in a decompressing stream, in which
+  // case records must be decompressed into `buffer_`. The same applies to
+  // read-ahead, which is only enabled for compressed mapped files
+  mapped_input_ = dynamic_cast<InMmapFileStream*>(input_.get());
+}
+
+void DbnDecoder::WrapZstdInput() {
+  const auto zstd_threads = decode_conf_.zstd_threads == 0
+                                ? std::max(std::thread::hardware_concurrency(), 1U)
+                                : decode_conf_.zstd_threads;
+  if (zstd_threads > 1) {
+    input_ = std::make_unique<detail::ParallelZstdDecodeStream>(std::move(input_),
+                                                                buffer_, zstd_threads);
+  } else {
+    input_ = std::make_unique<detail::ZstdDecodeStream>(std::move(input_), buffer_);
+  }
+}
+
+void DbnDecoder::MaybeReadAhead() {
+  // Reading ahead would only add copies for uncompressed mapped files
+  if (decode_conf_.read_ahead_depth > 0 &&
+      dynamic_cast<InMmapFileStream*>(input_.get()) == nullptr) {
+    auto read_ahead = std::make_unique<detail::ReadAheadStream>(
+        std::move(input_), decode_conf_.read_ahead_depth,
+        decode_conf_.read_ahead_buffer_size);
+    read_ahead_input_ = read_ahead.get();
+    input_ = std::move(read_ahead);
+  }
+}
+
+void DbnDecoder::ResetInput(std::unique_ptr<IReadable> input, std::size_t skip_size) {
+  // Stops any read-ahead thread reading from the old input
+  read_ahead_input_ = nullptr;
+  input_ = std::move(input);
+  mapped_input_ = nullptr;
+  decode_in_place_ = false;
+  buffer_.Clear();
+  batch_.records_.clear();
+  compat_batch_buffer_.Clear();
+  if (is_compressed_) {
+    if (!DetectCompression()) {
+      throw DbnResponseError{"Expected the start of a Zstd frame"};
+    }
+    WrapZstdInput();
+  }
+  MaybeReadAhead();
+  while (skip_size > 0) {
+    if (buffer_.ReadCapacity() == 0 && FillBuffer() == 0) {
+      throw DbnResponseError{"Unexpected end of input, " + std::to_string(skip_size) +
+                             " bytes short of the record to resume from"};
+    }
+    const auto consume_size = std::min(skip_size, buffer_.ReadCapacity());
+    buffer_.Consume(consume_size);
+    skip_size -= consume_size;
+  }
+  // Skipping may leave the buffer misaligned
+  buffer_.Shift();
+}
+
+void DbnDecoder::SkipBefore(UnixNanos ts) {
+  if (decode_in_place_) {
+    while (mapped_input_->ReadCapacity() >= sizeof(RecordHeader)) {
+      const Record record{MappedHeader(mapped_input_->ReadBegin())};
+      if (mapped_input_->ReadCapacity() < record.Size() || record.IndexTs() >= ts) {
+        return;
+      }
+      mapped_input_->Consume(record.Size());
+    }
+    return;
+  }
+  while (FillRecord()) {
+    const Record record{BufferRecordHeader()};
+    if (record.IndexTs() >= ts) {
+      return;
+    }
+    buffer_.Consume(record.Size());
+  }
+}
+
+databento::ReadAheadStats DbnDecoder::ReadAheadStats() const {
+  if (read_ahead_input_ == nullptr) {
+    return {0, 0};
+  }
+  return {read_ahead_input_->ProducerStalls(), read_ahead_input_->ConsumerStalls()};
 }
 
 std::pair<std::uint8_t, std::size_t> DbnDecoder::DecodeMetadataVersionAndSize(
@@ -173,7 +291,7 @@ databento::Metadata DbnDecoder::DecodeMetadata() {
       buffer_.ReadBegin(), kMetadataPreludeSize);
   buffer_.Consume(kMetadataPreludeSize);
   version_ = version;
-  needs_upgrade_ = NeedsUpgrade(upgrade_policy_, version_);
+  upgrade_record_ = SelectUpgrade(version_, upgrade_policy_);
   buffer_.Reserve(size);
   input_->ReadExact(buffer_.WriteBegin(), size);
   buffer_.Fill(size);
@@ -184,92 +302,246 @@ databento::Metadata DbnDecoder::DecodeMetadata() {
   // alignment
   buffer_.Shift();
   ts_out_ = metadata.ts_out;
+  fixed_records_.Init(version_, metadata.schema, ts_out_, upgrade_record_ != nullptr);
   metadata.Upgrade(upgrade_policy_);
+  if (mapped_input_ != nullptr && buffer_.ReadCapacity() == 0) {
+    // Records can only be referenced in place if they're 8-byte aligned, which
+    // depends on the length of the metadata
+    decode_in_place_ =
+        reinterpret_cast<std::uintptr_t>(mapped_input_->ReadBegin()) %
+            alignof(RecordHeader) ==
+        0;
+    if (!decode_in_place_ && log_receiver_->ShouldLog(LogLevel::Debug)) {
+      log_receiver_->Receive(
+          LogLevel::Debug,
+          "[DbnDecoder::DecodeMetadata] Records in memory-mapped file aren't 8-byte "
+          "aligned, falling back to buffered decoding");
+    }
+  }
   return metadata;
 }
 
 namespace {
+// The record types that changed between DBN versions, keyed by version
+template <std::uint8_t kVersion>
+struct VersionedRecords;
+
+template <>
+struct VersionedRecords<1> {
+  using InstrumentDefMsg = databento::v1::InstrumentDefMsg;
+  using StatMsg = databento::v1::StatMsg;
+  using ErrorMsg = databento::v1::ErrorMsg;
+  using SymbolMappingMsg = databento::v1::SymbolMappingMsg;
+  using SystemMsg = databento::v1::SystemMsg;
+};
+
+template <>
+struct VersionedRecords<2> {
+  using InstrumentDefMsg = databento::v2::InstrumentDefMsg;
+  using StatMsg = databento::v2::StatMsg;
+  using ErrorMsg = databento::v2::ErrorMsg;
+  using SymbolMappingMsg = databento::v2::SymbolMappingMsg;
+  using SystemMsg = databento::v2::SystemMsg;
+};
+
+template <>
+struct VersionedRecords<3> {
+  using InstrumentDefMsg = databento::v3::InstrumentDefMsg;
+  using StatMsg = databento::v3::StatMsg;
+  using ErrorMsg = databento::v3::ErrorMsg;
+  using SymbolMappingMsg = databento::v3::SymbolMappingMsg;
+  using SystemMsg = databento::v3::SystemMsg;
+};
+
+constexpr std::uint8_t UpgradedVersion(databento::VersionUpgradePolicy upgrade_policy) {
+  return upgrade_policy == databento::VersionUpgradePolicy::UpgradeToV2 ? 2 : 3;
+}
+
+// Returns the length of a `T` record once upgraded to `U`, or 0 if the record is
+// unchanged.
 template <typename T, typename U>
-databento::Record UpgradeRecord(
-    bool ts_out, std::array<std::byte, databento::kMaxRecordLen>* compat_buffer,
-    databento::Record rec) {
-  if (ts_out) {
-    const auto orig = rec.Get<databento::WithTsOut<T>>();
-    const databento::WithTsOut<U> upgraded = {orig.rec.template Upgrade<U>(),
-                                              orig.ts_out};
-    const auto upgraded_ptr = reinterpret_cast<const std::byte*>(&upgraded);
-    std::copy(upgraded_ptr, upgraded_ptr + upgraded.rec.hd.Size(),
-              compat_buffer->data());
+constexpr std::size_t UpgradedLength(bool ts_out) {
+  if constexpr (std::is_same_v<T, U>) {
+    return 0;
   } else {
-    const auto& orig = rec.Get<T>();
-    const U upgraded = orig.template Upgrade<U>();
-    const auto upgraded_ptr = reinterpret_cast<const std::byte*>(&upgraded);
-    std::copy(upgraded_ptr, upgraded_ptr + upgraded.hd.Size(), compat_buffer->data());
+    return ts_out ? sizeof(databento::WithTsOut<U>) : sizeof(U);
+  }
+}
+
+// Constructs the upgraded record directly in `out` rather than copying it from a
+// temporary.
+template <typename T, typename U>
+std::size_t UpgradeInto(const databento::RecordHeader& record, bool ts_out,
+                        std::byte* out) {
+  if constexpr (std::is_same_v<T, U>) {
+    return 0;
+  } else {
+    const auto& orig = *reinterpret_cast<const T*>(&record);
+    auto* upgraded = new (out) U(orig.template Upgrade<U>());
+    if (ts_out) {
+      // `ts_out` follows the record in both versions
+      const auto& orig_with_ts_out =
+          *reinterpret_cast<const databento::WithTsOut<T>*>(&record);
+      auto* upgraded_with_ts_out = reinterpret_cast<databento::WithTsOut<U>*>(out);
+      upgraded_with_ts_out->ts_out = orig_with_ts_out.ts_out;
+      upgraded->hd.length = sizeof(databento::WithTsOut<U>) /
+                            databento::RecordHeader::kLengthMultiplier;
+    }
+    return UpgradedLength<T, U>(ts_out);
+  }
+}
+
+// Returns the length of `rtype` records from `kVersion`-formatted data once
+// upgraded under `kPolicy`, or 0 if they're unchanged.
+template <std::uint8_t kVersion, databento::VersionUpgradePolicy kPolicy>
+std::size_t UpgradedLength(databento::RType rtype, bool ts_out) {
+  using In = VersionedRecords<kVersion>;
+  using Out = VersionedRecords<UpgradedVersion(kPolicy)>;
+  switch (rtype) {
+    case databento::RType::InstrumentDef: {
+      return UpgradedLength<typename In::InstrumentDefMsg,
+                            typename Out::InstrumentDefMsg>(ts_out);
+    }
+    case databento::RType::Statistics: {
+      return UpgradedLength<typename In::StatMsg, typename Out::StatMsg>(ts_out);
+    }
+    case databento::RType::SymbolMapping: {
+      return UpgradedLength<typename In::SymbolMappingMsg,
+                            typename Out::SymbolMappingMsg>(ts_out);
+    }
+    case databento::RType::Error: {
+      return UpgradedLength<typename In::ErrorMsg, typename Out::ErrorMsg>(ts_out);
+    }
+    case databento::RType::System: {
+      return UpgradedLength<typename In::SystemMsg, typename Out::SystemMsg>(ts_out);
+    }
+    default: {
+      return 0;
+    }
+  }
+}
+
+// Upgrades a record from `kVersion`-formatted data under `kPolicy`. Specializing on
+// the version and policy leaves a single switch on the rtype per record.
+template <std::uint8_t kVersion, databento::VersionUpgradePolicy kPolicy>
+std::size_t UpgradeRecord(const databento::RecordHeader& record, bool ts_out,
+                          std::byte* out) {
+  using In = VersionedRecords<kVersion>;
+  using Out = VersionedRecords<UpgradedVersion(kPolicy)>;
+  switch (record.rtype) {
+    case databento::RType::InstrumentDef: {
+      return UpgradeInto<typename In::InstrumentDefMsg,
+                         typename Out::InstrumentDefMsg>(record, ts_out, out);
+    }
+    case databento::RType::Statistics: {
+      return UpgradeInto<typename In::StatMsg, typename Out::StatMsg>(record, ts_out,
+                                                                      out);
+    }
+    case databento::RType::SymbolMapping: {
+      return UpgradeInto<typename In::SymbolMappingMsg,
+                         typename Out::SymbolMappingMsg>(record, ts_out, out);
+    }
+    case databento::RType::Error: {
+      return UpgradeInto<typename In::ErrorMsg, typename Out::ErrorMsg>(record, ts_out,
+                                                                        out);
+    }
+    case databento::RType::System: {
+      return UpgradeInto<typename In::SystemMsg, typename Out::SystemMsg>(
+          record, ts_out, out);
+    }
+    default: {
+      return 0;
+    }
+  }
+}
+
+template <std::uint8_t kVersion, databento::VersionUpgradePolicy kPolicy>
+std::pair<std::size_t, std::size_t> UpgradeRecords(bool ts_out,
+                                                   const std::byte* begin,
+                                                   const std::byte* end,
+                                                   std::byte* out,
+                                                   const std::byte* out_end) {
+  const auto* pos = begin;
+  auto* out_pos = out;
+  // Consecutive records unchanged by the upgrade are copied together
+  const auto* unchanged_begin = begin;
+  const auto copy_unchanged = [&pos, &out_pos, &unchanged_begin] {
+    out_pos = std::copy(unchanged_begin, pos, out_pos);
+    unchanged_begin = pos;
+  };
+  while (static_cast<std::size_t>(end - pos) >= sizeof(databento::RecordHeader)) {
+    const auto& header = *reinterpret_cast<const databento::RecordHeader*>(pos);
+    const auto size = header.Size();
+    if (size < sizeof(databento::RecordHeader)) {
+      throw databento::DbnResponseError{"Invalid record with length " +
+                                        std::to_string(size)};
+    }
+    if (static_cast<std::size_t>(end - pos) < size) {
+      break;
+    }
+    const auto upgraded_len = UpgradedLength<kVersion, kPolicy>(header.rtype, ts_out);
+    const auto pending_len = static_cast<std::size_t>(pos - unchanged_begin);
+    if (static_cast<std::size_t>(out_end - out_pos) - pending_len <
+        (upgraded_len == 0 ? size : upgraded_len)) {
+      break;
+    }
+    if (upgraded_len != 0) {
+      copy_unchanged();
+      out_pos += UpgradeRecord<kVersion, kPolicy>(header, ts_out, out_pos);
+      pos += size;
+      unchanged_begin = pos;
+    } else {
+      pos += size;
+    }
   }
-  return databento::Record{
-      reinterpret_cast<databento::RecordHeader*>(compat_buffer->data())};
+  copy_unchanged();
+  return {static_cast<std::size_t>(pos - begin),
+          static_cast<std::size_t>(out_pos - out)};
 }
 }  // namespace
 
+DbnDecoder::UpgradeFn DbnDecoder::SelectUpgrade(std::uint8_t version,
+                                                VersionUpgradePolicy upgrade_policy) {
+  if (version == 1 && upgrade_policy == VersionUpgradePolicy::UpgradeToV2) {
+    return &UpgradeRecord<1, VersionUpgradePolicy::UpgradeToV2>;
+  }
+  if (version == 1 && upgrade_policy == VersionUpgradePolicy::UpgradeToV3) {
+    return &UpgradeRecord<1, VersionUpgradePolicy::UpgradeToV3>;
+  }
+  if (version == 2 && upgrade_policy == VersionUpgradePolicy::UpgradeToV3) {
+    return &UpgradeRecord<2, VersionUpgradePolicy::UpgradeToV3>;
+  }
+  return nullptr;
+}
+
+std::pair<std::size_t, std::size_t> DbnDecoder::UpgradeRecords(
+    std::uint8_t version, VersionUpgradePolicy upgrade_policy, bool ts_out,
+    const std::byte* begin, const std::byte* end, std::byte* out,
+    const std::byte* out_end) {
+  if (version == 1 && upgrade_policy == VersionUpgradePolicy::UpgradeToV2) {
+    return ::UpgradeRecords<1, VersionUpgradePolicy::UpgradeToV2>(ts_out, begin, end,
+                                                                  out, out_end);
+  }
+  if (version == 1 && upgrade_policy == VersionUpgradePolicy::UpgradeToV3) {
+    return ::UpgradeRecords<1, VersionUpgradePolicy::UpgradeToV3>(ts_out, begin, end,
+                                                                  out, out_end);
+  }
+  if (version == 2 && upgrade_policy == VersionUpgradePolicy::UpgradeToV3) {
+    return ::UpgradeRecords<2, VersionUpgradePolicy::UpgradeToV3>(ts_out, begin, end,
+                                                                  out, out_end);
+  }
+  // Nothing to upgrade. Every record type is unchanged from version 3 to itself,
+  // so records are copied as is
+  return ::UpgradeRecords<3, VersionUpgradePolicy::UpgradeToV3>(ts_out, begin, end,
+                                                                out, out_end);
+}
+
 databento::Record DbnDecoder::DecodeRecordCompat(
     std::uint8_t version, VersionUpgradePolicy upgrade_policy, bool ts_out,
     std::array<std::byte, kMaxRecordLen>* compat_buffer, Record rec) {
-  if (version == 1 && upgrade_policy == VersionUpgradePolicy::UpgradeToV2) {
-    switch (rec.RType()) {
-      case RType::InstrumentDef: {
-        return UpgradeRecord<v1::InstrumentDefMsg, v2::InstrumentDefMsg>(
-            ts_out, compat_buffer, rec);
-      }
-      case RType::SymbolMapping: {
-        return UpgradeRecord<v1::SymbolMappingMsg, v2::SymbolMappingMsg>(
-            ts_out, compat_buffer, rec);
-      }
-      case RType::Error: {
-        return UpgradeRecord<v1::ErrorMsg, v2::ErrorMsg>(ts_out, compat_buffer, rec);
-      }
-      case RType::System: {
-        return UpgradeRecord<v1::SystemMsg, v2::SystemMsg>(ts_out, compat_buffer, rec);
-      }
-      default: {
-        break;
-      }
-    }
-  } else if (version == 1 && upgrade_policy == VersionUpgradePolicy::UpgradeToV3) {
-    switch (rec.RType()) {
-      case RType::InstrumentDef: {
-        return UpgradeRecord<v1::InstrumentDefMsg, v3::InstrumentDefMsg>(
-            ts_out, compat_buffer, rec);
-      }
-      case RType::Statistics: {
-        return UpgradeRecord<v1::StatMsg, v3::StatMsg>(ts_out, compat_buffer, rec);
-      }
-      case RType::SymbolMapping: {
-        return UpgradeRecord<v1::SymbolMappingMsg, v3::SymbolMappingMsg>(
-            ts_out, compat_buffer, rec);
-      }
-      case RType::Error: {
-        return UpgradeRecord<v1::ErrorMsg, v3::ErrorMsg>(ts_out, compat_buffer, rec);
-      }
-      case RType::System: {
-        return UpgradeRecord<v1::SystemMsg, v3::SystemMsg>(ts_out, compat_buffer, rec);
-      }
-      default: {
-        break;
-      }
-    }
-  } else if (version == 2 && upgrade_policy == VersionUpgradePolicy::UpgradeToV3) {
-    switch (rec.RType()) {
-      case RType::InstrumentDef: {
-        return UpgradeRecord<v2::InstrumentDefMsg, v3::InstrumentDefMsg>(
-            ts_out, compat_buffer, rec);
-      }
-      case RType::Statistics: {
-        return UpgradeRecord<v2::StatMsg, v3::StatMsg>(ts_out, compat_buffer, rec);
-      }
-      default: {
-        break;
-      }
-    }
+  const auto upgrade = SelectUpgrade(version, upgrade_policy);
+  if (upgrade != nullptr && upgrade(rec.Header(), ts_out, compat_buffer->data()) > 0) {
+    return Record{reinterpret_cast<RecordHeader*>(compat_buffer->data())};
   }
   return rec;
 }
@@ -287,12 +559,197 @@ bool DbnDecoder::NeedsUpgrade(VersionUpgradePolicy upgrade_policy,
   }
 }
 
+std::size_t DbnDecoder::FixedRecordLength(std::uint8_t version,
+                                          std::optional<Schema> schema, bool ts_out) {
+  if (!schema.has_value()) {
+    return 0;
+  }
+  std::size_t record_len{};
+  switch (*schema) {
+    case Schema::Mbo: {
+      record_len = sizeof(MboMsg);
+      break;
+    }
+    case Schema::Mbp1:
+    case Schema::Tbbo: {
+      record_len = sizeof(Mbp1Msg);
+      break;
+    }
+    case Schema::Mbp10: {
+      record_len = sizeof(Mbp10Msg);
+      break;
+    }
+    case Schema::Trades: {
+      record_len = sizeof(TradeMsg);
+      break;
+    }
+    case Schema::Ohlcv1S:
+    case Schema::Ohlcv1M:
+    case Schema::Ohlcv1H:
+    case Schema::Ohlcv1D:
+    case Schema::OhlcvEod: {
+      record_len = sizeof(OhlcvMsg);
+      break;
+    }
+    case Schema::Definition: {
+      if (version == 1) {
+        record_len = sizeof(v1::InstrumentDefMsg);
+      } else if (version == 2) {
+        record_len = sizeof(v2::InstrumentDefMsg);
+      } else {
+        record_len = sizeof(v3::InstrumentDefMsg);
+      }
+      break;
+    }
+    case Schema::Statistics: {
+      record_len = version < 3 ? sizeof(v1::StatMsg) : sizeof(v3::StatMsg);
+      break;
+    }
+    case Schema::Status: {
+      record_len = sizeof(StatusMsg);
+      break;
+    }
+    case Schema::Imbalance: {
+      record_len = sizeof(ImbalanceMsg);
+      break;
+    }
+    case Schema::Cmbp1:
+    case Schema::Tcbbo: {
+      record_len = sizeof(Cmbp1Msg);
+      break;
+    }
+    case Schema::Cbbo1S:
+    case Schema::Cbbo1M: {
+      record_len = sizeof(CbboMsg);
+      break;
+    }
+    case Schema::Bbo1S:
+    case Schema::Bbo1M: {
+      record_len = sizeof(BboMsg);
+      break;
+    }
+    default: {
+      return 0;
+    }
+  }
+  return ts_out ? record_len + sizeof(UnixNanos) : record_len;
+}
+
+std::size_t DbnDecoder::CountFixedLengthRecords(const std::byte* begin,
+                                                const std::byte* end,
+                                                std::size_t record_len) {
+  // Only the `length` field at the start of each record is checked
+  static_assert(offsetof(RecordHeader, length) == 0);
+  constexpr std::size_t kBlockSize = 8;
+  const auto length =
+      static_cast<std::uint8_t>(record_len / kRecordHeaderLengthMultiplier);
+  const std::size_t max_count = static_cast<std::size_t>(end - begin) / record_len;
+  std::size_t count = 0;
+  // Compare the lengths of a block of records at a time without branching on
+  // each one
+  while (max_count - count >= kBlockSize) {
+    const auto* block = begin + count * record_len;
+    std::uint8_t mismatch = 0;
+    for (std::size_t i = 0; i < kBlockSize; ++i) {
+      mismatch |= static_cast<std::uint8_t>(
+          std::to_integer<std::uint8_t>(block[i * record_len]) ^ length);
+    }
+    if (mismatch != 0) {
+      break;
+    }
+    count += kBlockSize;
+  }
+  while (count < max_count &&
+         std::to_integer<std::uint8_t>(begin[count * record_len]) == length) {
+    ++count;
+  }
+  return count;
+}
+
 // assumes DecodeMetadata has been called
 const databento::Record* DbnDecoder::DecodeRecord() {
+  if (decode_in_place_) {
+    return DecodeMappedRecord();
+  }
+  if (!FillRecord()) {
+    return nullptr;
+  }
+  current_record_ = Record{BufferRecordHeader()};
+  buffer_.Consume(current_record_.Size());
+  if (upgrade_record_ != nullptr &&
+      upgrade_record_(current_record_.Header(), ts_out_, compat_buffer_.data()) > 0) {
+    current_record_ = Record{reinterpret_cast<RecordHeader*>(compat_buffer_.data())};
+  }
+  return &current_record_;
+}
+
+const databento::Record* DbnDecoder::DecodeMappedRecord() {
+  const auto remaining = mapped_input_->ReadCapacity();
+  if (remaining == 0) {
+    return nullptr;
+  }
+  auto* header = MappedHeader(mapped_input_->ReadBegin());
+  if (remaining < sizeof(RecordHeader) || remaining < header->Size()) {
+    log_receiver_->Receive(LogLevel::Warning,
+                           "Unexpected partial record remaining in stream: " +
+                               std::to_string(remaining) + " bytes");
+    mapped_input_->Consume(remaining);
+    return nullptr;
+  }
+  current_record_ = Record{header};
+  mapped_input_->Consume(current_record_.Size());
+  if (upgrade_record_ != nullptr &&
+      upgrade_record_(current_record_.Header(), ts_out_, compat_buffer_.data()) > 0) {
+    current_record_ = Record{reinterpret_cast<RecordHeader*>(compat_buffer_.data())};
+  }
+  return &current_record_;
+}
+
+databento::RecordRef DbnDecoder::DecodeRecordRef() {
+  const auto* record = DecodeRecord();
+  if (record == nullptr) {
+    return {};
+  }
+  return PinRecord(*record);
+}
+
+databento::RecordRef DbnDecoder::PinRecord(const Record& record) {
+  const auto* record_begin = reinterpret_cast<const std::byte*>(&record.Header());
+  if (!decode_in_place_ && record_begin != compat_buffer_.data()) {
+    // Still in the slab backing `buffer_`, which moves to a new slab rather than
+    // overwrite it while it's pinned
+    return RecordRef{buffer_.Slab(), const_cast<RecordHeader*>(&record.Header())};
+  }
+  return ref_copier_.Copy(*slab_pool_, record);
+}
+
+// assumes DecodeMetadata has been called
+const databento::RecordBatch& DbnDecoder::DecodeBatch() {
+  batch_.records_.clear();
+  compat_batch_buffer_.Clear();
+  if (decode_in_place_) {
+    // Bound batches from the mapping to the same size as buffered ones
+    auto* begin = reinterpret_cast<std::byte*>(MappedHeader(mapped_input_->ReadBegin()));
+    const auto* end =
+        begin + std::min(mapped_input_->ReadCapacity(), buffer_.Capacity());
+    mapped_input_->Consume(BatchRecords(begin, end));
+    if (batch_.Empty()) {
+      // Logs and discards any partial record
+      DecodeMappedRecord();
+    }
+    return batch_;
+  }
+  if (FillRecord()) {
+    buffer_.Consume(BatchRecords(buffer_.ReadBegin(), buffer_.ReadEnd()));
+  }
+  return batch_;
+}
+
+bool DbnDecoder::FillRecord() {
   // need some unread unread_bytes
   if (buffer_.ReadCapacity() == 0) {
     if (FillBuffer() == 0) {
-      return nullptr;
+      return false;
     }
   }
   // check length
@@ -303,16 +760,46 @@ const databento::Record* DbnDecoder::DecodeRecord() {
                                "Unexpected partial record remaining in stream: " +
                                    std::to_string(buffer_.ReadCapacity()) + " bytes");
       }
-      return nullptr;
+      return false;
     }
   }
-  current_record_ = Record{BufferRecordHeader()};
-  buffer_.Consume(current_record_.Size());
-  if (needs_upgrade_) {
-    current_record_ = DbnDecoder::DecodeRecordCompat(version_, upgrade_policy_, ts_out_,
-                                                     &compat_buffer_, current_record_);
+  return true;
+}
+
+std::size_t DbnDecoder::BatchRecords(std::byte* begin, const std::byte* end) {
+  auto* pos = begin;
+  const auto fixed_record_len = fixed_records_.RecordLength();
+  const auto fixed_count = fixed_records_.Count(pos, end);
+  for (std::size_t i = 0; i < fixed_count; ++i) {
+    batch_.records_.emplace_back(reinterpret_cast<RecordHeader*>(pos));
+    pos += fixed_record_len;
   }
-  return &current_record_;
+  while (static_cast<std::size_t>(end - pos) >= sizeof(RecordHeader)) {
+    auto* header = reinterpret_cast<RecordHeader*>(pos);
+    const auto size = header->Size();
+    if (size < sizeof(RecordHeader)) {
+      throw DbnResponseError{"Invalid record with length " + std::to_string(size)};
+    }
+    if (static_cast<std::size_t>(end - pos) < size) {
+      break;
+    }
+    Record rec{header};
+    if (upgrade_record_ != nullptr) {
+      // Records are upgraded directly into batch-owned storage
+      if (compat_batch_buffer_.WriteCapacity() < kMaxRecordLen) {
+        break;
+      }
+      auto* upgraded = compat_batch_buffer_.WriteBegin();
+      const auto upgraded_len = upgrade_record_(*header, ts_out_, upgraded);
+      if (upgraded_len > 0) {
+        compat_batch_buffer_.Fill(upgraded_len);
+        rec = Record{reinterpret_cast<RecordHeader*>(upgraded)};
+      }
+    }
+    batch_.records_.push_back(rec);
+    pos += size;
+  }
+  return static_cast<std::size_t>(pos - begin);
 }
 
 size_t DbnDecoder::FillBuffer() {
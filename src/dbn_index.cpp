@@ -0,0 +1,300 @@
+#include "databento/dbn_index.hpp"
+
+#include <zstd.h>
+
+#include <algorithm>  // max, min, upper_bound
+#include <array>
+#include <chrono>  // nanoseconds
+#include <deque>
+#include <memory>  // unique_ptr
+#include <string>  // to_string
+#include <utility>  // move, pair
+
+#include "databento/constants.hpp"  // kUndefTimestamp
+#include "databento/dbn_decoder.hpp"
+#include "databento/detail/buffer.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/file_stream.hpp"
+#include "databento/record.hpp"  // kMaxRecordLen, Record, RecordHeader
+#include "dbn_constants.hpp"
+
+using databento::DbnIndex;
+using databento::DbnIndexer;
+
+namespace {
+constexpr std::array<char, 6> kIndexMagic{'D', 'B', 'N', 'I', 'D', 'X'};
+constexpr std::uint8_t kIndexVersion = 1;
+// Magic, version, compression, file size, and checkpoint count
+constexpr std::size_t kHeaderSize = kIndexMagic.size() + 2 + 2 * sizeof(std::uint64_t);
+constexpr std::size_t kCheckpointSize = 4 * sizeof(std::uint64_t);
+
+template <typename T>
+void WriteAsBytes(T value, databento::IWritable* output) {
+  output->WriteAll(reinterpret_cast<const std::byte*>(&value), sizeof(value));
+}
+
+template <typename T>
+T ReadAsBytes(databento::IReadable* input) {
+  T value;
+  input->ReadExact(reinterpret_cast<std::byte*>(&value), sizeof(value));
+  return value;
+}
+
+// Reads the DBN data in a file, decompressing it if necessary, while tracking where
+// each Zstd frame starts in both the file and the decompressed data.
+class DbnFileReader {
+ public:
+  struct Frame {
+    std::uint64_t offset;
+    std::uint64_t data_offset;
+  };
+
+  explicit DbnFileReader(const std::filesystem::path& path)
+      : file_{path}, z_dstream_{::ZSTD_createDStream(), ::ZSTD_freeDStream} {
+    std::uint32_t magic{};
+    file_.ReadExact(reinterpret_cast<std::byte*>(&magic), sizeof(magic));
+    file_.Seek(0);
+    is_compressed_ = magic == databento::kZstdMagicNumber;
+    if (is_compressed_) {
+      ::ZSTD_initDStream(z_dstream_.get());
+      in_buffer_.resize(::ZSTD_DStreamInSize());
+    }
+  }
+
+  bool IsCompressed() const { return is_compressed_; }
+
+  // Reads at most `max_length` bytes of DBN data. Returns 0 at the end of the file.
+  std::size_t Read(std::byte* buffer, std::size_t max_length) {
+    if (!is_compressed_) {
+      return file_.ReadSome(buffer, max_length);
+    }
+    ZSTD_outBuffer z_out_buffer{buffer, max_length, 0};
+    while (z_out_buffer.pos == 0) {
+      if (z_in_buffer_.pos == z_in_buffer_.size) {
+        in_offset_ += z_in_buffer_.size;
+        const auto read_size = file_.ReadSome(in_buffer_.data(), in_buffer_.size());
+        if (read_size == 0) {
+          break;
+        }
+        z_in_buffer_ = {in_buffer_.data(), read_size, 0};
+      }
+      if (is_frame_start_) {
+        frames_.push_back(
+            {in_offset_ + z_in_buffer_.pos, data_offset_ + z_out_buffer.pos});
+        is_frame_start_ = false;
+      }
+      const auto res =
+          ::ZSTD_decompressStream(z_dstream_.get(), &z_out_buffer, &z_in_buffer_);
+      if (::ZSTD_isError(res)) {
+        throw databento::DbnResponseError{std::string{"Zstd error decompressing: "} +
+                                          ::ZSTD_getErrorName(res)};
+      }
+      // The frame has been fully decompressed and flushed
+      is_frame_start_ = res == 0;
+    }
+    data_offset_ += z_out_buffer.pos;
+    return z_out_buffer.pos;
+  }
+
+  // Returns the last frame starting at or before `data_offset`, which must have
+  // already been read. Offsets must be passed in increasing order.
+  Frame FrameAt(std::uint64_t data_offset) {
+    if (!is_compressed_) {
+      return {data_offset, data_offset};
+    }
+    while (frames_.size() > 1 && frames_[1].data_offset <= data_offset) {
+      frames_.pop_front();
+    }
+    return frames_.front();
+  }
+
+ private:
+  databento::InFileStream file_;
+  bool is_compressed_{};
+  std::unique_ptr<ZSTD_DStream, std::size_t (*)(ZSTD_DStream*)> z_dstream_;
+  std::vector<std::byte> in_buffer_;
+  ZSTD_inBuffer z_in_buffer_{nullptr, 0, 0};
+  // The file offset of `in_buffer_`
+  std::uint64_t in_offset_{};
+  // The total decompressed size returned by `Read`
+  std::uint64_t data_offset_{};
+  bool is_frame_start_{true};
+  std::deque<Frame> frames_;
+};
+}  // namespace
+
+bool databento::operator==(const DbnCheckpoint& lhs, const DbnCheckpoint& rhs) {
+  return lhs.ts == rhs.ts && lhs.offset == rhs.offset &&
+         lhs.frame_offset == rhs.frame_offset &&
+         lhs.frame_data_offset == rhs.frame_data_offset;
+}
+
+std::filesystem::path DbnIndex::SidecarPath(const std::filesystem::path& dbn_path) {
+  auto res = dbn_path;
+  res += ".idx";
+  return res;
+}
+
+DbnIndex DbnIndex::Read(const std::filesystem::path& index_path) {
+  InFileStream input{index_path};
+  std::array<char, kIndexMagic.size()> magic{};
+  input.ReadExact(reinterpret_cast<std::byte*>(magic.data()), magic.size());
+  if (magic != kIndexMagic) {
+    throw DbnResponseError{"Missing DBN index prefix in " + index_path.string()};
+  }
+  const auto version = ReadAsBytes<std::uint8_t>(&input);
+  if (version != kIndexVersion) {
+    throw DbnResponseError{"Can't read version " + std::to_string(version) +
+                           " DBN index, expected version " +
+                           std::to_string(kIndexVersion)};
+  }
+  const auto is_compressed = ReadAsBytes<std::uint8_t>(&input) != 0;
+  const auto file_size = ReadAsBytes<std::uint64_t>(&input);
+  const auto checkpoint_count = ReadAsBytes<std::uint64_t>(&input);
+  if (std::filesystem::file_size(index_path) !=
+      kHeaderSize + checkpoint_count * kCheckpointSize) {
+    throw DbnResponseError{"DBN index " + index_path.string() +
+                           " is truncated or corrupted"};
+  }
+  std::vector<DbnCheckpoint> checkpoints;
+  checkpoints.reserve(checkpoint_count);
+  for (std::uint64_t i = 0; i < checkpoint_count; ++i) {
+    DbnCheckpoint checkpoint{};
+    checkpoint.ts =
+        UnixNanos{std::chrono::nanoseconds{ReadAsBytes<std::uint64_t>(&input)}};
+    checkpoint.offset = ReadAsBytes<std::uint64_t>(&input);
+    checkpoint.frame_offset = ReadAsBytes<std::uint64_t>(&input);
+    checkpoint.frame_data_offset = ReadAsBytes<std::uint64_t>(&input);
+    checkpoints.emplace_back(checkpoint);
+  }
+  if (checkpoints.empty()) {
+    throw DbnResponseError{"DBN index has no checkpoints"};
+  }
+  return DbnIndex{is_compressed, file_size, std::move(checkpoints)};
+}
+
+DbnIndex::DbnIndex(bool is_compressed, std::uint64_t file_size,
+                   std::vector<DbnCheckpoint> checkpoints)
+    : is_compressed_{is_compressed},
+      file_size_{file_size},
+      checkpoints_{std::move(checkpoints)} {
+  if (checkpoints_.empty()) {
+    throw InvalidArgumentError{"DbnIndex::DbnIndex", "checkpoints",
+                               "must contain at least one checkpoint"};
+  }
+}
+
+void DbnIndex::Write(const std::filesystem::path& index_path) const {
+  // Buffered so each checkpoint isn't a separate write to the file
+  detail::Buffer buffer{kHeaderSize + checkpoints_.size() * kCheckpointSize};
+  buffer.WriteAll(kIndexMagic.data(), kIndexMagic.size());
+  WriteAsBytes(kIndexVersion, &buffer);
+  WriteAsBytes(static_cast<std::uint8_t>(is_compressed_), &buffer);
+  WriteAsBytes(file_size_, &buffer);
+  const std::uint64_t checkpoint_count = checkpoints_.size();
+  WriteAsBytes(checkpoint_count, &buffer);
+  for (const auto& checkpoint : checkpoints_) {
+    WriteAsBytes(checkpoint.ts.time_since_epoch().count(), &buffer);
+    WriteAsBytes(checkpoint.offset, &buffer);
+    WriteAsBytes(checkpoint.frame_offset, &buffer);
+    WriteAsBytes(checkpoint.frame_data_offset, &buffer);
+  }
+  OutFileStream output{index_path};
+  output.WriteAll(buffer.ReadBegin(), buffer.ReadCapacity());
+}
+
+const databento::DbnCheckpoint& DbnIndex::Find(UnixNanos ts) const {
+  // Checkpoint timestamps are non-decreasing because each is the latest timestamp
+  // before it
+  const auto it = std::upper_bound(
+      checkpoints_.begin(), checkpoints_.end(), ts,
+      [](UnixNanos lhs, const DbnCheckpoint& rhs) { return lhs <= rhs.ts; });
+  return it == checkpoints_.begin() ? checkpoints_.front() : *(it - 1);
+}
+
+DbnIndexer::DbnIndexer() : DbnIndexer{kDefaultCheckpointInterval} {}
+
+DbnIndexer::DbnIndexer(std::size_t checkpoint_interval)
+    : checkpoint_interval_{checkpoint_interval} {
+  if (checkpoint_interval_ == 0) {
+    throw InvalidArgumentError{"DbnIndexer::DbnIndexer", "checkpoint_interval",
+                               "must be greater than 0"};
+  }
+}
+
+DbnIndex DbnIndexer::Index(const std::filesystem::path& dbn_path) const {
+  DbnFileReader reader{dbn_path};
+  detail::Buffer buffer{};
+  // Returns false if the end of the file is reached before `size` bytes are
+  // buffered
+  const auto fill_to = [&reader, &buffer](std::size_t size) {
+    while (buffer.ReadCapacity() < size) {
+      buffer.ShiftForSpace(std::max(size, kMaxRecordLen));
+      const auto read_size = reader.Read(buffer.WriteBegin(), buffer.WriteCapacity());
+      if (read_size == 0) {
+        return false;
+      }
+      buffer.Fill(read_size);
+    }
+    return true;
+  };
+
+  if (!fill_to(kMetadataPreludeSize)) {
+    throw DbnResponseError{"Unexpected end of file reading metadata from " +
+                           dbn_path.string()};
+  }
+  const auto metadata_size =
+      kMetadataPreludeSize + DbnDecoder::DecodeMetadataVersionAndSize(
+                                 buffer.ReadBegin(), buffer.ReadCapacity())
+                                 .second;
+  // The offset of `buffer.ReadBegin()` in the DBN data
+  std::uint64_t offset{};
+  while (offset < metadata_size) {
+    if (buffer.ReadCapacity() == 0 && !fill_to(1)) {
+      throw DbnResponseError{"Unexpected end of file reading metadata from " +
+                             dbn_path.string()};
+    }
+    const auto consume_size = std::min<std::uint64_t>(metadata_size - offset,
+                                                      buffer.ReadCapacity());
+    buffer.Consume(consume_size);
+    offset += consume_size;
+  }
+  // Metadata may leave the buffer misaligned
+  buffer.Shift();
+
+  std::vector<DbnCheckpoint> checkpoints;
+  UnixNanos max_ts{};
+  std::size_t record_count{};
+  while (fill_to(sizeof(RecordHeader))) {
+    const Record record{reinterpret_cast<RecordHeader*>(buffer.ReadBegin())};
+    const auto size = record.Size();
+    if (size < sizeof(RecordHeader)) {
+      throw DbnResponseError{"Invalid record with length " + std::to_string(size) +
+                             " at offset " + std::to_string(offset)};
+    }
+    if (!fill_to(size)) {
+      // Partial record at the end of the file
+      break;
+    }
+    if (record_count % checkpoint_interval_ == 0) {
+      const auto frame = reader.FrameAt(offset);
+      checkpoints.push_back({max_ts, offset, frame.offset, frame.data_offset});
+    }
+    // `fill_to` may have moved the record
+    const auto ts =
+        Record{reinterpret_cast<RecordHeader*>(buffer.ReadBegin())}.IndexTs();
+    if (ts.time_since_epoch().count() != kUndefTimestamp) {
+      max_ts = std::max(max_ts, ts);
+    }
+    buffer.Consume(size);
+    offset += size;
+    ++record_count;
+  }
+  if (checkpoints.empty()) {
+    // No records, but still resume after the metadata
+    const auto frame = reader.FrameAt(offset);
+    checkpoints.push_back({max_ts, offset, frame.offset, frame.data_offset});
+  }
+  return DbnIndex{reader.IsCompressed(), std::filesystem::file_size(dbn_path),
+                  std::move(checkpoints)};
+}
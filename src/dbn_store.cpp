@@ -1,24 +1,45 @@
 #include "databento/dbn_store.hpp"
 
-#include <memory>   // unique_ptr
-#include <utility>  // move
+#include <cstddef>     // size_t
+#include <filesystem>  // file_size
+#include <memory>      // unique_ptr
+#include <utility>     // move
 
+#include "databento/exceptions.hpp"  // Exception, InvalidArgumentError
 #include "databento/file_stream.hpp"
 #include "databento/record.hpp"
 
 using databento::DbnStore;
 
 DbnStore::DbnStore(const std::filesystem::path& file_path)
-    : decoder_{ILogReceiver::Default(), InFileStream{file_path}} {}
+    : file_path_{file_path},
+      decoder_{ILogReceiver::Default(), InFileStream{file_path}} {}
 
 DbnStore::DbnStore(ILogReceiver* log_receiver, const std::filesystem::path& file_path,
                    VersionUpgradePolicy upgrade_policy)
-    : decoder_{log_receiver, std::make_unique<InFileStream>(file_path),
-               upgrade_policy} {}
+    : DbnStore{log_receiver, file_path, upgrade_policy, DecodeConf{}} {}
+
+DbnStore::DbnStore(ILogReceiver* log_receiver, const std::filesystem::path& file_path,
+                   VersionUpgradePolicy upgrade_policy, DecodeConf decode_conf)
+    : file_path_{file_path},
+      decoder_{log_receiver, std::make_unique<InFileStream>(file_path), upgrade_policy,
+               decode_conf} {}
 
 DbnStore::DbnStore(ILogReceiver* log_receiver, std::unique_ptr<IReadable> input,
                    VersionUpgradePolicy upgrade_policy)
-    : decoder_{log_receiver, std::move(input), upgrade_policy} {}
+    : DbnStore{log_receiver, std::move(input), upgrade_policy, DecodeConf{}} {}
+
+DbnStore::DbnStore(ILogReceiver* log_receiver, std::unique_ptr<IReadable> input,
+                   VersionUpgradePolicy upgrade_policy, DecodeConf decode_conf)
+    : decoder_{log_receiver, std::move(input), upgrade_policy, decode_conf} {}
+
+DbnStore::DbnStore(ILogReceiver* log_receiver, InMmapFileStream file_stream,
+                   VersionUpgradePolicy upgrade_policy)
+    : DbnStore{log_receiver, std::move(file_stream), upgrade_policy, DecodeConf{}} {}
+
+DbnStore::DbnStore(ILogReceiver* log_receiver, InMmapFileStream file_stream,
+                   VersionUpgradePolicy upgrade_policy, DecodeConf decode_conf)
+    : decoder_{log_receiver, std::move(file_stream), upgrade_policy, decode_conf} {}
 
 void DbnStore::Replay(const MetadataCallback& metadata_callback,
                       const RecordCallback& record_callback) {
@@ -26,10 +47,15 @@ void DbnStore::Replay(const MetadataCallback& metadata_callback,
   if (metadata_callback) {
     metadata_callback(std::move(metadata));
   }
-  const databento::Record* record;
-  while ((record = decoder_.DecodeRecord()) != nullptr) {
-    if (record_callback(*record) == KeepGoing::Stop) {
-      break;
+  while (true) {
+    const auto& batch = decoder_.DecodeBatch();
+    if (batch.Empty()) {
+      return;
+    }
+    for (const auto& record : batch) {
+      if (record_callback(record) == KeepGoing::Stop) {
+        return;
+      }
     }
   }
 }
@@ -48,6 +74,53 @@ const databento::Record* DbnStore::NextRecord() {
   return decoder_.DecodeRecord();
 }
 
+databento::RecordRef DbnStore::NextRecordRef() {
+  MaybeDecodeMetadata();
+  return decoder_.DecodeRecordRef();
+}
+
+const databento::RecordBatch& DbnStore::NextBatch() {
+  MaybeDecodeMetadata();
+  return decoder_.DecodeBatch();
+}
+
+void DbnStore::SeekTo(UnixNanos ts) {
+  CheckSeekable();
+  if (!index_) {
+    index_ = DbnIndex::Read(DbnIndex::SidecarPath(file_path_));
+  }
+  SeekTo(*index_, ts);
+}
+
+void DbnStore::SeekTo(const DbnIndex& index, UnixNanos ts) {
+  static constexpr auto kMethodName = "DbnStore::SeekTo";
+  CheckSeekable();
+  if (std::filesystem::file_size(file_path_) != index.FileSize()) {
+    throw InvalidArgumentError{
+        kMethodName, "index",
+        "Index doesn't match the current contents of " + file_path_.string()};
+  }
+  MaybeDecodeMetadata();
+  const auto& checkpoint = index.Find(ts);
+  auto input = std::make_unique<InFileStream>(file_path_);
+  input->Seek(checkpoint.frame_offset);
+  // The distance within a single frame, so it fits in memory
+  const std::size_t skip_size = checkpoint.offset - checkpoint.frame_data_offset;
+  decoder_.ResetInput(std::move(input), skip_size);
+  decoder_.SkipBefore(ts);
+}
+
+databento::ReadAheadStats DbnStore::ReadAheadStats() const {
+  return decoder_.ReadAheadStats();
+}
+
+void DbnStore::CheckSeekable() const {
+  if (file_path_.empty()) {
+    throw Exception{"Seeking is only supported by a DbnStore constructed from a file "
+                    "path"};
+  }
+}
+
 void DbnStore::MaybeDecodeMetadata() {
   if (!has_decoded_metadata_) {
     metadata_ = decoder_.DecodeMetadata();
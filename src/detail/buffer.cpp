@@ -60,6 +60,10 @@ void Buffer::Reserve(std::size_t capacity) {
   if (capacity <= Capacity()) {
     return;
   }
+  if (slab_pool_) {
+    MoveToSlab(slab_pool_->Acquire(capacity));
+    return;
+  }
   UniqueBufPtr new_buf{AlignedNew(capacity), AlignedDelete};
   const auto unread_bytes = ReadCapacity();
   std::copy(ReadBegin(), ReadEnd(), new_buf.get());
@@ -69,7 +73,21 @@ void Buffer::Reserve(std::size_t capacity) {
   write_pos_ = read_pos_ + unread_bytes;
 }
 
+void Buffer::Clear() {
+  read_pos_ = buf_.get();
+  write_pos_ = buf_.get();
+  if (IsSlabShared()) {
+    MoveToSlab(slab_pool_->Acquire(slab_pool_->SlabSize()));
+  }
+}
+
 void Buffer::Shift() {
+  if (IsSlabShared()) {
+    // Returns to a regular slab if `Reserve` moved to a larger one
+    MoveToSlab(
+        slab_pool_->Acquire(std::max(ReadCapacity(), slab_pool_->SlabSize())));
+    return;
+  }
   const auto unread_bytes = ReadCapacity();
   if (unread_bytes) {
     std::copy(ReadBegin(), ReadEnd(), buf_.get());
@@ -78,6 +96,16 @@ void Buffer::Shift() {
   write_pos_ = read_pos_ + unread_bytes;
 }
 
+void Buffer::MoveToSlab(SlabRef slab) {
+  const auto unread_bytes = ReadCapacity();
+  std::copy(ReadBegin(), ReadEnd(), slab.Get()->Data());
+  slab_ = std::move(slab);
+  buf_ = UniqueBufPtr{slab_.Get()->Data(), NoDelete};
+  end_ = buf_.get() + slab_.Get()->Size();
+  read_pos_ = buf_.get();
+  write_pos_ = read_pos_ + unread_bytes;
+}
+
 namespace databento::detail {
 std::ostream& operator<<(std::ostream& stream, const Buffer& buffer) {
   return StreamOpBuilder{stream}
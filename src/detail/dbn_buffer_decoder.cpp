@@ -25,7 +25,7 @@ databento::KeepGoing DbnBufferDecoder::Process(const char* data, std::size_t len
         std::tie(input_version_, bytes_needed_) =
             DbnDecoder::DecodeMetadataVersionAndSize(dbn_buffer_.ReadBegin(),
                                                      dbn_buffer_.ReadCapacity());
-        needs_upgrade_ = DbnDecoder::NeedsUpgrade(upgrade_policy_, input_version_);
+        upgrade_record_ = DbnDecoder::SelectUpgrade(input_version_, upgrade_policy_);
         dbn_buffer_.Consume(kMetadataPreludeSize);
         dbn_buffer_.Reserve(bytes_needed_);
         state_ = DecoderState::Metadata;
@@ -42,6 +42,8 @@ databento::KeepGoing DbnBufferDecoder::Process(const char* data, std::size_t len
         // alignment
         dbn_buffer_.Shift();
         ts_out_ = metadata.ts_out;
+        fixed_records_.Init(input_version_, metadata.schema, ts_out_,
+                            upgrade_record_ != nullptr);
         metadata.Upgrade(upgrade_policy_);
         if (metadata_callback_) {
           metadata_callback_(std::move(metadata));
@@ -50,6 +52,16 @@ databento::KeepGoing DbnBufferDecoder::Process(const char* data, std::size_t len
         [[fallthrough]];
       }
       case DecoderState::Records: {
+        const auto fixed_record_len = fixed_records_.RecordLength();
+        const auto fixed_count =
+            fixed_records_.Count(dbn_buffer_.ReadBegin(), dbn_buffer_.ReadEnd());
+        for (std::size_t i = 0; i < fixed_count; ++i) {
+          const Record record{reinterpret_cast<RecordHeader*>(dbn_buffer_.ReadBegin())};
+          if (record_callback_(record) == KeepGoing::Stop) {
+            return KeepGoing::Stop;
+          }
+          dbn_buffer_.Consume(fixed_record_len);
+        }
         while (dbn_buffer_.ReadCapacity() > 0) {
           auto record =
               Record{reinterpret_cast<RecordHeader*>(dbn_buffer_.ReadBegin())};
@@ -57,9 +69,9 @@ databento::KeepGoing DbnBufferDecoder::Process(const char* data, std::size_t len
           if (dbn_buffer_.ReadCapacity() < bytes_needed_) {
             break;
           }
-          if (needs_upgrade_) {
-            record = DbnDecoder::DecodeRecordCompat(input_version_, upgrade_policy_,
-                                                    ts_out_, &compat_buffer_, record);
+          if (upgrade_record_ != nullptr &&
+              upgrade_record_(record.Header(), ts_out_, compat_buffer_.data()) > 0) {
+            record = Record{reinterpret_cast<RecordHeader*>(compat_buffer_.data())};
           }
           if (record_callback_(record) == KeepGoing::Stop) {
             return KeepGoing::Stop;
@@ -81,7 +93,8 @@ std::ostream& operator<<(std::ostream& stream, const DbnBufferDecoder& buffer) {
       .AddField("bytes_needed_", buffer.bytes_needed_)
       .AddField("input_version_", buffer.input_version_)
       .AddField("ts_out_", buffer.ts_out_)
-      .AddField("needs_upgrade_", buffer.needs_upgrade_)
+      .AddField("needs_upgrade_", buffer.upgrade_record_ != nullptr)
+      .AddField("fixed_record_len", buffer.fixed_records_.RecordLength())
       .AddField("state_", buffer.state_)
       .Finish();
 }
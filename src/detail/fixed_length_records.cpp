@@ -0,0 +1,26 @@
+#include "databento/detail/fixed_length_records.hpp"
+
+#include "databento/dbn_decoder.hpp"
+#include "databento/record.hpp"  // RecordHeader
+
+using databento::detail::FixedLengthRecords;
+
+void FixedLengthRecords::Init(std::uint8_t version, std::optional<Schema> schema,
+                              bool ts_out, bool needs_upgrade) {
+  record_len_ =
+      needs_upgrade ? 0 : DbnDecoder::FixedRecordLength(version, schema, ts_out);
+}
+
+std::size_t FixedLengthRecords::Count(const std::byte* begin, const std::byte* end) {
+  if (record_len_ == 0) {
+    return 0;
+  }
+  const auto count = DbnDecoder::CountFixedLengthRecords(begin, end, record_len_);
+  const auto* next = begin + count * record_len_;
+  if (static_cast<std::size_t>(end - next) >= sizeof(RecordHeader) &&
+      reinterpret_cast<const RecordHeader*>(next)->Size() != record_len_) {
+    // Fall back to reading the length of each record for the rest of the input
+    record_len_ = 0;
+  }
+  return count;
+}
@@ -0,0 +1,524 @@
+#include "detail/io_uring.hpp"
+
+#ifdef DATABENTO_IO_URING
+
+#include <fcntl.h>        // open, posix_fadvise, O_CLOEXEC, O_RDONLY
+#include <sys/mman.h>     // mmap, munmap
+#include <sys/stat.h>     // fstat
+#include <sys/syscall.h>  // __NR_io_uring_*
+#include <sys/utsname.h>  // uname, utsname
+#include <unistd.h>       // syscall
+
+#include <algorithm>  // copy, max, min
+#include <cerrno>     // errno
+#include <cstdio>     // sscanf
+#include <cstring>    // memset, strerror
+#include <string>
+
+#include "databento/exceptions.hpp"  // Exception, InvalidArgumentError, TcpError
+
+using databento::detail::IoUring;
+using Status = databento::IReadable::Status;
+
+namespace {
+[[noreturn]] void ThrowErrNo(const std::string& message, int err_num) {
+  throw databento::Exception{message + ": " + std::strerror(err_num)};
+}
+}  // namespace
+
+IoUring::IoUring(std::uint32_t entries, std::uint32_t cq_entries) {
+  ::io_uring_params params{};
+  if (cq_entries > 0) {
+    params.flags |= IORING_SETUP_CQSIZE;
+    params.cq_entries = cq_entries;
+  }
+  ring_fd_ =
+      ScopedFd{static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params))};
+  if (ring_fd_.Get() == ScopedFd::kUnset) {
+    ThrowErrNo("Failed to set up io_uring", errno);
+  }
+  if ((params.features & IORING_FEAT_SINGLE_MMAP) == 0 ||
+      (params.features & IORING_FEAT_EXT_ARG) == 0) {
+    throw Exception{"io_uring requires Linux 5.11 or later"};
+  }
+  // The submission and completion rings share a single mapping
+  ring_size_ =
+      (std::max)(params.sq_off.array + params.sq_entries * sizeof(std::uint32_t),
+                 params.cq_off.cqes + params.cq_entries * sizeof(::io_uring_cqe));
+  void* ring = ::mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring_fd_.Get(), IORING_OFF_SQ_RING);
+  if (ring == MAP_FAILED) {
+    ThrowErrNo("Failed to map io_uring", errno);
+  }
+  ring_ = ring;
+  sqes_size_ = params.sq_entries * sizeof(::io_uring_sqe);
+  void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring_fd_.Get(), IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    const int err_num = errno;
+    ::munmap(ring_, ring_size_);
+    ThrowErrNo("Failed to map io_uring", err_num);
+  }
+  sqes_ = static_cast<::io_uring_sqe*>(sqes);
+
+  auto* base = static_cast<std::byte*>(ring_);
+  const auto field = [base](std::uint32_t offset) {
+    return reinterpret_cast<std::uint32_t*>(base + offset);
+  };
+  sq_head_ = field(params.sq_off.head);
+  sq_tail_ = field(params.sq_off.tail);
+  sq_mask_ = *field(params.sq_off.ring_mask);
+  sq_entries_ = params.sq_entries;
+  // Each slot in the submission ring always refers to the entry at the same index
+  auto* sq_array = field(params.sq_off.array);
+  for (std::uint32_t i = 0; i < sq_entries_; ++i) {
+    sq_array[i] = i;
+  }
+  cq_head_ = field(params.cq_off.head);
+  cq_tail_ = field(params.cq_off.tail);
+  cq_mask_ = *field(params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<::io_uring_cqe*>(base + params.cq_off.cqes);
+}
+
+IoUring::~IoUring() {
+  ::munmap(sqes_, sqes_size_);
+  ::munmap(ring_, ring_size_);
+}
+
+::io_uring_sqe* IoUring::GetSqe() {
+  auto tail = *sq_tail_ + sq_queued_;
+  if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+    Submit();
+    tail = *sq_tail_;
+    if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+      throw Exception{"io_uring submission queue is full"};
+    }
+  }
+  auto* sqe = &sqes_[tail & sq_mask_];
+  std::memset(sqe, 0, sizeof(*sqe));
+  ++sq_queued_;
+  return sqe;
+}
+
+void IoUring::Submit() {
+  // Publish the queued entries only once they've been filled
+  __atomic_store_n(sq_tail_, *sq_tail_ + sq_queued_, __ATOMIC_RELEASE);
+  sq_queued_ = 0;
+  const auto to_submit = *sq_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  if (to_submit == 0) {
+    return;
+  }
+  while (Enter(to_submit, 0, 0, nullptr, 0) < 0) {
+    if (errno != EINTR) {
+      ThrowErrNo("Failed to submit to io_uring", errno);
+    }
+  }
+}
+
+bool IoUring::SubmitAndWait(std::chrono::nanoseconds timeout) {
+  __atomic_store_n(sq_tail_, *sq_tail_ + sq_queued_, __ATOMIC_RELEASE);
+  sq_queued_ = 0;
+  const auto to_submit = *sq_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  ::__kernel_timespec ts{};
+  ::io_uring_getevents_arg arg{};
+  if (timeout.count() >= 0) {
+    ts.tv_sec = timeout.count() / 1'000'000'000;
+    ts.tv_nsec = timeout.count() % 1'000'000'000;
+    arg.ts = reinterpret_cast<std::uint64_t>(&ts);
+  }
+  if (Enter(to_submit, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg,
+            sizeof(arg)) >= 0) {
+    return true;
+  }
+  const int err_num = errno;
+  if (err_num == ETIME) {
+    return false;
+  }
+  // Interruptions are treated as spurious wakeups
+  if (err_num != EINTR) {
+    ThrowErrNo("Failed to wait on io_uring", err_num);
+  }
+  return true;
+}
+
+const ::io_uring_cqe* IoUring::PeekCqe() const {
+  const auto head = *cq_head_;
+  if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+    return nullptr;
+  }
+  return &cqes_[head & cq_mask_];
+}
+
+void IoUring::SeenCqe() {
+  __atomic_store_n(cq_head_, *cq_head_ + 1, __ATOMIC_RELEASE);
+}
+
+void IoUring::RegisterBuffers(const ::iovec* iovecs, std::uint32_t count) {
+  Register(IORING_REGISTER_BUFFERS, iovecs, count);
+}
+
+void IoUring::RegisterBufRing(const ::io_uring_buf_reg& reg) {
+  Register(IORING_REGISTER_PBUF_RING, &reg, 1);
+}
+
+void IoUring::UnregisterBufRing(std::uint16_t buf_group) {
+  ::io_uring_buf_reg reg{};
+  reg.bgid = buf_group;
+  Register(IORING_UNREGISTER_PBUF_RING, &reg, 1);
+}
+
+int IoUring::Enter(std::uint32_t to_submit, std::uint32_t min_complete,
+                   std::uint32_t flags, const void* arg, std::size_t arg_size) {
+  return static_cast<int>(::syscall(__NR_io_uring_enter, ring_fd_.Get(), to_submit,
+                                    min_complete, flags, arg, arg_size));
+}
+
+void IoUring::Register(std::uint32_t opcode, const void* arg, std::uint32_t count) {
+  if (::syscall(__NR_io_uring_register, ring_fd_.Get(), opcode, arg, count) < 0) {
+    ThrowErrNo("Failed to register with io_uring", errno);
+  }
+}
+
+using databento::detail::UringSocketReader;
+
+namespace {
+constexpr std::uint32_t kSocketRingEntries = 8;
+// Must be a power of 2
+constexpr std::uint16_t kRecvBufCount = 64;
+// Room for a completion for every receive buffer plus the cancellation, so a burst
+// filling every buffer doesn't overflow the completion ring and end the multishot
+// receive
+constexpr std::uint32_t kSocketRingCqEntries = 2 * kRecvBufCount;
+constexpr std::uint32_t kRecvBufSize = 16 * 1024;
+constexpr std::uint16_t kRecvBufGroup = 0;
+constexpr std::uint64_t kRecvTag = 1;
+constexpr std::uint64_t kCancelTag = 2;
+// How long to wait for the kernel to finish with the receive buffers on destruction
+constexpr std::chrono::seconds kCancelTimeout{1};
+
+bool IsKernelAtLeast(int major, int minor) {
+  ::utsname name{};
+  int release_major{};
+  int release_minor{};
+  if (::uname(&name) != 0 ||
+      std::sscanf(name.release, "%d.%d", &release_major, &release_minor) != 2) {
+    return false;
+  }
+  return release_major > major || (release_major == major && release_minor >= minor);
+}
+}  // namespace
+
+UringSocketReader::UringSocketReader(Socket fd)
+    : fd_{fd},
+      ring_{kSocketRingEntries, kSocketRingCqEntries},
+      bufs_{std::make_unique<std::byte[]>(std::size_t{kRecvBufCount} * kRecvBufSize)} {
+  // Multishot receive can't be probed for and older kernels only reject it once a
+  // read completes, which would be too late to fall back
+  if (!IsKernelAtLeast(6, 0)) {
+    throw Exception{"io_uring multishot receive requires Linux 6.0 or later"};
+  }
+  // The kernel requires the buffer ring to be page-aligned
+  const auto buf_ring_size = kRecvBufCount * sizeof(::io_uring_buf);
+  void* buf_ring = ::mmap(nullptr, buf_ring_size, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (buf_ring == MAP_FAILED) {
+    ThrowErrNo("Failed to allocate io_uring buffer ring", errno);
+  }
+  buf_ring_ = static_cast<::io_uring_buf*>(buf_ring);
+  ::io_uring_buf_reg reg{};
+  reg.ring_addr = reinterpret_cast<std::uint64_t>(buf_ring_);
+  reg.ring_entries = kRecvBufCount;
+  reg.bgid = kRecvBufGroup;
+  try {
+    ring_.RegisterBufRing(reg);
+  } catch (...) {
+    ::munmap(buf_ring_, buf_ring_size);
+    throw;
+  }
+  for (std::uint16_t buf_id = 0; buf_id < kRecvBufCount; ++buf_id) {
+    RecycleBuffer(buf_id);
+  }
+  // Arm eagerly so the ring's descriptor polls readable as soon as data arrives
+  ArmRecv();
+}
+
+UringSocketReader::~UringSocketReader() {
+  try {
+    if (is_armed_) {
+      auto* sqe = ring_.GetSqe();
+      sqe->opcode = IORING_OP_ASYNC_CANCEL;
+      sqe->addr = kRecvTag;
+      sqe->user_data = kCancelTag;
+      // Wait for the final completion of the receive so the kernel is done with
+      // the buffers before they're freed
+      const auto deadline = std::chrono::steady_clock::now() + kCancelTimeout;
+      while (is_armed_ && std::chrono::steady_clock::now() < deadline) {
+        const auto* cqe = ring_.PeekCqe();
+        if (cqe == nullptr) {
+          ring_.SubmitAndWait(kCancelTimeout);
+          continue;
+        }
+        if (cqe->user_data == kRecvTag && (cqe->flags & IORING_CQE_F_MORE) == 0) {
+          is_armed_ = false;
+        }
+        ring_.SeenCqe();
+      }
+    }
+    ring_.UnregisterBufRing(kRecvBufGroup);
+  } catch (...) {
+  }
+  ::munmap(buf_ring_, kRecvBufCount * sizeof(::io_uring_buf));
+}
+
+bool UringSocketReader::HasBufferedData() const {
+  return pending_.has_value() || ring_.PeekCqe() != nullptr;
+}
+
+void UringSocketReader::ReadExact(std::byte* buffer, std::size_t size) {
+  std::size_t read_size = 0;
+  while (read_size < size) {
+    const auto res =
+        ReadSome(buffer + read_size, size - read_size, std::chrono::milliseconds{});
+    if (res.status == Status::Closed) {
+      throw TcpError{ECONNRESET, "Error reading from socket"};
+    }
+    read_size += res.read_size;
+  }
+}
+
+databento::IReadable::Result UringSocketReader::ReadSome(
+    std::byte* buffer, std::size_t max_size, std::chrono::milliseconds timeout) {
+  const bool has_timeout = timeout.count() > 0;
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (true) {
+    // Copy out everything that's already been received without any system calls
+    std::size_t read_size = 0;
+    while (read_size < max_size && !is_closed_) {
+      if (pending_) {
+        read_size += CopyPending(buffer + read_size, max_size - read_size);
+      } else if (!ReapCqe()) {
+        break;
+      }
+    }
+    if (!is_armed_ && !is_closed_) {
+      ArmRecv();
+    }
+    if (read_size > 0) {
+      return {read_size, Status::Ok};
+    }
+    if (is_closed_) {
+      return {0, Status::Closed};
+    }
+    std::chrono::nanoseconds wait{-1};
+    if (has_timeout) {
+      wait = deadline - std::chrono::steady_clock::now();
+      if (wait.count() <= 0) {
+        return {0, Status::Timeout};
+      }
+    }
+    if (!ring_.SubmitAndWait(wait)) {
+      return {0, Status::Timeout};
+    }
+  }
+}
+
+void UringSocketReader::ArmRecv() {
+  auto* sqe = ring_.GetSqe();
+  sqe->opcode = IORING_OP_RECV;
+  sqe->fd = fd_;
+  sqe->ioprio = IORING_RECV_MULTISHOT;
+  // Each completion picks the next buffer from the ring
+  sqe->flags = IOSQE_BUFFER_SELECT;
+  sqe->buf_group = kRecvBufGroup;
+  sqe->user_data = kRecvTag;
+  ring_.Submit();
+  is_armed_ = true;
+}
+
+std::size_t UringSocketReader::CopyPending(std::byte* buffer, std::size_t max_size) {
+  auto& pending = *pending_;
+  const auto copy_size = std::min<std::size_t>(pending.size - pending.offset, max_size);
+  const auto* begin =
+      bufs_.get() + std::size_t{pending.buf_id} * kRecvBufSize + pending.offset;
+  std::copy(begin, begin + copy_size, buffer);
+  pending.offset += static_cast<std::uint32_t>(copy_size);
+  if (pending.offset == pending.size) {
+    RecycleBuffer(pending.buf_id);
+    pending_.reset();
+  }
+  return copy_size;
+}
+
+bool UringSocketReader::ReapCqe() {
+  const auto* cqe = ring_.PeekCqe();
+  if (cqe == nullptr) {
+    return false;
+  }
+  const auto res = cqe->res;
+  const auto flags = cqe->flags;
+  const auto user_data = cqe->user_data;
+  ring_.SeenCqe();
+  if (user_data != kRecvTag) {
+    return true;
+  }
+  if ((flags & IORING_CQE_F_MORE) == 0) {
+    // Re-armed by the caller
+    is_armed_ = false;
+  }
+  if (res > 0) {
+    pending_ = Pending{static_cast<std::uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT), 0,
+                       static_cast<std::uint32_t>(res)};
+  } else if (res == 0) {
+    is_closed_ = true;
+  } else if (res != -ENOBUFS) {
+    // Running out of buffers only means the receive needs to be re-armed
+    throw TcpError{-res, "Error reading from socket"};
+  }
+  return true;
+}
+
+void UringSocketReader::RecycleBuffer(std::uint16_t buf_id) {
+  auto& buf = buf_ring_[buf_ring_tail_ & (kRecvBufCount - 1)];
+  buf.addr = reinterpret_cast<std::uint64_t>(bufs_.get() +
+                                             std::size_t{buf_id} * kRecvBufSize);
+  buf.len = kRecvBufSize;
+  buf.bid = buf_id;
+  ++buf_ring_tail_;
+  // The ring's tail overlays the reserved field of the first entry
+  __atomic_store_n(&buf_ring_[0].resv, buf_ring_tail_, __ATOMIC_RELEASE);
+}
+
+using databento::detail::UringFileReader;
+
+namespace {
+constexpr std::uint32_t kReadBlockCount = 4;
+constexpr std::uint32_t kReadBlockSize = std::uint32_t{1} << 20;
+}  // namespace
+
+UringFileReader::UringFileReader(const std::filesystem::path& file_path)
+    : file_fd_{::open(file_path.c_str(), O_RDONLY | O_CLOEXEC)},
+      ring_{kReadBlockCount},
+      bufs_{new std::byte[std::size_t{kReadBlockCount} * kReadBlockSize]},
+      blocks_(kReadBlockCount) {
+  static constexpr auto kMethodName = "InUringFileStream";
+  if (file_fd_.Get() == ScopedFd::kUnset) {
+    throw InvalidArgumentError{kMethodName, "file_path",
+                               "Non-existent or invalid file: " + file_path.string()};
+  }
+  struct ::stat file_stat {};
+  if (::fstat(file_fd_.Get(), &file_stat) != 0) {
+    throw InvalidArgumentError{kMethodName, "file_path",
+                               "Unable to get size of file: " + file_path.string()};
+  }
+  file_size_ = static_cast<std::uint64_t>(file_stat.st_size);
+  // Widens the kernel's read-ahead. Only a hint, so errors are ignored
+  ::posix_fadvise(file_fd_.Get(), 0, 0, POSIX_FADV_SEQUENTIAL);
+  // Registering the buffers saves the kernel from mapping them on every read
+  ::iovec iovecs[kReadBlockCount];
+  for (std::uint32_t i = 0; i < kReadBlockCount; ++i) {
+    iovecs[i] = {bufs_.get() + std::size_t{i} * kReadBlockSize, kReadBlockSize};
+  }
+  ring_.RegisterBuffers(iovecs, kReadBlockCount);
+  for (std::size_t i = 0; i < kReadBlockCount; ++i) {
+    StartBlock(i);
+  }
+  ring_.Submit();
+}
+
+UringFileReader::~UringFileReader() {
+  // The kernel may still be writing to the buffers
+  try {
+    for (std::size_t i = 0; i < blocks_.size(); ++i) {
+      while (blocks_[i].is_in_flight) {
+        if (const auto* cqe = ring_.PeekCqe()) {
+          blocks_[cqe->user_data].is_in_flight = false;
+          ring_.SeenCqe();
+        } else {
+          ring_.SubmitAndWait(std::chrono::nanoseconds{-1});
+        }
+      }
+    }
+  } catch (...) {
+  }
+}
+
+std::size_t UringFileReader::ReadSome(std::byte* buffer, std::size_t max_length) {
+  std::size_t read_size = 0;
+  while (read_size < max_length) {
+    WaitForBlock(head_);
+    auto& block = blocks_[head_];
+    if (block.consumed == block.size) {
+      // End of file
+      break;
+    }
+    const auto copy_size =
+        std::min<std::size_t>(block.size - block.consumed, max_length - read_size);
+    const auto* begin =
+        bufs_.get() + head_ * std::size_t{kReadBlockSize} + block.consumed;
+    std::copy(begin, begin + copy_size, buffer + read_size);
+    block.consumed += static_cast<std::uint32_t>(copy_size);
+    read_size += copy_size;
+    if (block.consumed == block.size) {
+      StartBlock(head_);
+      head_ = (head_ + 1) % blocks_.size();
+    }
+  }
+  ring_.Submit();
+  return read_size;
+}
+
+void UringFileReader::SubmitRead(std::size_t block_idx) {
+  auto& block = blocks_[block_idx];
+  auto* sqe = ring_.GetSqe();
+  sqe->opcode = IORING_OP_READ_FIXED;
+  sqe->fd = file_fd_.Get();
+  sqe->addr = reinterpret_cast<std::uint64_t>(
+      bufs_.get() + block_idx * std::size_t{kReadBlockSize} + block.filled);
+  sqe->len = block.size - block.filled;
+  sqe->off = block.file_offset + block.filled;
+  sqe->buf_index = static_cast<std::uint16_t>(block_idx);
+  sqe->user_data = block_idx;
+  block.is_in_flight = true;
+}
+
+void UringFileReader::StartBlock(std::size_t block_idx) {
+  const auto size = static_cast<std::uint32_t>(
+      std::min<std::uint64_t>(kReadBlockSize, file_size_ - next_offset_));
+  blocks_[block_idx] = {next_offset_, size, 0, 0, false};
+  next_offset_ += size;
+  if (size > 0) {
+    SubmitRead(block_idx);
+  }
+}
+
+void UringFileReader::WaitForBlock(std::size_t block_idx) {
+  ReapCqes();
+  while (blocks_[block_idx].is_in_flight) {
+    ring_.SubmitAndWait(std::chrono::nanoseconds{-1});
+    ReapCqes();
+  }
+}
+
+void UringFileReader::ReapCqes() {
+  while (const auto* cqe = ring_.PeekCqe()) {
+    const auto res = cqe->res;
+    auto& block = blocks_[cqe->user_data];
+    ring_.SeenCqe();
+    block.is_in_flight = false;
+    if (res < 0) {
+      ThrowErrNo("Error reading file", -res);
+    }
+    if (res == 0) {
+      // The file was truncated while reading
+      block.size = block.filled;
+    } else {
+      block.filled += static_cast<std::uint32_t>(res);
+    }
+    if (block.filled < block.size) {
+      // Short read
+      SubmitRead(static_cast<std::size_t>(&block - blocks_.data()));
+    }
+  }
+}
+
+#endif  // DATABENTO_IO_URING
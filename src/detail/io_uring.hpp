@@ -0,0 +1,166 @@
+#pragma once
+
+// Only available when configured with `DATABENTO_ENABLE_IO_URING`
+#ifdef DATABENTO_IO_URING
+
+#include <linux/io_uring.h>
+#include <sys/uio.h>  // iovec
+
+#include <chrono>  // milliseconds, nanoseconds
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>  // unique_ptr
+#include <optional>
+#include <vector>
+
+#include "databento/detail/scoped_fd.hpp"  // ScopedFd, Socket
+#include "databento/ireadable.hpp"
+
+namespace databento::detail {
+// A minimal wrapper around an `io_uring` instance using the raw kernel interface.
+// Requires Linux 5.11 or later for single mmap rings and waiting with a timeout.
+class IoUring {
+ public:
+  // `cq_entries` sizes the completion ring, which defaults to twice `entries`.
+  explicit IoUring(std::uint32_t entries, std::uint32_t cq_entries = 0);
+  IoUring(const IoUring&) = delete;
+  IoUring& operator=(const IoUring&) = delete;
+  IoUring(IoUring&&) = delete;
+  IoUring& operator=(IoUring&&) = delete;
+  ~IoUring();
+
+  // The ring's file descriptor, which polls readable when completions are ready.
+  int Fd() const { return ring_fd_.Get(); }
+  // Returns a zeroed submission queue entry, submitting queued entries first if the
+  // queue is full.
+  ::io_uring_sqe* GetSqe();
+  // Submits any queued entries without waiting.
+  void Submit();
+  // Submits any queued entries and waits until a completion is ready. Returns
+  // false if `timeout` elapses first. A negative timeout waits indefinitely.
+  bool SubmitAndWait(std::chrono::nanoseconds timeout);
+  // Returns the next completion without waiting, or `nullptr` if none are ready.
+  const ::io_uring_cqe* PeekCqe() const;
+  // Marks the completion returned by `PeekCqe()` as consumed.
+  void SeenCqe();
+  void RegisterBuffers(const ::iovec* iovecs, std::uint32_t count);
+  void RegisterBufRing(const ::io_uring_buf_reg& reg);
+  void UnregisterBufRing(std::uint16_t buf_group);
+
+ private:
+  int Enter(std::uint32_t to_submit, std::uint32_t min_complete, std::uint32_t flags,
+            const void* arg, std::size_t arg_size);
+  void Register(std::uint32_t opcode, const void* arg, std::uint32_t count);
+
+  ScopedFd ring_fd_;
+  void* ring_{};
+  std::size_t ring_size_{};
+  ::io_uring_sqe* sqes_{};
+  std::size_t sqes_size_{};
+  std::uint32_t* sq_head_{};
+  std::uint32_t* sq_tail_{};
+  std::uint32_t sq_mask_{};
+  std::uint32_t sq_entries_{};
+  // Entries filled by `GetSqe()` that haven't been submitted
+  std::uint32_t sq_queued_{};
+  std::uint32_t* cq_head_{};
+  std::uint32_t* cq_tail_{};
+  ::io_uring_cqe* cqes_{};
+  std::uint32_t cq_mask_{};
+};
+
+// Receives from a connected socket with a single multishot `recv` into a ring of
+// kernel-provided buffers, so data that has already arrived is read without any
+// system calls. Requires Linux 6.0 or later.
+class UringSocketReader {
+ public:
+  explicit UringSocketReader(Socket fd);
+  UringSocketReader(const UringSocketReader&) = delete;
+  UringSocketReader& operator=(const UringSocketReader&) = delete;
+  UringSocketReader(UringSocketReader&&) = delete;
+  UringSocketReader& operator=(UringSocketReader&&) = delete;
+  ~UringSocketReader();
+
+  // The descriptor to poll for readability in place of the socket.
+  int Fd() const { return ring_.Fd(); }
+  // Whether data has been received that hasn't been read.
+  bool HasBufferedData() const;
+  void ReadExact(std::byte* buffer, std::size_t size);
+  // A timeout of 0 blocks until data is available or the socket is closed.
+  IReadable::Result ReadSome(std::byte* buffer, std::size_t max_size,
+                             std::chrono::milliseconds timeout);
+
+ private:
+  struct Pending {
+    std::uint16_t buf_id;
+    std::uint32_t offset;
+    std::uint32_t size;
+  };
+
+  void ArmRecv();
+  // Copies out of the buffer currently being read, recycling it once it's empty.
+  std::size_t CopyPending(std::byte* buffer, std::size_t max_size);
+  // Handles the next completion. Returns false if none are ready.
+  bool ReapCqe();
+  void RecycleBuffer(std::uint16_t buf_id);
+
+  const Socket fd_;
+  IoUring ring_;
+  std::unique_ptr<std::byte[]> bufs_;
+  ::io_uring_buf* buf_ring_{};
+  std::uint16_t buf_ring_tail_{};
+  // The received buffer currently being read
+  std::optional<Pending> pending_;
+  bool is_armed_{};
+  bool is_closed_{};
+};
+
+// Reads a file sequentially with several reads into registered buffers kept in
+// flight ahead of the reader.
+class UringFileReader {
+ public:
+  explicit UringFileReader(const std::filesystem::path& file_path);
+  UringFileReader(const UringFileReader&) = delete;
+  UringFileReader& operator=(const UringFileReader&) = delete;
+  UringFileReader(UringFileReader&&) = delete;
+  UringFileReader& operator=(UringFileReader&&) = delete;
+  ~UringFileReader();
+
+  // Returns 0 only at the end of the file.
+  std::size_t ReadSome(std::byte* buffer, std::size_t max_length);
+
+ private:
+  struct Block {
+    std::uint64_t file_offset;
+    std::uint32_t size;
+    std::uint32_t filled;
+    std::uint32_t consumed;
+    bool is_in_flight;
+  };
+
+  void SubmitRead(std::size_t block_idx);
+  void StartBlock(std::size_t block_idx);
+  void WaitForBlock(std::size_t block_idx);
+  void ReapCqes();
+
+  ScopedFd file_fd_;
+  std::uint64_t file_size_{};
+  std::uint64_t next_offset_{};
+  IoUring ring_;
+  std::unique_ptr<std::byte[]> bufs_;
+  std::vector<Block> blocks_;
+  std::size_t head_{};
+};
+}  // namespace databento::detail
+
+#else
+
+namespace databento::detail {
+// Never constructed without io_uring support, but complete so they can be held
+// by `std::unique_ptr`
+class UringSocketReader {};
+class UringFileReader {};
+}  // namespace databento::detail
+
+#endif  // DATABENTO_IO_URING
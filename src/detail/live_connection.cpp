@@ -14,6 +14,11 @@ LiveConnection::LiveConnection(ILogReceiver* log_receiver, const std::string& ga
                                std::uint16_t port, TcpClient::RetryConf retry_conf)
     : client_{log_receiver, gateway, port, retry_conf} {}
 
+LiveConnection::LiveConnection(ILogReceiver* log_receiver, const std::string& gateway,
+                               std::uint16_t port, TcpClient::RetryConf retry_conf,
+                               TcpClient::SocketConf socket_conf)
+    : client_{log_receiver, gateway, port, retry_conf, socket_conf} {}
+
 void LiveConnection::WriteAll(std::string_view str) { client_.WriteAll(str); }
 
 void LiveConnection::WriteAll(const std::byte* buffer, std::size_t size) {
@@ -43,8 +48,15 @@ databento::IReadable::Result LiveConnection::ReadSome(
 
 void LiveConnection::Close() { client_.Close(); }
 
-void LiveConnection::SetCompression(Compression compression) {
+void LiveConnection::SetCompression(Compression compression, bool is_timed) {
   if (compression == Compression::Zstd) {
     zstd_stream_.emplace(std::make_unique<TcpReadable>(&client_));
+    if (is_timed) {
+      zstd_stream_->EnableTiming();
+    }
   }
 }
+
+std::chrono::nanoseconds LiveConnection::TakeDecompressTime() {
+  return zstd_stream_ ? zstd_stream_->TakeDecompressTime() : std::chrono::nanoseconds{};
+}
@@ -0,0 +1,95 @@
+#include "databento/detail/live_stats_recorder.hpp"
+
+#include "databento/record.hpp"          // Record
+#include "databento/record_visitor.hpp"  // VisitRecord
+
+using databento::detail::LiveStatsRecorder;
+
+namespace {
+// Safe because each counter has a single writer
+template <typename T>
+void Add(std::atomic<T>& counter, T value) {
+  counter.store(counter.load(std::memory_order_relaxed) + value,
+                std::memory_order_relaxed);
+}
+
+void Increment(std::atomic<std::uint64_t>& counter) { Add<std::uint64_t>(counter, 1); }
+
+std::uint64_t ElapsedNanos(databento::UnixNanos start, databento::UnixNanos end) {
+  return end > start ? (end - start).count() : 0;
+}
+}  // namespace
+
+void LiveStatsRecorder::RecordRead(std::size_t size) {
+  Increment(reads_);
+  Add<std::uint64_t>(bytes_read_, size);
+  read_sizes_.Record(size);
+}
+
+void LiveStatsRecorder::RecordRecord(const Record& record, bool has_ts_out,
+                                     UnixNanos rx_ts) {
+  const auto rtype = static_cast<std::uint8_t>(record.RType());
+  Increment(records_);
+  Increment(records_by_rtype_[rtype]);
+  Add<std::uint64_t>(bytes_by_rtype_[rtype], record.Size());
+  if (!has_ts_out) {
+    return;
+  }
+  // `ts_out` is appended to the end of the record
+  const auto* record_end =
+      reinterpret_cast<const std::byte*>(&record.Header()) + record.Size();
+  const auto ts_out =
+      *reinterpret_cast<const UnixNanos*>(record_end - sizeof(UnixNanos));
+  // Fall back to `ts_event` for unknown rtypes
+  UnixNanos index_ts = record.Header().ts_event;
+  VisitRecord(record, [&index_ts](const auto& rec) { index_ts = rec.IndexTs(); });
+  gateway_latencies_.Record(ElapsedNanos(index_ts, ts_out));
+  if (rx_ts == UnixNanos{}) {
+    rx_ts = UnixNanos{std::chrono::system_clock::now()};
+  }
+  transit_latencies_.Record(ElapsedNanos(ts_out, rx_ts));
+}
+
+void LiveStatsRecorder::RecordCallback(std::chrono::nanoseconds duration) {
+  callback_times_.Record(static_cast<std::uint64_t>(duration.count()));
+}
+
+void LiveStatsRecorder::AddDecompressTime(std::chrono::nanoseconds duration) {
+  Add<std::int64_t>(decompress_time_, duration.count());
+}
+
+databento::LiveStats LiveStatsRecorder::Snapshot() const {
+  LiveStats stats{};
+  stats.reads = reads_.load(std::memory_order_relaxed);
+  stats.bytes_read = bytes_read_.load(std::memory_order_relaxed);
+  stats.records = records_.load(std::memory_order_relaxed);
+  for (std::size_t i = 0; i < records_by_rtype_.size(); ++i) {
+    stats.records_by_rtype[i] = records_by_rtype_[i].load(std::memory_order_relaxed);
+    stats.bytes_by_rtype[i] = bytes_by_rtype_[i].load(std::memory_order_relaxed);
+  }
+  stats.decompress_time =
+      std::chrono::nanoseconds{decompress_time_.load(std::memory_order_relaxed)};
+  read_sizes_.CopyTo(stats.read_sizes);
+  callback_times_.CopyTo(stats.callback_times);
+  gateway_latencies_.CopyTo(stats.gateway_latencies);
+  transit_latencies_.CopyTo(stats.transit_latencies);
+  return stats;
+}
+
+void LiveStatsRecorder::AtomicHistogram::Record(std::uint64_t value) {
+  Increment(counts_[LiveHistogram::BucketOf(value)]);
+  Increment(count_);
+  Add(sum_, value);
+  if (value > max_.load(std::memory_order_relaxed)) {
+    max_.store(value, std::memory_order_relaxed);
+  }
+}
+
+void LiveStatsRecorder::AtomicHistogram::CopyTo(LiveHistogram& histogram) const {
+  for (std::size_t i = 0; i < counts_.size(); ++i) {
+    histogram.counts_[i] = counts_[i].load(std::memory_order_relaxed);
+  }
+  histogram.count_ = count_.load(std::memory_order_relaxed);
+  histogram.sum_ = sum_.load(std::memory_order_relaxed);
+  histogram.max_ = max_.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,139 @@
+#include "databento/detail/read_ahead_stream.hpp"
+
+#include <algorithm>  // max
+#include <sstream>
+#include <utility>  // move
+
+#include "databento/exceptions.hpp"
+
+using databento::detail::ReadAheadStream;
+using Status = databento::IReadable::Status;
+
+ReadAheadStream::ReadAheadStream(std::unique_ptr<IReadable> input, std::size_t depth,
+                                 std::size_t buffer_size)
+    : input_{std::move(input)} {
+  if (depth == 0) {
+    throw InvalidArgumentError{"ReadAheadStream", "depth", "must be greater than 0"};
+  }
+  if (buffer_size == 0) {
+    throw InvalidArgumentError{"ReadAheadStream", "buffer_size",
+                               "must be greater than 0"};
+  }
+  ring_.reserve(depth);
+  for (std::size_t i = 0; i < depth; ++i) {
+    ring_.emplace_back(buffer_size);
+  }
+  producer_ = ScopedThread{&ReadAheadStream::ProducerThread, this};
+}
+
+ReadAheadStream::~ReadAheadStream() {
+  {
+    const std::lock_guard<std::mutex> lock{mutex_};
+    is_stopping_ = true;
+  }
+  not_full_cv_.notify_one();
+}
+
+void ReadAheadStream::ReadExact(std::byte* buffer, std::size_t length) {
+  std::size_t size{};
+  std::size_t read_size{};
+  do {
+    read_size = ReadSome(&buffer[size], length - size);
+    size += read_size;
+  } while (size < length && read_size > 0);
+  if (size < length) {
+    std::ostringstream err_msg;
+    err_msg << "Reached end of stream without " << length << " bytes, only " << size
+            << " bytes available";
+    throw DbnResponseError{err_msg.str()};
+  }
+}
+
+std::size_t ReadAheadStream::ReadSome(std::byte* buffer, std::size_t max_length) {
+  return ReadSome(buffer, max_length, std::chrono::milliseconds{}).read_size;
+}
+
+databento::IReadable::Result ReadAheadStream::ReadSome(
+    std::byte* buffer, std::size_t max_length, std::chrono::milliseconds timeout) {
+  {
+    std::unique_lock<std::mutex> lock{mutex_};
+    const auto is_readable = [this] {
+      return filled_count_ > 0 || is_input_done_ || exception_;
+    };
+    if (!is_readable()) {
+      consumer_stalls_.fetch_add(1, std::memory_order_relaxed);
+      if (timeout.count() == 0) {
+        not_empty_cv_.wait(lock, is_readable);
+      } else if (!not_empty_cv_.wait_for(lock, timeout, is_readable)) {
+        return {0, Status::Timeout};
+      }
+    }
+    if (filled_count_ == 0) {
+      // Only surface an exception once all data read before it has been consumed
+      if (exception_) {
+        std::rethrow_exception(exception_);
+      }
+      return {0, Status::Closed};
+    }
+  }
+  // The buffer at `read_idx_` is owned by the consumer while `filled_count_ > 0`
+  auto& read_buffer = ring_[read_idx_];
+  const auto read_size = read_buffer.ReadSome(buffer, max_length);
+  if (read_buffer.ReadCapacity() == 0) {
+    read_idx_ = (read_idx_ + 1) % ring_.size();
+    {
+      const std::lock_guard<std::mutex> lock{mutex_};
+      --filled_count_;
+    }
+    not_full_cv_.notify_one();
+  }
+  return {read_size, Status::Ok};
+}
+
+void ReadAheadStream::ProducerThread() {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      const auto is_writable = [this] {
+        return filled_count_ < ring_.size() || is_stopping_;
+      };
+      if (!is_writable()) {
+        producer_stalls_.fetch_add(1, std::memory_order_relaxed);
+        not_full_cv_.wait(lock, is_writable);
+      }
+      if (is_stopping_) {
+        return;
+      }
+    }
+    // The buffer at `write_idx_` is owned by the producer while
+    // `filled_count_ < ring_.size()`
+    auto& write_buffer = ring_[write_idx_];
+    write_buffer.Clear();
+    std::exception_ptr exception;
+    std::size_t read_size{};
+    try {
+      // Fill the whole buffer to minimize hand-offs
+      do {
+        read_size = input_->ReadSome(write_buffer.WriteBegin(),
+                                     write_buffer.WriteCapacity());
+        write_buffer.Fill(read_size);
+      } while (read_size > 0 && write_buffer.WriteCapacity() > 0);
+    } catch (...) {
+      exception = std::current_exception();
+    }
+    const bool is_done = read_size == 0 || exception;
+    {
+      const std::lock_guard<std::mutex> lock{mutex_};
+      if (write_buffer.ReadCapacity() > 0) {
+        write_idx_ = (write_idx_ + 1) % ring_.size();
+        ++filled_count_;
+      }
+      is_input_done_ = is_done;
+      exception_ = exception;
+    }
+    not_empty_cv_.notify_one();
+    if (is_done) {
+      return;
+    }
+  }
+}
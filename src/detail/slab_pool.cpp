@@ -0,0 +1,86 @@
+#include "databento/detail/slab_pool.hpp"
+
+#include <utility>  // move, swap
+
+#include "databento/exceptions.hpp"  // InvalidArgumentError
+
+using databento::detail::SlabPool;
+using databento::detail::SlabRef;
+
+SlabRef::SlabRef(const SlabRef& other) noexcept : slab_{other.slab_} {
+  if (slab_ != nullptr) {
+    slab_->ref_count_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+SlabRef& SlabRef::operator=(const SlabRef& rhs) noexcept {
+  SlabRef copy{rhs};
+  std::swap(slab_, copy.slab_);
+  return *this;
+}
+
+SlabRef& SlabRef::operator=(SlabRef&& rhs) noexcept {
+  std::swap(slab_, rhs.slab_);
+  return *this;
+}
+
+std::uint32_t SlabRef::UseCount() const {
+  if (slab_ == nullptr) {
+    return 0;
+  }
+  // Acquire so the released references' reads of the slab happen before any
+  // writes after finding it's no longer shared
+  return slab_->ref_count_.load(std::memory_order_acquire);
+}
+
+void SlabRef::Release() noexcept {
+  if (slab_ == nullptr) {
+    return;
+  }
+  auto* slab = slab_;
+  slab_ = nullptr;
+  if (slab->ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    // May destroy the pool if this was the last reference to it
+    const auto pool = std::move(slab->pool_);
+    pool->Return(slab);
+  }
+}
+
+SlabPool::SlabPool(std::size_t slab_size) : slab_size_{slab_size} {
+  if (slab_size == 0) {
+    throw InvalidArgumentError{"SlabPool", "slab_size", "must be greater than 0"};
+  }
+}
+
+SlabPool::~SlabPool() = default;
+
+std::size_t SlabPool::FreeCount() const {
+  const std::lock_guard<std::mutex> lock{mutex_};
+  return free_slabs_.size();
+}
+
+SlabRef SlabPool::Acquire(std::size_t min_size) {
+  std::unique_ptr<Slab> slab;
+  if (min_size <= slab_size_) {
+    const std::lock_guard<std::mutex> lock{mutex_};
+    if (!free_slabs_.empty()) {
+      slab = std::move(free_slabs_.back());
+      free_slabs_.pop_back();
+    }
+  }
+  if (!slab) {
+    slab.reset(new Slab{min_size <= slab_size_ ? slab_size_ : min_size});
+  }
+  slab->pool_ = shared_from_this();
+  slab->ref_count_.store(1, std::memory_order_relaxed);
+  return SlabRef{slab.release()};
+}
+
+void SlabPool::Return(Slab* slab) {
+  std::unique_ptr<Slab> owned{slab};
+  if (owned->Size() != slab_size_) {
+    return;
+  }
+  const std::lock_guard<std::mutex> lock{mutex_};
+  free_slabs_.emplace_back(std::move(owned));
+}
@@ -7,14 +7,20 @@
 #include <netdb.h>       // addrinfo, gai_strerror, getaddrinfo, freeaddrinfo
 #include <netinet/in.h>  // htons, IPPROTO_TCP
 #include <sys/poll.h>    // pollfd
-#include <sys/socket.h>  // AF_INET, connect, recv, send, sockaddr, sockaddr_in, socket, SOCK_STREAM, getsockopt, SO_ERROR, SOL_SOCKET
+#include <sys/socket.h>  // AF_INET, connect, recv, send, sockaddr, sockaddr_in, socket, SOCK_STREAM, getsockopt, setsockopt, SO_ERROR, SOL_SOCKET, MSG_DONTWAIT
 #include <unistd.h>      // close, ssize_t
 
 #include <cerrno>  // errno
 #endif
+#ifdef __linux__
+#include <linux/errqueue.h>    // scm_timestamping
+#include <linux/net_tstamp.h>  // SOF_TIMESTAMPING_*
+#endif
 
 #include <algorithm>  // max
-#include <memory>     // unique_ptr
+#include <array>
+#include <cstring>  // memcpy
+#include <memory>   // unique_ptr
 #include <sstream>
 #include <thread>
 #include <utility>  // move
@@ -22,6 +28,7 @@
 
 #include "databento/exceptions.hpp"  // TcpError
 #include "databento/log.hpp"         // ILogReceiver
+#include "detail/io_uring.hpp"       // UringSocketReader
 
 using databento::detail::TcpClient;
 using Status = databento::IReadable::Status;
@@ -53,6 +60,62 @@ int GetSockOpt(databento::detail::Socket fd, int level, int optname, int* optval
 #endif
 }
 
+int SetSockOpt(databento::detail::Socket fd, int level, int optname, int optval) {
+#ifdef _WIN32
+  return ::setsockopt(fd, level, optname, reinterpret_cast<const char*>(&optval),
+                      sizeof(optval));
+#else
+  return ::setsockopt(fd, level, optname, &optval, sizeof(optval));
+#endif
+}
+
+#ifdef __linux__
+// Reads like `recv`, also setting `rx_ts` from the `SCM_TIMESTAMPING` control
+// message if one is received.
+::ssize_t RecvWithRxTs(databento::detail::Socket fd, std::byte* buffer,
+                       std::size_t max_size, int flags, databento::UnixNanos* rx_ts) {
+  ::iovec iov{buffer, max_size};
+  alignas(::cmsghdr) std::array<char, CMSG_SPACE(sizeof(::scm_timestamping))>
+      control;
+  ::msghdr msg{};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.data();
+  msg.msg_controllen = control.size();
+  const ::ssize_t res = ::recvmsg(fd, &msg, flags);
+  if (res <= 0) {
+    return res;
+  }
+  *rx_ts = {};
+  for (::cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr;
+       cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_TIMESTAMPING) {
+      continue;
+    }
+    ::scm_timestamping tss;
+    std::memcpy(&tss, CMSG_DATA(cmsg), sizeof(tss));
+    // `ts[2]` is the raw hardware timestamp, which is only set when the network
+    // device has been configured to generate them
+    const ::timespec& ts =
+        (tss.ts[2].tv_sec != 0 || tss.ts[2].tv_nsec != 0) ? tss.ts[2] : tss.ts[0];
+    *rx_ts = databento::UnixNanos{std::chrono::seconds{ts.tv_sec} +
+                                  std::chrono::nanoseconds{ts.tv_nsec}};
+  }
+  return res;
+}
+#endif
+
+// `rx_ts` is only updated when non-null.
+::ssize_t Recv(databento::detail::Socket fd, std::byte* buffer, std::size_t max_size,
+               int flags, [[maybe_unused]] databento::UnixNanos* rx_ts) {
+#ifdef __linux__
+  if (rx_ts != nullptr) {
+    return RecvWithRxTs(fd, buffer, max_size, flags, rx_ts);
+  }
+#endif
+  return ::recv(fd, reinterpret_cast<char*>(buffer), max_size, flags);
+}
+
 #ifdef _WIN32
 constexpr int kConnectInProgress = WSAEWOULDBLOCK;
 constexpr int kTimedOut = WSAETIMEDOUT;
@@ -165,7 +228,23 @@ TcpClient::TcpClient(ILogReceiver* log_receiver, const std::string& gateway,
 
 TcpClient::TcpClient(ILogReceiver* log_receiver, const std::string& gateway,
                      std::uint16_t port, RetryConf retry_conf)
-    : socket_{InitSocket(log_receiver, gateway, port, retry_conf)} {}
+    : TcpClient{log_receiver, gateway, port, retry_conf, {}} {}
+
+TcpClient::TcpClient(ILogReceiver* log_receiver, const std::string& gateway,
+                     std::uint16_t port, RetryConf retry_conf, SocketConf socket_conf)
+    : socket_{InitSocket(log_receiver, gateway, port, retry_conf)},
+      spin_{socket_conf.spin} {
+  ApplySocketConf(log_receiver, socket_conf);
+  // Spinning already avoids waiting in the kernel and multishot receives don't
+  // return timestamps
+  if (socket_conf.io_uring && !spin_ && !rx_timestamps_) {
+    InitUringReader(log_receiver);
+  }
+}
+
+TcpClient::TcpClient(TcpClient&&) noexcept = default;
+TcpClient& TcpClient::operator=(TcpClient&&) noexcept = default;
+TcpClient::~TcpClient() = default;
 
 void TcpClient::WriteAll(std::string_view str) {
   WriteAll(reinterpret_cast<const std::byte*>(str.data()), str.length());
@@ -176,7 +255,11 @@ void TcpClient::WriteAll(const std::byte* buffer, std::size_t size) {
     const ::ssize_t res =
         ::send(socket_.Get(), reinterpret_cast<const char*>(buffer), size, {});
     if (res < 0) {
-      throw TcpError{::GetErrNo(), "Error writing to socket"};
+      const int err_num = ::GetErrNo();
+      if (err_num == EINTR) {
+        continue;
+      }
+      throw TcpError{err_num, "Error writing to socket"};
     }
     size -= static_cast<std::size_t>(res);
     buffer += res;
@@ -184,17 +267,38 @@ void TcpClient::WriteAll(const std::byte* buffer, std::size_t size) {
 }
 
 void TcpClient::ReadExact(std::byte* buffer, std::size_t size) {
-  const ::ssize_t res =
-      ::recv(socket_.Get(), reinterpret_cast<char*>(buffer), size, MSG_WAITALL);
-  if (res != static_cast<::ssize_t>(size)) {
-    throw TcpError{::GetErrNo(), "Error reading from socket"};
+#ifdef DATABENTO_IO_URING
+  if (uring_reader_) {
+    uring_reader_->ReadExact(buffer, size);
+    return;
+  }
+#endif
+  // `MSG_WAITALL` can still return early when interrupted, such as by `io_uring`
+  // task work
+  while (size > 0) {
+    const ::ssize_t res =
+        ::recv(socket_.Get(), reinterpret_cast<char*>(buffer), size, MSG_WAITALL);
+    if (res > 0) {
+      size -= static_cast<std::size_t>(res);
+      buffer += res;
+      continue;
+    }
+    const int err_num = res == 0 ? ECONNRESET : ::GetErrNo();
+    if (err_num != EINTR) {
+      throw TcpError{err_num, "Error reading from socket"};
+    }
   }
 }
 
 databento::IReadable::Result TcpClient::ReadSome(std::byte* buffer,
                                                  std::size_t max_size) {
-  const ::ssize_t res =
-      ::recv(socket_.Get(), reinterpret_cast<char*>(buffer), max_size, {});
+#ifdef DATABENTO_IO_URING
+  if (uring_reader_) {
+    return uring_reader_->ReadSome(buffer, max_size, std::chrono::milliseconds{});
+  }
+#endif
+  const ::ssize_t res = Recv(socket_.Get(), buffer, max_size, {},
+                             rx_timestamps_ ? &last_rx_ts_ : nullptr);
   if (res < 0) {
     throw TcpError{::GetErrNo(), "Error reading from socket"};
   }
@@ -204,6 +308,14 @@ databento::IReadable::Result TcpClient::ReadSome(std::byte* buffer,
 databento::IReadable::Result TcpClient::ReadSome(std::byte* buffer,
                                                  std::size_t max_size,
                                                  std::chrono::milliseconds timeout) {
+  if (spin_) {
+    return SpinReadSome(buffer, max_size, timeout);
+  }
+#ifdef DATABENTO_IO_URING
+  if (uring_reader_) {
+    return uring_reader_->ReadSome(buffer, max_size, timeout);
+  }
+#endif
   pollfd fds{socket_.Get(), POLLIN, {}};
   // passing a timeout of -1 blocks indefinitely, which is the equivalent of
   // having no timeout
@@ -224,7 +336,123 @@ databento::IReadable::Result TcpClient::ReadSome(std::byte* buffer,
   }
 }
 
-void TcpClient::Close() { socket_.Close(); }
+void TcpClient::Close() {
+  // The reader must be done with the socket before it's closed
+  uring_reader_.reset();
+  socket_.Close();
+}
+
+databento::detail::Socket TcpClient::Fd() const {
+#ifdef DATABENTO_IO_URING
+  if (uring_reader_) {
+    return uring_reader_->Fd();
+  }
+#endif
+  return socket_.Get();
+}
+
+bool TcpClient::HasBufferedData() const {
+#ifdef DATABENTO_IO_URING
+  if (uring_reader_) {
+    return uring_reader_->HasBufferedData();
+  }
+#endif
+  return false;
+}
+
+void TcpClient::InitUringReader([[maybe_unused]] ILogReceiver* log_receiver) {
+#ifdef DATABENTO_IO_URING
+  try {
+    uring_reader_ = std::make_unique<UringSocketReader>(socket_.Get());
+  } catch (const Exception& exc) {
+    // Older kernels lack multishot receive and provided buffer rings
+    std::ostringstream log_msg;
+    log_msg << "[TcpClient::TcpClient] Falling back to reading with recv: "
+            << exc.what();
+    log_receiver->Receive(LogLevel::Warning, log_msg.str());
+  }
+#endif
+}
+
+void TcpClient::ApplySocketConf(ILogReceiver* log_receiver, SocketConf socket_conf) {
+  static constexpr auto kMethod = "TcpClient::TcpClient";
+  // The options are hints, so failing to set them only warrants a warning. For
+  // example, raising `SO_BUSY_POLL` above `net.core.busy_read` requires
+  // `CAP_NET_ADMIN`
+  const auto warn = [log_receiver](const TcpError& err) {
+    std::ostringstream log_msg;
+    log_msg << '[' << kMethod << "] " << err.what();
+    log_receiver->Receive(LogLevel::Warning, log_msg.str());
+  };
+  if (socket_conf.busy_poll.count() > 0) {
+#ifdef SO_BUSY_POLL
+    if (SetSockOpt(socket_.Get(), SOL_SOCKET, SO_BUSY_POLL,
+                   static_cast<int>(socket_conf.busy_poll.count())) != 0) {
+      warn(TcpError{::GetErrNo(), "Failed to set SO_BUSY_POLL"});
+    }
+#else
+    log_receiver->Receive(
+        LogLevel::Warning,
+        std::string{'['} + kMethod + "] SO_BUSY_POLL is not supported on this platform");
+#endif
+  }
+  if (socket_conf.rcv_lowat > 0 &&
+      SetSockOpt(socket_.Get(), SOL_SOCKET, SO_RCVLOWAT, socket_conf.rcv_lowat) != 0) {
+    warn(TcpError{::GetErrNo(), "Failed to set SO_RCVLOWAT"});
+  }
+  if (socket_conf.rx_timestamps) {
+#ifdef __linux__
+    // Hardware timestamps are only reported if the network device has been
+    // configured to generate them, which requires `CAP_NET_ADMIN`
+    constexpr int kFlags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE |
+                           SOF_TIMESTAMPING_RX_HARDWARE |
+                           SOF_TIMESTAMPING_RAW_HARDWARE;
+    if (SetSockOpt(socket_.Get(), SOL_SOCKET, SO_TIMESTAMPING, kFlags) == 0) {
+      rx_timestamps_ = true;
+    } else {
+      warn(TcpError{::GetErrNo(), "Failed to set SO_TIMESTAMPING"});
+    }
+#else
+    log_receiver->Receive(LogLevel::Warning,
+                          std::string{'['} + kMethod +
+                              "] SO_TIMESTAMPING is not supported on this platform");
+#endif
+  }
+}
+
+databento::IReadable::Result TcpClient::SpinReadSome(
+    std::byte* buffer, std::size_t max_size, std::chrono::milliseconds timeout) {
+  // A timeout of 0 spins until data is available or the socket is closed
+  const bool has_timeout = timeout.count() > 0;
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (true) {
+#ifdef _WIN32
+    // Windows has no per-call non-blocking flag for `recv`, so check readiness
+    // without waiting instead
+    pollfd fds{socket_.Get(), POLLIN, {}};
+    const int poll_status = Poll(&fds, 1, 0);
+    if (poll_status > 0) {
+      return ReadSome(buffer, max_size);
+    }
+    if (poll_status < 0) {
+      throw TcpError{::GetErrNo(), "Incorrect poll"};
+    }
+#else
+    const ::ssize_t res = Recv(socket_.Get(), buffer, max_size, MSG_DONTWAIT,
+                               rx_timestamps_ ? &last_rx_ts_ : nullptr);
+    if (res >= 0) {
+      return {static_cast<std::size_t>(res), res == 0 ? Status::Closed : Status::Ok};
+    }
+    const int err_num = ::GetErrNo();
+    if (err_num != EAGAIN && err_num != EINTR) {
+      throw TcpError{err_num, "Error reading from socket"};
+    }
+#endif
+    if (has_timeout && std::chrono::steady_clock::now() >= deadline) {
+      return {0, Status::Timeout};
+    }
+  }
+}
 
 databento::detail::ScopedFd TcpClient::InitSocket(ILogReceiver* log_receiver,
                                                   const std::string& gateway,
@@ -1,5 +1,7 @@
 #include "databento/detail/zstd_stream.hpp"
 
+#include <zstd_errors.h>
+
 #include <algorithm>
 #include <sstream>
 #include <utility>  // move
@@ -49,6 +51,17 @@ databento::IReadable::Result ZstdDecodeStream::ReadSome(
   ZSTD_outBuffer z_out_buffer{buffer, max_length, 0};
   databento::IReadable::Result read_result{0, Status::Ok};
 
+  // Decompress what's already been read before waiting on the input, otherwise
+  // buffered data could be held back until more input arrives
+  if (z_in_buffer_.pos < z_in_buffer_.size || is_output_pending_) {
+    if (read_suggestion_ == 0) {
+      read_suggestion_ = ::ZSTD_initDStream(z_dstream_.get());
+    }
+    Decompress(&z_out_buffer);
+    if (z_out_buffer.pos > 0) {
+      return {z_out_buffer.pos, Status::Ok};
+    }
+  }
   do {
     const auto unread_input = z_in_buffer_.size - z_in_buffer_.pos;
     if (unread_input > 0) {
@@ -77,12 +90,7 @@ databento::IReadable::Result ZstdDecodeStream::ReadSome(
       break;
     }
 
-    read_suggestion_ =
-        ::ZSTD_decompressStream(z_dstream_.get(), &z_out_buffer, &z_in_buffer_);
-    if (::ZSTD_isError(read_suggestion_)) {
-      throw DbnResponseError{std::string{"Zstd error decompressing: "} +
-                             ::ZSTD_getErrorName(read_suggestion_)};
-    }
+    Decompress(&z_out_buffer);
   } while (z_out_buffer.pos == 0 && read_result.read_size > 0);
 
   const auto read_size = z_out_buffer.pos;
@@ -90,6 +98,253 @@ databento::IReadable::Result ZstdDecodeStream::ReadSome(
   return {read_size, read_size > 0 ? Status::Ok : read_result.status};
 }
 
+void ZstdDecodeStream::Decompress(ZSTD_outBuffer* z_out_buffer) {
+  const auto decompress_start = is_timed_ ? std::chrono::steady_clock::now()
+                                          : std::chrono::steady_clock::time_point{};
+  read_suggestion_ =
+      ::ZSTD_decompressStream(z_dstream_.get(), z_out_buffer, &z_in_buffer_);
+  if (is_timed_) {
+    decompress_time_ += std::chrono::steady_clock::now() - decompress_start;
+  }
+  if (::ZSTD_isError(read_suggestion_)) {
+    throw DbnResponseError{std::string{"Zstd error decompressing: "} +
+                           ::ZSTD_getErrorName(read_suggestion_)};
+  }
+  // A full output buffer means Zstd may be holding more decompressed data
+  is_output_pending_ = z_out_buffer->pos == z_out_buffer->size;
+}
+
+std::chrono::nanoseconds ZstdDecodeStream::TakeDecompressTime() {
+  const auto decompress_time = decompress_time_;
+  decompress_time_ = {};
+  return decompress_time;
+}
+
+using databento::detail::ParallelZstdDecodeStream;
+
+namespace {
+// Size of each read from the compressed input while scanning for frames
+constexpr std::size_t kScanReadSize = 1 << 20;
+}  // namespace
+
+ParallelZstdDecodeStream::ParallelZstdDecodeStream(std::unique_ptr<IReadable> input,
+                                                   std::size_t thread_count)
+    : ParallelZstdDecodeStream{std::move(input), thread_count, kDefaultMaxFrameSize} {
+}
+
+ParallelZstdDecodeStream::ParallelZstdDecodeStream(std::unique_ptr<IReadable> input,
+                                                   std::size_t thread_count,
+                                                   std::size_t max_frame_size)
+    : input_{std::move(input)},
+      // Keep enough frames queued that workers don't idle while the reader copies
+      // out decompressed data
+      max_in_flight_{2 * std::max<std::size_t>(thread_count, 1)},
+      max_frame_size_{max_frame_size} {
+  for (std::size_t i = 0; i < std::max<std::size_t>(thread_count, 1); ++i) {
+    workers_.emplace_back(&ParallelZstdDecodeStream::WorkerThread, this);
+  }
+}
+
+ParallelZstdDecodeStream::ParallelZstdDecodeStream(std::unique_ptr<IReadable> input,
+                                                   detail::Buffer& in_buffer,
+                                                   std::size_t thread_count)
+    : ParallelZstdDecodeStream{std::move(input), in_buffer, thread_count,
+                               kDefaultMaxFrameSize} {}
+
+ParallelZstdDecodeStream::ParallelZstdDecodeStream(std::unique_ptr<IReadable> input,
+                                                   detail::Buffer& in_buffer,
+                                                   std::size_t thread_count,
+                                                   std::size_t max_frame_size)
+    : ParallelZstdDecodeStream{std::move(input), thread_count, max_frame_size} {
+  scan_buffer_.assign(in_buffer.ReadBegin(), in_buffer.ReadEnd());
+  in_buffer.Consume(in_buffer.ReadCapacity());
+}
+
+ParallelZstdDecodeStream::~ParallelZstdDecodeStream() {
+  {
+    const std::lock_guard<std::mutex> lock{mutex_};
+    is_stopping_ = true;
+  }
+  work_cv_.notify_all();
+  // Join before `frames_` are destroyed
+  workers_.clear();
+}
+
+void ParallelZstdDecodeStream::ReadExact(std::byte* buffer, std::size_t length) {
+  std::size_t size{};
+  std::size_t read_size{};
+  do {
+    read_size = ReadSome(&buffer[size], length - size);
+    size += read_size;
+  } while (size < length && read_size > 0);
+  // check for end of stream without obtaining `length` bytes
+  if (size < length) {
+    std::ostringstream err_msg;
+    err_msg << "Reached end of Zstd stream without " << length << " bytes, only "
+            << size << " bytes available";
+    throw DbnResponseError{err_msg.str()};
+  }
+}
+
+std::size_t ParallelZstdDecodeStream::ReadSome(std::byte* buffer,
+                                               std::size_t max_length) {
+  if (serial_stream_) {
+    return serial_stream_->ReadSome(buffer, max_length);
+  }
+  while (true) {
+    while (!needs_serial_ && frames_.size() < max_in_flight_ && QueueFrame()) {
+    }
+    if (frames_.empty()) {
+      if (needs_serial_) {
+        // Pass the remaining input, which starts with the oversized frame, to a
+        // serial stream
+        detail::Buffer remaining{scan_buffer_.size() - scan_pos_};
+        remaining.WriteAll(scan_buffer_.data() + scan_pos_,
+                           scan_buffer_.size() - scan_pos_);
+        scan_buffer_ = {};
+        serial_stream_ =
+            std::make_unique<ZstdDecodeStream>(std::move(input_), remaining);
+        return serial_stream_->ReadSome(buffer, max_length);
+      }
+      return 0;
+    }
+    auto& frame = *frames_.front();
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      done_cv_.wait(lock, [&frame] { return frame.is_done; });
+    }
+    if (frame.exception) {
+      std::rethrow_exception(frame.exception);
+    }
+    const auto read_size = frame.decompressed.ReadSome(buffer, max_length);
+    if (frame.decompressed.ReadCapacity() == 0) {
+      frames_.pop_front();
+    }
+    // Frames can be empty, e.g. skippable frames
+    if (read_size > 0) {
+      return read_size;
+    }
+  }
+}
+
+databento::IReadable::Result ParallelZstdDecodeStream::ReadSome(
+    std::byte* buffer, std::size_t max_length, std::chrono::milliseconds) {
+  const auto read_size = ReadSome(buffer, max_length);
+  return {read_size, read_size > 0 ? Status::Ok : Status::Closed};
+}
+
+bool ParallelZstdDecodeStream::QueueFrame() {
+  while (true) {
+    const auto* scan_begin = scan_buffer_.data() + scan_pos_;
+    const auto scan_size = scan_buffer_.size() - scan_pos_;
+    if (scan_size > 0) {
+      const auto frame_size = ::ZSTD_findFrameCompressedSize(scan_begin, scan_size);
+      if (!::ZSTD_isError(frame_size)) {
+        Submit(scan_begin, frame_size);
+        scan_pos_ += frame_size;
+        return true;
+      }
+      if (::ZSTD_getErrorCode(frame_size) != ZSTD_error_srcSize_wrong) {
+        throw DbnResponseError{std::string{"Zstd error scanning for frame: "} +
+                               ::ZSTD_getErrorName(frame_size)};
+      }
+      if (is_input_done_) {
+        // Truncated final frame: decompress what's there like `ZstdDecodeStream`
+        Submit(scan_begin, scan_size);
+        scan_pos_ += scan_size;
+        return true;
+      }
+      if (scan_size >= max_frame_size_) {
+        needs_serial_ = true;
+        return false;
+      }
+    } else if (is_input_done_) {
+      return false;
+    }
+    // Drop scanned input before reading more
+    scan_buffer_.erase(scan_buffer_.begin(),
+                       scan_buffer_.begin() + static_cast<std::ptrdiff_t>(scan_pos_));
+    scan_pos_ = 0;
+    const auto prev_size = scan_buffer_.size();
+    scan_buffer_.resize(prev_size + kScanReadSize);
+    const auto read_size = input_->ReadSome(&scan_buffer_[prev_size], kScanReadSize);
+    scan_buffer_.resize(prev_size + read_size);
+    is_input_done_ = read_size == 0;
+  }
+}
+
+void ParallelZstdDecodeStream::Submit(const std::byte* data, std::size_t size) {
+  auto frame = std::make_unique<Frame>();
+  frame->compressed.assign(data, data + size);
+  {
+    const std::lock_guard<std::mutex> lock{mutex_};
+    work_queue_.emplace_back(frame.get());
+  }
+  frames_.emplace_back(std::move(frame));
+  work_cv_.notify_one();
+}
+
+void ParallelZstdDecodeStream::WorkerThread() {
+  const std::unique_ptr<ZSTD_DCtx, std::size_t (*)(ZSTD_DCtx*)> dctx{
+      ::ZSTD_createDCtx(), ::ZSTD_freeDCtx};
+  while (true) {
+    Frame* frame;
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      work_cv_.wait(lock, [this] { return is_stopping_ || !work_queue_.empty(); });
+      if (is_stopping_) {
+        return;
+      }
+      frame = work_queue_.front();
+      work_queue_.pop_front();
+    }
+    try {
+      DecompressFrame(dctx.get(), frame);
+    } catch (...) {
+      frame->exception = std::current_exception();
+    }
+    {
+      const std::lock_guard<std::mutex> lock{mutex_};
+      frame->is_done = true;
+    }
+    done_cv_.notify_all();
+  }
+}
+
+void ParallelZstdDecodeStream::DecompressFrame(ZSTD_DCtx* dctx, Frame* frame) {
+  ::ZSTD_DCtx_reset(dctx, ZSTD_reset_session_only);
+  ZSTD_inBuffer z_in_buffer{frame->compressed.data(), frame->compressed.size(), 0};
+  auto& out = frame->decompressed;
+  const auto content_size =
+      ::ZSTD_getFrameContentSize(z_in_buffer.src, z_in_buffer.size);
+  // Content size is optional in the frame header
+  if (content_size != ZSTD_CONTENTSIZE_UNKNOWN &&
+      content_size != ZSTD_CONTENTSIZE_ERROR) {
+    out.Reserve(static_cast<std::size_t>(content_size));
+  } else {
+    out.Reserve(4 * z_in_buffer.size);
+  }
+  while (true) {
+    if (out.WriteCapacity() == 0) {
+      out.Reserve(std::max(2 * out.Capacity(), ::ZSTD_DStreamOutSize()));
+    }
+    ZSTD_outBuffer z_out_buffer{out.WriteBegin(), out.WriteCapacity(), 0};
+    const auto res = ::ZSTD_decompressStream(dctx, &z_out_buffer, &z_in_buffer);
+    if (::ZSTD_isError(res)) {
+      throw DbnResponseError{std::string{"Zstd error decompressing: "} +
+                             ::ZSTD_getErrorName(res)};
+    }
+    out.Fill(z_out_buffer.pos);
+    // Finished frame or no more input and all buffered output has been flushed
+    if (res == 0 || (z_in_buffer.pos == z_in_buffer.size &&
+                     z_out_buffer.pos < z_out_buffer.size)) {
+      break;
+    }
+  }
+  // Release compressed input early
+  frame->compressed = {};
+}
+
 using databento::detail::ZstdCompressStream;
 
 ZstdCompressStream::ZstdCompressStream(IWritable* output)
@@ -113,8 +368,9 @@ ZstdCompressStream::~ZstdCompressStream() { Flush(); }
 void ZstdCompressStream::WriteAll(const std::byte* buffer, std::size_t length) {
   in_buffer_.insert(in_buffer_.end(), buffer, buffer + length);
   z_in_buffer_ = {in_buffer_.data(), in_buffer_.size(), 0};
-  // Wait for sufficient data before compressing
-  if (in_buffer_.size() >= in_size_) {
+  // Wait for sufficient data before compressing. Each call produces at most one
+  // output buffer of data, so large writes take several calls
+  while (z_in_buffer_.size - z_in_buffer_.pos >= in_size_) {
     ZSTD_outBuffer z_out_buffer{out_buffer_.data(), out_buffer_.size(), 0};
     const std::size_t remaining = ::ZSTD_compressStream2(
         z_cstream_.get(), &z_out_buffer, &z_in_buffer_, ::ZSTD_e_continue);
@@ -122,18 +378,19 @@ void ZstdCompressStream::WriteAll(const std::byte* buffer, std::size_t length) {
       throw DbnResponseError{std::string{"Zstd error compressing: "} +
                              ::ZSTD_getErrorName(remaining)};
     }
-    // Shift unread input to front
-    const auto unread_input = z_in_buffer_.size - z_in_buffer_.pos;
-    if (unread_input > 0) {
-      std::copy(in_buffer_.cbegin() + static_cast<std::ptrdiff_t>(z_in_buffer_.pos),
-                in_buffer_.cend(), in_buffer_.begin());
-    }
-    in_buffer_.resize(unread_input);
     if (z_out_buffer.pos > 0) {
       // Forward compressed output
       output_->WriteAll(out_buffer_.data(), z_out_buffer.pos);
     }
   }
+  if (z_in_buffer_.pos > 0) {
+    // Shift unread input to front
+    const auto unread_input = z_in_buffer_.size - z_in_buffer_.pos;
+    std::copy(in_buffer_.cbegin() + static_cast<std::ptrdiff_t>(z_in_buffer_.pos),
+              in_buffer_.cend(), in_buffer_.begin());
+    in_buffer_.resize(unread_input);
+    z_in_buffer_ = {in_buffer_.data(), unread_input, 0};
+  }
 }
 
 void ZstdCompressStream::Flush() {
@@ -141,21 +398,25 @@ void ZstdCompressStream::Flush() {
   while (true) {
     const std::size_t remaining = ::ZSTD_compressStream2(
         z_cstream_.get(), &z_out_buffer, &z_in_buffer_, ::ZSTD_e_end);
-    if (remaining == 0) {
+    if (::ZSTD_isError(remaining)) {
+      if (log_receiver_) {
+        log_receiver_->Receive(LogLevel::Error,
+                               std::string{"Zstd error compressing end of stream: "} +
+                                   ::ZSTD_getErrorName(remaining));
+      }
       break;
     }
-    if (::ZSTD_isError(remaining) && log_receiver_) {
-      log_receiver_->Receive(LogLevel::Error,
-                             std::string{"Zstd error compressing end of stream: "} +
-                                 ::ZSTD_getErrorName(remaining));
+    // Forward compressed output, freeing the output buffer for the rest of the
+    // frame
+    if (z_out_buffer.pos > 0) {
+      output_->WriteAll(out_buffer_.data(), z_out_buffer.pos);
+      z_out_buffer.pos = 0;
+    }
+    if (remaining == 0) {
       break;
     }
   }
   assert(z_in_buffer_.pos == z_in_buffer_.size);
-  // Forward compressed output
-  if (z_out_buffer.pos > 0) {
-    output_->WriteAll(out_buffer_.data(), z_out_buffer.pos);
-  }
   // Clear the input buffer since it's all been flushed
   in_buffer_.clear();
   z_in_buffer_ = {in_buffer_.data(), 0, 0};
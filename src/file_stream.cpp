@@ -1,9 +1,28 @@
 #include "databento/file_stream.hpp"
 
-#include <ios>  // ios, streamsize
+#ifdef _WIN32
+#include <windows.h>  // CreateFileMappingW, CreateFileW, MapViewOfFile
+#else
+#include <fcntl.h>     // open, O_RDONLY
+#include <sys/mman.h>  // madvise, mmap, munmap
+#include <sys/stat.h>  // fstat
+#include <unistd.h>    // close
+
+#include <cerrno>   // errno
+#include <cstring>  // strerror
+#endif
+
+#include <algorithm>  // copy, min
+#include <cstdint>    // uintptr_t
+#include <ios>        // ios, streamoff, streamsize
+#include <memory>     // make_unique
 #include <sstream>
+#include <string>  // to_string
+#include <utility>  // swap
 
+#include "databento/detail/scoped_fd.hpp"
 #include "databento/exceptions.hpp"
+#include "detail/io_uring.hpp"  // UringFileReader
 
 using databento::InFileStream;
 using Status = databento::IReadable::Status;
@@ -38,6 +57,235 @@ databento::IReadable::Result InFileStream::ReadSome(std::byte* buffer,
   return {bytes_read, bytes_read > 0 ? Status::Ok : Status::Closed};
 }
 
+void InFileStream::Seek(std::uint64_t offset) {
+  // Clears EOF from any previous read
+  stream_.clear();
+  stream_.seekg(static_cast<std::streamoff>(offset));
+  if (stream_.fail()) {
+    throw InvalidArgumentError{"InFileStream::Seek", "offset",
+                               "Unable to seek to " + std::to_string(offset)};
+  }
+}
+
+using databento::InMmapFileStream;
+
+namespace {
+// How far reading must advance before consumed pages are returned to the OS.
+constexpr std::size_t kReleaseInterval = std::size_t{64} << 20;
+// Records handed out from the mapping are only valid until the next read, but keep
+// the most recent one mapped to be safe.
+constexpr std::size_t kReleaseLag = std::size_t{1} << 20;
+}  // namespace
+
+InMmapFileStream::InMmapFileStream(const std::filesystem::path& file_path) {
+  static constexpr auto kMethodName = "InMmapFileStream";
+#ifdef _WIN32
+  const HANDLE file = ::CreateFileW(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                                    nullptr, OPEN_EXISTING,
+                                    FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw InvalidArgumentError{kMethodName, "file_path",
+                               "Non-existent or invalid file: " + file_path.string()};
+  }
+  LARGE_INTEGER file_size{};
+  if (!::GetFileSizeEx(file, &file_size)) {
+    ::CloseHandle(file);
+    throw InvalidArgumentError{kMethodName, "file_path",
+                               "Unable to get size of file: " + file_path.string()};
+  }
+  const auto size = static_cast<std::size_t>(file_size.QuadPart);
+  if (size > 0) {
+    mapping_handle_ =
+        ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_handle_ != nullptr) {
+      data_ = static_cast<std::byte*>(
+          ::MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0));
+    }
+  }
+  // The mapping keeps the file open
+  ::CloseHandle(file);
+  if (size > 0 && data_ == nullptr) {
+    Unmap();
+    throw Exception{"Failed to memory map file: " + file_path.string()};
+  }
+#else
+  const detail::ScopedFd fd{::open(file_path.c_str(), O_RDONLY)};
+  if (fd.Get() == detail::ScopedFd::kUnset) {
+    throw InvalidArgumentError{kMethodName, "file_path",
+                               "Non-existent or invalid file: " + file_path.string()};
+  }
+  struct ::stat file_stat {};
+  if (::fstat(fd.Get(), &file_stat) != 0) {
+    throw InvalidArgumentError{kMethodName, "file_path",
+                               "Unable to get size of file: " + file_path.string()};
+  }
+  const auto size = static_cast<std::size_t>(file_stat.st_size);
+  if (size > 0) {
+    void* addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd.Get(), 0);
+    if (addr == MAP_FAILED) {
+      throw Exception{"Failed to memory map file " + file_path.string() + ": " +
+                      std::strerror(errno)};
+    }
+    data_ = static_cast<std::byte*>(addr);
+    // The file is read front to back, so the kernel can read ahead aggressively.
+    // Hints are best effort, so errors are ignored
+    ::madvise(addr, size, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+    // Fewer TLB misses when scanning large files. Huge pages for read-only file
+    // mappings need a kernel with `CONFIG_READ_ONLY_THP_FOR_FS`; elsewhere this is
+    // a no-op or fails with `EINVAL`
+    ::madvise(addr, size, MADV_HUGEPAGE);
+#endif
+  }
+  // The mapping keeps the file open
+#endif
+  end_ = data_ + size;
+  read_pos_ = data_;
+  released_pos_ = data_;
+}
+
+InMmapFileStream::InMmapFileStream(InMmapFileStream&& other) noexcept
+    : data_{other.data_},
+      end_{other.end_},
+      read_pos_{other.read_pos_},
+      released_pos_{other.released_pos_}
+#ifdef _WIN32
+      ,
+      mapping_handle_{other.mapping_handle_}
+#endif
+{
+  other.data_ = nullptr;
+  other.end_ = nullptr;
+  other.read_pos_ = nullptr;
+  other.released_pos_ = nullptr;
+#ifdef _WIN32
+  other.mapping_handle_ = nullptr;
+#endif
+}
+
+InMmapFileStream& InMmapFileStream::operator=(InMmapFileStream&& rhs) noexcept {
+  std::swap(data_, rhs.data_);
+  std::swap(end_, rhs.end_);
+  std::swap(read_pos_, rhs.read_pos_);
+  std::swap(released_pos_, rhs.released_pos_);
+#ifdef _WIN32
+  std::swap(mapping_handle_, rhs.mapping_handle_);
+#endif
+  return *this;
+}
+
+InMmapFileStream::~InMmapFileStream() { Unmap(); }
+
+void InMmapFileStream::ReadExact(std::byte* buffer, std::size_t length) {
+  const auto size = ReadSome(buffer, length);
+  if (size != length) {
+    std::ostringstream err_msg;
+    err_msg << "Unexpected end of file, expected " << length << " bytes, got " << size;
+    throw DbnResponseError{err_msg.str()};
+  }
+}
+
+std::size_t InMmapFileStream::ReadSome(std::byte* buffer, std::size_t max_length) {
+  const auto read_size = std::min(ReadCapacity(), max_length);
+  std::copy(ReadBegin(), ReadBegin() + read_size, buffer);
+  Consume(read_size);
+  return read_size;
+}
+
+databento::IReadable::Result InMmapFileStream::ReadSome(std::byte* buffer,
+                                                        std::size_t max_length,
+                                                        std::chrono::milliseconds) {
+  const auto bytes_read = ReadSome(buffer, max_length);
+  return {bytes_read, bytes_read > 0 ? Status::Ok : Status::Closed};
+}
+
+void InMmapFileStream::Consume(std::size_t length) {
+  read_pos_ += length;
+  if (static_cast<std::size_t>(read_pos_ - released_pos_) >=
+      kReleaseInterval + kReleaseLag) {
+    ReleaseConsumed();
+  }
+}
+
+void InMmapFileStream::ReleaseConsumed() {
+#ifndef _WIN32
+  // `madvise` requires page alignment. The mapping itself is page-aligned
+  static const auto kPageSize = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+  const auto release_end =
+      reinterpret_cast<std::uintptr_t>(read_pos_ - kReleaseLag) & ~(kPageSize - 1);
+  const auto release_begin = reinterpret_cast<std::uintptr_t>(released_pos_);
+  if (release_end > release_begin) {
+    // Dropping the pages is safe because they've already been read. The page cache
+    // keeps the file data, but it no longer counts against this process
+    ::madvise(released_pos_, release_end - release_begin, MADV_DONTNEED);
+    released_pos_ = reinterpret_cast<std::byte*>(release_end);
+  }
+#else
+  released_pos_ = read_pos_;
+#endif
+}
+
+void InMmapFileStream::Unmap() {
+#ifdef _WIN32
+  if (data_ != nullptr) {
+    ::UnmapViewOfFile(data_);
+  }
+  if (mapping_handle_ != nullptr) {
+    ::CloseHandle(mapping_handle_);
+    mapping_handle_ = nullptr;
+  }
+#else
+  if (data_ != nullptr) {
+    ::munmap(data_, static_cast<std::size_t>(end_ - data_));
+  }
+#endif
+  data_ = nullptr;
+  end_ = nullptr;
+  read_pos_ = nullptr;
+  released_pos_ = nullptr;
+}
+
+using databento::InUringFileStream;
+
+InUringFileStream::InUringFileStream(
+    [[maybe_unused]] const std::filesystem::path& file_path) {
+#ifdef DATABENTO_IO_URING
+  reader_ = std::make_unique<detail::UringFileReader>(file_path);
+#else
+  throw Exception{"InUringFileStream requires building with DATABENTO_ENABLE_IO_URING"};
+#endif
+}
+
+InUringFileStream::InUringFileStream(InUringFileStream&&) noexcept = default;
+InUringFileStream& InUringFileStream::operator=(InUringFileStream&&) noexcept =
+    default;
+InUringFileStream::~InUringFileStream() = default;
+
+void InUringFileStream::ReadExact(std::byte* buffer, std::size_t length) {
+  const auto size = ReadSome(buffer, length);
+  if (size != length) {
+    std::ostringstream err_msg;
+    err_msg << "Unexpected end of file, expected " << length << " bytes, got " << size;
+    throw DbnResponseError{err_msg.str()};
+  }
+}
+
+std::size_t InUringFileStream::ReadSome([[maybe_unused]] std::byte* buffer,
+                                        [[maybe_unused]] std::size_t max_length) {
+#ifdef DATABENTO_IO_URING
+  return reader_->ReadSome(buffer, max_length);
+#else
+  return 0;
+#endif
+}
+
+databento::IReadable::Result InUringFileStream::ReadSome(std::byte* buffer,
+                                                         std::size_t max_length,
+                                                         std::chrono::milliseconds) {
+  const auto bytes_read = ReadSome(buffer, max_length);
+  return {bytes_read, bytes_read > 0 ? Status::Ok : Status::Closed};
+}
+
 using databento::OutFileStream;
 
 OutFileStream::OutFileStream(const std::filesystem::path& file_path)
@@ -924,6 +924,35 @@ databento::SymbologyResolution Historical::SymbologyResolve(
   return res;
 }
 
+databento::SymbologyFile Historical::SymbologyResolve(
+    const std::string& dataset, const std::vector<std::string>& symbols, SType stype_in,
+    SType stype_out, const DateRange& date_range, const SymbologyCache& cache) {
+  static const std::string kEndpoint = "Historical::SymbologyResolve";
+  const auto parse_date = [](const std::string& param, const std::string& raw_date) {
+    std::istringstream date_stream{raw_date};
+    date::year_month_day date;
+    date_stream >> date::parse("%F", date);
+    // Rejects trailing characters
+    if (raw_date.empty() || date_stream.fail() ||
+        date_stream.peek() != std::char_traits<char>::eof()) {
+      throw InvalidArgumentError{kEndpoint, param, "Expected YYYY-MM-DD date string"};
+    }
+    return date;
+  };
+  return cache.Resolve(
+      dataset, symbols, stype_in, stype_out,
+      parse_date("date_range.start", date_range.start),
+      parse_date("date_range.end", date_range.end),
+      [&](date::year_month_day start_date, date::year_month_day end_date) {
+        std::ostringstream start_ss;
+        start_ss << start_date;
+        std::ostringstream end_ss;
+        end_ss << end_date;
+        return SymbologyResolve(dataset, symbols, stype_in, stype_out,
+                                DateRange{start_ss.str(), end_ss.str()});
+      });
+}
+
 constexpr std::string_view kTimeseriesGetRangeEndpoint =
     "Historical::TimeseriesGetRange";
 
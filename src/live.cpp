@@ -95,6 +95,16 @@ LiveBuilder& LiveBuilder::SetTimeoutConf(TimeoutConf timeout_conf) {
   return *this;
 }
 
+LiveBuilder& LiveBuilder::SetLowLatencyConf(LowLatencyConf low_latency_conf) {
+  low_latency_conf_ = low_latency_conf;
+  return *this;
+}
+
+LiveBuilder& LiveBuilder::SetCollectStats(bool collect_stats) {
+  collect_stats_ = collect_stats;
+  return *this;
+}
+
 databento::LiveBlocking LiveBuilder::BuildBlocking() {
   Validate();
   if (gateway_.empty()) {
@@ -103,7 +113,8 @@ databento::LiveBlocking LiveBuilder::BuildBlocking() {
                                    upgrade_policy_, heartbeat_interval_,
                                    buffer_size_,    user_agent_ext_,
                                    compression_,    slow_reader_behavior_,
-                                   timeout_conf_};
+                                   timeout_conf_,   low_latency_conf_,
+                                 collect_stats_};
   }
   return databento::LiveBlocking{log_receiver_,   key_,
                                  dataset_,        gateway_,
@@ -111,7 +122,8 @@ databento::LiveBlocking LiveBuilder::BuildBlocking() {
                                  upgrade_policy_, heartbeat_interval_,
                                  buffer_size_,    user_agent_ext_,
                                  compression_,    slow_reader_behavior_,
-                                 timeout_conf_};
+                                 timeout_conf_,   low_latency_conf_,
+                                 collect_stats_};
 }
 
 databento::LiveThreaded LiveBuilder::BuildThreaded() {
@@ -122,7 +134,8 @@ databento::LiveThreaded LiveBuilder::BuildThreaded() {
                                    upgrade_policy_, heartbeat_interval_,
                                    buffer_size_,    user_agent_ext_,
                                    compression_,    slow_reader_behavior_,
-                                   timeout_conf_};
+                                   timeout_conf_,   low_latency_conf_,
+                                 collect_stats_};
   }
   return databento::LiveThreaded{log_receiver_,   key_,
                                  dataset_,        gateway_,
@@ -130,7 +143,8 @@ databento::LiveThreaded LiveBuilder::BuildThreaded() {
                                  upgrade_policy_, heartbeat_interval_,
                                  buffer_size_,    user_agent_ext_,
                                  compression_,    slow_reader_behavior_,
-                                 timeout_conf_};
+                                 timeout_conf_,   low_latency_conf_,
+                                 collect_stats_};
 }
 
 void LiveBuilder::Validate() {
@@ -6,6 +6,7 @@
 #include <cstddef>  // ptrdiff_t
 #include <cstdlib>
 #include <limits>
+#include <memory>  // make_shared, make_unique
 #include <sstream>
 #include <variant>
 
@@ -35,6 +36,13 @@ databento::detail::TcpClient::RetryConf RetryConfFrom(
   retry_conf.connect_timeout = timeout_conf.connect;
   return retry_conf;
 }
+
+databento::detail::TcpClient::SocketConf SocketConfFrom(
+    const databento::LowLatencyConf& low_latency_conf) {
+  return {low_latency_conf.spin, low_latency_conf.busy_poll,
+          low_latency_conf.rcv_lowat, low_latency_conf.io_uring,
+          low_latency_conf.rx_timestamps};
+}
 }  // namespace
 
 databento::LiveBuilder LiveBlocking::Builder() { return databento::LiveBuilder{}; }
@@ -45,7 +53,8 @@ LiveBlocking::LiveBlocking(
     std::optional<std::chrono::seconds> heartbeat_interval, std::size_t buffer_size,
     std::string user_agent_ext, databento::Compression compression,
     std::optional<databento::SlowReaderBehavior> slow_reader_behavior,
-    databento::TimeoutConf timeout_conf)
+    databento::TimeoutConf timeout_conf, databento::LowLatencyConf low_latency_conf,
+    bool collect_stats)
     : log_receiver_{log_receiver},
       key_{std::move(key)},
       dataset_{std::move(dataset)},
@@ -58,9 +67,13 @@ LiveBlocking::LiveBlocking(
       compression_{compression},
       slow_reader_behavior_{slow_reader_behavior},
       timeout_conf_{timeout_conf},
-      connection_{log_receiver_, gateway_, port_, RetryConfFrom(timeout_conf_)},
-      buffer_{buffer_size},
-      session_id_{this->Authenticate()} {}
+      low_latency_conf_{low_latency_conf},
+      connection_{log_receiver_, gateway_, port_, RetryConfFrom(timeout_conf_),
+                  SocketConfFrom(low_latency_conf_)},
+      slab_pool_{std::make_shared<detail::SlabPool>(buffer_size)},
+      buffer_{slab_pool_},
+      session_id_{this->Authenticate()},
+      stats_{collect_stats ? std::make_unique<detail::LiveStatsRecorder>() : nullptr} {}
 
 LiveBlocking::LiveBlocking(
     ILogReceiver* log_receiver, std::string key, std::string dataset,
@@ -69,7 +82,8 @@ LiveBlocking::LiveBlocking(
     std::optional<std::chrono::seconds> heartbeat_interval, std::size_t buffer_size,
     std::string user_agent_ext, databento::Compression compression,
     std::optional<databento::SlowReaderBehavior> slow_reader_behavior,
-    databento::TimeoutConf timeout_conf)
+    databento::TimeoutConf timeout_conf, databento::LowLatencyConf low_latency_conf,
+    bool collect_stats)
     : log_receiver_{log_receiver},
       key_{std::move(key)},
       dataset_{std::move(dataset)},
@@ -82,9 +96,13 @@ LiveBlocking::LiveBlocking(
       compression_{compression},
       slow_reader_behavior_{slow_reader_behavior},
       timeout_conf_{timeout_conf},
-      connection_{log_receiver_, gateway_, port_, RetryConfFrom(timeout_conf_)},
-      buffer_{buffer_size},
-      session_id_{this->Authenticate()} {}
+      low_latency_conf_{low_latency_conf},
+      connection_{log_receiver_, gateway_, port_, RetryConfFrom(timeout_conf_),
+                  SocketConfFrom(low_latency_conf_)},
+      slab_pool_{std::make_shared<detail::SlabPool>(buffer_size)},
+      buffer_{slab_pool_},
+      session_id_{this->Authenticate()},
+      stats_{collect_stats ? std::make_unique<detail::LiveStatsRecorder>() : nullptr} {}
 
 void LiveBlocking::Subscribe(const std::vector<std::string>& symbols, Schema schema,
                              SType stype_in) {
@@ -172,7 +190,7 @@ databento::Metadata LiveBlocking::Start() {
   log_receiver_->Receive(LogLevel::Info, "[LiveBlocking::Start] Starting session");
 
   connection_.WriteAll("start_session\n");
-  connection_.SetCompression(compression_);
+  connection_.SetCompression(compression_, stats_ != nullptr);
   connection_.ReadExact(buffer_.WriteBegin(), kMetadataPreludeSize);
   buffer_.Fill(kMetadataPreludeSize);
   const auto [version, size] = DbnDecoder::DecodeMetadataVersionAndSize(
@@ -188,6 +206,7 @@ databento::Metadata LiveBlocking::Start() {
   // alignment
   buffer_.Shift();
   version_ = metadata.version;
+  upgrade_record_ = DbnDecoder::SelectUpgrade(version_, upgrade_policy_);
   metadata.Upgrade(upgrade_policy_);
   last_read_time_ = std::chrono::steady_clock::now();
   return metadata;
@@ -242,6 +261,22 @@ const databento::Record* LiveBlocking::TryNextRecord() {
   return ConsumeBufferedRecord();
 }
 
+databento::RecordRef LiveBlocking::NextRecordRef() {
+  return PinRecord(NextRecord());
+}
+
+databento::RecordRef LiveBlocking::NextRecordRef(std::chrono::milliseconds timeout) {
+  const auto* rec = NextRecord(timeout);
+  if (rec == nullptr) {
+    return {};
+  }
+  return PinRecord(*rec);
+}
+
+databento::LiveStats LiveBlocking::Stats() const {
+  return stats_ ? stats_->Snapshot() : LiveStats{};
+}
+
 void LiveBlocking::Stop() { connection_.Close(); }
 
 void LiveBlocking::Reconnect() {
@@ -251,8 +286,12 @@ void LiveBlocking::Reconnect() {
     log_receiver_->Receive(LogLevel::Info, log_msg.str());
   }
   connection_ = detail::LiveConnection{log_receiver_, gateway_, port_,
-                                       RetryConfFrom(timeout_conf_)};
+                                       RetryConfFrom(timeout_conf_),
+                                       SocketConfFrom(low_latency_conf_)};
   buffer_.Clear();
+  rx_reads_.clear();
+  rx_consumed_ = 0;
+  last_record_rx_ts_ = {};
   sub_counter_ = 0;
   session_id_ = this->Authenticate();
   last_read_time_ = std::chrono::steady_clock::now();
@@ -496,6 +535,16 @@ databento::IReadable::Result LiveBlocking::FillBuffer(
   buffer_.Fill(read_res.read_size);
   if (read_res.read_size > 0) {
     last_read_time_ = std::chrono::steady_clock::now();
+    if (low_latency_conf_.rx_timestamps) {
+      rx_reads_.push_back(
+          {rx_consumed_ + buffer_.ReadCapacity(), connection_.LastRxTs()});
+    }
+    if (stats_) {
+      stats_->RecordRead(read_res.read_size);
+    }
+  }
+  if (stats_ && compression_ == databento::Compression::Zstd) {
+    stats_->AddDecompressTime(connection_.TakeDecompressTime());
   }
   return read_res;
 }
@@ -503,11 +552,40 @@ databento::IReadable::Result LiveBlocking::FillBuffer(
 const databento::Record* LiveBlocking::ConsumeBufferedRecord() {
   current_record_ = Record{BufferRecordHeader()};
   buffer_.Consume(current_record_.Size());
-  current_record_ = DbnDecoder::DecodeRecordCompat(
-      version_, upgrade_policy_, send_ts_out_, &compat_buffer_, current_record_);
+  if (low_latency_conf_.rx_timestamps) {
+    TrackRxTs(current_record_.Size());
+  }
+  if (upgrade_record_ != nullptr &&
+      upgrade_record_(current_record_.Header(), send_ts_out_, compat_buffer_.data()) >
+          0) {
+    current_record_ = Record{reinterpret_cast<RecordHeader*>(compat_buffer_.data())};
+  }
+  if (stats_) {
+    stats_->RecordRecord(current_record_, send_ts_out_, last_record_rx_ts_);
+  }
   return &current_record_;
 }
 
+void LiveBlocking::TrackRxTs(std::size_t record_size) {
+  rx_consumed_ += record_size;
+  // A record is timestamped by the read that received its last byte
+  while (!rx_reads_.empty() && rx_reads_.front().end < rx_consumed_) {
+    rx_reads_.pop_front();
+  }
+  last_record_rx_ts_ = rx_reads_.empty() ? UnixNanos{} : rx_reads_.front().rx_ts;
+}
+
+databento::RecordRef LiveBlocking::PinRecord(const Record& record) {
+  const auto* record_begin = reinterpret_cast<const std::byte*>(&record.Header());
+  if (record_begin != compat_buffer_.data()) {
+    // Still in the slab backing `buffer_`, which moves to a new slab rather than
+    // overwrite it while it's pinned
+    return RecordRef{buffer_.Slab(), const_cast<RecordHeader*>(&record.Header())};
+  }
+  // Upgraded records are copied into a separate slab
+  return compat_copier_.Copy(*slab_pool_, record);
+}
+
 databento::RecordHeader* LiveBlocking::BufferRecordHeader() {
   return reinterpret_cast<RecordHeader*>(buffer_.ReadBegin());
 }
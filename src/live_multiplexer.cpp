@@ -0,0 +1,258 @@
+#include "databento/live_multiplexer.hpp"
+
+#ifdef _WIN32
+#include <winsock2.h>  // WSAPoll
+#else
+#include <sys/poll.h>  // poll, pollfd
+
+#include <cerrno>  // errno
+#endif
+
+#include <algorithm>  // any_of, copy, find, max, min, pop_heap, push_heap
+#include <tuple>      // tie
+#include <utility>    // move
+
+#include "databento/constants.hpp"   // kUndefTimestamp
+#include "databento/exceptions.hpp"  // InvalidArgumentError, LiveApiError, TcpError
+
+using databento::LiveMultiplexer;
+using Status = databento::IReadable::Status;
+
+namespace {
+// The longest to wait for more data from a session that polled readable, which only
+// matters when a compressed frame is split across reads
+constexpr std::chrono::milliseconds kFillTimeout{1};
+// How often `NextRecord()` checks for heartbeat timeouts
+constexpr std::chrono::seconds kHeartbeatCheckInterval{1};
+
+// Orders the heap of held records with the earliest at the front
+constexpr auto kIsLater = [](const auto& lhs, const auto& rhs) {
+  return std::tie(lhs.ts, lhs.sequence) > std::tie(rhs.ts, rhs.sequence);
+};
+
+bool IsUndefTs(databento::UnixNanos ts) {
+  return ts.time_since_epoch().count() == databento::kUndefTimestamp;
+}
+
+// Adds `window` to `ts`, stopping at the maximum timestamp instead of wrapping
+databento::UnixNanos SaturatingAdd(databento::UnixNanos ts,
+                                   std::chrono::milliseconds window) {
+  const auto window_ns = static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(window).count());
+  const auto ts_ns = ts.time_since_epoch().count();
+  const auto sum_ns = window_ns > databento::kUndefTimestamp - ts_ns
+                          ? databento::kUndefTimestamp
+                          : ts_ns + window_ns;
+  return databento::UnixNanos{databento::UnixNanos::duration{sum_ns}};
+}
+
+int GetErrNo() {
+#ifdef _WIN32
+  return ::WSAGetLastError();
+#else
+  return errno;
+#endif
+}
+
+int Poll(std::vector<::pollfd>& fds, int timeout_ms) {
+#ifdef _WIN32
+  return ::WSAPoll(fds.data(), static_cast<ULONG>(fds.size()), timeout_ms);
+#else
+  return ::poll(fds.data(), fds.size(), timeout_ms);
+#endif
+}
+}  // namespace
+
+LiveMultiplexer::LiveMultiplexer(std::vector<LiveBlocking> sessions)
+    : LiveMultiplexer{std::move(sessions), {}} {}
+
+LiveMultiplexer::LiveMultiplexer(std::vector<LiveBlocking> sessions,
+                                 databento::MergeConf merge_conf)
+    : sessions_{std::move(sessions)},
+      merge_conf_{merge_conf},
+      pending_(sessions_.size()) {
+  static constexpr auto kMethod = "LiveMultiplexer::LiveMultiplexer";
+  if (sessions_.empty()) {
+    throw InvalidArgumentError{kMethod, "sessions", "must not be empty"};
+  }
+  if (merge_conf_.order == MergeOrder::TsOut &&
+      std::any_of(sessions_.begin(), sessions_.end(),
+                  [](const LiveBlocking& session) { return !session.SendTsOut(); })) {
+    throw InvalidArgumentError{
+        kMethod, "merge_conf",
+        "ordering by ts_out requires every session to have send_ts_out enabled"};
+  }
+}
+
+std::vector<databento::Metadata> LiveMultiplexer::Start() {
+  std::vector<Metadata> metadata;
+  metadata.reserve(sessions_.size());
+  for (auto& session : sessions_) {
+    metadata.emplace_back(session.Start());
+  }
+  return metadata;
+}
+
+const databento::Record& LiveMultiplexer::NextRecord() {
+  while (true) {
+    if (const auto* rec = NextRecord(kHeartbeatCheckInterval)) {
+      return *rec;
+    }
+  }
+}
+
+const databento::Record* LiveMultiplexer::NextRecord(
+    std::chrono::milliseconds timeout) {
+  if (released_slot_) {
+    free_slots_.push_back(*released_slot_);
+    released_slot_.reset();
+  }
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (true) {
+    if (const auto* rec = NextBufferedRecord()) {
+      return rec;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) {
+      CheckHeartbeatTimeouts();
+      return nullptr;
+    }
+    auto wait = deadline - now;
+    if (!held_.empty()) {
+      // Wake up in time to release the earliest held record
+      wait = (std::min)(wait,
+                        held_.front().held_since + merge_conf_.reorder_window - now);
+    }
+    PollAndFill(std::chrono::ceil<std::chrono::milliseconds>(wait));
+  }
+}
+
+void LiveMultiplexer::Run(const RecordCallback& record_callback) {
+  while (record_callback(NextRecord()) == KeepGoing::Continue) {
+  }
+  Stop();
+}
+
+void LiveMultiplexer::Stop() {
+  for (auto& session : sessions_) {
+    session.Stop();
+  }
+}
+
+const databento::Record* LiveMultiplexer::NextBufferedRecord() {
+  const auto count = sessions_.size();
+  if (merge_conf_.order == MergeOrder::Arrival) {
+    for (std::size_t i = 0; i < count; ++i) {
+      const auto idx = (next_session_ + i) % count;
+      if (const auto* rec = sessions_[idx].TryNextRecord()) {
+        next_session_ = (idx + 1) % count;
+        return rec;
+      }
+    }
+    return nullptr;
+  }
+  for (auto& session : sessions_) {
+    while (const auto* rec = session.TryNextRecord()) {
+      Hold(*rec);
+    }
+  }
+  return PopReleasable(std::chrono::steady_clock::now());
+}
+
+void LiveMultiplexer::Hold(const Record& record) {
+  std::size_t slot;
+  if (free_slots_.empty()) {
+    slot = slots_.size();
+    slots_.emplace_back(std::make_unique<Slot>());
+  } else {
+    slot = free_slots_.back();
+    free_slots_.pop_back();
+  }
+  const auto* record_begin = reinterpret_cast<const std::byte*>(&record.Header());
+  std::copy(record_begin, record_begin + record.Size(), slots_[slot]->data.data());
+  const auto ts = OrderTs(record);
+  // An undefined timestamp is the maximum value and would release everything else
+  // immediately
+  if (!IsUndefTs(ts)) {
+    max_ts_ = (std::max)(max_ts_, ts);
+  }
+  held_.push_back({ts, sequence_++, std::chrono::steady_clock::now(), slot});
+  std::push_heap(held_.begin(), held_.end(), kIsLater);
+}
+
+databento::UnixNanos LiveMultiplexer::OrderTs(const Record& record) const {
+  if (merge_conf_.order == MergeOrder::TsOut) {
+    // `ts_out` is appended to the end of the record
+    const auto* record_end =
+        reinterpret_cast<const std::byte*>(&record.Header()) + record.Size();
+    return *reinterpret_cast<const UnixNanos*>(record_end - sizeof(UnixNanos));
+  }
+  return record.IndexTs();
+}
+
+const databento::Record* LiveMultiplexer::PopReleasable(
+    std::chrono::steady_clock::time_point now) {
+  if (held_.empty()) {
+    return nullptr;
+  }
+  const auto& earliest = held_.front();
+  if (SaturatingAdd(earliest.ts, merge_conf_.reorder_window) > max_ts_ &&
+      now - earliest.held_since < merge_conf_.reorder_window &&
+      held_.size() <= merge_conf_.max_held) {
+    return nullptr;
+  }
+  std::pop_heap(held_.begin(), held_.end(), kIsLater);
+  released_slot_ = held_.back().slot;
+  held_.pop_back();
+  current_record_ =
+      Record{reinterpret_cast<RecordHeader*>(slots_[*released_slot_]->data.data())};
+  return &current_record_;
+}
+
+void LiveMultiplexer::PollAndFill(std::chrono::milliseconds timeout) {
+  std::vector<::pollfd> fds;
+  fds.reserve(sessions_.size());
+  for (std::size_t i = 0; i < sessions_.size(); ++i) {
+    const auto& connection = sessions_[i].connection_;
+    fds.push_back({connection.Fd(), POLLIN, {}});
+    // A partially read io_uring buffer doesn't make the descriptor readable
+    if (connection.HasBufferedData()) {
+      pending_[i] = true;
+    }
+  }
+  // Don't wait when a session already has data to read
+  const bool has_pending = std::find(pending_.begin(), pending_.end(), true) !=
+                           pending_.end();
+  const int timeout_ms =
+      (has_pending || timeout.count() < 0) ? 0 : static_cast<int>(timeout.count());
+  if (Poll(fds, timeout_ms) < 0) {
+    const int err_num = ::GetErrNo();
+    if (err_num == EINTR) {
+      return;
+    }
+    throw TcpError{err_num, "Incorrect poll"};
+  }
+  for (std::size_t i = 0; i < sessions_.size(); ++i) {
+    if (pending_[i] || fds[i].revents != 0) {
+      Fill(i);
+    }
+  }
+}
+
+void LiveMultiplexer::Fill(std::size_t session_idx) {
+  auto& session = sessions_[session_idx];
+  session.buffer_.ShiftForSpace(kMaxRecordLen);
+  const auto capacity = session.buffer_.WriteCapacity();
+  const auto read_res = session.FillBuffer(kFillTimeout);
+  if (read_res.status == Status::Closed) {
+    throw LiveApiError{"Gateway closed the session for " + session.Dataset()};
+  }
+  pending_[session_idx] = session.Compression() == Compression::Zstd &&
+                          read_res.read_size == capacity;
+}
+
+void LiveMultiplexer::CheckHeartbeatTimeouts() const {
+  for (const auto& session : sessions_) {
+    session.CheckHeartbeatTimeout();
+  }
+}
@@ -0,0 +1,59 @@
+#include "databento/live_stats.hpp"
+
+#ifdef _MSC_VER
+#include <intrin.h>  // _BitScanReverse64
+#endif
+
+#include <algorithm>  // min
+#include <cmath>      // ceil
+
+using databento::LiveHistogram;
+
+namespace {
+// `value` must be nonzero
+std::size_t MostSignificantBit(std::uint64_t value) {
+#ifdef _MSC_VER
+  unsigned long idx;
+  ::_BitScanReverse64(&idx, value);
+  return idx;
+#else
+  return static_cast<std::size_t>(63 - __builtin_clzll(value));
+#endif
+}
+}  // namespace
+
+std::size_t LiveHistogram::BucketOf(std::uint64_t value) {
+  if (value < kSubBucketCount) {
+    return value;
+  }
+  const auto shift = MostSignificantBit(value) - kSubBucketBits;
+  const std::size_t sub_bucket = (value >> shift) & (kSubBucketCount - 1);
+  return (shift + 1) * kSubBucketCount + sub_bucket;
+}
+
+double LiveHistogram::Mean() const {
+  if (count_ == 0) {
+    return 0;
+  }
+  return static_cast<double>(sum_) / static_cast<double>(count_);
+}
+
+std::uint64_t LiveHistogram::ValueAtPercentile(double percentile) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  const auto rank = std::max<std::uint64_t>(
+      1, static_cast<std::uint64_t>(
+             std::ceil(percentile / 100 * static_cast<double>(count_))));
+  std::uint64_t seen = 0;
+  for (std::size_t bucket = 0; bucket < kBucketCount; ++bucket) {
+    seen += counts_[bucket];
+    if (seen >= rank) {
+      if (bucket + 1 == kBucketCount) {
+        return max_;
+      }
+      return (std::min)(BucketLowerBound(bucket + 1) - 1, max_);
+    }
+  }
+  return max_;
+}
@@ -1,26 +1,94 @@
 #include "databento/live_threaded.hpp"
 
+#ifdef __linux__
+#include <pthread.h>  // pthread_self, pthread_setaffinity_np
+#include <sched.h>    // cpu_set_t, CPU_SET, CPU_ZERO
+#endif
+
 #include <atomic>
 #include <chrono>  // milliseconds
 #include <condition_variable>
+#include <cstdint>
 #include <exception>
 #include <mutex>
 #include <sstream>
-#include <thread>
+#include <system_error>  // system_category
+#include <thread>   // this_thread
 #include <utility>  // forward, move, swap
+#include <vector>
 
 #include "databento/detail/scoped_thread.hpp"  // ScopedThread
+#include "databento/exceptions.hpp"            // InvalidArgumentError
 #include "databento/live.hpp"                  // LiveBuilder
 #include "databento/live_blocking.hpp"         // LiveBlocking
 #include "databento/log.hpp"                   // ILogReceiver
+#include "databento/record.hpp"                // Record
 
 using databento::LiveThreaded;
 
+namespace {
+void PinCurrentThread(databento::ILogReceiver* log_receiver, std::uint32_t cpu) {
+  static constexpr auto kMethodName = "LiveThreaded::ProcessingThread";
+#ifdef __linux__
+  ::cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+  const int err_num =
+      ::pthread_setaffinity_np(::pthread_self(), sizeof(cpu_set), &cpu_set);
+  if (err_num != 0) {
+    std::ostringstream log_ss;
+    log_ss << '[' << kMethodName << "] Failed to pin thread to CPU " << cpu << ": "
+           << std::system_category().message(err_num);
+    log_receiver->Receive(databento::LogLevel::Warning, log_ss.str());
+  }
+#else
+  std::ostringstream log_ss;
+  log_ss << '[' << kMethodName << "] Ignoring CPU affinity of " << cpu
+         << ", which is only supported on Linux";
+  log_receiver->Receive(databento::LogLevel::Warning, log_ss.str());
+#endif
+}
+
+// Records that aren't specific to one instrument are passed to every shard
+bool IsBroadcast(databento::RType rtype) {
+  return rtype == databento::RType::SymbolMapping ||
+         rtype == databento::RType::System || rtype == databento::RType::Error;
+}
+
+std::size_t ShardOf(std::uint32_t instrument_id, std::size_t shard_count) {
+  // Fibonacci hashing spreads out sequential IDs
+  constexpr std::uint64_t kMultiplier = 0x9E3779B97F4A7C15;
+  return ((instrument_id * kMultiplier) >> 32) % shard_count;
+}
+}  // namespace
+
 struct LiveThreaded::Impl {
   template <typename... A>
   explicit Impl(ILogReceiver* log_recv, A&&... args)
       : log_receiver{log_recv}, blocking{log_receiver, std::forward<A>(args)...} {}
 
+  // Unblocks a push waiting for space
+  void CloseQueues() {
+    if (queue != nullptr) {
+      queue->Close();
+    }
+    for (auto& shard_queue : shard_queues) {
+      shard_queue->Close();
+    }
+  }
+
+  // Starting from the callback thread would deadlock, so it's logged and ignored
+  bool IsCallbackThread() {
+    if (std::this_thread::get_id() != thread_id_) {
+      return false;
+    }
+    std::ostringstream log_ss;
+    log_ss << "[LiveThreaded::Start] Called Start from callback thread, which "
+              "would cause a deadlock. Ignoring.";
+    log_receiver->Receive(LogLevel::Warning, log_ss.str());
+    return true;
+  }
+
   void NotifyOfStop() {
     const std::lock_guard<std::mutex> lock{last_cb_ret_mutex};
     last_cb_ret = KeepGoing::Stop;
@@ -28,6 +96,14 @@ struct LiveThreaded::Impl {
   }
 
   ILogReceiver* log_receiver;
+  // Non-owning. Set when records are handed off to a queue
+  RecordQueue* queue{};
+  // Set in sharded mode
+  std::vector<std::unique_ptr<RecordQueue>> shard_queues;
+  RecordCallback shard_record_cb;
+  ExceptionCallback shard_exception_cb;
+  // Set when the record callback returns Stop on a shard thread
+  std::atomic<bool> is_shard_stopped{};
   std::atomic<std::thread::id> thread_id_{};
   // Set to false when destructor is called
   std::atomic<bool> keep_going{true};
@@ -35,6 +111,8 @@ struct LiveThreaded::Impl {
   std::mutex last_cb_ret_mutex;
   std::condition_variable last_cb_ret_cv;
   LiveBlocking blocking;
+  // Declared last so the shard threads are joined before the queues are destroyed
+  std::vector<detail::ScopedThread> shard_threads;
 };
 
 databento::LiveBuilder LiveThreaded::Builder() { return databento::LiveBuilder{}; }
@@ -45,6 +123,7 @@ LiveThreaded::LiveThreaded(LiveThreaded&& other) noexcept
 LiveThreaded& LiveThreaded::operator=(LiveThreaded&& rhs) noexcept {
   if (impl_) {
     impl_->keep_going.store(false, std::memory_order_relaxed);
+    impl_->CloseQueues();
   }
   std::swap(impl_, rhs.impl_);
   std::swap(thread_, rhs.thread_);
@@ -54,6 +133,7 @@ LiveThreaded& LiveThreaded::operator=(LiveThreaded&& rhs) noexcept {
 LiveThreaded::~LiveThreaded() {
   if (impl_) {
     impl_->keep_going.store(false, std::memory_order_relaxed);
+    impl_->CloseQueues();
   }
 }
 
@@ -63,11 +143,13 @@ LiveThreaded::LiveThreaded(
     std::optional<std::chrono::seconds> heartbeat_interval, std::size_t buffer_size,
     std::string user_agent_ext, databento::Compression compression,
     std::optional<databento::SlowReaderBehavior> slow_reader_behavior,
-    databento::TimeoutConf timeout_conf)
+    databento::TimeoutConf timeout_conf, databento::LowLatencyConf low_latency_conf,
+    bool collect_stats)
     : impl_{std::make_unique<Impl>(log_receiver, std::move(key), std::move(dataset),
                                    send_ts_out, upgrade_policy, heartbeat_interval,
                                    buffer_size, std::move(user_agent_ext), compression,
-                                   slow_reader_behavior, timeout_conf)} {}
+                                   slow_reader_behavior, timeout_conf,
+                                   low_latency_conf, collect_stats)} {}
 
 LiveThreaded::LiveThreaded(
     ILogReceiver* log_receiver, std::string key, std::string dataset,
@@ -76,12 +158,14 @@ LiveThreaded::LiveThreaded(
     std::optional<std::chrono::seconds> heartbeat_interval, std::size_t buffer_size,
     std::string user_agent_ext, databento::Compression compression,
     std::optional<databento::SlowReaderBehavior> slow_reader_behavior,
-    databento::TimeoutConf timeout_conf)
-    : impl_{std::make_unique<Impl>(
-          log_receiver, std::move(key), std::move(dataset), std::move(gateway), port,
-          send_ts_out, upgrade_policy, heartbeat_interval, buffer_size,
-          std::move(user_agent_ext), compression, slow_reader_behavior, timeout_conf)} {
-}
+    databento::TimeoutConf timeout_conf, databento::LowLatencyConf low_latency_conf,
+    bool collect_stats)
+    : impl_{std::make_unique<Impl>(log_receiver, std::move(key), std::move(dataset),
+                                   std::move(gateway), port, send_ts_out,
+                                   upgrade_policy, heartbeat_interval, buffer_size,
+                                   std::move(user_agent_ext), compression,
+                                   slow_reader_behavior, timeout_conf,
+                                   low_latency_conf, collect_stats)} {}
 
 const std::string& LiveThreaded::Key() const { return impl_->blocking.Key(); }
 
@@ -113,6 +197,10 @@ const databento::TimeoutConf& LiveThreaded::TimeoutConf() const {
   return impl_->blocking.TimeoutConf();
 }
 
+const databento::LowLatencyConf& LiveThreaded::LowLatencyConf() const {
+  return impl_->blocking.LowLatencyConf();
+}
+
 std::uint64_t LiveThreaded::SessionId() const { return impl_->blocking.SessionId(); }
 
 const std::vector<databento::LiveSubscription>& LiveThreaded::Subscriptions() const {
@@ -123,6 +211,8 @@ std::vector<databento::LiveSubscription>& LiveThreaded::Subscriptions() {
   return impl_->blocking.Subscriptions();
 }
 
+databento::LiveStats LiveThreaded::Stats() const { return impl_->blocking.Stats(); }
+
 void LiveThreaded::Subscribe(const std::vector<std::string>& symbols, Schema schema,
                              SType stype_in) {
   impl_->blocking.Subscribe(symbols, schema, stype_in);
@@ -155,18 +245,97 @@ void LiveThreaded::Start(databento::MetadataCallback metadata_callback,
 void LiveThreaded::Start(MetadataCallback metadata_callback,
                          RecordCallback record_callback,
                          ExceptionCallback exception_callback) {
-  // Deadlock check
-  if (std::this_thread::get_id() == impl_->thread_id_) {
-    std::ostringstream log_ss;
-    log_ss << "[LiveThreaded::Start] Called Start from callback thread, which "
-              "would cause a deadlock. Ignoring.";
-    impl_->log_receiver->Receive(LogLevel::Warning, log_ss.str());
+  if (impl_->IsCallbackThread()) {
     return;
   }
   // Safe to pass raw pointer because `thread_` cannot outlive `impl_`
   thread_ = detail::ScopedThread{
-      &LiveThreaded::ProcessingThread, impl_.get(), std::move(metadata_callback),
-      std::move(record_callback), std::move(exception_callback)};
+      [](Impl* impl, MetadataCallback&& metadata_cb, RecordCallback&& record_cb,
+         ExceptionCallback&& exception_cb) {
+        ProcessingThread(impl, std::move(metadata_cb), std::move(record_cb),
+                         std::move(exception_cb));
+        // Signal the consumers that no more records will be pushed
+        impl->CloseQueues();
+      },
+      impl_.get(), std::move(metadata_callback), std::move(record_callback),
+      std::move(exception_callback)};
+}
+
+void LiveThreaded::Start(RecordQueue* queue) { Start({}, queue, {}); }
+
+void LiveThreaded::Start(MetadataCallback metadata_callback, RecordQueue* queue) {
+  Start(std::move(metadata_callback), queue, {});
+}
+
+void LiveThreaded::Start(MetadataCallback metadata_callback, RecordQueue* queue,
+                         ExceptionCallback exception_callback) {
+  if (queue == nullptr) {
+    throw InvalidArgumentError{"LiveThreaded::Start", "queue", "must not be null"};
+  }
+  impl_->queue = queue;
+  // Records dropped by the queue's overflow policy don't stop the session
+  Start(
+      std::move(metadata_callback),
+      [queue](const Record& record) {
+        queue->Push(record);
+        return KeepGoing::Continue;
+      },
+      std::move(exception_callback));
+}
+
+void LiveThreaded::Start(RecordCallback record_callback, ShardConf shard_conf) {
+  Start({}, std::move(record_callback), {}, shard_conf);
+}
+
+void LiveThreaded::Start(MetadataCallback metadata_callback,
+                         RecordCallback record_callback,
+                         ExceptionCallback exception_callback, ShardConf shard_conf) {
+  static constexpr auto kMethodName = "LiveThreaded::Start";
+  if (shard_conf.shard_count == 0) {
+    throw InvalidArgumentError{kMethodName, "shard_conf.shard_count",
+                               "must be greater than 0"};
+  }
+  if (!record_callback) {
+    throw InvalidArgumentError{kMethodName, "record_callback", "must not be empty"};
+  }
+  auto* impl = impl_.get();
+  // Checked before creating the shards so they aren't left idle
+  if (impl->IsCallbackThread()) {
+    return;
+  }
+  if (!impl->shard_threads.empty()) {
+    throw InvalidArgumentError{kMethodName, "shard_conf",
+                               "can only start sharded dispatch once"};
+  }
+  impl->shard_record_cb = std::move(record_callback);
+  impl->shard_exception_cb = exception_callback;
+  impl->shard_queues.reserve(shard_conf.shard_count);
+  for (std::size_t i = 0; i < shard_conf.shard_count; ++i) {
+    impl->shard_queues.emplace_back(std::make_unique<RecordQueue>(
+        shard_conf.queue_capacity, RecordQueue::OverflowPolicy::Block));
+  }
+  impl->shard_threads.reserve(shard_conf.shard_count);
+  for (std::size_t i = 0; i < shard_conf.shard_count; ++i) {
+    impl->shard_threads.emplace_back(&LiveThreaded::ShardThread, impl, i);
+  }
+  Start(
+      std::move(metadata_callback),
+      [impl](const Record& record) {
+        if (impl->is_shard_stopped.load(std::memory_order_acquire)) {
+          return KeepGoing::Stop;
+        }
+        auto& shard_queues = impl->shard_queues;
+        if (IsBroadcast(record.RType())) {
+          for (auto& shard_queue : shard_queues) {
+            shard_queue->Push(record);
+          }
+        } else {
+          shard_queues[ShardOf(record.Header().instrument_id, shard_queues.size())]
+              ->Push(record);
+        }
+        return KeepGoing::Continue;
+      },
+      std::move(exception_callback));
 }
 
 void LiveThreaded::Reconnect() { impl_->blocking.Reconnect(); }
@@ -202,6 +371,9 @@ void LiveThreaded::ProcessingThread(Impl* impl, MetadataCallback&& metadata_call
   constexpr std::chrono::milliseconds kTimeout{50};
 
   impl->thread_id_ = std::this_thread::get_id();
+  if (const auto cpu = impl->blocking.LowLatencyConf().cpu_affinity) {
+    PinCurrentThread(impl->log_receiver, *cpu);
+  }
   const auto metadata_cb{std::move(metadata_callback)};
   const auto record_cb{std::move(record_callback)};
   const auto exception_cb{std::move(exception_callback)};
@@ -226,11 +398,16 @@ void LiveThreaded::ProcessingThread(Impl* impl, MetadataCallback&& metadata_call
       try {
         const Record* rec = impl->blocking.NextRecord(kTimeout);
         if (rec) {
-          if (record_cb(*rec) == KeepGoing::Stop) {
+          if (CallRecordCallback(impl, record_cb, *rec) == KeepGoing::Stop) {
             impl->blocking.Stop();
             impl->NotifyOfStop();
             return;
           }
+        } else if (impl->is_shard_stopped.load(std::memory_order_acquire)) {
+          // A shard stopped while no records were being received
+          impl->blocking.Stop();
+          impl->NotifyOfStop();
+          return;
         }  // else timeout
       } catch (const std::exception& exc) {
         if (ExceptionHandler(impl, exception_cb, exc, kMethodName,
@@ -246,6 +423,58 @@ void LiveThreaded::ProcessingThread(Impl* impl, MetadataCallback&& metadata_call
   }
 }
 
+databento::KeepGoing LiveThreaded::CallRecordCallback(
+    Impl* impl, const RecordCallback& record_callback, const Record& record) {
+  auto* stats = impl->blocking.stats_.get();
+  if (stats == nullptr) {
+    return record_callback(record);
+  }
+  const auto start = std::chrono::steady_clock::now();
+  const auto keep_going = record_callback(record);
+  stats->RecordCallback(std::chrono::steady_clock::now() - start);
+  return keep_going;
+}
+
+void LiveThreaded::ShardThread(Impl* impl, std::size_t shard_idx) {
+  static constexpr auto kMethodName = "LiveThreaded::ShardThread";
+  constexpr std::size_t kBatchSize = 64;
+
+  auto& queue = *impl->shard_queues[shard_idx];
+  const auto& record_cb = impl->shard_record_cb;
+  const auto& exception_cb = impl->shard_exception_cb;
+  const auto callback = [impl, &record_cb, &exception_cb](const Record& record) {
+    auto keep_going = KeepGoing::Continue;
+    try {
+      keep_going = record_cb(record);
+    } catch (const std::exception& exc) {
+      // The session is unaffected, so restarting skips the record
+      std::ostringstream log_ss;
+      log_ss << kMethodName << " Caught exception in record callback: " << exc.what();
+      if (exception_cb && exception_cb(exc) == ExceptionAction::Restart) {
+        log_ss << ". Skipping record.";
+        impl->log_receiver->Receive(LogLevel::Warning, log_ss.str());
+        return KeepGoing::Continue;
+      }
+      log_ss << ". Stopping thread.";
+      impl->log_receiver->Receive(LogLevel::Error, log_ss.str());
+      keep_going = KeepGoing::Stop;
+    }
+    if (keep_going == KeepGoing::Stop) {
+      impl->is_shard_stopped.store(true, std::memory_order_release);
+      // Unblocks the network thread if it's waiting on a full queue
+      impl->CloseQueues();
+    }
+    return keep_going;
+  };
+  while (impl->keep_going.load(std::memory_order_relaxed) &&
+         !impl->is_shard_stopped.load(std::memory_order_acquire)) {
+    if (queue.PopBatch(callback, kBatchSize) == 0 && !queue.WaitForRecord()) {
+      // Closed and empty
+      return;
+    }
+  }
+}
+
 LiveThreaded::ExceptionAction LiveThreaded::ExceptionHandler(
     Impl* impl, const ExceptionCallback& exception_callback, const std::exception& exc,
     std::string_view pretty_function_name, std::string_view message) {
@@ -3,8 +3,9 @@
 #include <string>
 
 #include "databento/enums.hpp"
-#include "databento/exceptions.hpp"  // InvalidArgumentError
-#include "databento/pretty.hpp"      // Px
+#include "databento/exceptions.hpp"      // InvalidArgumentError
+#include "databento/pretty.hpp"          // Px
+#include "databento/record_visitor.hpp"  // VisitRecord
 #include "detail/stream_op_helper.hpp"
 
 using databento::Record;
@@ -16,6 +17,12 @@ std::size_t RecordHeader::Size() const {
 
 std::size_t Record::Size() const { return record_->Size(); }
 
+databento::UnixNanos Record::IndexTs() const {
+  UnixNanos ts = record_->ts_event;
+  VisitRecord(*this, [&ts](const auto& rec) { ts = rec.IndexTs(); });
+  return ts;
+}
+
 std::size_t Record::SizeOfSchema(const Schema schema) {
   switch (schema) {
     case Schema::Mbo: {
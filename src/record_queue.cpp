@@ -0,0 +1,190 @@
+#include "databento/record_queue.hpp"
+
+#include <algorithm>  // copy
+#include <mutex>      // lock_guard, unique_lock
+#include <thread>     // yield
+
+#include "databento/exceptions.hpp"
+
+using databento::RecordQueue;
+
+namespace {
+// With a single slot, a full slot's sequence would equal the position of the next
+// push, so the capacity is at least two
+std::size_t SlotCount(std::size_t n) {
+  std::size_t res = 2;
+  while (res < n) {
+    res <<= 1;
+  }
+  return res;
+}
+}  // namespace
+
+RecordQueue::RecordQueue(std::size_t capacity, OverflowPolicy overflow_policy)
+    : capacity_{SlotCount(capacity)}, overflow_policy_{overflow_policy} {
+  if (capacity == 0) {
+    throw InvalidArgumentError{"RecordQueue", "capacity", "must be greater than 0"};
+  }
+  slots_ = std::make_unique<Slot[]>(capacity_);
+  for (std::size_t i = 0; i < capacity_; ++i) {
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+RecordQueue::~RecordQueue() = default;
+
+bool RecordQueue::Push(const Record& record) {
+  if (IsClosed()) {
+    return false;
+  }
+  const auto pos = tail_.load(std::memory_order_relaxed);
+  auto& slot = slots_[pos & (capacity_ - 1)];
+  bool is_stalled = false;
+  // The slot is still in use by the record `capacity_` positions earlier
+  while (slot.sequence.load(std::memory_order_acquire) != pos) {
+    if (overflow_policy_ == OverflowPolicy::DropNewest) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    if (overflow_policy_ == OverflowPolicy::DropOldest &&
+        TryDropOldest(pos - capacity_)) {
+      break;
+    }
+    // Either blocking or the consumer is reading the oldest record
+    if (IsClosed()) {
+      return false;
+    }
+    if (!is_stalled && overflow_policy_ == OverflowPolicy::Block) {
+      is_stalled = true;
+      producer_stalls_.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::this_thread::yield();
+  }
+  const auto* record_begin = reinterpret_cast<const std::byte*>(&record.Header());
+  std::copy(record_begin, record_begin + record.Size(), slot.data.data());
+  slot.sequence.store(pos + 1, std::memory_order_release);
+  tail_.store(pos + 1, std::memory_order_release);
+  NotifyConsumer();
+  pushed_.fetch_add(1, std::memory_order_relaxed);
+  const std::size_t size = pos + 1 - head_.load(std::memory_order_relaxed);
+  if (size > high_water_mark_.load(std::memory_order_relaxed)) {
+    high_water_mark_.store(size, std::memory_order_relaxed);
+  }
+  return true;
+}
+
+void RecordQueue::Close() {
+  is_closed_.store(true, std::memory_order_release);
+  // Locking ensures a consumer that saw the queue open is already waiting
+  { const std::lock_guard<std::mutex> lock{wait_mutex_}; }
+  wait_cv_.notify_all();
+}
+
+const databento::Record* RecordQueue::TryPop() {
+  std::uint64_t pos{};
+  auto* slot = Claim(pos);
+  if (slot == nullptr) {
+    return nullptr;
+  }
+  const Record record{reinterpret_cast<RecordHeader*>(slot->data.data())};
+  std::copy(slot->data.data(), slot->data.data() + record.Size(), current_.data());
+  Release(slot, pos);
+  current_record_ = Record{reinterpret_cast<RecordHeader*>(current_.data())};
+  return &current_record_;
+}
+
+std::size_t RecordQueue::PopBatch(const RecordCallback& callback,
+                                  std::size_t max_count) {
+  std::size_t count = 0;
+  while (count < max_count) {
+    std::uint64_t pos{};
+    auto* slot = Claim(pos);
+    if (slot == nullptr) {
+      break;
+    }
+    KeepGoing keep_going;
+    try {
+      keep_going = callback(Record{reinterpret_cast<RecordHeader*>(slot->data.data())});
+    } catch (...) {
+      // Otherwise the slot would never be returned to the producer
+      Release(slot, pos);
+      throw;
+    }
+    Release(slot, pos);
+    ++count;
+    if (keep_going == KeepGoing::Stop) {
+      break;
+    }
+  }
+  return count;
+}
+
+bool RecordQueue::WaitForRecord() {
+  if (!Empty()) {
+    return true;
+  }
+  std::unique_lock<std::mutex> lock{wait_mutex_};
+  is_consumer_waiting_.store(true, std::memory_order_relaxed);
+  // Pairs with the fence in `NotifyConsumer`: either the producer sees the
+  // consumer waiting or the consumer sees the new record
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  wait_cv_.wait(lock, [this] { return !Empty() || IsClosed(); });
+  is_consumer_waiting_.store(false, std::memory_order_relaxed);
+  return !Empty();
+}
+
+std::size_t RecordQueue::Size() const {
+  // Loading the head first ensures the tail isn't behind it
+  const auto head = head_.load(std::memory_order_acquire);
+  const auto tail = tail_.load(std::memory_order_acquire);
+  return tail - head;
+}
+
+databento::RecordQueueStats RecordQueue::Stats() const {
+  return {pushed_.load(std::memory_order_relaxed),
+          dropped_.load(std::memory_order_relaxed),
+          producer_stalls_.load(std::memory_order_relaxed),
+          high_water_mark_.load(std::memory_order_relaxed)};
+}
+
+RecordQueue::Slot* RecordQueue::Claim(std::uint64_t& pos) {
+  pos = head_.load(std::memory_order_relaxed);
+  while (true) {
+    auto* slot = &slots_[pos & (capacity_ - 1)];
+    const auto sequence = slot->sequence.load(std::memory_order_acquire);
+    if (sequence == pos + 1) {
+      // On failure, `pos` is updated to the current head
+      if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        return slot;
+      }
+    } else if (sequence == pos) {
+      // Empty
+      return nullptr;
+    } else {
+      // The record was dropped by the producer
+      pos = head_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+void RecordQueue::Release(Slot* slot, std::uint64_t pos) {
+  slot->sequence.store(pos + capacity_, std::memory_order_release);
+}
+
+void RecordQueue::NotifyConsumer() {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (is_consumer_waiting_.load(std::memory_order_relaxed)) {
+    { const std::lock_guard<std::mutex> lock{wait_mutex_}; }
+    wait_cv_.notify_one();
+  }
+}
+
+bool RecordQueue::TryDropOldest(std::uint64_t pos) {
+  auto expected = pos;
+  if (!head_.compare_exchange_strong(expected, pos + 1, std::memory_order_acquire)) {
+    return false;
+  }
+  Release(&slots_[pos & (capacity_ - 1)], pos);
+  dropped_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
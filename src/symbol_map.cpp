@@ -2,8 +2,13 @@
 
 #include <date/date.h>
 
+#include <algorithm>  // find_if, lower_bound, max, min
+#include <cstddef>    // ptrdiff_t, size_t
+#include <cstring>    // memcpy
 #include <memory>
+#include <stdexcept>  // out_of_range
 #include <string>
+#include <utility>  // exchange, move
 
 #include "databento/datetime.hpp"
 #include "databento/dbn.hpp"
@@ -27,6 +32,39 @@ bool IsInverse(const databento::Metadata& metadata) {
       "Can only create symbol maps from metadata where InstrumentId is one "
       "of the stypes"};
 }
+
+// Calls `func(instrument_id, symbol)` for each instrument mapped on `date`.
+template <typename F>
+void ForEachMappingOnDate(const databento::Metadata& metadata,
+                          date::year_month_day date, const char* method_name,
+                          F&& func) {
+  using databento::MappingInterval;
+  using databento::UnixNanos;
+  if (date::sys_days{date} < date::floor<date::days>(metadata.start) ||
+      // need to compare with `end` as datetime to handle midnight case
+      UnixNanos{date::sys_days{date}} >= metadata.end) {
+    throw databento::InvalidArgumentError{method_name, "date", "Outside query range"};
+  }
+  const auto is_inverse = IsInverse(metadata);
+  for (const auto& mapping : metadata.mappings) {
+    const auto interval_it =
+        std::find_if(mapping.intervals.begin(), mapping.intervals.end(),
+                     [date](const MappingInterval& interval) {
+                       return date >= interval.start_date && date < interval.end_date;
+                     });
+    // Empty symbols in old symbology format
+    if (interval_it == mapping.intervals.end() || interval_it->symbol.empty()) {
+      continue;
+    }
+    if (is_inverse) {
+      func(static_cast<std::uint32_t>(std::stoul(mapping.raw_symbol)),
+           interval_it->symbol);
+    } else {
+      func(static_cast<std::uint32_t>(std::stoul(interval_it->symbol)),
+           mapping.raw_symbol);
+    }
+  }
+}
 }  // namespace
 
 TsSymbolMap::TsSymbolMap(const Metadata& metadata) {
@@ -73,34 +111,178 @@ void TsSymbolMap::Insert(std::uint32_t instrument_id, date::year_month_day start
   }
 }
 
-using databento::PitSymbolMap;
+using databento::FlatTsSymbolMap;
 
-PitSymbolMap::PitSymbolMap(const Metadata& metadata, date::year_month_day date) {
-  if (date::sys_days{date} < date::floor<date::days>(metadata.start) ||
-      // need to compare with `end` as datetime to handle midnight case
-      UnixNanos{date::sys_days{date}} >= metadata.end) {
-    throw InvalidArgumentError{"PitSymbolMap::PitSymbolMap", "date",
-                               "Outside query range"};
+FlatTsSymbolMap::FlatTsSymbolMap(const Metadata& metadata) {
+  const auto is_inverse = ::IsInverse(metadata);
+  std::size_t interval_count{};
+  for (const auto& mapping : metadata.mappings) {
+    interval_count += mapping.intervals.size();
   }
-  const auto is_inverse = IsInverse(metadata);
+  intervals_.reserve(interval_count);
+  blocks_.Reserve(is_inverse ? metadata.mappings.size() : interval_count);
   for (const auto& mapping : metadata.mappings) {
-    const auto interval_it =
-        std::find_if(mapping.intervals.begin(), mapping.intervals.end(),
-                     [date](const MappingInterval& interval) {
-                       return date >= interval.start_date && date < interval.end_date;
-                     });
-    // Empty symbols in old symbology format
-    if (interval_it == mapping.intervals.end() || interval_it->symbol.empty()) {
+    for (const auto& interval : mapping.intervals) {
+      // Handle old symbology format
+      if (interval.symbol.empty()) {
+        continue;
+      }
+      if (is_inverse) {
+        Insert(static_cast<std::uint32_t>(std::stoul(mapping.raw_symbol)),
+               interval.start_date, interval.end_date, interval.symbol);
+      } else {
+        Insert(static_cast<std::uint32_t>(std::stoul(interval.symbol)),
+               interval.start_date, interval.end_date, mapping.raw_symbol);
+      }
+    }
+  }
+}
+
+FlatTsSymbolMap::FlatTsSymbolMap(const FlatTsSymbolMap& other)
+    : intervals_{other.intervals_},
+      blocks_{other.blocks_},
+      unused_interval_count_{other.unused_interval_count_},
+      symbols_{other.symbols_} {
+  // The views in `other.symbol_idxs_` refer to `other.symbols_`
+  symbol_idxs_.reserve(symbols_.size());
+  for (std::size_t i = 0; i < symbols_.size(); ++i) {
+    symbol_idxs_.emplace(symbols_[i], static_cast<std::uint32_t>(i));
+  }
+}
+
+FlatTsSymbolMap& FlatTsSymbolMap::operator=(const FlatTsSymbolMap& other) {
+  if (this != &other) {
+    *this = FlatTsSymbolMap{other};
+  }
+  return *this;
+}
+
+void FlatTsSymbolMap::Insert(std::uint32_t instrument_id,
+                             date::year_month_day start_date,
+                             date::year_month_day end_date, std::string_view symbol) {
+  if (start_date > end_date) {
+    throw InvalidArgumentError{"FlatTsSymbolMap::Insert", "end_date",
+                               "can't be before start_date"};
+  }
+  if (start_date == end_date) {
+    // Ignore
+    return;
+  }
+  const Day end = date::sys_days{end_date}.time_since_epoch().count();
+  Day cur = date::sys_days{start_date}.time_since_epoch().count();
+  const auto symbol_idx = Intern(symbol);
+  auto& block =
+      *blocks_
+           .Insert(instrument_id,
+                   Block{static_cast<std::uint32_t>(intervals_.size()), 0})
+           .first;
+  MoveToEnd(block);
+  // The first interval that ends after `cur`
+  std::size_t idx = static_cast<std::size_t>(
+      std::lower_bound(intervals_.begin() + block.offset,
+                       intervals_.begin() + block.offset + block.count, cur,
+                       [](const Interval& interval, Day day) {
+                         return interval.end <= day;
+                       }) -
+      (intervals_.begin() + block.offset));
+  // Only fill the gaps between existing intervals so the first symbol inserted for
+  // each date is kept
+  while (cur < end) {
+    if (idx < block.count && intervals_[block.offset + idx].start <= cur) {
+      cur = intervals_[block.offset + idx].end;
+      ++idx;
       continue;
     }
-    if (is_inverse) {
-      const auto iid = static_cast<std::uint32_t>(std::stoul(mapping.raw_symbol));
-      map_.emplace(iid, interval_it->symbol);
-    } else {
-      const auto iid = static_cast<std::uint32_t>(std::stoul(interval_it->symbol));
-      map_.emplace(iid, mapping.raw_symbol);
+    const auto gap_end =
+        idx < block.count ? std::min(end, intervals_[block.offset + idx].start) : end;
+    idx = InsertAt(block, idx, Interval{cur, gap_end, symbol_idx});
+  }
+  if (unused_interval_count_ > intervals_.size() / 2) {
+    Compact();
+  }
+}
+
+const std::string& FlatTsSymbolMap::Checked(const std::string* symbol) {
+  if (symbol == nullptr) {
+    throw std::out_of_range{"FlatTsSymbolMap::At: no symbol for instrument on date"};
+  }
+  return *symbol;
+}
+
+std::uint32_t FlatTsSymbolMap::Intern(std::string_view symbol) {
+  const auto it = symbol_idxs_.find(symbol);
+  if (it != symbol_idxs_.end()) {
+    return it->second;
+  }
+  const auto symbol_idx = static_cast<std::uint32_t>(symbols_.size());
+  symbols_.emplace_back(symbol);
+  symbol_idxs_.emplace(symbols_.back(), symbol_idx);
+  return symbol_idx;
+}
+
+void FlatTsSymbolMap::MoveToEnd(Block& block) {
+  if (block.offset + block.count == intervals_.size()) {
+    return;
+  }
+  // Reserve first so the copied intervals aren't invalidated while copying
+  intervals_.reserve(intervals_.size() + block.count);
+  const auto offset = static_cast<std::uint32_t>(intervals_.size());
+  for (std::size_t i = 0; i < block.count; ++i) {
+    intervals_.push_back(intervals_[block.offset + i]);
+  }
+  unused_interval_count_ += block.count;
+  block.offset = offset;
+}
+
+std::size_t FlatTsSymbolMap::InsertAt(Block& block, std::size_t idx,
+                                      const Interval& interval) {
+  const std::size_t pos = block.offset + idx;
+  if (idx > 0) {
+    auto& prev = intervals_[pos - 1];
+    if (prev.end == interval.start && prev.symbol_idx == interval.symbol_idx) {
+      prev.end = interval.end;
+      if (idx < block.count && intervals_[pos].start == prev.end &&
+          intervals_[pos].symbol_idx == prev.symbol_idx) {
+        prev.end = intervals_[pos].end;
+        intervals_.erase(intervals_.begin() + static_cast<std::ptrdiff_t>(pos));
+        --block.count;
+      }
+      return idx - 1;
+    }
+  }
+  if (idx < block.count) {
+    auto& next = intervals_[pos];
+    if (next.start == interval.end && next.symbol_idx == interval.symbol_idx) {
+      next.start = interval.start;
+      return idx;
     }
   }
+  intervals_.insert(intervals_.begin() + static_cast<std::ptrdiff_t>(pos), interval);
+  ++block.count;
+  return idx;
+}
+
+void FlatTsSymbolMap::Compact() {
+  std::vector<Interval> intervals;
+  intervals.reserve(intervals_.size() - unused_interval_count_);
+  blocks_.ForEach([this, &intervals](std::uint32_t, Block& block) {
+    const auto offset = static_cast<std::uint32_t>(intervals.size());
+    intervals.insert(intervals.end(), intervals_.begin() + block.offset,
+                     intervals_.begin() + block.offset + block.count);
+    block.offset = offset;
+  });
+  intervals_ = std::move(intervals);
+  unused_interval_count_ = 0;
+}
+
+using databento::PitSymbolMap;
+
+PitSymbolMap::PitSymbolMap(const Metadata& metadata, date::year_month_day date) {
+  map_.reserve(metadata.mappings.size());
+  ::ForEachMappingOnDate(metadata, date, "PitSymbolMap::PitSymbolMap",
+                         [this](std::uint32_t iid, const std::string& symbol) {
+                           map_.emplace(iid, symbol);
+                         });
 }
 
 template <typename SymbolMappingRec>
@@ -124,6 +306,101 @@ void PitSymbolMap::OnRecord(const Record& record) {
   }
 }
 
+using databento::FlatPitSymbolMap;
+
+FlatPitSymbolMap::FlatPitSymbolMap(std::size_t instrument_count) {
+  Reserve(instrument_count);
+}
+
+FlatPitSymbolMap::FlatPitSymbolMap(const Metadata& metadata, date::year_month_day date)
+    : FlatPitSymbolMap{metadata.mappings.size()} {
+  ::ForEachMappingOnDate(metadata, date, "FlatPitSymbolMap::FlatPitSymbolMap",
+                         [this](std::uint32_t iid, const std::string& symbol) {
+                           // Keep the first mapping like `PitSymbolMap`
+                           if (Find(iid) == nullptr) {
+                             Insert(iid, symbol);
+                           }
+                         });
+}
+
+FlatPitSymbolMap::FlatPitSymbolMap(const FlatPitSymbolMap& other)
+    : FlatPitSymbolMap{other.Size()} {
+  // The views in `other` refer to its arena
+  other.map_.ForEach([this](std::uint32_t iid, std::string_view symbol) {
+    map_.Insert(iid, Store(symbol));
+  });
+}
+
+FlatPitSymbolMap& FlatPitSymbolMap::operator=(const FlatPitSymbolMap& other) {
+  if (this != &other) {
+    *this = FlatPitSymbolMap{other};
+  }
+  return *this;
+}
+
+FlatPitSymbolMap::FlatPitSymbolMap(FlatPitSymbolMap&& other) noexcept
+    : map_{std::move(other.map_)},
+      arena_blocks_{std::move(other.arena_blocks_)},
+      arena_pos_{std::exchange(other.arena_pos_, nullptr)},
+      arena_remaining_{std::exchange(other.arena_remaining_, 0)} {
+  other.arena_blocks_.clear();
+}
+
+FlatPitSymbolMap& FlatPitSymbolMap::operator=(FlatPitSymbolMap&& rhs) noexcept {
+  if (this != &rhs) {
+    map_ = std::move(rhs.map_);
+    arena_blocks_ = std::move(rhs.arena_blocks_);
+    rhs.arena_blocks_.clear();
+    arena_pos_ = std::exchange(rhs.arena_pos_, nullptr);
+    arena_remaining_ = std::exchange(rhs.arena_remaining_, 0);
+  }
+  return *this;
+}
+
+void FlatPitSymbolMap::Insert(std::uint32_t instrument_id, std::string_view symbol) {
+  const auto res = map_.Insert(instrument_id, std::string_view{});
+  if (!res.second && *res.first == symbol) {
+    return;
+  }
+  // Remapped symbols are left in the arena so views of them remain valid
+  *res.first = Store(symbol);
+}
+
+void FlatPitSymbolMap::OnRecord(const Record& record) {
+  if (record.RType() == RType::SymbolMapping) {
+    // Version compat
+    if (record.Header().Size() >= sizeof(SymbolMappingMsgV2)) {
+      OnSymbolMapping(record.Get<SymbolMappingMsgV2>());
+    } else {
+      OnSymbolMapping(record.Get<SymbolMappingMsgV1>());
+    }
+  }
+}
+
+std::string_view FlatPitSymbolMap::Checked(const std::string_view* symbol) {
+  if (symbol == nullptr) {
+    throw std::out_of_range{"FlatPitSymbolMap::At: no symbol for instrument"};
+  }
+  return *symbol;
+}
+
+std::string_view FlatPitSymbolMap::Store(std::string_view symbol) {
+  if (symbol.empty()) {
+    return {};
+  }
+  if (symbol.size() > arena_remaining_) {
+    const auto block_size = std::max(kArenaBlockSize, symbol.size());
+    arena_blocks_.emplace_back(new char[block_size]);
+    arena_pos_ = arena_blocks_.back().get();
+    arena_remaining_ = block_size;
+  }
+  std::memcpy(arena_pos_, symbol.data(), symbol.size());
+  const std::string_view res{arena_pos_, symbol.size()};
+  arena_pos_ += symbol.size();
+  arena_remaining_ -= symbol.size();
+  return res;
+}
+
 // Explicit instantiation
 template void PitSymbolMap::OnSymbolMapping(const SymbolMappingMsgV1& symbol_mapping);
 template void PitSymbolMap::OnSymbolMapping(const SymbolMappingMsgV2& symbol_mapping);
@@ -0,0 +1,512 @@
+#include "databento/symbology_cache.hpp"
+
+#include <algorithm>  // max, min, sort, unique
+#include <array>
+#include <charconv>  // from_chars
+#include <cstring>   // memcpy
+#include <iomanip>   // setfill, setw
+#include <memory>    // make_shared
+#include <optional>
+#include <random>  // random_device
+#include <sstream>
+#include <system_error>  // errc, error_code
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>  // move
+
+#include "databento/exceptions.hpp"  // DbnResponseError, InvalidArgumentError
+
+using databento::FlatTsSymbolMap;
+using databento::PitSymbolMap;
+using databento::SymbologyCache;
+using databento::SymbologyFile;
+using databento::SymbologyResolution;
+using databento::TsSymbolMap;
+
+namespace {
+constexpr std::array<char, 6> kSymbologyMagic{'D', 'B', 'S', 'Y', 'M', 'C'};
+constexpr std::uint8_t kSymbologyVersion = 1;
+// Magic, version, stypes, padding, dates, key, and counts
+constexpr std::size_t kHeaderSize = 48;
+constexpr std::size_t kMappingSize = 4 * sizeof(std::uint32_t);
+constexpr std::size_t kIntervalSize = 4 * sizeof(std::uint32_t);
+constexpr std::size_t kStringRefSize = 2 * sizeof(std::uint32_t);
+
+template <typename T>
+void WriteAsBytes(T value, databento::IWritable* output) {
+  output->WriteAll(reinterpret_cast<const std::byte*>(&value), sizeof(value));
+}
+
+template <typename T>
+T ReadAsBytes(const std::byte* data, std::size_t offset) {
+  T value;
+  std::memcpy(&value, data + offset, sizeof(value));
+  return value;
+}
+
+std::int32_t ToDays(date::year_month_day date) {
+  // Every `year_month_day` is within range
+  return static_cast<std::int32_t>(date::sys_days{date}.time_since_epoch().count());
+}
+
+date::year_month_day FromDays(std::int32_t days) {
+  return date::year_month_day{date::sys_days{date::days{days}}};
+}
+
+std::uint32_t ParseInstrumentId(std::string_view method_name, std::string_view symbol) {
+  std::uint32_t instrument_id{};
+  const auto* end = symbol.data() + symbol.size();
+  const auto res = std::from_chars(symbol.data(), end, instrument_id);
+  if (res.ec != std::errc{} || res.ptr != end) {
+    throw databento::InvalidArgumentError{std::string{method_name}, "symbol",
+                                          "Invalid instrument ID '" +
+                                              std::string{symbol} + "'"};
+  }
+  return instrument_id;
+}
+
+// Deduplicates the strings written to a file's string table.
+class StringTableBuilder {
+ public:
+  // Returns the offset of `str` in the table.
+  std::uint32_t Add(std::string_view str) {
+    const auto it = offsets_.find(str);
+    if (it != offsets_.end()) {
+      return it->second;
+    }
+    const auto offset = static_cast<std::uint32_t>(table_.size());
+    table_.append(str);
+    offsets_.emplace(str, offset);
+    return offset;
+  }
+  const std::string& Table() const { return table_; }
+
+ private:
+  std::string table_;
+  // Views of the strings being written, which outlive the builder
+  std::unordered_map<std::string_view, std::uint32_t> offsets_;
+};
+
+// Sorts `intervals` and merges adjacent intervals with the same symbol, such as
+// those split across two requests.
+void Coalesce(std::vector<databento::MappingInterval>* intervals) {
+  std::sort(intervals->begin(), intervals->end(),
+            [](const databento::MappingInterval& lhs,
+               const databento::MappingInterval& rhs) {
+              return lhs.start_date < rhs.start_date;
+            });
+  std::size_t last{};
+  for (std::size_t i = 1; i < intervals->size(); ++i) {
+    auto& prev = (*intervals)[last];
+    auto& interval = (*intervals)[i];
+    if (prev.end_date == interval.start_date && prev.symbol == interval.symbol) {
+      prev.end_date = interval.end_date;
+    } else if (++last != i) {
+      (*intervals)[last] = std::move(interval);
+    }
+  }
+  if (!intervals->empty()) {
+    intervals->resize(last + 1);
+  }
+}
+
+// Merges the resolution of other dates into `res`. Symbols not found in some of
+// the dates become partial.
+void Merge(databento::SymbologyResolution* res, databento::SymbologyResolution part) {
+  for (auto& [symbol, intervals] : part.mappings) {
+    auto& res_intervals = res->mappings[symbol];
+    res_intervals.insert(res_intervals.end(),
+                         std::make_move_iterator(intervals.begin()),
+                         std::make_move_iterator(intervals.end()));
+    Coalesce(&res_intervals);
+  }
+  std::unordered_set<std::string> partial{res->partial.begin(), res->partial.end()};
+  partial.insert(part.partial.begin(), part.partial.end());
+  std::unordered_set<std::string> not_found;
+  const auto has_mappings = [res](const std::string& symbol) {
+    const auto it = res->mappings.find(symbol);
+    return it != res->mappings.end() && !it->second.empty();
+  };
+  for (const auto* list : {&res->not_found, &part.not_found}) {
+    for (const auto& symbol : *list) {
+      if (partial.count(symbol) > 0) {
+        continue;
+      }
+      if (has_mappings(symbol)) {
+        partial.emplace(symbol);
+      } else {
+        not_found.emplace(symbol);
+      }
+    }
+  }
+  res->partial.assign(partial.begin(), partial.end());
+  std::sort(res->partial.begin(), res->partial.end());
+  res->not_found.assign(not_found.begin(), not_found.end());
+  std::sort(res->not_found.begin(), res->not_found.end());
+}
+
+void WriteStringRef(std::uint32_t offset, std::string_view str,
+                    databento::IWritable* output) {
+  WriteAsBytes(offset, output);
+  WriteAsBytes(static_cast<std::uint32_t>(str.size()), output);
+}
+
+// FNV-1a, which unlike `std::hash` is stable across processes
+std::uint64_t StableHash(std::string_view str) {
+  std::uint64_t hash = 0xCBF29CE484222325;
+  for (const char c : str) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001B3;
+  }
+  return hash;
+}
+
+// Independent of the order of `symbols` and any duplicates, which don't change the
+// resolution
+std::string CacheKey(const std::string& dataset,
+                     const std::vector<std::string>& symbols) {
+  auto sorted_symbols = symbols;
+  std::sort(sorted_symbols.begin(), sorted_symbols.end());
+  sorted_symbols.erase(std::unique(sorted_symbols.begin(), sorted_symbols.end()),
+                       sorted_symbols.end());
+  auto key = dataset;
+  for (const auto& symbol : sorted_symbols) {
+    key += '\n';
+    key += symbol;
+  }
+  return key;
+}
+}  // namespace
+
+void SymbologyFile::Write(const std::filesystem::path& path, std::string_view key,
+                          const SymbologyResolution& resolution,
+                          date::year_month_day start_date,
+                          date::year_month_day end_date) {
+  // Sorted so the file is the same for the same resolution
+  std::vector<const decltype(resolution.mappings)::value_type*> mappings;
+  mappings.reserve(resolution.mappings.size());
+  std::size_t interval_count{};
+  for (const auto& mapping : resolution.mappings) {
+    mappings.emplace_back(&mapping);
+    interval_count += mapping.second.size();
+  }
+  std::sort(mappings.begin(), mappings.end(),
+            [](const auto* lhs, const auto* rhs) { return lhs->first < rhs->first; });
+
+  StringTableBuilder strings;
+  const auto key_offset = strings.Add(key);
+  std::vector<std::uint32_t> symbol_offsets;
+  symbol_offsets.reserve(mappings.size() + interval_count);
+  for (const auto* mapping : mappings) {
+    symbol_offsets.emplace_back(strings.Add(mapping->first));
+    for (const auto& interval : mapping->second) {
+      symbol_offsets.emplace_back(strings.Add(interval.symbol));
+    }
+  }
+  std::vector<std::uint32_t> list_offsets;
+  for (const auto* list : {&resolution.partial, &resolution.not_found}) {
+    for (const auto& symbol : *list) {
+      list_offsets.emplace_back(strings.Add(symbol));
+    }
+  }
+
+  // Written next to `path` and renamed so readers never see a partial file
+  auto tmp_path = path;
+  tmp_path += ".tmp" + std::to_string(std::random_device{}());
+  {
+    OutFileStream output{tmp_path};
+    output.WriteAll(reinterpret_cast<const std::byte*>(kSymbologyMagic.data()),
+                    kSymbologyMagic.size());
+    WriteAsBytes(kSymbologyVersion, &output);
+    WriteAsBytes(resolution.stype_in, &output);
+    WriteAsBytes(resolution.stype_out, &output);
+    const std::array<std::byte, 3> padding{};
+    output.WriteAll(padding.data(), padding.size());
+    WriteAsBytes(ToDays(start_date), &output);
+    WriteAsBytes(ToDays(end_date), &output);
+    WriteStringRef(key_offset, key, &output);
+    WriteAsBytes(static_cast<std::uint32_t>(mappings.size()), &output);
+    WriteAsBytes(static_cast<std::uint32_t>(interval_count), &output);
+    WriteAsBytes(static_cast<std::uint32_t>(resolution.partial.size()), &output);
+    WriteAsBytes(static_cast<std::uint32_t>(resolution.not_found.size()), &output);
+    WriteAsBytes(static_cast<std::uint32_t>(strings.Table().size()), &output);
+
+    std::size_t offset_idx{};
+    std::uint32_t first_interval{};
+    for (const auto* mapping : mappings) {
+      WriteStringRef(symbol_offsets[offset_idx], mapping->first, &output);
+      offset_idx += 1 + mapping->second.size();
+      WriteAsBytes(first_interval, &output);
+      WriteAsBytes(static_cast<std::uint32_t>(mapping->second.size()), &output);
+      first_interval += static_cast<std::uint32_t>(mapping->second.size());
+    }
+    offset_idx = 0;
+    for (const auto* mapping : mappings) {
+      ++offset_idx;
+      for (const auto& interval : mapping->second) {
+        WriteAsBytes(ToDays(interval.start_date), &output);
+        WriteAsBytes(ToDays(interval.end_date), &output);
+        WriteStringRef(symbol_offsets[offset_idx++], interval.symbol, &output);
+      }
+    }
+    offset_idx = 0;
+    for (const auto* list : {&resolution.partial, &resolution.not_found}) {
+      for (const auto& symbol : *list) {
+        WriteStringRef(list_offsets[offset_idx++], symbol, &output);
+      }
+    }
+    output.WriteAll(reinterpret_cast<const std::byte*>(strings.Table().data()),
+                    strings.Table().size());
+  }
+  std::filesystem::rename(tmp_path, path);
+}
+
+SymbologyFile::SymbologyFile(const std::filesystem::path& path) : file_{path} {
+  const auto* data = file_.ReadBegin();
+  const auto size = file_.ReadCapacity();
+  if (size < kHeaderSize ||
+      std::memcmp(data, kSymbologyMagic.data(), kSymbologyMagic.size()) != 0) {
+    throw DbnResponseError{"Missing symbology file prefix in " + path.string()};
+  }
+  const auto version = ReadAsBytes<std::uint8_t>(data, 6);
+  if (version != kSymbologyVersion) {
+    throw DbnResponseError{"Can't read version " + std::to_string(version) +
+                           " symbology file, expected version " +
+                           std::to_string(kSymbologyVersion)};
+  }
+  header_.stype_in = ReadAsBytes<SType>(data, 7);
+  header_.stype_out = ReadAsBytes<SType>(data, 8);
+  header_.start_date = ReadAsBytes<std::int32_t>(data, 12);
+  header_.end_date = ReadAsBytes<std::int32_t>(data, 16);
+  header_.key = ReadAsBytes<StringRef>(data, 20);
+  header_.mapping_count = ReadAsBytes<std::uint32_t>(data, 28);
+  header_.interval_count = ReadAsBytes<std::uint32_t>(data, 32);
+  header_.partial_count = ReadAsBytes<std::uint32_t>(data, 36);
+  header_.not_found_count = ReadAsBytes<std::uint32_t>(data, 40);
+  header_.string_table_size = ReadAsBytes<std::uint32_t>(data, 44);
+  mappings_offset_ = kHeaderSize;
+  intervals_offset_ = mappings_offset_ + kMappingSize * header_.mapping_count;
+  partial_offset_ = intervals_offset_ + kIntervalSize * header_.interval_count;
+  not_found_offset_ = partial_offset_ + kStringRefSize * header_.partial_count;
+  strings_offset_ = not_found_offset_ + kStringRefSize * header_.not_found_count;
+  if (size != strings_offset_ + header_.string_table_size) {
+    throw DbnResponseError{"Symbology file " + path.string() +
+                           " is truncated or corrupted"};
+  }
+  Validate(path);
+}
+
+date::year_month_day SymbologyFile::StartDate() const {
+  return FromDays(header_.start_date);
+}
+
+date::year_month_day SymbologyFile::EndDate() const {
+  return FromDays(header_.end_date);
+}
+
+SymbologyResolution SymbologyFile::ToResolution() const {
+  SymbologyResolution res{{}, {}, {}, header_.stype_in, header_.stype_out};
+  res.mappings.reserve(header_.mapping_count);
+  for (std::size_t i = 0; i < header_.mapping_count; ++i) {
+    const auto& mapping = MappingAt(i);
+    std::vector<MappingInterval> intervals;
+    intervals.reserve(mapping.interval_count);
+    for (std::size_t j = 0; j < mapping.interval_count; ++j) {
+      const auto& interval = IntervalAt(mapping.first_interval + j);
+      intervals.emplace_back(MappingInterval{FromDays(interval.start_date),
+                                             FromDays(interval.end_date),
+                                             std::string{String(interval.symbol)}});
+    }
+    res.mappings.emplace(String(mapping.symbol), std::move(intervals));
+  }
+  res.partial.reserve(header_.partial_count);
+  for (std::size_t i = 0; i < header_.partial_count; ++i) {
+    res.partial.emplace_back(String(At<StringRef>(partial_offset_, i)));
+  }
+  res.not_found.reserve(header_.not_found_count);
+  for (std::size_t i = 0; i < header_.not_found_count; ++i) {
+    res.not_found.emplace_back(String(At<StringRef>(not_found_offset_, i)));
+  }
+  return res;
+}
+
+TsSymbolMap SymbologyFile::CreateSymbolMap() const {
+  static constexpr auto kMethodName = "SymbologyFile::CreateSymbolMap";
+  const auto is_inverse = IsInverse(kMethodName);
+  TsSymbolMap res;
+  for (std::size_t i = 0; i < header_.mapping_count; ++i) {
+    const auto& mapping = MappingAt(i);
+    std::shared_ptr<const std::string> symbol;
+    std::uint32_t instrument_id{};
+    if (is_inverse) {
+      instrument_id = ParseInstrumentId(kMethodName, String(mapping.symbol));
+    } else {
+      symbol = std::make_shared<const std::string>(String(mapping.symbol));
+    }
+    for (std::size_t j = 0; j < mapping.interval_count; ++j) {
+      const auto& interval = IntervalAt(mapping.first_interval + j);
+      if (is_inverse) {
+        symbol = std::make_shared<const std::string>(String(interval.symbol));
+      } else {
+        instrument_id = ParseInstrumentId(kMethodName, String(interval.symbol));
+      }
+      res.Insert(instrument_id, FromDays(interval.start_date),
+                 FromDays(interval.end_date), symbol);
+    }
+  }
+  return res;
+}
+
+FlatTsSymbolMap SymbologyFile::CreateFlatSymbolMap() const {
+  static constexpr auto kMethodName = "SymbologyFile::CreateFlatSymbolMap";
+  const auto is_inverse = IsInverse(kMethodName);
+  FlatTsSymbolMap res;
+  for (std::size_t i = 0; i < header_.mapping_count; ++i) {
+    const auto& mapping = MappingAt(i);
+    for (std::size_t j = 0; j < mapping.interval_count; ++j) {
+      const auto& interval = IntervalAt(mapping.first_interval + j);
+      if (is_inverse) {
+        res.Insert(ParseInstrumentId(kMethodName, String(mapping.symbol)),
+                   FromDays(interval.start_date), FromDays(interval.end_date),
+                   String(interval.symbol));
+      } else {
+        res.Insert(ParseInstrumentId(kMethodName, String(interval.symbol)),
+                   FromDays(interval.start_date), FromDays(interval.end_date),
+                   String(mapping.symbol));
+      }
+    }
+  }
+  return res;
+}
+
+PitSymbolMap SymbologyFile::CreateSymbolMapForDate(date::year_month_day date) const {
+  static constexpr auto kMethodName = "SymbologyFile::CreateSymbolMapForDate";
+  const auto day = ToDays(date);
+  if (day < header_.start_date || day >= header_.end_date) {
+    throw InvalidArgumentError{kMethodName, "date", "Outside resolved dates"};
+  }
+  const auto is_inverse = IsInverse(kMethodName);
+  PitSymbolMap res;
+  res.Map().reserve(header_.mapping_count);
+  for (std::size_t i = 0; i < header_.mapping_count; ++i) {
+    const auto& mapping = MappingAt(i);
+    for (std::size_t j = 0; j < mapping.interval_count; ++j) {
+      const auto& interval = IntervalAt(mapping.first_interval + j);
+      if (day < interval.start_date || day >= interval.end_date) {
+        continue;
+      }
+      if (is_inverse) {
+        res.Map().emplace(ParseInstrumentId(kMethodName, String(mapping.symbol)),
+                          String(interval.symbol));
+      } else {
+        res.Map().emplace(ParseInstrumentId(kMethodName, String(interval.symbol)),
+                          String(mapping.symbol));
+      }
+      break;
+    }
+  }
+  return res;
+}
+
+void SymbologyFile::Validate(const std::filesystem::path& path) const {
+  const auto is_valid = [this](StringRef ref) {
+    return std::uint64_t{ref.offset} + ref.size <= header_.string_table_size;
+  };
+  bool is_valid_file = is_valid(header_.key);
+  for (std::size_t i = 0; is_valid_file && i < header_.mapping_count; ++i) {
+    const auto& mapping = MappingAt(i);
+    is_valid_file = is_valid(mapping.symbol) &&
+                    std::uint64_t{mapping.first_interval} + mapping.interval_count <=
+                        header_.interval_count;
+  }
+  for (std::size_t i = 0; is_valid_file && i < header_.interval_count; ++i) {
+    is_valid_file = is_valid(IntervalAt(i).symbol);
+  }
+  for (std::size_t i = 0;
+       is_valid_file && i < header_.partial_count + header_.not_found_count; ++i) {
+    // The not found list directly follows the partial list
+    is_valid_file = is_valid(At<StringRef>(partial_offset_, i));
+  }
+  if (!is_valid_file) {
+    throw DbnResponseError{"Symbology file " + path.string() +
+                           " has out-of-bounds strings"};
+  }
+}
+
+bool SymbologyFile::IsInverse(std::string_view method_name) const {
+  if (header_.stype_in == SType::InstrumentId) {
+    return true;
+  }
+  if (header_.stype_out == SType::InstrumentId) {
+    return false;
+  }
+  throw InvalidArgumentError{
+      std::string{method_name}, "stype_in",
+      "Can only create symbol maps when InstrumentId is one of the stypes"};
+}
+
+SymbologyCache::SymbologyCache(std::filesystem::path dir) : dir_{std::move(dir)} {
+  std::filesystem::create_directories(dir_);
+}
+
+std::filesystem::path SymbologyCache::FilePath(const std::string& dataset,
+                                               const std::vector<std::string>& symbols,
+                                               SType stype_in, SType stype_out) const {
+  // The symbols can be too long for a file name
+  std::ostringstream file_name;
+  file_name << dataset << '.' << stype_in << '.' << stype_out << '.' << std::hex
+            << std::setfill('0') << std::setw(16)
+            << StableHash(CacheKey(dataset, symbols)) << ".dbsym";
+  return dir_ / file_name.str();
+}
+
+SymbologyFile SymbologyCache::Resolve(const std::string& dataset,
+                                      const std::vector<std::string>& symbols,
+                                      SType stype_in, SType stype_out,
+                                      date::year_month_day start_date,
+                                      date::year_month_day end_date,
+                                      const Resolver& resolver) const {
+  if (end_date <= start_date) {
+    throw InvalidArgumentError{"SymbologyCache::Resolve", "end_date",
+                               "must be after start_date"};
+  }
+  const auto path = FilePath(dataset, symbols, stype_in, stype_out);
+  const auto key = CacheKey(dataset, symbols);
+  std::optional<SymbologyFile> cached;
+  if (std::filesystem::exists(path)) {
+    try {
+      cached.emplace(path);
+    } catch (const DbnResponseError&) {
+      // Replaced below
+    }
+  }
+  if (cached && (cached->Key() != key || cached->StypeIn() != stype_in ||
+                 cached->StypeOut() != stype_out)) {
+    cached.reset();
+  }
+  if (cached && cached->StartDate() <= start_date && cached->EndDate() >= end_date) {
+    return std::move(*cached);
+  }
+
+  SymbologyResolution res{{}, {}, {}, stype_in, stype_out};
+  if (cached) {
+    // Keep the cached dates contiguous with the new ones
+    const auto cached_start = cached->StartDate();
+    const auto cached_end = cached->EndDate();
+    res = cached->ToResolution();
+    // Unmapped before it's replaced
+    cached.reset();
+    if (start_date < cached_start) {
+      ::Merge(&res, resolver(start_date, cached_start));
+    }
+    if (end_date > cached_end) {
+      ::Merge(&res, resolver(cached_end, end_date));
+    }
+    start_date = std::min(start_date, cached_start);
+    end_date = std::max(end_date, cached_end);
+  } else {
+    ::Merge(&res, resolver(start_date, end_date));
+  }
+  SymbologyFile::Write(path, key, res, start_date, end_date);
+  return SymbologyFile{path};
+}
@@ -0,0 +1,557 @@
+#include "databento/synth.hpp"
+
+#include <date/date.h>
+
+#include <algorithm>  // copy, min, max, sort
+#include <array>
+#include <string>
+#include <utility>  // move
+
+#include "databento/constants.hpp"  // kDbnVersion, kFixedPriceScale, kUndefPrice
+#include "databento/dbn_encoder.hpp"
+#include "databento/exceptions.hpp"  // InvalidArgumentError
+#include "databento/flag_set.hpp"
+#include "databento/iwritable.hpp"
+
+using databento::synth::Generator;
+
+namespace {
+constexpr std::int64_t kTickSize = 250'000'000;  // 0.25
+// New orders are placed up to this many ticks from the mid price
+constexpr std::uint64_t kBookTicks = 12;
+constexpr std::uint64_t kMaxOrderSize = 20;
+constexpr std::array<databento::StatType, 6> kStatTypes = {
+    databento::StatType::OpeningPrice,
+    databento::StatType::TradingSessionHighPrice,
+    databento::StatType::TradingSessionLowPrice,
+    databento::StatType::ClearedVolume,
+    databento::StatType::OpenInterest,
+    databento::StatType::SettlementPrice};
+
+// Leaves the last byte as the null terminator
+template <std::size_t N>
+void CopyCstr(std::array<char, N>& dest, const std::string& src) {
+  const auto len = (std::min)(src.size(), N - 1);
+  std::copy(src.begin(), src.begin() + static_cast<std::ptrdiff_t>(len), dest.begin());
+}
+
+databento::Side Opposite(databento::Side side) {
+  return side == databento::Side::Bid ? databento::Side::Ask : databento::Side::Bid;
+}
+
+// Returns true if `lhs` is a better price than `rhs` on `side`
+bool IsBetter(databento::Side side, std::int64_t lhs, std::int64_t rhs) {
+  return side == databento::Side::Bid ? lhs > rhs : lhs < rhs;
+}
+}  // namespace
+
+Generator::Generator(Schema schema, const GeneratorConf& conf)
+    : schema_{schema}, conf_{conf}, rng_state_{conf.seed} {
+  switch (schema) {
+    case Schema::Mbo:
+    case Schema::Mbp10:
+    case Schema::Trades:
+    case Schema::Definition:
+    case Schema::Statistics: {
+      break;
+    }
+    default: {
+      throw InvalidArgumentError{"synth::Generator::Generator", "schema",
+                                 "unsupported schema"};
+    }
+  }
+  if (conf.instrument_count == 0) {
+    throw InvalidArgumentError{"synth::Generator::Generator",
+                               "conf.instrument_count", "must be positive"};
+  }
+  if (conf.message_rate == 0) {
+    throw InvalidArgumentError{"synth::Generator::Generator", "conf.message_rate",
+                               "must be positive"};
+  }
+  if (conf.max_orders == 0) {
+    throw InvalidArgumentError{"synth::Generator::Generator", "conf.max_orders",
+                               "must be positive"};
+  }
+  instruments_.reserve(conf.instrument_count);
+  for (std::size_t i = 0; i < conf.instrument_count; ++i) {
+    const auto mid = 4'000 * kFixedPriceScale +
+                     static_cast<std::int64_t>(i % 1'000) * 40 * kTickSize;
+    Instrument instrument{conf.first_instrument_id + static_cast<std::uint32_t>(i),
+                          mid,
+                          0,
+                          {},
+                          kUndefPrice,
+                          mid,
+                          mid,
+                          0,
+                          0,
+                          0};
+    instrument.orders.reserve(conf.max_orders);
+    instruments_.emplace_back(std::move(instrument));
+  }
+  sorted_orders_.reserve(conf.max_orders);
+}
+
+std::string Generator::Symbol(std::uint32_t instrument_id) const {
+  return "SYN" + std::to_string(instrument_id);
+}
+
+databento::Metadata Generator::GenerateMetadata(std::size_t record_count) const {
+  const auto start = RecordTs(record_count_);
+  const auto end = RecordTs(record_count_ + record_count) + std::chrono::nanoseconds{1};
+  const date::year_month_day start_date{date::floor<date::days>(start)};
+  const date::year_month_day end_date{date::floor<date::days>(end) + date::days{1}};
+  std::vector<std::string> symbols;
+  std::vector<SymbolMapping> mappings;
+  symbols.reserve(instruments_.size());
+  mappings.reserve(instruments_.size());
+  for (const auto& instrument : instruments_) {
+    auto symbol = Symbol(instrument.instrument_id);
+    mappings.emplace_back(SymbolMapping{
+        symbol, {{start_date, end_date, std::to_string(instrument.instrument_id)}}});
+    symbols.emplace_back(std::move(symbol));
+  }
+  return Metadata{kDbnVersion,
+                  ToString(PublisherDataset(conf_.publisher)),
+                  schema_,
+                  start,
+                  end,
+                  record_count,
+                  SType::RawSymbol,
+                  SType::InstrumentId,
+                  false,
+                  kSymbolCstrLen,
+                  std::move(symbols),
+                  {},
+                  {},
+                  std::move(mappings)};
+}
+
+const databento::Record& Generator::NextRecord() {
+  if (pending_pos_ == pending_.size()) {
+    pending_.clear();
+    pending_pos_ = 0;
+    GenerateEvent();
+  }
+  current_ = Record{reinterpret_cast<RecordHeader*>(&pending_[pending_pos_])};
+  pending_pos_ += current_.Size();
+  ++record_count_;
+  return current_;
+}
+
+void Generator::WriteRecords(std::size_t record_count, IWritable* output) {
+  // Batch records into fewer, larger writes
+  constexpr std::size_t kBatchSize = 64 * 1024;
+  std::vector<std::byte> batch;
+  batch.reserve(kBatchSize + kMaxRecordLen);
+  for (std::size_t i = 0; i < record_count; ++i) {
+    const auto& rec = NextRecord();
+    const auto* begin = reinterpret_cast<const std::byte*>(&rec.Header());
+    batch.insert(batch.end(), begin, begin + rec.Size());
+    if (batch.size() >= kBatchSize) {
+      output->WriteAll(batch.data(), batch.size());
+      batch.clear();
+    }
+  }
+  if (!batch.empty()) {
+    output->WriteAll(batch.data(), batch.size());
+  }
+}
+
+void Generator::WriteDbn(std::size_t record_count, IWritable* output) {
+  DbnEncoder::EncodeMetadata(GenerateMetadata(record_count), output);
+  WriteRecords(record_count, output);
+}
+
+// SplitMix64, which unlike the standard library distributions gives the same
+// results on every platform
+std::uint64_t Generator::Rand() {
+  auto z = (rng_state_ += 0x9E3779B97F4A7C15);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+  return z ^ (z >> 31);
+}
+
+std::uint64_t Generator::Uniform(std::uint64_t bound) { return Rand() % bound; }
+
+Generator::Instrument& Generator::PickInstrument() {
+  // Squaring a uniform value skews activity toward the first instruments
+  const auto uniform = static_cast<double>(Rand() >> 11) * 0x1.0p-53;
+  const auto idx = static_cast<std::size_t>(
+      uniform * uniform * static_cast<double>(instruments_.size()));
+  return instruments_[(std::min)(idx, instruments_.size() - 1)];
+}
+
+databento::UnixNanos Generator::RecordTs(std::uint64_t record_idx) const {
+  return conf_.start + std::chrono::nanoseconds{static_cast<std::int64_t>(
+                           record_idx * 1'000'000'000 / conf_.message_rate)};
+}
+
+void Generator::StartEvent(Instrument& instrument) {
+  ++instrument.sequence;
+  ts_recv_ = RecordTs(record_count_);
+  // Time from the venue's matching engine to the capture server
+  ts_event_ = ts_recv_ - std::chrono::nanoseconds{
+                             2'000 + static_cast<std::int64_t>(Uniform(18'000))};
+  ts_in_delta_ = TimeDeltaNanos{1'000 + static_cast<std::int32_t>(Uniform(9'000))};
+}
+
+databento::RecordHeader Generator::Header(RType rtype, std::size_t size,
+                                          const Instrument& instrument) const {
+  return RecordHeader{static_cast<std::uint8_t>(size / RecordHeader::kLengthMultiplier),
+                      rtype, static_cast<std::uint16_t>(conf_.publisher),
+                      instrument.instrument_id, ts_event_};
+}
+
+std::size_t Generator::BestOrder(const Instrument& instrument, Side side) {
+  const auto& orders = instrument.orders;
+  auto best = orders.size();
+  for (std::size_t i = 0; i < orders.size(); ++i) {
+    const auto& order = orders[i];
+    if (order.side != side) {
+      continue;
+    }
+    if (best == orders.size() || IsBetter(side, order.price, orders[best].price) ||
+        (order.price == orders[best].price &&
+         order.order_id < orders[best].order_id)) {
+      best = i;
+    }
+  }
+  return best;
+}
+
+void Generator::GenerateEvent() {
+  switch (schema_) {
+    case Schema::Mbo:
+    case Schema::Mbp10: {
+      GenerateBookEvent(PickInstrument());
+      break;
+    }
+    case Schema::Trades: {
+      // Only trades are appended
+      while (!GenerateBookEvent(PickInstrument())) {
+      }
+      break;
+    }
+    case Schema::Definition: {
+      GenerateDefinition();
+      break;
+    }
+    case Schema::Statistics: {
+      GenerateStatistic();
+      break;
+    }
+    default: {
+      // Checked in the constructor
+      break;
+    }
+  }
+}
+
+bool Generator::GenerateBookEvent(Instrument& instrument) {
+  StartEvent(instrument);
+  const auto& orders = instrument.orders;
+  const auto roll = Uniform(100);
+  if (orders.empty() || (roll < 45 && orders.size() < conf_.max_orders)) {
+    AddOrder(instrument);
+    return false;
+  }
+  if (roll < 70) {
+    CancelOrder(instrument, Uniform(orders.size()));
+    return false;
+  }
+  if (roll < 85) {
+    ModifyOrder(instrument, Uniform(orders.size()));
+    return false;
+  }
+  return Trade(instrument);
+}
+
+void Generator::AddOrder(Instrument& instrument) {
+  const auto side = Uniform(2) == 0 ? Side::Bid : Side::Ask;
+  const auto ticks = static_cast<std::int64_t>(1 + Uniform(kBookTicks));
+  auto price = side == Side::Bid ? instrument.mid - ticks * kTickSize
+                                 : instrument.mid + ticks * kTickSize;
+  // Never cross the book
+  const auto opposite_idx = BestOrder(instrument, Opposite(side));
+  if (opposite_idx < instrument.orders.size()) {
+    const auto opposite_price = instrument.orders[opposite_idx].price;
+    price = side == Side::Bid ? (std::min)(price, opposite_price - kTickSize)
+                              : (std::max)(price, opposite_price + kTickSize);
+  }
+  const Order order{next_order_id_++, price,
+                    static_cast<std::uint32_t>(1 + Uniform(kMaxOrderSize)), side};
+  instrument.orders.emplace_back(order);
+  AppendMbo(instrument, Action::Add, order, FlagSet::kLast);
+  AppendMbp10(instrument, Action::Add, side, price, order.size, FlagSet::kLast);
+}
+
+void Generator::CancelOrder(Instrument& instrument, std::size_t idx) {
+  auto& orders = instrument.orders;
+  const auto order = orders[idx];
+  orders[idx] = orders.back();
+  orders.pop_back();
+  AppendMbo(instrument, Action::Cancel, order, FlagSet::kLast);
+  AppendMbp10(instrument, Action::Cancel, order.side, order.price, order.size,
+              FlagSet::kLast);
+}
+
+void Generator::ModifyOrder(Instrument& instrument, std::size_t idx) {
+  auto& order = instrument.orders[idx];
+  order.size = static_cast<std::uint32_t>(1 + Uniform(kMaxOrderSize));
+  AppendMbo(instrument, Action::Modify, order, FlagSet::kLast);
+  AppendMbp10(instrument, Action::Modify, order.side, order.price, order.size,
+              FlagSet::kLast);
+}
+
+bool Generator::Trade(Instrument& instrument) {
+  const auto aggressor = Uniform(2) == 0 ? Side::Bid : Side::Ask;
+  auto& orders = instrument.orders;
+  const auto idx = BestOrder(instrument, Opposite(aggressor));
+  if (idx == orders.size()) {
+    AddOrder(instrument);
+    return false;
+  }
+  const auto resting = orders[idx];
+  const auto size = static_cast<std::uint32_t>(1 + Uniform(resting.size));
+  // Trades and fills don't change the book
+  AppendMbo(instrument, Action::Trade, Order{0, resting.price, size, aggressor}, 0);
+  AppendMbo(instrument, Action::Fill,
+            Order{resting.order_id, resting.price, size, resting.side}, 0);
+  AppendMbp10(instrument, Action::Trade, aggressor, resting.price, size, 0);
+  AppendTrade(instrument, aggressor, resting.price, size);
+  if (instrument.open == kUndefPrice) {
+    instrument.open = resting.price;
+  }
+  instrument.high = (std::max)(instrument.high, resting.price);
+  instrument.low = (std::min)(instrument.low, resting.price);
+  instrument.volume += size;
+  // Drift toward the aggressor
+  if (Uniform(4) == 0) {
+    instrument.mid += aggressor == Side::Bid ? kTickSize : -kTickSize;
+  }
+  if (size == resting.size) {
+    orders[idx] = orders.back();
+    orders.pop_back();
+    AppendMbo(instrument, Action::Cancel, resting, FlagSet::kLast);
+    AppendMbp10(instrument, Action::Cancel, resting.side, resting.price, size,
+                FlagSet::kLast);
+  } else {
+    auto& order = orders[idx];
+    order.size -= size;
+    AppendMbo(instrument, Action::Modify, order, FlagSet::kLast);
+    AppendMbp10(instrument, Action::Modify, order.side, order.price, order.size,
+                FlagSet::kLast);
+  }
+  return true;
+}
+
+void Generator::GenerateDefinition() {
+  auto& instrument = instruments_[record_count_ % instruments_.size()];
+  StartEvent(instrument);
+  InstrumentDefMsg def{};
+  def.hd = Header(RType::InstrumentDef, sizeof(def), instrument);
+  def.ts_recv = ts_recv_;
+  def.min_price_increment = kTickSize;
+  def.display_factor = kFixedPriceScale;
+  def.expiration = conf_.start + date::days{75};
+  def.activation = conf_.start - date::days{290};
+  def.high_limit_price = instrument.mid + instrument.mid / 20;
+  def.low_limit_price = instrument.mid - instrument.mid / 20;
+  def.max_price_variation = 200 * kTickSize;
+  def.unit_of_measure_qty = 50 * kFixedPriceScale;
+  def.min_price_increment_amount = 12'500'000'000;
+  def.price_ratio = kUndefPrice;
+  def.strike_price = kUndefPrice;
+  def.raw_instrument_id = instrument.instrument_id;
+  def.leg_price = kUndefPrice;
+  def.leg_delta = kUndefPrice;
+  def.market_depth_implied = 2;
+  def.market_depth = 10;
+  def.max_trade_vol = 3'000;
+  def.min_lot_size = 1;
+  def.min_lot_size_block = 1;
+  def.min_lot_size_round_lot = 1;
+  def.min_trade_vol = 1;
+  def.contract_multiplier = 50;
+  def.maturity_year = 2024;
+  def.maturity_month = 3;
+  CopyCstr(def.currency, "USD");
+  CopyCstr(def.settl_currency, "USD");
+  CopyCstr(def.raw_symbol, Symbol(instrument.instrument_id));
+  CopyCstr(def.group, "SY");
+  CopyCstr(def.exchange, "XSYN");
+  CopyCstr(def.asset, "SYN");
+  CopyCstr(def.cfi, "FFICSX");
+  CopyCstr(def.security_type, "FUT");
+  CopyCstr(def.unit_of_measure, "IPNT");
+  def.instrument_class = InstrumentClass::Future;
+  def.match_algorithm = MatchAlgorithm::Fifo;
+  def.security_update_action = instrument.definition_count++ == 0
+                                   ? SecurityUpdateAction::Add
+                                   : SecurityUpdateAction::Modify;
+  def.user_defined_instrument = UserDefinedInstrument::No;
+  def.leg_side = Side::None;
+  Append(def);
+}
+
+void Generator::GenerateStatistic() {
+  auto& instrument = PickInstrument();
+  StartEvent(instrument);
+  // Random walk
+  instrument.mid += (static_cast<std::int64_t>(Uniform(3)) - 1) * kTickSize;
+  if (instrument.open == kUndefPrice) {
+    instrument.open = instrument.mid;
+  }
+  instrument.high = (std::max)(instrument.high, instrument.mid);
+  instrument.low = (std::min)(instrument.low, instrument.mid);
+  instrument.volume += static_cast<std::int64_t>(1 + Uniform(100));
+
+  StatMsg stat{};
+  stat.hd = Header(RType::Statistics, sizeof(stat), instrument);
+  stat.ts_recv = ts_recv_;
+  stat.ts_ref = UnixNanos{date::floor<date::days>(conf_.start)};
+  stat.price = kUndefPrice;
+  stat.quantity = kUndefStatQuantity;
+  stat.sequence = instrument.sequence;
+  stat.ts_in_delta = ts_in_delta_;
+  stat.stat_type = kStatTypes[instrument.stat_index++ % kStatTypes.size()];
+  stat.update_action = StatUpdateAction::New;
+  switch (stat.stat_type) {
+    case StatType::OpeningPrice: {
+      stat.price = instrument.open;
+      break;
+    }
+    case StatType::TradingSessionHighPrice: {
+      stat.price = instrument.high;
+      break;
+    }
+    case StatType::TradingSessionLowPrice: {
+      stat.price = instrument.low;
+      break;
+    }
+    case StatType::ClearedVolume: {
+      stat.quantity = instrument.volume;
+      break;
+    }
+    case StatType::OpenInterest: {
+      stat.quantity = 100'000 + instrument.volume / 10;
+      break;
+    }
+    default: {
+      stat.price = instrument.mid;
+      break;
+    }
+  }
+  Append(stat);
+}
+
+void Generator::AppendMbo(const Instrument& instrument, Action action,
+                          const Order& order, std::uint8_t flags) {
+  if (schema_ != Schema::Mbo) {
+    return;
+  }
+  MboMsg mbo{};
+  mbo.hd = Header(RType::Mbo, sizeof(mbo), instrument);
+  mbo.order_id = order.order_id;
+  mbo.price = order.price;
+  mbo.size = order.size;
+  mbo.flags = FlagSet{flags};
+  mbo.action = action;
+  mbo.side = order.side;
+  mbo.ts_recv = ts_recv_;
+  mbo.ts_in_delta = ts_in_delta_;
+  mbo.sequence = instrument.sequence;
+  Append(mbo);
+}
+
+void Generator::AppendMbp10(const Instrument& instrument, Action action, Side side,
+                            std::int64_t price, std::uint32_t size,
+                            std::uint8_t flags) {
+  if (schema_ != Schema::Mbp10) {
+    return;
+  }
+  Mbp10Msg mbp{};
+  mbp.hd = Header(RType::Mbp10, sizeof(mbp), instrument);
+  mbp.price = price;
+  mbp.size = size;
+  mbp.action = action;
+  mbp.side = side;
+  mbp.flags = FlagSet{flags};
+  mbp.ts_recv = ts_recv_;
+  mbp.ts_in_delta = ts_in_delta_;
+  mbp.sequence = instrument.sequence;
+  for (auto& level : mbp.levels) {
+    level.bid_px = kUndefPrice;
+    level.ask_px = kUndefPrice;
+  }
+  // Aggregate the book into levels, bids then asks, best first
+  sorted_orders_.assign(instrument.orders.begin(), instrument.orders.end());
+  std::sort(sorted_orders_.begin(), sorted_orders_.end(),
+            [](const Order& lhs, const Order& rhs) {
+              if (lhs.side != rhs.side) {
+                return lhs.side == Side::Bid;
+              }
+              return IsBetter(lhs.side, lhs.price, rhs.price);
+            });
+  // Trades are at the best price of the resting side
+  const auto book_side = action == Action::Trade ? Opposite(side) : side;
+  std::size_t depth = 0;
+  std::size_t bid_count = 0;
+  std::size_t ask_count = 0;
+  for (auto it = sorted_orders_.begin(); it != sorted_orders_.end();) {
+    const auto level_side = it->side;
+    const auto level_price = it->price;
+    std::uint32_t level_size = 0;
+    std::uint32_t level_count = 0;
+    for (; it != sorted_orders_.end() && it->side == level_side &&
+           it->price == level_price;
+         ++it) {
+      level_size += it->size;
+      ++level_count;
+    }
+    if (level_side == book_side && IsBetter(level_side, level_price, price)) {
+      ++depth;
+    }
+    auto& count = level_side == Side::Bid ? bid_count : ask_count;
+    if (count < mbp.levels.size()) {
+      auto& level = mbp.levels[count];
+      if (level_side == Side::Bid) {
+        level.bid_px = level_price;
+        level.bid_sz = level_size;
+        level.bid_ct = level_count;
+      } else {
+        level.ask_px = level_price;
+        level.ask_sz = level_size;
+        level.ask_ct = level_count;
+      }
+    }
+    ++count;
+  }
+  mbp.depth = static_cast<std::uint8_t>((std::min)(depth, mbp.levels.size() - 1));
+  Append(mbp);
+}
+
+void Generator::AppendTrade(const Instrument& instrument, Side side,
+                            std::int64_t price, std::uint32_t size) {
+  if (schema_ != Schema::Trades) {
+    return;
+  }
+  TradeMsg trade{};
+  trade.hd = Header(RType::Mbp0, sizeof(trade), instrument);
+  trade.price = price;
+  trade.size = size;
+  trade.action = Action::Trade;
+  trade.side = side;
+  trade.flags = FlagSet{FlagSet::kLast};
+  trade.ts_recv = ts_recv_;
+  trade.ts_in_delta = ts_in_delta_;
+  trade.sequence = instrument.sequence;
+  Append(trade);
+}
+
+template <typename R>
+void Generator::Append(const R& rec) {
+  const auto* bytes = reinterpret_cast<const std::byte*>(&rec);
+  pending_.insert(pending_.end(), bytes, bytes + sizeof(R));
+}
@@ -26,6 +26,7 @@ using ssize_t = SSIZE_T;
 #include "databento/enums.hpp"                 // Schema, SType, Compression
 #include "databento/iwritable.hpp"
 #include "databento/record.hpp"  // RecordHeader
+#include "databento/synth.hpp"   // Generator
 
 namespace databento::tests::mock {
 class SocketStream : public databento::IWritable {
@@ -89,6 +90,9 @@ class MockLsgServer {
         sizeof(Rec) - sizeof(RecordHeader)};
     Send(second_part);
   }
+  // Sends the next `record_count` records from `generator`, batched into large
+  // writes.
+  void SendRecords(synth::Generator& generator, std::size_t record_count);
 
   void Close();
 
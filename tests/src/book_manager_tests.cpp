@@ -0,0 +1,219 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "databento/book.hpp"
+#include "databento/book_manager.hpp"
+#include "databento/constants.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/flag_set.hpp"
+#include "databento/record.hpp"
+#include "databento/synth.hpp"
+
+namespace databento::tests {
+using book::BookManager;
+using book::BookManagerConf;
+using book::OrderBook;
+
+class BookManagerTests : public testing::Test {
+ protected:
+  static MboMsg Mbo(std::uint32_t instrument_id, std::uint16_t publisher_id,
+                    Action action, Side side, std::uint64_t order_id,
+                    std::int64_t price, std::uint32_t size,
+                    FlagSet::Repr flags = FlagSet::kLast) {
+    MboMsg mbo{};
+    mbo.hd = RecordHeader{sizeof(MboMsg) / kRecordHeaderLengthMultiplier, RType::Mbo,
+                          publisher_id, instrument_id, UnixNanos{}};
+    mbo.order_id = order_id;
+    mbo.price = price;
+    mbo.size = size;
+    mbo.flags = FlagSet{flags};
+    mbo.action = action;
+    mbo.side = side;
+    return mbo;
+  }
+
+  static ConsolidatedBidAskPair Cbbo(std::int64_t bid_px, std::int64_t ask_px,
+                                     std::uint32_t bid_sz, std::uint32_t ask_sz,
+                                     std::uint16_t bid_pb, std::uint16_t ask_pb) {
+    ConsolidatedBidAskPair bbo{};
+    bbo.bid_px = bid_px;
+    bbo.ask_px = ask_px;
+    bbo.bid_sz = bid_sz;
+    bbo.ask_sz = ask_sz;
+    bbo.bid_pb = bid_pb;
+    bbo.ask_pb = ask_pb;
+    return bbo;
+  }
+
+  // Returns the instruments reported as changed with their consolidated BBO
+  std::vector<std::pair<std::uint32_t, ConsolidatedBidAskPair>> TakeChanged() {
+    std::vector<std::pair<std::uint32_t, ConsolidatedBidAskPair>> res;
+    target_.ForEachChanged(
+        [&res](std::uint32_t instrument_id, const ConsolidatedBidAskPair& bbo) {
+          res.emplace_back(instrument_id, bbo);
+        });
+    return res;
+  }
+
+  BookManager target_;
+};
+
+TEST_F(BookManagerTests, TestInvalidConf) {
+  BookManagerConf conf{};
+  conf.book_capacity = 0;
+  ASSERT_THROW(BookManager{conf}, InvalidArgumentError);
+}
+
+TEST_F(BookManagerTests, TestBooksKeyedByInstrumentAndPublisher) {
+  EXPECT_EQ(target_.Find(1, 1), nullptr);
+  target_.Apply(Mbo(1, 1, Action::Add, Side::Bid, 1, 100, 10));
+  target_.Apply(Mbo(1, 2, Action::Add, Side::Bid, 1, 101, 20));
+  target_.Apply(Mbo(2, 1, Action::Add, Side::Ask, 1, 200, 30));
+  EXPECT_EQ(target_.BookCount(), 3);
+  ASSERT_NE(target_.Find(1, 1), nullptr);
+  EXPECT_EQ(target_.Find(1, 1)->Bid(), (book::PriceLevel{100, 10, 1}));
+  EXPECT_EQ(target_.Find(1, 2)->Bid(), (book::PriceLevel{101, 20, 1}));
+  EXPECT_EQ(target_.Find(2, 1)->Ask(), (book::PriceLevel{200, 30, 1}));
+  EXPECT_EQ(target_.Find(2, 2), nullptr);
+  // Other records are ignored
+  TradeMsg trade{};
+  trade.hd = RecordHeader{sizeof(TradeMsg) / kRecordHeaderLengthMultiplier,
+                          RType::Mbp0, 1, 3, UnixNanos{}};
+  target_.Apply(Record{&trade.hd});
+  EXPECT_EQ(target_.BookCount(), 3);
+}
+
+TEST_F(BookManagerTests, TestConsolidatedBbo) {
+  EXPECT_EQ(target_.ConsolidatedBbo(1),
+            Cbbo(kUndefPrice, kUndefPrice, 0, 0, 0, 0));
+  target_.Apply(Mbo(1, 3, Action::Add, Side::Bid, 1, 100, 10));
+  target_.Apply(Mbo(1, 3, Action::Add, Side::Ask, 2, 105, 10));
+  EXPECT_EQ(target_.ConsolidatedBbo(1), Cbbo(100, 105, 10, 10, 3, 3));
+  // Better bid
+  target_.Apply(Mbo(1, 2, Action::Add, Side::Bid, 1, 101, 5));
+  EXPECT_EQ(target_.ConsolidatedBbo(1), Cbbo(101, 105, 5, 10, 2, 3));
+  // Sizes at the same price are summed, with the publisher with the most size
+  target_.Apply(Mbo(1, 1, Action::Add, Side::Bid, 1, 101, 7));
+  target_.Apply(Mbo(1, 1, Action::Add, Side::Ask, 2, 105, 20));
+  EXPECT_EQ(target_.ConsolidatedBbo(1), Cbbo(101, 105, 12, 30, 1, 1));
+  // Ties go to the lowest publisher ID
+  target_.Apply(Mbo(1, 1, Action::Cancel, Side::Ask, 2, 105, 10));
+  EXPECT_EQ(target_.ConsolidatedBbo(1), Cbbo(101, 105, 12, 20, 1, 1));
+  target_.Apply(Mbo(1, 1, Action::Cancel, Side::Bid, 1, 101, 7));
+  target_.Apply(Mbo(1, 1, Action::Cancel, Side::Ask, 2, 105, 10));
+  EXPECT_EQ(target_.ConsolidatedBbo(1), Cbbo(101, 105, 5, 10, 2, 3));
+  EXPECT_EQ(target_.ConsolidatedBbo(2),
+            Cbbo(kUndefPrice, kUndefPrice, 0, 0, 0, 0));
+}
+
+TEST_F(BookManagerTests, TestForEachChanged) {
+  target_.Apply(Mbo(1, 1, Action::Add, Side::Bid, 1, 100, 10));
+  target_.Apply(Mbo(2, 1, Action::Add, Side::Bid, 1, 200, 10));
+  target_.Apply(Mbo(1, 2, Action::Add, Side::Ask, 1, 105, 10));
+  auto changed = TakeChanged();
+  ASSERT_EQ(changed.size(), 2);
+  EXPECT_EQ(changed[0].first, 1);
+  EXPECT_EQ(changed[0].second, Cbbo(100, 105, 10, 10, 1, 2));
+  EXPECT_EQ(changed[1].first, 2);
+  EXPECT_TRUE(TakeChanged().empty());
+  // Changes below the top of the book don't change the BBO
+  target_.Apply(Mbo(1, 1, Action::Add, Side::Bid, 2, 99, 10));
+  EXPECT_TRUE(TakeChanged().empty());
+  // Books in the middle of an event aren't read
+  target_.Apply(Mbo(2, 1, Action::Add, Side::Bid, 2, 201, 5, 0));
+  EXPECT_TRUE(TakeChanged().empty());
+  EXPECT_EQ(target_.ConsolidatedBbo(2).bid_px, 200);
+  target_.Apply(Mbo(2, 1, Action::Add, Side::Ask, 3, 202, 5));
+  changed = TakeChanged();
+  ASSERT_EQ(changed.size(), 1);
+  EXPECT_EQ(changed[0].first, 2);
+  EXPECT_EQ(changed[0].second, Cbbo(201, 202, 5, 5, 1, 1));
+}
+
+TEST_F(BookManagerTests, TestPoolGrowthAndClear) {
+  BookManagerConf conf{};
+  conf.book_capacity = 2;
+  BookManager target{conf};
+  EXPECT_EQ(target.BookCapacity(), 2);
+  target.Apply(Mbo(1, 1, Action::Add, Side::Bid, 1, 100, 10));
+  const auto* first_book = target.Find(1, 1);
+  for (std::uint16_t publisher_id = 2; publisher_id <= 5; ++publisher_id) {
+    target.Apply(Mbo(1, publisher_id, Action::Add, Side::Bid, 1, 100, 10));
+  }
+  EXPECT_EQ(target.BookCount(), 5);
+  EXPECT_EQ(target.BookCapacity(), 6);
+  // Books don't move when the pool grows
+  EXPECT_EQ(target.Find(1, 1), first_book);
+  EXPECT_EQ(target.ConsolidatedBbo(1), Cbbo(100, kUndefPrice, 50, 0, 1, 0));
+  // Leave the book in the middle of an event
+  auto mbo = Mbo(1, 1, Action::Add, Side::Ask, 2, 105, 10, 0);
+  mbo.ts_recv = UnixNanos{std::chrono::nanoseconds{5}};
+  mbo.sequence = 7;
+  target.Apply(mbo);
+  ASSERT_FALSE(first_book->IsConsistent());
+
+  target.Clear();
+  EXPECT_EQ(target.BookCount(), 0);
+  EXPECT_EQ(target.BookCapacity(), 6);
+  EXPECT_EQ(target.Find(1, 1), nullptr);
+  EXPECT_EQ(target.ConsolidatedBbo(1),
+            Cbbo(kUndefPrice, kUndefPrice, 0, 0, 0, 0));
+  // Released books don't keep the previous instrument's state
+  EXPECT_TRUE(first_book->IsConsistent());
+  EXPECT_EQ(first_book->TsRecv(), UnixNanos{});
+  EXPECT_EQ(first_book->Sequence(), 0);
+  // Reused books start empty
+  target.Apply(Mbo(7, 1, Action::Add, Side::Ask, 1, 100, 10));
+  EXPECT_EQ(target.Find(7, 1), first_book);
+  EXPECT_EQ(first_book->OrderCount(), 1);
+  EXPECT_EQ(target.ConsolidatedBbo(7), Cbbo(kUndefPrice, 100, 0, 10, 0, 1));
+}
+
+// Splits synthetic instruments across publishers and checks the books and
+// consolidated BBOs against books built separately
+TEST_F(BookManagerTests, TestMatchesSeparateBooks) {
+  constexpr std::uint32_t kPublisherCount = 3;
+  synth::GeneratorConf conf{};
+  conf.instrument_count = 12;
+  conf.first_instrument_id = 0;
+  conf.max_orders = 128;
+  synth::Generator gen{Schema::Mbo, conf};
+  std::vector<OrderBook> books(conf.instrument_count);
+  // Stop at the end of an event so every book is consistent
+  bool is_last{};
+  for (std::size_t i = 0; i < 50'000 || !is_last; ++i) {
+    auto mbo = gen.NextRecord().Get<MboMsg>();
+    is_last = mbo.flags.IsLast();
+    books[mbo.hd.instrument_id].Apply(mbo);
+    mbo.hd.publisher_id = static_cast<std::uint16_t>(
+        1 + mbo.hd.instrument_id % kPublisherCount);
+    mbo.hd.instrument_id /= kPublisherCount;
+    target_.Apply(mbo);
+  }
+  ASSERT_EQ(target_.BookCount(), conf.instrument_count);
+  for (std::uint32_t id = 0; id < conf.instrument_count; ++id) {
+    const auto* book = target_.Find(
+        id / kPublisherCount, static_cast<std::uint16_t>(1 + id % kPublisherCount));
+    ASSERT_NE(book, nullptr);
+    EXPECT_EQ(book->Levels<10>(), books[id].Levels<10>());
+  }
+  for (const auto& [instrument_id, bbo] : TakeChanged()) {
+    std::int64_t best_bid = kUndefPrice;
+    for (std::uint32_t id = instrument_id * kPublisherCount;
+         id < (instrument_id + 1) * kPublisherCount; ++id) {
+      const auto bid_px = books[id].Bid().price;
+      if (best_bid == kUndefPrice || (bid_px != kUndefPrice && bid_px > best_bid)) {
+        best_bid = bid_px;
+      }
+    }
+    EXPECT_EQ(bbo.bid_px, best_bid);
+    EXPECT_EQ(bbo, target_.ConsolidatedBbo(instrument_id));
+  }
+}
+}  // namespace databento::tests
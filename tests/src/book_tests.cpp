@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "databento/book.hpp"
+#include "databento/constants.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/flag_set.hpp"
+#include "databento/record.hpp"
+#include "databento/synth.hpp"
+
+namespace databento::tests {
+using book::OrderBook;
+using book::PriceLevel;
+
+class OrderBookTests : public testing::Test {
+ protected:
+  static MboMsg Mbo(Action action, Side side, std::uint64_t order_id,
+                    std::int64_t price, std::uint32_t size,
+                    FlagSet::Repr flags = FlagSet::kLast) {
+    MboMsg mbo{};
+    mbo.hd = RecordHeader{sizeof(MboMsg) / kRecordHeaderLengthMultiplier, RType::Mbo,
+                          1, 1, UnixNanos{}};
+    mbo.order_id = order_id;
+    mbo.price = price;
+    mbo.size = size;
+    mbo.flags = FlagSet{flags};
+    mbo.action = action;
+    mbo.side = side;
+    return mbo;
+  }
+
+  OrderBook target_;
+};
+
+TEST_F(OrderBookTests, TestEmpty) {
+  EXPECT_TRUE(target_.IsConsistent());
+  EXPECT_EQ(target_.OrderCount(), 0);
+  EXPECT_TRUE(target_.Bid().IsEmpty());
+  EXPECT_TRUE(target_.Ask().IsEmpty());
+  const auto bbo = target_.Bbo();
+  EXPECT_EQ(bbo.bid_px, kUndefPrice);
+  EXPECT_EQ(bbo.ask_px, kUndefPrice);
+  EXPECT_EQ(bbo.bid_sz, 0);
+  EXPECT_EQ(bbo.ask_ct, 0);
+}
+
+TEST_F(OrderBookTests, TestAddAndLevels) {
+  target_.Apply(Mbo(Action::Add, Side::Bid, 1, 100, 10));
+  target_.Apply(Mbo(Action::Add, Side::Bid, 2, 102, 5));
+  target_.Apply(Mbo(Action::Add, Side::Bid, 3, 100, 7));
+  target_.Apply(Mbo(Action::Add, Side::Ask, 4, 105, 1));
+  target_.Apply(Mbo(Action::Add, Side::Ask, 5, 104, 2));
+  target_.Apply(Mbo(Action::Add, Side::Ask, 6, 110, 3));
+  EXPECT_EQ(target_.OrderCount(), 6);
+  ASSERT_EQ(target_.BidLevelCount(), 2);
+  ASSERT_EQ(target_.AskLevelCount(), 3);
+  EXPECT_EQ(target_.Bid(0), (PriceLevel{102, 5, 1}));
+  EXPECT_EQ(target_.Bid(1), (PriceLevel{100, 17, 2}));
+  EXPECT_TRUE(target_.Bid(2).IsEmpty());
+  EXPECT_EQ(target_.Ask(0), (PriceLevel{104, 2, 1}));
+  EXPECT_EQ(target_.Ask(1), (PriceLevel{105, 1, 1}));
+  EXPECT_EQ(target_.Ask(2), (PriceLevel{110, 3, 1}));
+  EXPECT_EQ(target_.Bbo(), (BidAskPair{102, 104, 5, 2, 1, 1}));
+  const auto levels = target_.Levels<3>();
+  EXPECT_EQ(levels[1], (BidAskPair{100, 105, 17, 1, 2, 1}));
+  EXPECT_EQ(levels[2], (BidAskPair{kUndefPrice, 110, 0, 3, 0, 1}));
+  const auto* order = target_.FindOrder(3);
+  ASSERT_NE(order, nullptr);
+  EXPECT_EQ(order->price, 100);
+  EXPECT_EQ(order->size, 7);
+  EXPECT_EQ(order->side, Side::Bid);
+  EXPECT_EQ(target_.FindOrder(7), nullptr);
+}
+
+TEST_F(OrderBookTests, TestCancel) {
+  target_.Apply(Mbo(Action::Add, Side::Ask, 1, 100, 10));
+  target_.Apply(Mbo(Action::Add, Side::Ask, 2, 100, 5));
+  // Partial
+  target_.Apply(Mbo(Action::Cancel, Side::Ask, 1, 100, 4));
+  EXPECT_EQ(target_.Ask(), (PriceLevel{100, 11, 2}));
+  EXPECT_EQ(target_.FindOrder(1)->size, 6);
+  target_.Apply(Mbo(Action::Cancel, Side::Ask, 1, 100, 6));
+  EXPECT_EQ(target_.Ask(), (PriceLevel{100, 5, 1}));
+  EXPECT_EQ(target_.FindOrder(1), nullptr);
+  target_.Apply(Mbo(Action::Cancel, Side::Ask, 2, 100, 5));
+  EXPECT_EQ(target_.AskLevelCount(), 0);
+  EXPECT_EQ(target_.OrderCount(), 0);
+}
+
+TEST_F(OrderBookTests, TestModify) {
+  target_.Apply(Mbo(Action::Add, Side::Bid, 1, 100, 10));
+  target_.Apply(Mbo(Action::Add, Side::Bid, 2, 100, 5));
+  // Size only
+  target_.Apply(Mbo(Action::Modify, Side::Bid, 1, 100, 3));
+  EXPECT_EQ(target_.Bid(), (PriceLevel{100, 8, 2}));
+  // New price
+  target_.Apply(Mbo(Action::Modify, Side::Bid, 2, 101, 5));
+  EXPECT_EQ(target_.Bid(0), (PriceLevel{101, 5, 1}));
+  EXPECT_EQ(target_.Bid(1), (PriceLevel{100, 3, 1}));
+  target_.Apply(Mbo(Action::Modify, Side::Bid, 1, 101, 4));
+  EXPECT_EQ(target_.BidLevelCount(), 1);
+  EXPECT_EQ(target_.Bid(), (PriceLevel{101, 9, 2}));
+  // Unknown orders are added
+  target_.Apply(Mbo(Action::Modify, Side::Ask, 3, 105, 1));
+  EXPECT_EQ(target_.Ask(), (PriceLevel{105, 1, 1}));
+  EXPECT_EQ(target_.OrderCount(), 3);
+}
+
+TEST_F(OrderBookTests, TestTradesAndFillsDontChangeBook) {
+  target_.Apply(Mbo(Action::Add, Side::Ask, 1, 100, 10));
+  target_.Apply(Mbo(Action::Trade, Side::Bid, 0, 100, 4, 0));
+  target_.Apply(Mbo(Action::Fill, Side::Ask, 1, 100, 4, 0));
+  EXPECT_FALSE(target_.IsConsistent());
+  EXPECT_EQ(target_.Ask(), (PriceLevel{100, 10, 1}));
+  target_.Apply(Mbo(Action::Cancel, Side::Ask, 1, 100, 4));
+  EXPECT_TRUE(target_.IsConsistent());
+  EXPECT_EQ(target_.Ask(), (PriceLevel{100, 6, 1}));
+}
+
+TEST_F(OrderBookTests, TestClearAndSnapshot) {
+  target_.Apply(Mbo(Action::Add, Side::Bid, 1, 100, 10));
+  target_.Apply(Mbo(Action::Add, Side::Ask, 2, 101, 10));
+  target_.Apply(Mbo(Action::Clear, Side::None, 0, kUndefPrice, 0, FlagSet::kSnapshot));
+  EXPECT_FALSE(target_.IsConsistent());
+  EXPECT_EQ(target_.OrderCount(), 0);
+  EXPECT_EQ(target_.BidLevelCount(), 0);
+  target_.Apply(Mbo(Action::Add, Side::Bid, 3, 99, 1, FlagSet::kSnapshot));
+  EXPECT_FALSE(target_.IsConsistent());
+  target_.Apply(
+      Mbo(Action::Add, Side::Ask, 1, 102, 2, FlagSet::kSnapshot | FlagSet::kLast));
+  EXPECT_TRUE(target_.IsConsistent());
+  EXPECT_EQ(target_.Bbo(), (BidAskPair{99, 102, 1, 2, 1, 1}));
+}
+
+TEST_F(OrderBookTests, TestClearResetsState) {
+  auto mbo = Mbo(Action::Add, Side::Bid, 1, 100, 10, 0);
+  mbo.ts_recv = UnixNanos{std::chrono::nanoseconds{5}};
+  mbo.sequence = 7;
+  target_.Apply(mbo);
+  ASSERT_FALSE(target_.IsConsistent());
+  target_.Clear();
+  EXPECT_TRUE(target_.IsConsistent());
+  EXPECT_EQ(target_.TsRecv(), UnixNanos{});
+  EXPECT_EQ(target_.Sequence(), 0);
+  EXPECT_EQ(target_.OrderCount(), 0);
+  EXPECT_TRUE(target_.Bid().IsEmpty());
+}
+
+TEST_F(OrderBookTests, TestTopOfBook) {
+  const auto kTob = FlagSet::kTob | FlagSet::kLast;
+  target_.Apply(Mbo(Action::Add, Side::Bid, 0, 100, 10, kTob));
+  target_.Apply(Mbo(Action::Add, Side::Ask, 0, 101, 20, kTob));
+  target_.Apply(Mbo(Action::Add, Side::Bid, 0, 99, 30, kTob));
+  EXPECT_EQ(target_.BidLevelCount(), 1);
+  EXPECT_EQ(target_.Bbo(), (BidAskPair{99, 101, 30, 20, 1, 1}));
+  EXPECT_EQ(target_.OrderCount(), 0);
+  // An undefined price empties the side
+  target_.Apply(Mbo(Action::Add, Side::Ask, 0, kUndefPrice, 0, kTob));
+  EXPECT_EQ(target_.AskLevelCount(), 0);
+}
+
+TEST_F(OrderBookTests, TestIgnoresOtherRecords) {
+  TradeMsg trade{};
+  trade.hd = RecordHeader{sizeof(TradeMsg) / kRecordHeaderLengthMultiplier,
+                          RType::Mbp0, 1, 1, UnixNanos{}};
+  trade.action = Action::Trade;
+  target_.Apply(Record{&trade.hd});
+  auto mbo = Mbo(Action::Add, Side::Bid, 1, 100, 10);
+  target_.Apply(Record{&mbo.hd});
+  EXPECT_EQ(target_.OrderCount(), 1);
+}
+
+TEST_F(OrderBookTests, TestInvalidRecords) {
+  target_.Apply(Mbo(Action::Add, Side::Bid, 1, 100, 10));
+  ASSERT_THROW(target_.Apply(Mbo(Action::Add, Side::Bid, 1, 100, 10)),
+               InvalidArgumentError);
+  ASSERT_THROW(target_.Apply(Mbo(Action::Add, Side::None, 2, 100, 10)),
+               InvalidArgumentError);
+  ASSERT_THROW(target_.Apply(Mbo(Action::Cancel, Side::Bid, 3, 100, 10)),
+               InvalidArgumentError);
+  ASSERT_THROW(target_.Apply(Mbo(Action::Cancel, Side::Bid, 1, 100, 11)),
+               InvalidArgumentError);
+  EXPECT_EQ(target_.Bid(), (PriceLevel{100, 10, 1}));
+}
+
+// The synthetic MBP-10 records are built from the same book as the MBO records
+TEST_F(OrderBookTests, TestMatchesSyntheticMbp10) {
+  synth::GeneratorConf conf{};
+  conf.instrument_count = 4;
+  conf.max_orders = 256;
+  synth::Generator mbo_gen{Schema::Mbo, conf};
+  synth::Generator mbp_gen{Schema::Mbp10, conf};
+  std::vector<OrderBook> books(conf.instrument_count);
+  for (std::size_t i = 0; i < 50'000; ++i) {
+    const auto& mbp = mbp_gen.NextRecord().Get<Mbp10Msg>();
+    if (!mbp.flags.IsLast()) {
+      continue;
+    }
+    while (true) {
+      const auto& mbo = mbo_gen.NextRecord().Get<MboMsg>();
+      auto& book = books[mbo.hd.instrument_id - conf.first_instrument_id];
+      book.Apply(mbo);
+      if (book.IsConsistent()) {
+        ASSERT_EQ(mbo.hd.instrument_id, mbp.hd.instrument_id);
+        break;
+      }
+    }
+    const auto& book = books[mbp.hd.instrument_id - conf.first_instrument_id];
+    ASSERT_EQ(book.Sequence(), mbp.sequence);
+    ASSERT_EQ(book.Levels<10>(), mbp.levels) << i;
+  }
+}
+}  // namespace databento::tests
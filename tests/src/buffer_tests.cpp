@@ -1,9 +1,12 @@
 #include <gtest/gtest.h>
 
 #include <array>
+#include <memory>
 #include <string_view>
+#include <thread>
 
 #include "databento/detail/buffer.hpp"
+#include "databento/detail/slab_pool.hpp"
 
 using namespace std::string_view_literals;
 
@@ -92,4 +95,67 @@ TEST(BufferTests, TestShiftForSpaceNoopWhenUnconsumed) {
   ASSERT_EQ(target.WriteCapacity(), 12);
   ASSERT_EQ(target.ReadCapacity(), 4);
 }
+
+TEST(BufferTests, TestSlabShiftWhenShared) {
+  const auto pool = std::make_shared<SlabPool>(16);
+  Buffer target{pool};
+  ASSERT_EQ(target.Capacity(), 16);
+  target.WriteAll("0123456789ab", 12);
+  target.Consume(10);
+  // Pin the consumed data
+  const SlabRef pinned = target.Slab();
+  const auto* pinned_data = target.Slab().Get()->Data();
+  target.ShiftForSpace(8);
+  // Moved to a new slab instead of overwriting the pinned one
+  EXPECT_NE(target.Slab().Get(), pinned.Get());
+  EXPECT_EQ(target.ReadCapacity(), 2);
+  EXPECT_EQ(*target.ReadBegin(), std::byte{'a'});
+  EXPECT_EQ(std::string_view(reinterpret_cast<const char*>(pinned_data), 12),
+            "0123456789ab"sv);
+}
+
+TEST(BufferTests, TestSlabShiftInPlaceWhenUnshared) {
+  const auto pool = std::make_shared<SlabPool>(16);
+  Buffer target{pool};
+  const auto* slab = target.Slab().Get();
+  target.WriteAll("0123456789ab", 12);
+  target.Consume(10);
+  target.ShiftForSpace(8);
+  EXPECT_EQ(target.Slab().Get(), slab);
+  EXPECT_EQ(target.ReadCapacity(), 2);
+  EXPECT_EQ(*target.ReadBegin(), std::byte{'a'});
+}
+
+TEST(BufferTests, TestSlabReuse) {
+  const auto pool = std::make_shared<SlabPool>(16);
+  Buffer target{pool};
+  SlabRef pinned = target.Slab();
+  const auto* first_slab = pinned.Get();
+  target.Clear();
+  ASSERT_NE(target.Slab().Get(), first_slab);
+  EXPECT_EQ(pool->FreeCount(), 0);
+  // Released on another thread
+  std::thread{[released = std::move(pinned)]() mutable { released = SlabRef{}; }}
+      .join();
+  EXPECT_EQ(pool->FreeCount(), 1);
+  // The released slab is reused by the next shift
+  const SlabRef second = target.Slab();
+  target.Clear();
+  EXPECT_EQ(target.Slab().Get(), first_slab);
+  EXPECT_EQ(pool->FreeCount(), 0);
+}
+
+TEST(BufferTests, TestSlabReserve) {
+  const auto pool = std::make_shared<SlabPool>(16);
+  Buffer target{pool};
+  target.WriteAll("0123456789ab", 12);
+  target.Reserve(64);
+  EXPECT_EQ(target.Capacity(), 64);
+  EXPECT_EQ(target.ReadCapacity(), 12);
+  // Oversized slabs aren't pooled
+  target.Consume(12);
+  const SlabRef pinned = target.Slab();
+  target.Shift();
+  EXPECT_EQ(target.Capacity(), 16);
+}
 }  // namespace databento::detail::tests
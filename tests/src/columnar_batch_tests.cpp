@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <type_traits>
+
+#include "databento/columnar_batch.hpp"
+#include "databento/constants.hpp"
+#include "databento/datetime.hpp"
+#include "databento/dbn.hpp"
+#include "databento/dbn_encoder.hpp"
+#include "databento/dbn_store.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/file_stream.hpp"
+#include "databento/flag_set.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"
+#include "temp_file.hpp"
+
+namespace databento::tests {
+namespace {
+MboMsg GenerateMbo(std::size_t i) {
+  MboMsg mbo{};
+  mbo.hd = {sizeof(MboMsg) / RecordHeader::kLengthMultiplier, RType::Mbo, 1,
+            static_cast<std::uint32_t>(i % 7), UnixNanos{std::chrono::nanoseconds{i}}};
+  mbo.order_id = i;
+  mbo.price = static_cast<std::int64_t>(i) * kFixedPriceScale;
+  mbo.size = static_cast<std::uint32_t>(i % 100);
+  mbo.flags = FlagSet{static_cast<FlagSet::Repr>(i % 256)};
+  mbo.channel_id = static_cast<std::uint8_t>(i % 3);
+  mbo.action = i % 2 == 0 ? Action::Add : Action::Cancel;
+  mbo.side = i % 3 == 0 ? Side::Bid : Side::Ask;
+  mbo.ts_recv = UnixNanos{std::chrono::nanoseconds{i + 10}};
+  mbo.ts_in_delta = TimeDeltaNanos{static_cast<std::int32_t>(i % 1000)};
+  mbo.sequence = static_cast<std::uint32_t>(i);
+  return mbo;
+}
+
+TradeMsg GenerateTrade(std::size_t i) {
+  TradeMsg trade{};
+  trade.hd = {sizeof(TradeMsg) / RecordHeader::kLengthMultiplier, RType::Mbp0, 1,
+              static_cast<std::uint32_t>(i % 5),
+              UnixNanos{std::chrono::nanoseconds{i}}};
+  trade.price = -static_cast<std::int64_t>(i);
+  trade.size = static_cast<std::uint32_t>(i % 10);
+  trade.action = Action::Trade;
+  trade.side = Side::None;
+  trade.ts_recv = UnixNanos{std::chrono::nanoseconds{i + 5}};
+  trade.sequence = static_cast<std::uint32_t>(i);
+  return trade;
+}
+
+template <typename R>
+void ExpectEqualRow(const RecordColumns<R>& columns, std::size_t idx, const R& rec) {
+  EXPECT_EQ(columns.ts_event[idx], rec.hd.ts_event);
+  EXPECT_EQ(columns.publisher_id[idx], rec.hd.publisher_id);
+  EXPECT_EQ(columns.instrument_id[idx], rec.hd.instrument_id);
+  EXPECT_EQ(columns.price[idx], rec.price);
+  EXPECT_EQ(columns.size[idx], rec.size);
+  EXPECT_EQ(columns.flags[idx], rec.flags);
+  EXPECT_EQ(columns.action[idx], rec.action);
+  EXPECT_EQ(columns.side[idx], rec.side);
+  EXPECT_EQ(columns.ts_recv[idx], rec.ts_recv);
+  EXPECT_EQ(columns.ts_in_delta[idx], rec.ts_in_delta);
+  EXPECT_EQ(columns.sequence[idx], rec.sequence);
+  if constexpr (std::is_same_v<R, MboMsg>) {
+    EXPECT_EQ(columns.order_id[idx], rec.order_id);
+    EXPECT_EQ(columns.channel_id[idx], rec.channel_id);
+  } else {
+    EXPECT_EQ(columns.depth[idx], rec.depth);
+  }
+  if constexpr (std::is_same_v<R, Mbp1Msg>) {
+    EXPECT_EQ(columns.bid_px[idx], rec.levels[0].bid_px);
+    EXPECT_EQ(columns.ask_px[idx], rec.levels[0].ask_px);
+    EXPECT_EQ(columns.bid_sz[idx], rec.levels[0].bid_sz);
+    EXPECT_EQ(columns.ask_sz[idx], rec.levels[0].ask_sz);
+    EXPECT_EQ(columns.bid_ct[idx], rec.levels[0].bid_ct);
+    EXPECT_EQ(columns.ask_ct[idx], rec.levels[0].ask_ct);
+  }
+}
+
+// Checks every batch filled from `file_path` against the records returned by
+// `NextRecord`.
+template <typename R>
+std::size_t ExpectMatchesNextRecord(const std::filesystem::path& file_path,
+                                    std::size_t capacity) {
+  DbnStore expected_store{ILogReceiver::Default(), file_path,
+                          VersionUpgradePolicy::UpgradeToV3};
+  DbnStore store{ILogReceiver::Default(), file_path,
+                 VersionUpgradePolicy::UpgradeToV3};
+  ColumnarBatch<R> target{capacity};
+  std::size_t count{};
+  while (target.Fill(store) > 0) {
+    EXPECT_LE(target.Size(), capacity);
+    const auto& columns = target.Columns();
+    EXPECT_EQ(columns.price.size(), target.Size());
+    for (std::size_t i = 0; i < target.Size(); ++i) {
+      const Record* expected;
+      do {
+        expected = expected_store.NextRecord();
+      } while (expected != nullptr && !expected->Holds<R>());
+      EXPECT_NE(expected, nullptr);
+      if (expected == nullptr) {
+        return count;
+      }
+      ExpectEqualRow(columns, i, expected->Get<R>());
+      ++count;
+    }
+  }
+  EXPECT_TRUE(target.Empty());
+  return count;
+}
+}  // namespace
+
+class ColumnarBatchCapacityTests : public testing::TestWithParam<std::size_t> {};
+
+INSTANTIATE_TEST_SUITE_P(TestCapacities, ColumnarBatchCapacityTests,
+                         testing::Values(1, 3, 1000, 4096));
+
+TEST_P(ColumnarBatchCapacityTests, TestMbo) {
+  EXPECT_EQ(ExpectMatchesNextRecord<MboMsg>(TEST_DATA_DIR "/test_data.mbo.v3.dbn",
+                                            GetParam()),
+            2);
+}
+
+TEST_P(ColumnarBatchCapacityTests, TestTrades) {
+  EXPECT_EQ(ExpectMatchesNextRecord<TradeMsg>(
+                TEST_DATA_DIR "/test_data.trades.v3.dbn.zst", GetParam()),
+            2);
+}
+
+TEST_P(ColumnarBatchCapacityTests, TestMbp1) {
+  EXPECT_EQ(ExpectMatchesNextRecord<Mbp1Msg>(
+                TEST_DATA_DIR "/test_data.mbp-1.v3.dbn.zst", GetParam()),
+            2);
+}
+
+TEST_P(ColumnarBatchCapacityTests, TestTbbo) {
+  EXPECT_EQ(ExpectMatchesNextRecord<Mbp1Msg>(
+                TEST_DATA_DIR "/test_data.tbbo.v3.dbn.zst", GetParam()),
+            2);
+}
+
+// Spans many decoder batches and skips interleaved records of other types
+TEST_P(ColumnarBatchCapacityTests, TestMixedRecords) {
+  constexpr std::size_t kRecordCount = 30'000;
+  const TempFile temp_file{std::filesystem::temp_directory_path() /
+                           ("test_columnar_batch_mixed_" +
+                            std::to_string(GetParam()) + ".dbn")};
+  {
+    OutFileStream out_file{temp_file.Path()};
+    DbnEncoder encoder{Metadata{kDbnVersion,
+                                ToString(Dataset::GlbxMdp3),
+                                Schema::Mbo,
+                                {},
+                                {},
+                                {},
+                                SType::InstrumentId,
+                                SType::InstrumentId,
+                                false,
+                                kSymbolCstrLen,
+                                {},
+                                {},
+                                {},
+                                {}},
+                       &out_file};
+    for (std::size_t i = 0; i < kRecordCount; ++i) {
+      if (i % 3 == 0) {
+        encoder.EncodeRecord(GenerateTrade(i));
+      } else {
+        encoder.EncodeRecord(GenerateMbo(i));
+      }
+    }
+  }
+  EXPECT_EQ(ExpectMatchesNextRecord<MboMsg>(temp_file.Path(), GetParam()),
+            kRecordCount / 3 * 2);
+  EXPECT_EQ(ExpectMatchesNextRecord<TradeMsg>(temp_file.Path(), GetParam()),
+            kRecordCount / 3);
+  EXPECT_EQ(ExpectMatchesNextRecord<Mbp1Msg>(temp_file.Path(), GetParam()), 0);
+}
+
+TEST(ColumnarBatchTests, TestZeroCapacity) {
+  ASSERT_THROW(ColumnarBatch<MboMsg>{0}, InvalidArgumentError);
+}
+}  // namespace databento::tests
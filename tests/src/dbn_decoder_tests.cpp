@@ -19,6 +19,7 @@
 #include "databento/dbn_decoder.hpp"
 #include "databento/dbn_encoder.hpp"
 #include "databento/detail/buffer.hpp"
+#include "databento/detail/fixed_length_records.hpp"
 #include "databento/detail/scoped_thread.hpp"
 #include "databento/detail/zstd_stream.hpp"
 #include "databento/enums.hpp"
@@ -240,6 +241,443 @@ TEST_F(DbnDecoderTests, TestNeedsUpgrade) {
   }
 }
 
+TEST_F(DbnDecoderTests, TestSelectUpgrade) {
+  for (const auto policy :
+       {VersionUpgradePolicy::AsIs, VersionUpgradePolicy::UpgradeToV2,
+        VersionUpgradePolicy::UpgradeToV3}) {
+    for (std::uint8_t version = 1; version <= kDbnVersion; ++version) {
+      EXPECT_EQ(DbnDecoder::SelectUpgrade(version, policy) != nullptr,
+                DbnDecoder::NeedsUpgrade(policy, version))
+          << "policy=" << static_cast<int>(policy)
+          << " version=" << static_cast<int>(version);
+    }
+  }
+}
+
+class DbnDecoderUpgradeRecordsTests : public testing::TestWithParam<bool> {
+ protected:
+  template <typename R>
+  void Append(R rec) {
+    rec.hd.length = sizeof(R) / RecordHeader::kLengthMultiplier;
+    if (GetParam()) {
+      const WithTsOut<R> with_ts_out{
+          rec, UnixNanos{std::chrono::nanoseconds{
+                   static_cast<std::int64_t>(input_.ReadCapacity())}}};
+      input_.WriteAll(reinterpret_cast<const std::byte*>(&with_ts_out),
+                      sizeof(with_ts_out));
+    } else {
+      input_.WriteAll(reinterpret_cast<const std::byte*>(&rec), sizeof(rec));
+    }
+  }
+
+  // Builds an input of unchanged records interleaved with ones that change
+  // between versions 1 and 3
+  void AppendMixedV1Records() {
+    for (std::uint32_t i = 0; i < 10; ++i) {
+      MboMsg mbo{};
+      mbo.hd.rtype = RType::Mbo;
+      mbo.hd.instrument_id = i;
+      Append(mbo);
+      Append(mbo);
+      v1::InstrumentDefMsg def{};
+      def.hd.rtype = RType::InstrumentDef;
+      def.hd.instrument_id = i;
+      def.raw_instrument_id = i;
+      Append(def);
+      v1::StatMsg stat{};
+      stat.hd.rtype = RType::Statistics;
+      stat.hd.instrument_id = i;
+      stat.quantity = v1::kUndefStatQuantity;
+      Append(stat);
+      Append(mbo);
+      v1::ErrorMsg error{};
+      error.hd.rtype = RType::Error;
+      Append(error);
+    }
+  }
+
+  detail::Buffer input_{};
+};
+
+INSTANTIATE_TEST_SUITE_P(TestTsOut, DbnDecoderUpgradeRecordsTests,
+                         testing::Values(false, true));
+
+// Batch upgrades should match upgrading records one at a time
+TEST_P(DbnDecoderUpgradeRecordsTests, TestMatchesDecodeRecordCompat) {
+  AppendMixedV1Records();
+  detail::Buffer output{};
+  const auto [consumed, written] = DbnDecoder::UpgradeRecords(
+      1, VersionUpgradePolicy::UpgradeToV3, GetParam(), input_.ReadBegin(),
+      input_.ReadEnd(), output.WriteBegin(),
+      output.WriteBegin() + output.WriteCapacity());
+  ASSERT_EQ(consumed, input_.ReadCapacity());
+  output.Fill(written);
+
+  alignas(RecordHeader) std::array<std::byte, kMaxRecordLen> compat_buffer{};
+  std::size_t count{};
+  while (input_.ReadCapacity() > 0) {
+    ASSERT_GT(output.ReadCapacity(), 0);
+    const auto expected = DbnDecoder::DecodeRecordCompat(
+        1, VersionUpgradePolicy::UpgradeToV3, GetParam(), &compat_buffer,
+        Record{reinterpret_cast<RecordHeader*>(input_.ReadBegin())});
+    const Record actual{reinterpret_cast<RecordHeader*>(output.ReadBegin())};
+    ASSERT_EQ(actual.Size(), expected.Size());
+    EXPECT_EQ(std::memcmp(&actual.Header(), &expected.Header(), actual.Size()), 0);
+    input_.Consume(Record{reinterpret_cast<RecordHeader*>(input_.ReadBegin())}.Size());
+    output.Consume(actual.Size());
+    ++count;
+  }
+  EXPECT_EQ(output.ReadCapacity(), 0);
+  EXPECT_EQ(count, 60);
+}
+
+TEST_P(DbnDecoderUpgradeRecordsTests, TestStopsAtRecordNotFitting) {
+  AppendMixedV1Records();
+  const auto ts_out_len = GetParam() ? sizeof(UnixNanos) : 0;
+  const auto mbo_len = sizeof(MboMsg) + ts_out_len;
+  // Room for the first two MBO records but not the upgraded definition, even
+  // though the definition would fit before being upgraded
+  detail::Buffer output{};
+  const auto out_len = 2 * mbo_len + sizeof(v1::InstrumentDefMsg) + ts_out_len;
+  const auto [consumed, written] = DbnDecoder::UpgradeRecords(
+      1, VersionUpgradePolicy::UpgradeToV3, GetParam(), input_.ReadBegin(),
+      input_.ReadEnd(), output.WriteBegin(), output.WriteBegin() + out_len);
+  EXPECT_EQ(consumed, 2 * mbo_len);
+  EXPECT_EQ(written, 2 * mbo_len);
+}
+
+TEST_P(DbnDecoderUpgradeRecordsTests, TestAsIsCopies) {
+  AppendMixedV1Records();
+  detail::Buffer output{};
+  const auto [consumed, written] = DbnDecoder::UpgradeRecords(
+      1, VersionUpgradePolicy::AsIs, GetParam(), input_.ReadBegin(), input_.ReadEnd(),
+      output.WriteBegin(), output.WriteBegin() + output.WriteCapacity());
+  ASSERT_EQ(consumed, input_.ReadCapacity());
+  ASSERT_EQ(written, consumed);
+  EXPECT_EQ(std::memcmp(output.WriteBegin(), input_.ReadBegin(), written), 0);
+}
+
+TEST_P(DbnDecoderUpgradeRecordsTests, TestPartialRecord) {
+  AppendMixedV1Records();
+  detail::Buffer output{};
+  // Cut off the last record
+  const auto* end = input_.ReadEnd() - 8;
+  const auto [consumed, written] = DbnDecoder::UpgradeRecords(
+      1, VersionUpgradePolicy::UpgradeToV3, GetParam(), input_.ReadBegin(), end,
+      output.WriteBegin(), output.WriteBegin() + output.WriteCapacity());
+  EXPECT_EQ(consumed, input_.ReadCapacity() - sizeof(v1::ErrorMsg) -
+                          (GetParam() ? sizeof(UnixNanos) : 0));
+  EXPECT_GT(written, consumed);
+}
+
+class DbnDecoderMmapTests
+    : public DbnDecoderTests,
+      public testing::WithParamInterface<std::pair<const char*, bool>> {};
+
+INSTANTIATE_TEST_SUITE_P(
+    TestFiles, DbnDecoderMmapTests,
+    testing::Values(
+        // Aligned records
+        std::make_pair("test_data.mbo.v3.dbn", true),
+        // Aligned records requiring upgrade
+        std::make_pair("test_data.statistics.v1.dbn", true),
+        // Misaligned records
+        std::make_pair("test_data.mbo.v1.dbn", false),
+        // Compressed
+        std::make_pair("test_data.definition.v2.dbn.zst", false)),
+    [](const testing::TestParamInfo<std::pair<const char*, bool>>& test_info) {
+      std::string name = test_info.param.first;
+      for (auto& c : name) {
+        if (c == '.' || c == '-') {
+          c = '_';
+        }
+      }
+      return name;
+    });
+
+TEST_P(DbnDecoderMmapTests, TestDecodeMatchesInFileStream) {
+  const auto [file_name, is_zero_copy] = GetParam();
+  const auto file_path = std::string{TEST_DATA_DIR "/"} + file_name;
+  DbnDecoder expected_decoder{&logger_, std::make_unique<InFileStream>(file_path),
+                              VersionUpgradePolicy::UpgradeToV3};
+  DbnDecoder target{&logger_, InMmapFileStream{file_path},
+                    VersionUpgradePolicy::UpgradeToV3};
+  EXPECT_EQ(target.DecodeMetadata(), expected_decoder.DecodeMetadata());
+  EXPECT_EQ(target.IsZeroCopy(), is_zero_copy);
+  std::size_t count{};
+  while (const auto* expected = expected_decoder.DecodeRecord()) {
+    const auto* record = target.DecodeRecord();
+    ASSERT_NE(record, nullptr);
+    ASSERT_EQ(record->Size(), expected->Size());
+    EXPECT_EQ(std::memcmp(&record->Header(), &expected->Header(), record->Size()), 0);
+    ++count;
+  }
+  EXPECT_GT(count, 0);
+  EXPECT_EQ(target.DecodeRecord(), nullptr);
+}
+
+TEST_P(DbnDecoderMmapTests, TestDecodeBatchMatchesDecodeRecord) {
+  const auto file_path = std::string{TEST_DATA_DIR "/"} + GetParam().first;
+  DbnDecoder expected_decoder{&logger_, std::make_unique<InFileStream>(file_path),
+                              VersionUpgradePolicy::UpgradeToV3};
+  DbnDecoder buffered_target{&logger_, std::make_unique<InFileStream>(file_path),
+                             VersionUpgradePolicy::UpgradeToV3};
+  DbnDecoder mapped_target{&logger_, InMmapFileStream{file_path},
+                           VersionUpgradePolicy::UpgradeToV3};
+  expected_decoder.DecodeMetadata();
+  for (auto* target : {&buffered_target, &mapped_target}) {
+    target->DecodeMetadata();
+  }
+  std::vector<std::vector<std::byte>> expected;
+  while (const auto* record = expected_decoder.DecodeRecord()) {
+    const auto* begin = reinterpret_cast<const std::byte*>(&record->Header());
+    expected.emplace_back(begin, begin + record->Size());
+  }
+  ASSERT_FALSE(expected.empty());
+  for (auto* target : {&buffered_target, &mapped_target}) {
+    std::size_t count{};
+    while (true) {
+      const auto& batch = target->DecodeBatch();
+      if (batch.Empty()) {
+        break;
+      }
+      for (const auto& record : batch) {
+        ASSERT_LT(count, expected.size());
+        ASSERT_EQ(record.Size(), expected[count].size());
+        EXPECT_EQ(std::memcmp(&record.Header(), expected[count].data(), record.Size()),
+                  0);
+        ++count;
+      }
+    }
+    EXPECT_EQ(count, expected.size());
+    EXPECT_EQ(target->DecodeRecord(), nullptr);
+  }
+}
+
+TEST_F(DbnDecoderTests, TestDecodeBatchUpgradeExceedsCompatBuffer) {
+  constexpr std::uint32_t kRecordCount = 500;
+  auto buffer = std::make_unique<detail::Buffer>();
+  {
+    DbnEncoder encoder{Metadata{2,
+                                ToString(Dataset::XnasItch),
+                                Schema::Definition,
+                                {},
+                                {},
+                                {},
+                                {},
+                                {},
+                                false,
+                                kSymbolCstrLen,
+                                {}},
+                       buffer.get()};
+    for (std::uint32_t i = 0; i < kRecordCount; ++i) {
+      v2::InstrumentDefMsg def{};
+      def.hd = RecordHeader{sizeof(def) / RecordHeader::kLengthMultiplier,
+                            RType::InstrumentDef, 0, i, {}};
+      encoder.EncodeRecord(def);
+    }
+  }
+  DbnDecoder target{&logger_, std::move(buffer), VersionUpgradePolicy::UpgradeToV3};
+  target.DecodeMetadata();
+  std::uint32_t count{};
+  std::size_t batch_count{};
+  while (true) {
+    const auto& batch = target.DecodeBatch();
+    if (batch.Empty()) {
+      break;
+    }
+    ++batch_count;
+    for (const auto& record : batch) {
+      const auto& def = record.Get<v3::InstrumentDefMsg>();
+      EXPECT_EQ(def.hd.instrument_id, count);
+      ++count;
+    }
+  }
+  EXPECT_EQ(count, kRecordCount);
+  // Upgraded records don't all fit in a single batch
+  EXPECT_GT(batch_count, 1);
+}
+
+TEST_F(DbnDecoderTests, TestFixedRecordLength) {
+  EXPECT_EQ(DbnDecoder::FixedRecordLength(3, Schema::Mbo, false), sizeof(MboMsg));
+  EXPECT_EQ(DbnDecoder::FixedRecordLength(3, Schema::Mbo, true),
+            sizeof(WithTsOut<MboMsg>));
+  EXPECT_EQ(DbnDecoder::FixedRecordLength(1, Schema::Tbbo, false), sizeof(Mbp1Msg));
+  EXPECT_EQ(DbnDecoder::FixedRecordLength(1, Schema::Definition, false),
+            sizeof(v1::InstrumentDefMsg));
+  EXPECT_EQ(DbnDecoder::FixedRecordLength(2, Schema::Definition, false),
+            sizeof(v2::InstrumentDefMsg));
+  EXPECT_EQ(DbnDecoder::FixedRecordLength(3, Schema::Definition, true),
+            sizeof(WithTsOut<v3::InstrumentDefMsg>));
+  EXPECT_EQ(DbnDecoder::FixedRecordLength(2, Schema::Statistics, false),
+            sizeof(v2::StatMsg));
+  EXPECT_EQ(DbnDecoder::FixedRecordLength(3, Schema::Statistics, false),
+            sizeof(v3::StatMsg));
+  EXPECT_EQ(DbnDecoder::FixedRecordLength(3, {}, false), 0);
+}
+
+TEST_F(DbnDecoderTests, TestCountFixedLengthRecords) {
+  constexpr std::size_t kRecordCount = 21;
+  std::vector<MboMsg> records(kRecordCount);
+  for (auto& mbo : records) {
+    mbo.hd.length = sizeof(MboMsg) / RecordHeader::kLengthMultiplier;
+  }
+  const auto* begin = reinterpret_cast<const std::byte*>(records.data());
+  const auto* end = begin + records.size() * sizeof(MboMsg);
+  EXPECT_EQ(DbnDecoder::CountFixedLengthRecords(begin, end, sizeof(MboMsg)),
+            kRecordCount);
+  // Partial record
+  EXPECT_EQ(DbnDecoder::CountFixedLengthRecords(begin, end - 1, sizeof(MboMsg)),
+            kRecordCount - 1);
+  EXPECT_EQ(DbnDecoder::CountFixedLengthRecords(begin, end, sizeof(TradeMsg)), 0);
+  // Mismatches in the first block, a later block, and the remainder
+  for (const std::size_t mismatch_idx : {3, 11, 19}) {
+    records[mismatch_idx].hd.length = 1;
+    EXPECT_EQ(DbnDecoder::CountFixedLengthRecords(begin, end, sizeof(MboMsg)),
+              mismatch_idx);
+    records[mismatch_idx].hd.length = sizeof(MboMsg) / RecordHeader::kLengthMultiplier;
+  }
+}
+
+TEST_F(DbnDecoderTests, TestFixedLengthRecords) {
+  std::vector<MboMsg> records(10);
+  for (auto& mbo : records) {
+    mbo.hd.length = sizeof(MboMsg) / RecordHeader::kLengthMultiplier;
+  }
+  records[6].hd.length = 1;
+  const auto* begin = reinterpret_cast<const std::byte*>(records.data());
+  const auto* end = begin + records.size() * sizeof(MboMsg);
+  detail::FixedLengthRecords target;
+  // Upgraded records are read one at a time
+  target.Init(1, Schema::Mbo, false, true);
+  EXPECT_EQ(target.RecordLength(), 0);
+  EXPECT_EQ(target.Count(begin, end), 0);
+  target.Init(3, Schema::Mbo, false, false);
+  ASSERT_EQ(target.RecordLength(), sizeof(MboMsg));
+  // A partial header doesn't disable the fast path
+  EXPECT_EQ(target.Count(begin, begin + 2 * sizeof(MboMsg) + 1), 2);
+  EXPECT_EQ(target.RecordLength(), sizeof(MboMsg));
+  // The record with a different length disables it
+  EXPECT_EQ(target.Count(begin, end), 6);
+  EXPECT_EQ(target.RecordLength(), 0);
+  EXPECT_EQ(target.Count(begin, end), 0);
+}
+
+// A stream that doesn't match its metadata schema should decode the same as with
+// the generic path
+TEST_F(DbnDecoderTests, TestDecodeBatchFixedLengthMismatch) {
+  constexpr std::uint32_t kRecordCount = 5000;
+  constexpr std::uint32_t kMismatchIdx = 3000;
+  auto buffer = std::make_unique<detail::Buffer>();
+  {
+    DbnEncoder encoder{Metadata{kDbnVersion,
+                                ToString(Dataset::GlbxMdp3),
+                                Schema::Mbo,
+                                {},
+                                {},
+                                {},
+                                {},
+                                {},
+                                false,
+                                kSymbolCstrLen,
+                                {}},
+                       buffer.get()};
+    for (std::uint32_t i = 0; i < kRecordCount; ++i) {
+      if (i == kMismatchIdx) {
+        SystemMsg system{};
+        system.hd = RecordHeader{sizeof(system) / RecordHeader::kLengthMultiplier,
+                                 RType::System, 0, i, {}};
+        encoder.EncodeRecord(system);
+      } else {
+        MboMsg mbo{};
+        mbo.hd = RecordHeader{sizeof(mbo) / RecordHeader::kLengthMultiplier,
+                              RType::Mbo, 0, i, {}};
+        encoder.EncodeRecord(mbo);
+      }
+    }
+  }
+  DbnDecoder target{&logger_, std::move(buffer), VersionUpgradePolicy::UpgradeToV3};
+  target.DecodeMetadata();
+  std::uint32_t count{};
+  while (true) {
+    const auto& batch = target.DecodeBatch();
+    if (batch.Empty()) {
+      break;
+    }
+    for (const auto& record : batch) {
+      EXPECT_EQ(record.Header().instrument_id, count);
+      EXPECT_EQ(record.RType(), count == kMismatchIdx ? RType::System : RType::Mbo);
+      ++count;
+    }
+  }
+  EXPECT_EQ(count, kRecordCount);
+}
+
+TEST_F(DbnDecoderTests, TestDecodeParallelZstd) {
+  const std::string file_path = TEST_DATA_DIR "/multi-frame.definition.v1.dbn.frag.zst";
+  const std::string metadata_path = TEST_DATA_DIR "/test_data.definition.v1.dbn.zst";
+  const auto make_input = [&file_path, &metadata_path] {
+    // The fragment has no metadata, so prepend the compressed metadata of a
+    // file with the same schema
+    auto buffer = std::make_unique<detail::Buffer>();
+    for (const auto& path : {metadata_path, file_path}) {
+      std::ifstream input_file{path, std::ios::binary | std::ios::ate};
+      const auto size = static_cast<std::size_t>(input_file.tellg());
+      input_file.seekg(0, std::ios::beg);
+      std::vector<char> contents(size);
+      input_file.read(contents.data(), static_cast<std::streamsize>(size));
+      buffer->WriteAll(contents.data(), contents.size());
+    }
+    return buffer;
+  };
+  DbnDecoder expected_decoder{&logger_, make_input(),
+                              VersionUpgradePolicy::UpgradeToV3};
+  DbnDecoder target{&logger_, make_input(), VersionUpgradePolicy::UpgradeToV3,
+                    DecodeConf{4}};
+  EXPECT_EQ(target.DecodeMetadata(), expected_decoder.DecodeMetadata());
+  std::size_t count{};
+  while (const auto* expected = expected_decoder.DecodeRecord()) {
+    const auto* record = target.DecodeRecord();
+    ASSERT_NE(record, nullptr);
+    EXPECT_EQ(record->Get<v3::InstrumentDefMsg>(),
+              expected->Get<v3::InstrumentDefMsg>());
+    ++count;
+  }
+  // 2 from the full file and 8 from the fragment
+  EXPECT_EQ(count, 10);
+  EXPECT_EQ(target.DecodeRecord(), nullptr);
+}
+
+TEST_F(DbnDecoderTests, TestDecodeReadAhead) {
+  const std::string file_path = TEST_DATA_DIR "/test_data.definition.v1.dbn.zst";
+  DbnDecoder expected_decoder{&logger_, std::make_unique<InFileStream>(file_path),
+                              VersionUpgradePolicy::UpgradeToV3};
+  DecodeConf decode_conf{};
+  decode_conf.read_ahead_depth = 2;
+  // Smaller than a record
+  decode_conf.read_ahead_buffer_size = 100;
+  DbnDecoder target{&logger_, std::make_unique<InFileStream>(file_path),
+                    VersionUpgradePolicy::UpgradeToV3, decode_conf};
+  EXPECT_EQ(target.DecodeMetadata(), expected_decoder.DecodeMetadata());
+  std::size_t count{};
+  while (const auto* expected = expected_decoder.DecodeRecord()) {
+    const auto* record = target.DecodeRecord();
+    ASSERT_NE(record, nullptr);
+    EXPECT_EQ(record->Get<v3::InstrumentDefMsg>(),
+              expected->Get<v3::InstrumentDefMsg>());
+    ++count;
+  }
+  EXPECT_EQ(count, 2);
+  EXPECT_EQ(target.DecodeRecord(), nullptr);
+  // Uncompressed memory-mapped files don't use read-ahead
+  DbnDecoder mapped_target{&logger_,
+                           InMmapFileStream{TEST_DATA_DIR "/test_data.mbo.v3.dbn"},
+                           VersionUpgradePolicy::UpgradeToV3, decode_conf};
+  mapped_target.DecodeMetadata();
+  EXPECT_TRUE(mapped_target.IsZeroCopy());
+  EXPECT_EQ(mapped_target.ReadAheadStats().consumer_stalls, 0);
+}
+
 class DbnDecoderSchemaTests
     : public DbnDecoderTests,
       public testing::WithParamInterface<std::pair<const char*, std::uint8_t>> {};
@@ -1,7 +1,12 @@
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>  // memcmp
+#include <filesystem>
+#include <optional>
+#include <vector>
 
+#include "databento/constants.hpp"
 #include "databento/datetime.hpp"
 #include "databento/dbn.hpp"
 #include "databento/dbn_encoder.hpp"
@@ -10,8 +15,12 @@
 #include "databento/enums.hpp"
 #include "databento/file_stream.hpp"
 #include "databento/flag_set.hpp"
+#include "databento/log.hpp"
 #include "databento/record.hpp"
+#include "databento/record_ref.hpp"
+#include "databento/timeseries.hpp"
 #include "databento/v1.hpp"
+#include "databento/v2.hpp"
 #include "temp_file.hpp"
 
 namespace databento::tests {
@@ -115,4 +124,146 @@ TEST(DbnFileStoreTests, TestDecodeExtended) {
   }
   ASSERT_EQ(count, kExpSize);
 }
+
+namespace {
+// Checks every record from `NextRecordRef` is still valid after reading the rest
+void AssertRecordRefsMatch(DbnStore& target, DbnStore& expected) {
+  std::vector<RecordRef> refs;
+  while (auto ref = target.NextRecordRef()) {
+    refs.emplace_back(std::move(ref));
+  }
+  std::size_t count{};
+  while (const auto* rec = expected.NextRecord()) {
+    ASSERT_LT(count, refs.size());
+    const auto& ref = refs[count];
+    ASSERT_EQ(ref->Size(), rec->Size()) << "at count = " << count;
+    ASSERT_EQ(std::memcmp(&ref->Header(), &rec->Header(), rec->Size()), 0)
+        << "at count = " << count;
+    ++count;
+  }
+  EXPECT_EQ(count, refs.size());
+}
+}  // namespace
+
+TEST(DbnFileStoreTests, TestNextRecordRef) {
+  constexpr std::uint32_t kRecordCount = 20'000;
+  for (const bool is_compressed : {false, true}) {
+    const TempFile temp_file{
+        std::filesystem::temp_directory_path() /
+        (is_compressed ? "test_next_record_ref.dbn.zst" : "test_next_record_ref.dbn")};
+    {
+      OutFileStream out_file{temp_file.Path()};
+      std::optional<detail::ZstdCompressStream> zstd_stream;
+      IWritable* output = &out_file;
+      if (is_compressed) {
+        output = &zstd_stream.emplace(&out_file);
+      }
+      DbnEncoder encoder{Metadata{kDbnVersion,
+                                  ToString(Dataset::GlbxMdp3),
+                                  Schema::Mbo,
+                                  {},
+                                  {},
+                                  {},
+                                  {},
+                                  {},
+                                  false,
+                                  kSymbolCstrLen,
+                                  {}},
+                         output};
+      for (std::uint32_t i = 0; i < kRecordCount; ++i) {
+        MboMsg mbo{};
+        mbo.hd = RecordHeader{sizeof(mbo) / RecordHeader::kLengthMultiplier,
+                              RType::Mbo, 0, i, {}};
+        mbo.order_id = i;
+        encoder.EncodeRecord(mbo);
+      }
+    }
+    // Pinned in the decoding buffer
+    DbnFileStore target{temp_file.Path()};
+    DbnFileStore expected{temp_file.Path()};
+    AssertRecordRefsMatch(target, expected);
+    // Copied out of the mapping
+    DbnStore mapped_target{ILogReceiver::Default(), InMmapFileStream{temp_file.Path()},
+                           VersionUpgradePolicy::UpgradeToV3};
+    DbnFileStore mapped_expected{temp_file.Path()};
+    AssertRecordRefsMatch(mapped_target, mapped_expected);
+  }
+  // Upgraded records are copied
+  const auto file_path = TEST_DATA_DIR "/test_data.definition.v1.dbn";
+  DbnFileStore target{ILogReceiver::Default(), file_path,
+                      VersionUpgradePolicy::UpgradeToV3};
+  DbnFileStore expected{ILogReceiver::Default(), file_path,
+                        VersionUpgradePolicy::UpgradeToV3};
+  AssertRecordRefsMatch(target, expected);
+}
+
+TEST(DbnFileStoreTests, TestReplayVisitor) {
+  struct Visitor {
+    void operator()(const v1::InstrumentDefMsg&) { ++def_v1_count; }
+    void operator()(const v2::InstrumentDefMsg&) { ++def_v2_count; }
+    KeepGoing operator()(const InstrumentDefMsg&) {
+      ++def_v3_count;
+      return def_v3_count < stop_after ? KeepGoing::Continue : KeepGoing::Stop;
+    }
+
+    std::size_t stop_after;
+    std::size_t def_v1_count{};
+    std::size_t def_v2_count{};
+    std::size_t def_v3_count{};
+  };
+  const auto file_path = TEST_DATA_DIR "/test_data.definition.v1.dbn";
+
+  std::size_t callback_count{};
+  DbnFileStore callback_store{ILogReceiver::Default(), file_path,
+                              VersionUpgradePolicy::AsIs};
+  callback_store.Replay([&callback_count](const Record&) {
+    ++callback_count;
+    return KeepGoing::Continue;
+  });
+  ASSERT_GT(callback_count, 1);
+
+  Visitor as_is{callback_count};
+  std::optional<Metadata> metadata;
+  DbnFileStore as_is_store{ILogReceiver::Default(), file_path,
+                           VersionUpgradePolicy::AsIs};
+  as_is_store.Replay([&metadata](Metadata&& md) { metadata = std::move(md); }, as_is);
+  ASSERT_TRUE(metadata.has_value());
+  EXPECT_EQ(metadata->version, 1);
+  EXPECT_EQ(as_is.def_v1_count, callback_count);
+  EXPECT_EQ(as_is.def_v2_count, 0);
+  EXPECT_EQ(as_is.def_v3_count, 0);
+
+  Visitor upgraded{1};
+  DbnFileStore upgraded_store{ILogReceiver::Default(), file_path,
+                              VersionUpgradePolicy::UpgradeToV3};
+  upgraded_store.Replay(upgraded);
+  EXPECT_EQ(upgraded.def_v1_count, 0);
+  EXPECT_EQ(upgraded.def_v2_count, 0);
+  // Stops after the first record
+  EXPECT_EQ(upgraded.def_v3_count, 1);
+}
+
+namespace {
+struct FallbackVisitor {
+  void operator()(const MboMsg&) { ++mbo_count; }
+  template <typename T>
+  void operator()(const T&) {
+    ++other_count;
+  }
+
+  std::size_t mbo_count{};
+  std::size_t other_count{};
+};
+}  // namespace
+
+// A visitor with a generic fallback can also be converted to a `RecordCallback`,
+// but should still be dispatched to its concrete overloads
+TEST(DbnFileStoreTests, TestReplayVisitorWithFallback) {
+  DbnFileStore target{ILogReceiver::Default(), TEST_DATA_DIR "/test_data.mbo.v3.dbn",
+                      VersionUpgradePolicy::UpgradeToV3};
+  FallbackVisitor visitor;
+  target.Replay(visitor);
+  EXPECT_EQ(visitor.mbo_count, 2);
+  EXPECT_EQ(visitor.other_count, 0);
+}
 }  // namespace databento::tests
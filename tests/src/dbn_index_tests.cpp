@@ -0,0 +1,256 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "databento/constants.hpp"
+#include "databento/datetime.hpp"
+#include "databento/dbn.hpp"
+#include "databento/dbn_encoder.hpp"
+#include "databento/dbn_index.hpp"
+#include "databento/dbn_store.hpp"
+#include "databento/detail/zstd_stream.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/file_stream.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"
+#include "databento/synth.hpp"
+#include "temp_file.hpp"
+
+namespace databento::tests {
+class DbnIndexTests : public testing::Test {
+ protected:
+  static constexpr std::size_t kRecordCount = 5'000;
+  static constexpr std::size_t kFrameRecordCount = 700;
+
+  // Writes `kRecordCount` synthetic MBO records to `temp_file_`, with a new Zstd
+  // frame every `kFrameRecordCount` records if `is_multi_frame`
+  void WriteFile(Compression compression, bool is_multi_frame) {
+    OutFileStream out_file{temp_file_.Path()};
+    synth::Generator generator{Schema::Mbo, {}};
+    if (compression == Compression::None) {
+      generator.WriteDbn(kRecordCount, &out_file);
+      return;
+    }
+    detail::ZstdCompressStream zstd_stream{&out_file};
+    if (!is_multi_frame) {
+      generator.WriteDbn(kRecordCount, &zstd_stream);
+      return;
+    }
+    generator.WriteDbn(0, &zstd_stream);
+    for (std::size_t written = 0; written < kRecordCount;
+         written += kFrameRecordCount) {
+      zstd_stream.Flush();
+      generator.WriteRecords(std::min(kFrameRecordCount, kRecordCount - written),
+                             &zstd_stream);
+    }
+  }
+
+  DbnStore Store() const {
+    return DbnStore{ILogReceiver::Default(), temp_file_.Path(),
+                    VersionUpgradePolicy::AsIs};
+  }
+
+  // The expected records from seeking to `ts`: everything from the first record at
+  // or after `ts`
+  std::vector<MboMsg> ExpectedFrom(UnixNanos ts) const {
+    auto store = Store();
+    std::vector<MboMsg> res;
+    while (const auto* rec = store.NextRecord()) {
+      if (!res.empty() || rec->IndexTs() >= ts) {
+        res.emplace_back(rec->Get<MboMsg>());
+      }
+    }
+    return res;
+  }
+
+  void CheckSeeks(const DbnIndex& index) {
+    auto store = Store();
+    const auto all = ExpectedFrom(UnixNanos{});
+    ASSERT_EQ(all.size(), kRecordCount);
+    // Out of order to seek both forwards and backwards
+    for (const std::size_t idx : {2'500, 0, 4'999, 1'234, 1'235, 3'000, 699, 700}) {
+      const auto ts = all[idx].ts_recv;
+      store.SeekTo(index, ts);
+      const auto expected = ExpectedFrom(ts);
+      for (const auto& expected_rec : expected) {
+        const auto* rec = store.NextRecord();
+        ASSERT_NE(rec, nullptr) << idx;
+        ASSERT_EQ(rec->Get<MboMsg>(), expected_rec) << idx;
+      }
+      ASSERT_EQ(store.NextRecord(), nullptr) << idx;
+    }
+    // After the last record
+    store.SeekTo(index, all.back().ts_recv + std::chrono::nanoseconds{1});
+    EXPECT_EQ(store.NextRecord(), nullptr);
+  }
+
+  TempFile temp_file_{std::filesystem::temp_directory_path() /
+                      ("test_dbn_index_" +
+                       std::string{testing::UnitTest::GetInstance()
+                                       ->current_test_info()
+                                       ->name()} +
+                       ".dbn")};
+};
+
+TEST_F(DbnIndexTests, TestIndexUncompressed) {
+  WriteFile(Compression::None, false);
+  const auto index = DbnIndexer{1'000}.Index(temp_file_.Path());
+  EXPECT_FALSE(index.IsCompressed());
+  EXPECT_EQ(index.FileSize(), std::filesystem::file_size(temp_file_.Path()));
+  ASSERT_EQ(index.Checkpoints().size(), 5);
+  EXPECT_EQ(index.Checkpoints()[0].ts, UnixNanos{});
+  for (const auto& checkpoint : index.Checkpoints()) {
+    EXPECT_EQ(checkpoint.frame_offset, checkpoint.offset);
+    EXPECT_EQ(checkpoint.frame_data_offset, checkpoint.offset);
+  }
+  EXPECT_EQ(index.Checkpoints()[1].offset - index.Checkpoints()[0].offset,
+            1'000 * sizeof(MboMsg));
+  CheckSeeks(index);
+}
+
+TEST_F(DbnIndexTests, TestIndexSingleFrameZstd) {
+  WriteFile(Compression::Zstd, false);
+  const auto index = DbnIndexer{1'000}.Index(temp_file_.Path());
+  EXPECT_TRUE(index.IsCompressed());
+  ASSERT_EQ(index.Checkpoints().size(), 5);
+  for (const auto& checkpoint : index.Checkpoints()) {
+    EXPECT_EQ(checkpoint.frame_offset, 0);
+    EXPECT_EQ(checkpoint.frame_data_offset, 0);
+  }
+  CheckSeeks(index);
+}
+
+TEST_F(DbnIndexTests, TestIndexMultiFrameZstd) {
+  WriteFile(Compression::Zstd, true);
+  const auto index = DbnIndexer{500}.Index(temp_file_.Path());
+  EXPECT_TRUE(index.IsCompressed());
+  ASSERT_EQ(index.Checkpoints().size(), 10);
+  // Checkpoints after the first frame start decompressing at a later frame
+  EXPECT_GT(index.Checkpoints().back().frame_offset, 0);
+  for (const auto& checkpoint : index.Checkpoints()) {
+    EXPECT_LE(checkpoint.frame_data_offset, checkpoint.offset);
+    EXPECT_LE(checkpoint.offset - checkpoint.frame_data_offset,
+              kFrameRecordCount * sizeof(MboMsg));
+  }
+  CheckSeeks(index);
+}
+
+TEST_F(DbnIndexTests, TestSeekToSidecar) {
+  WriteFile(Compression::Zstd, true);
+  TempFile index_file{DbnIndex::SidecarPath(temp_file_.Path())};
+  EXPECT_EQ(index_file.Path().string(), temp_file_.Path().string() + ".idx");
+  const auto index = DbnIndexer{}.Index(temp_file_.Path());
+  ASSERT_EQ(index.Checkpoints().size(), 1);
+  index.Write(index_file.Path());
+  const auto read_index = DbnIndex::Read(index_file.Path());
+  EXPECT_EQ(read_index.IsCompressed(), index.IsCompressed());
+  EXPECT_EQ(read_index.FileSize(), index.FileSize());
+  EXPECT_EQ(read_index.Checkpoints(), index.Checkpoints());
+
+  const auto expected = ExpectedFrom(UnixNanos{});
+  auto store = Store();
+  store.SeekTo(expected[4'000].ts_recv);
+  EXPECT_EQ(store.GetMetadata().schema, Schema::Mbo);
+  ASSERT_NE(store.NextRecord(), nullptr);
+}
+
+TEST_F(DbnIndexTests, TestReadInvalidIndex) {
+  WriteFile(Compression::None, false);
+  // A DBN file isn't an index
+  ASSERT_THROW(DbnIndex::Read(temp_file_.Path()), DbnResponseError);
+}
+
+TEST_F(DbnIndexTests, TestSeekToStaleIndex) {
+  WriteFile(Compression::None, false);
+  const auto index = DbnIndexer{}.Index(temp_file_.Path());
+  {
+    OutFileStream out_file{temp_file_.Path()};
+    synth::Generator{Schema::Mbo, {}}.WriteDbn(10, &out_file);
+  }
+  auto store = Store();
+  ASSERT_THROW(store.SeekTo(index, UnixNanos{}), InvalidArgumentError);
+}
+
+TEST_F(DbnIndexTests, TestSeekToRequiresFilePath) {
+  WriteFile(Compression::None, false);
+  const auto index = DbnIndexer{}.Index(temp_file_.Path());
+  DbnStore store{ILogReceiver::Default(),
+                 std::make_unique<InFileStream>(temp_file_.Path()),
+                 VersionUpgradePolicy::AsIs};
+  ASSERT_THROW(store.SeekTo(index, UnixNanos{}), Exception);
+}
+
+TEST_F(DbnIndexTests, TestIndexUnsorted) {
+  // Index timestamps going backwards at every third record
+  std::vector<TradeMsg> trades;
+  for (std::int64_t i = 0; i < 100; ++i) {
+    TradeMsg trade{};
+    trade.hd = RecordHeader{sizeof(TradeMsg) / kRecordHeaderLengthMultiplier,
+                            RType::Mbp0, 1, 1, UnixNanos{}};
+    trade.ts_recv = UnixNanos{std::chrono::nanoseconds{
+        i % 3 == 2 ? i * 100 - 150 : i * 100}};
+    trades.emplace_back(trade);
+  }
+  {
+    OutFileStream out_file{temp_file_.Path()};
+    DbnEncoder encoder{Metadata{kDbnVersion,
+                                dataset::kXnasItch,
+                                Schema::Trades,
+                                {},
+                                {},
+                                {},
+                                SType::InstrumentId,
+                                SType::InstrumentId,
+                                false,
+                                kSymbolCstrLen,
+                                {},
+                                {},
+                                {},
+                                {}},
+                       &out_file};
+    for (const auto& trade : trades) {
+      encoder.EncodeRecord(trade);
+    }
+  }
+  const auto index = DbnIndexer{10}.Index(temp_file_.Path());
+  ASSERT_EQ(index.Checkpoints().size(), 10);
+  DbnStore store{temp_file_.Path()};
+  for (const std::int64_t target : {0, 50, 100, 550, 549, 4'200, 9'850}) {
+    const UnixNanos ts{std::chrono::nanoseconds{target}};
+    store.SeekTo(index, ts);
+    auto it = std::find_if(trades.begin(), trades.end(),
+                           [ts](const TradeMsg& trade) { return trade.ts_recv >= ts; });
+    for (; it != trades.end(); ++it) {
+      const auto& trade = *it;
+      const auto* rec = store.NextRecord();
+      ASSERT_NE(rec, nullptr) << target;
+      ASSERT_EQ(rec->Get<TradeMsg>(), trade) << target;
+    }
+    ASSERT_EQ(store.NextRecord(), nullptr) << target;
+  }
+}
+
+TEST(DbnIndexerTests, TestInvalidCheckpointInterval) {
+  ASSERT_THROW(DbnIndexer{0}, InvalidArgumentError);
+}
+
+TEST(RecordTests, TestIndexTs) {
+  MboMsg mbo{};
+  mbo.hd = RecordHeader{sizeof(MboMsg) / kRecordHeaderLengthMultiplier, RType::Mbo, 1,
+                        1, UnixNanos{std::chrono::nanoseconds{1}}};
+  mbo.ts_recv = UnixNanos{std::chrono::nanoseconds{2}};
+  EXPECT_EQ(Record{&mbo.hd}.IndexTs(), mbo.ts_recv);
+  OhlcvMsg ohlcv{};
+  ohlcv.hd = RecordHeader{sizeof(OhlcvMsg) / kRecordHeaderLengthMultiplier,
+                          RType::Ohlcv1S, 1, 1, UnixNanos{std::chrono::nanoseconds{3}}};
+  EXPECT_EQ(Record{&ohlcv.hd}.IndexTs(), ohlcv.hd.ts_event);
+}
+}  // namespace databento::tests
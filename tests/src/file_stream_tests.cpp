@@ -1,7 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>  // equal, min
 #include <cstddef>
 #include <filesystem>
+#include <vector>
 
 #include "databento/exceptions.hpp"
 #include "databento/file_stream.hpp"
@@ -31,6 +33,102 @@ TEST(InFileStreamTests, TestReadSomeLessThanMax) {
   }));
 }
 
+TEST(InMmapFileStreamTests, TestNonExistentFile) {
+  ASSERT_THROW(InMmapFileStream{TEST_DATA_DIR "/missing.dbn"}, InvalidArgumentError);
+}
+
+TEST(InMmapFileStreamTests, TestReadExactInsufficient) {
+  const std::string file_path = TEST_DATA_DIR "/test_data.mbo.v3.dbn";
+  InMmapFileStream target{file_path};
+  std::vector<std::byte> buffer(1024);  // File is less than 1KiB
+  try {
+    target.ReadExact(buffer.data(), buffer.size());
+    FAIL() << "Expected throw";
+  } catch (const databento::Exception& exc) {
+    ASSERT_STREQ(exc.what(), "Unexpected end of file, expected 1024 bytes, got 472");
+  }
+}
+
+TEST(InMmapFileStreamTests, TestReadMatchesInFileStream) {
+  const std::string file_path = TEST_DATA_DIR "/test_data.ohlcv-1d.v1.dbn.zst";
+  InFileStream expected_stream{file_path};
+  InMmapFileStream target{file_path};
+  std::vector<std::byte> expected(1024);
+  expected.resize(expected_stream.ReadSome(expected.data(), expected.size()));
+  ASSERT_EQ(target.ReadCapacity(), expected.size());
+  ASSERT_TRUE(std::equal(expected.cbegin(), expected.cend(), target.ReadBegin()));
+  std::vector<std::byte> buffer(expected.size());
+  // Reads are split to check the position advances
+  ASSERT_EQ(target.ReadSome(buffer.data(), 10), 10);
+  ASSERT_EQ(target.ReadSome(&buffer[10], buffer.size()), buffer.size() - 10);
+  ASSERT_EQ(target.ReadCapacity(), 0);
+  ASSERT_EQ(target.ReadSome(buffer.data(), buffer.size()), 0);
+  ASSERT_EQ(buffer, expected);
+}
+
+TEST(InMmapFileStreamTests, TestEmptyFile) {
+  TempFile temp_file{std::filesystem::temp_directory_path() / "empty_mmap"};
+  { OutFileStream{temp_file.Path()}; }
+  InMmapFileStream target{temp_file.Path()};
+  std::vector<std::byte> buffer(8);
+  ASSERT_EQ(target.ReadCapacity(), 0);
+  ASSERT_EQ(target.ReadSome(buffer.data(), buffer.size()), 0);
+}
+
+#ifdef DATABENTO_IO_URING
+TEST(InUringFileStreamTests, TestNonExistentFile) {
+  ASSERT_THROW(InUringFileStream{TEST_DATA_DIR "/missing.dbn"}, InvalidArgumentError);
+}
+
+TEST(InUringFileStreamTests, TestReadExactInsufficient) {
+  const std::string file_path = TEST_DATA_DIR "/test_data.mbo.v3.dbn";
+  InUringFileStream target{file_path};
+  std::vector<std::byte> buffer(1024);  // File is less than 1KiB
+  try {
+    target.ReadExact(buffer.data(), buffer.size());
+    FAIL() << "Expected throw";
+  } catch (const databento::Exception& exc) {
+    ASSERT_STREQ(exc.what(), "Unexpected end of file, expected 1024 bytes, got 472");
+  }
+}
+
+TEST(InUringFileStreamTests, TestReadLargeFile) {
+  // Larger than all the read buffers combined and not a multiple of their size
+  constexpr std::size_t kSize = (std::size_t{9} << 20) + 123;
+  std::vector<std::byte> expected(kSize);
+  for (std::size_t i = 0; i < kSize; ++i) {
+    expected[i] = static_cast<std::byte>(i * 31 + i / 4099);
+  }
+  TempFile temp_file{std::filesystem::temp_directory_path() / "large_uring"};
+  OutFileStream{temp_file.Path()}.WriteAll(expected.data(), expected.size());
+
+  InUringFileStream target{temp_file.Path()};
+  std::vector<std::byte> buffer(kSize);
+  std::size_t read_size = 0;
+  // Odd read sizes so reads straddle the read buffers
+  while (const auto size = target.ReadSome(&buffer[read_size],
+                                           (std::min)(kSize - read_size,
+                                                      std::size_t{777'777}))) {
+    read_size += size;
+  }
+  ASSERT_EQ(read_size, kSize);
+  ASSERT_EQ(buffer, expected);
+  ASSERT_EQ(target.ReadSome(buffer.data(), buffer.size()), 0);
+}
+
+TEST(InUringFileStreamTests, TestEmptyFile) {
+  TempFile temp_file{std::filesystem::temp_directory_path() / "empty_uring"};
+  { OutFileStream{temp_file.Path()}; }
+  InUringFileStream target{temp_file.Path()};
+  std::vector<std::byte> buffer(8);
+  ASSERT_EQ(target.ReadSome(buffer.data(), buffer.size()), 0);
+}
+#else
+TEST(InUringFileStreamTests, TestUnsupported) {
+  ASSERT_THROW(InUringFileStream{TEST_DATA_DIR "/test_data.mbo.v3.dbn"}, Exception);
+}
+#endif
+
 TEST(OutFileStreamTests, TestWriteAllCanBeRead) {
   constexpr auto data = "abcdefgh";
   TempFile temp_file{std::filesystem::temp_directory_path() / "out"};
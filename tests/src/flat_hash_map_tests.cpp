@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>  // move
+
+#include "databento/detail/flat_hash_map.hpp"
+
+namespace databento::detail::tests {
+TEST(FlatHashMapTests, TestInsertFindErase) {
+  FlatHashMap<std::uint64_t, std::string> target;
+  EXPECT_TRUE(target.IsEmpty());
+  EXPECT_EQ(target.Find(1), nullptr);
+  EXPECT_FALSE(target.Erase(1));
+
+  const auto [value, is_inserted] = target.Insert(1, "one");
+  EXPECT_TRUE(is_inserted);
+  EXPECT_EQ(*value, "one");
+  // Doesn't overwrite
+  const auto res = target.Insert(1, "uno");
+  EXPECT_FALSE(res.second);
+  EXPECT_EQ(*res.first, "one");
+  target.Insert(0, "zero");
+  EXPECT_EQ(target.Size(), 2);
+  ASSERT_NE(target.Find(0), nullptr);
+  EXPECT_EQ(*target.Find(0), "zero");
+
+  EXPECT_TRUE(target.Erase(1));
+  EXPECT_EQ(target.Find(1), nullptr);
+  EXPECT_EQ(target.Size(), 1);
+  target.Clear();
+  EXPECT_TRUE(target.IsEmpty());
+  EXPECT_EQ(target.Find(0), nullptr);
+}
+
+TEST(FlatHashMapTests, TestForEach) {
+  FlatHashMap<std::uint32_t, std::uint32_t> target{100};
+  for (std::uint32_t i = 0; i < 100; ++i) {
+    target.Insert(i, i * 2);
+  }
+  std::uint32_t key_sum{};
+  target.ForEach([&key_sum](std::uint32_t key, std::uint32_t& value) {
+    EXPECT_EQ(value, key * 2);
+    key_sum += key;
+    ++value;
+  });
+  EXPECT_EQ(key_sum, 4950);
+  EXPECT_EQ(*target.Find(10), 21);
+}
+
+TEST(FlatHashMapTests, TestMove) {
+  FlatHashMap<std::uint32_t, std::uint32_t> target;
+  for (std::uint32_t i = 0; i < 100; ++i) {
+    target.Insert(i, i * 2);
+  }
+  FlatHashMap<std::uint32_t, std::uint32_t> moved{std::move(target)};
+  EXPECT_EQ(moved.Size(), 100);
+  EXPECT_EQ(*moved.Find(10), 20);
+  // The moved-from map is empty and still usable
+  EXPECT_TRUE(target.IsEmpty());
+  EXPECT_EQ(target.Find(10), nullptr);
+  EXPECT_FALSE(target.Erase(10));
+  EXPECT_TRUE(target.Insert(10, 1).second);
+  EXPECT_EQ(*target.Find(10), 1);
+
+  target = std::move(moved);
+  EXPECT_EQ(target.Size(), 100);
+  EXPECT_EQ(*target.Find(10), 20);
+  EXPECT_TRUE(moved.IsEmpty());
+  EXPECT_EQ(moved.Find(10), nullptr);
+  EXPECT_TRUE(moved.Insert(5, 5).second);
+  EXPECT_EQ(moved.Size(), 1);
+}
+
+// Checks erasing keeps colliding entries reachable
+TEST(FlatHashMapTests, TestMatchesUnorderedMap) {
+  FlatHashMap<std::uint64_t, std::uint64_t> target;
+  std::unordered_map<std::uint64_t, std::uint64_t> expected;
+  std::mt19937_64 rng{42};
+  for (std::size_t i = 0; i < 200'000; ++i) {
+    // Few enough keys that most operations hit existing entries
+    const auto key = rng() % 2'000;
+    switch (rng() % 3) {
+      case 0: {
+        const auto inserted = target.Insert(key, i).second;
+        ASSERT_EQ(inserted, expected.emplace(key, i).second);
+        break;
+      }
+      case 1: {
+        ASSERT_EQ(target.Erase(key), expected.erase(key) == 1);
+        break;
+      }
+      default: {
+        const auto* value = target.Find(key);
+        const auto it = expected.find(key);
+        ASSERT_EQ(value == nullptr, it == expected.end());
+        if (value != nullptr) {
+          ASSERT_EQ(*value, it->second);
+        }
+      }
+    }
+    ASSERT_EQ(target.Size(), expected.size());
+  }
+}
+}  // namespace databento::detail::tests
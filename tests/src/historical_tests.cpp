@@ -26,6 +26,7 @@
 #include "databento/log.hpp"
 #include "databento/metadata.hpp"
 #include "databento/record.hpp"
+#include "databento/record_visitor.hpp"
 #include "databento/symbology.hpp"  // kAllSymbols
 #include "databento/timeseries.hpp"
 #include "mock/mock_http_server.hpp"
@@ -748,6 +749,36 @@ TEST_F(HistoricalTests, TestTimeseriesGetRange_NoMetadataCallback) {
   EXPECT_EQ(mbo_records.size(), 2);
 }
 
+TEST_F(HistoricalTests, TestTimeseriesGetRange_Visitor) {
+  mock_server_.MockPostDbn("/v0/timeseries.get_range",
+                           {{"dataset", dataset::kGlbxMdp3},
+                            {"start", "2022-10-21T13:30"},
+                            {"end", "2022-10-21T20:00"},
+                            {"symbols", "CYZ2"},
+                            {"schema", "tbbo"},
+                            {"encoding", "dbn"},
+                            {"stype_in", "raw_symbol"},
+                            {"stype_out", "instrument_id"}},
+                           TEST_DATA_DIR "/test_data.tbbo.v3.dbn.zst");
+  const auto port = mock_server_.ListenOnThread();
+
+  struct Visitor {
+    void operator()(const TbboMsg& tbbo) { tbbo_records.emplace_back(tbbo); }
+    void operator()(const MboMsg&) { ++mbo_count; }
+
+    std::vector<TbboMsg> tbbo_records;
+    std::size_t mbo_count{};
+  };
+  databento::Historical target = Client(port);
+  Visitor visitor;
+  target.TimeseriesGetRange(
+      dataset::kGlbxMdp3, {"2022-10-21T13:30", "2022-10-21T20:00"}, {"CYZ2"},
+      Schema::Tbbo,
+      [&visitor](const Record& record) { return VisitRecord(record, visitor); });
+  EXPECT_EQ(visitor.tbbo_records.size(), 2);
+  EXPECT_EQ(visitor.mbo_count, 0);
+}
+
 // should get helpful message if there's a problem with the request
 TEST_F(HistoricalTests, TestTimeseriesGetRange_BadRequest) {
   const nlohmann::json resp{
@@ -22,6 +22,7 @@
 #include "databento/live_subscription.hpp"
 #include "databento/log.hpp"
 #include "databento/record.hpp"
+#include "databento/record_ref.hpp"
 #include "databento/symbology.hpp"
 #include "databento/with_ts_out.hpp"
 #include "mock/mock_log_receiver.hpp"
@@ -289,6 +290,73 @@ TEST_F(LiveBlockingTests, TestNextRecord) {
   }
 }
 
+TEST_F(LiveBlockingTests, TestNextRecordLowLatency) {
+  constexpr auto kTsOut = false;
+  const auto kRecCount = 12;
+  constexpr OhlcvMsg kRec{DummyHeader<OhlcvMsg>(RType::Ohlcv1M), 1, 2, 3, 4, 5};
+  const mock::MockLsgServer mock_server{dataset::kXnasItch, kTsOut,
+                                        [kRec, kRecCount](mock::MockLsgServer& self) {
+                                          self.Accept();
+                                          self.Authenticate();
+                                          for (size_t i = 0; i < kRecCount; ++i) {
+                                            self.SendRecord(kRec);
+                                          }
+                                        }};
+
+  LowLatencyConf low_latency_conf{};
+  low_latency_conf.spin = true;
+  low_latency_conf.rcv_lowat = 1;
+  LiveBlocking target = builder_.SetDataset(dataset::kXnasItch)
+                            .SetSendTsOut(kTsOut)
+                            .SetAddress(kLocalhost, mock_server.Port())
+                            .SetLowLatencyConf(low_latency_conf)
+                            .BuildBlocking();
+  EXPECT_TRUE(target.LowLatencyConf().spin);
+  for (size_t i = 0; i < kRecCount; ++i) {
+    const auto* rec = target.NextRecord(std::chrono::seconds{5});
+    ASSERT_NE(rec, nullptr) << "Failed on call " << i;
+    ASSERT_TRUE(rec->Holds<OhlcvMsg>()) << "Failed on call " << i;
+    EXPECT_EQ(rec->Get<OhlcvMsg>(), kRec);
+  }
+}
+
+TEST_F(LiveBlockingTests, TestNextRecordRef) {
+  constexpr auto kTsOut = false;
+  constexpr std::int64_t kRecCount = 200;
+  constexpr std::size_t kBufferSize = 2048;
+  const mock::MockLsgServer mock_server{
+      dataset::kXnasItch, kTsOut, [](mock::MockLsgServer& self) {
+        self.Accept();
+        self.Authenticate();
+        for (std::int64_t i = 0; i < kRecCount; ++i) {
+          self.SendRecord(OhlcvMsg{DummyHeader<OhlcvMsg>(RType::Ohlcv1M), i, 2, 3,
+                                   4, 5});
+        }
+      }};
+
+  LiveBlocking target = builder_.SetDataset(dataset::kXnasItch)
+                            .SetSendTsOut(kTsOut)
+                            .SetBufferSize(kBufferSize)
+                            .SetAddress(kLocalhost, mock_server.Port())
+                            .BuildBlocking();
+  // Holding every record requires the buffer to move to new slabs
+  std::vector<RecordRef> recs;
+  for (std::int64_t i = 0; i < kRecCount; ++i) {
+    auto rec = target.NextRecordRef(std::chrono::seconds{5});
+    ASSERT_TRUE(rec) << "Failed on call " << i;
+    recs.emplace_back(std::move(rec));
+  }
+  EXPECT_FALSE(target.NextRecordRef(std::chrono::milliseconds{10}));
+  // Records remain valid on another thread
+  std::thread{[&recs] {
+    for (std::int64_t i = 0; i < kRecCount; ++i) {
+      ASSERT_TRUE(recs[i]->Holds<OhlcvMsg>()) << "Failed on record " << i;
+      EXPECT_EQ(recs[i]->Get<OhlcvMsg>().open, i);
+    }
+    recs.clear();
+  }}.join();
+}
+
 TEST_F(LiveBlockingTests, TestNextRecordWithZstdCompression) {
   constexpr auto kTsOut = false;
   const auto kRecCount = 12;
@@ -501,6 +569,61 @@ TEST_F(LiveBlockingTests, TestNextRecordPartialRead) {
   EXPECT_EQ(rec.Get<MboMsg>(), kRec);
 }
 
+#ifdef __linux__
+TEST_F(LiveBlockingTests, TestLastRecordRxTs) {
+  constexpr auto kTsOut = false;
+  constexpr MboMsg kRec{DummyHeader<MboMsg>(RType::Mbo),
+                        1,
+                        2,
+                        3,
+                        {},
+                        4,
+                        Action::Add,
+                        Side::Bid,
+                        UnixNanos{},
+                        TimeDeltaNanos{},
+                        100};
+
+  bool send_remaining{};
+  std::mutex send_remaining_mutex;
+  std::condition_variable send_remaining_cv;
+  const mock::MockLsgServer mock_server{
+      dataset::kGlbxMdp3, kTsOut,
+      [kRec, &send_remaining, &send_remaining_mutex,
+       &send_remaining_cv](mock::MockLsgServer& self) {
+        self.Accept();
+        self.Authenticate();
+        self.SendRecord(kRec);
+        self.SplitSendRecord(kRec, send_remaining, send_remaining_mutex,
+                             send_remaining_cv);
+      }};
+
+  LowLatencyConf low_latency_conf{};
+  low_latency_conf.rx_timestamps = true;
+  const auto start = UnixNanos{std::chrono::system_clock::now()};
+  LiveBlocking target = builder_.SetDataset(dataset::kGlbxMdp3)
+                            .SetSendTsOut(kTsOut)
+                            .SetAddress(kLocalhost, mock_server.Port())
+                            .SetLowLatencyConf(low_latency_conf)
+                            .BuildBlocking();
+  EXPECT_EQ(target.LastRecordRxTs(), UnixNanos{});
+  ASSERT_NE(target.NextRecord(std::chrono::seconds{5}), nullptr);
+  const auto first_rx_ts = target.LastRecordRxTs();
+  EXPECT_GE(first_rx_ts, start);
+  ASSERT_EQ(target.NextRecord(std::chrono::milliseconds{10}), nullptr);
+  const auto resume = UnixNanos{std::chrono::system_clock::now()};
+  {
+    const std::lock_guard<std::mutex> lock{send_remaining_mutex};
+    send_remaining = true;
+    send_remaining_cv.notify_one();
+  }
+  ASSERT_NE(target.NextRecord(std::chrono::seconds{5}), nullptr);
+  // Timestamped by the read that completed the record, not the partial one
+  EXPECT_GE(target.LastRecordRxTs(), resume);
+  EXPECT_LE(target.LastRecordRxTs(), UnixNanos{std::chrono::system_clock::now()});
+}
+#endif
+
 TEST_F(LiveBlockingTests, TestNextRecordWithTsOut) {
   const auto kRecCount = 5;
   constexpr auto kTsOut = true;
@@ -539,6 +662,62 @@ TEST_F(LiveBlockingTests, TestNextRecordWithTsOut) {
   }
 }
 
+TEST_F(LiveBlockingTests, TestStats) {
+  const auto kRecCount = 5;
+  constexpr auto kTsOut = true;
+  TradeMsg trade{DummyHeader<TradeMsg>(RType::Mbp0), 1, 2, Action::Add, Side::Ask, {},
+                 1, {}, {}, 2};
+  trade.ts_recv = UnixNanos{std::chrono::seconds{1}};
+  const WithTsOut<TradeMsg> send_rec{
+      trade, UnixNanos{std::chrono::seconds{1} + std::chrono::microseconds{5}}};
+  const mock::MockLsgServer mock_server{
+      dataset::kXnasItch, kTsOut, [send_rec, kRecCount](mock::MockLsgServer& self) {
+        self.Accept();
+        self.Authenticate();
+        for (size_t i = 0; i < kRecCount; ++i) {
+          self.SendRecord(send_rec);
+        }
+      }};
+
+  LiveBlocking target = builder_.SetDataset(dataset::kXnasItch)
+                            .SetSendTsOut(kTsOut)
+                            .SetAddress(kLocalhost, mock_server.Port())
+                            .SetCollectStats(true)
+                            .BuildBlocking();
+  EXPECT_EQ(target.Stats().records, 0);
+  for (size_t i = 0; i < kRecCount; ++i) {
+    ASSERT_NE(target.NextRecord(std::chrono::seconds{5}), nullptr);
+  }
+  const auto stats = target.Stats();
+  EXPECT_EQ(stats.records, kRecCount);
+  EXPECT_EQ(stats.records_by_rtype[static_cast<std::uint8_t>(RType::Mbp0)], kRecCount);
+  EXPECT_EQ(stats.bytes_read, kRecCount * sizeof(send_rec));
+  EXPECT_GE(stats.reads, 1);
+  EXPECT_EQ(stats.read_sizes.Count(), stats.reads);
+  EXPECT_EQ(stats.gateway_latencies.Count(), kRecCount);
+  EXPECT_EQ(stats.gateway_latencies.Max(), 5'000);
+  EXPECT_EQ(stats.transit_latencies.Count(), kRecCount);
+  // Only measured by `LiveThreaded`
+  EXPECT_EQ(stats.callback_times.Count(), 0);
+}
+
+TEST_F(LiveBlockingTests, TestStatsDisabled) {
+  const mock::MockLsgServer mock_server{dataset::kXnasItch, false,
+                                        [](mock::MockLsgServer& self) {
+                                          self.Accept();
+                                          self.Authenticate();
+                                          self.SendRecord(OhlcvMsg{
+                                              DummyHeader<OhlcvMsg>(RType::Ohlcv1M),
+                                              1, 2, 3, 4, 5});
+                                        }};
+  LiveBlocking target = builder_.SetDataset(dataset::kXnasItch)
+                            .SetAddress(kLocalhost, mock_server.Port())
+                            .BuildBlocking();
+  ASSERT_NE(target.NextRecord(std::chrono::seconds{5}), nullptr);
+  EXPECT_EQ(target.Stats().records, 0);
+  EXPECT_EQ(target.Stats().reads, 0);
+}
+
 TEST_F(LiveBlockingTests, TestStop) {
   constexpr auto kTsOut = true;
   const WithTsOut<TradeMsg> send_rec{
@@ -0,0 +1,223 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>  // milliseconds, seconds
+#include <cstddef>
+#include <cstdint>
+#include <thread>  // this_thread
+#include <vector>
+
+#include "databento/constants.hpp"  // dataset
+#include "databento/datetime.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/live.hpp"
+#include "databento/live_blocking.hpp"
+#include "databento/live_multiplexer.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"
+#include "mock/mock_log_receiver.hpp"
+#include "mock/mock_lsg_server.hpp"  // MockLsgServer
+
+namespace databento::tests {
+class LiveMultiplexerTests : public testing::Test {
+ protected:
+  static constexpr auto kKey = "32-character-with-lots-of-filler";
+  static constexpr auto kLocalhost = "127.0.0.1";
+
+  static MboMsg Mbo(std::uint32_t instrument_id, std::chrono::seconds ts_recv) {
+    return Mbo(instrument_id, UnixNanos{ts_recv});
+  }
+
+  static MboMsg Mbo(std::uint32_t instrument_id, UnixNanos ts_recv) {
+    return {{sizeof(MboMsg) / RecordHeader::kLengthMultiplier, RType::Mbo, 1,
+             instrument_id, UnixNanos{}},
+            1,
+            2,
+            3,
+            {},
+            4,
+            Action::Add,
+            Side::Bid,
+            ts_recv,
+            {},
+            5};
+  }
+
+  LiveBlocking Build(const mock::MockLsgServer& server, const std::string& dataset) {
+    return LiveBuilder{}
+        .SetLogReceiver(&logger_)
+        .SetKey(kKey)
+        .SetDataset(dataset)
+        .SetAddress(kLocalhost, server.Port())
+        .BuildBlocking();
+  }
+
+  mock::MockLogReceiver logger_ =
+      mock::MockLogReceiver::AssertNoLogs(LogLevel::Warning);
+};
+
+TEST_F(LiveMultiplexerTests, TestEmptySessions) {
+  ASSERT_THROW(LiveMultiplexer{std::vector<LiveBlocking>{}}, InvalidArgumentError);
+}
+
+TEST_F(LiveMultiplexerTests, TestTsOutOrderRequiresSendTsOut) {
+  const mock::MockLsgServer mock_server{dataset::kXnasItch, false,
+                                        [](mock::MockLsgServer& self) {
+                                          self.Accept();
+                                          self.Authenticate();
+                                        }};
+  std::vector<LiveBlocking> sessions;
+  sessions.emplace_back(Build(mock_server, dataset::kXnasItch));
+  MergeConf merge_conf{};
+  merge_conf.order = MergeOrder::TsOut;
+  ASSERT_THROW((LiveMultiplexer{std::move(sessions), merge_conf}),
+               InvalidArgumentError);
+}
+
+TEST_F(LiveMultiplexerTests, TestArrivalMerge) {
+  constexpr std::uint32_t kRecCount = 10;
+  const auto serve = [](std::uint32_t instrument_id) {
+    return [instrument_id](mock::MockLsgServer& self) {
+      self.Accept();
+      self.Authenticate();
+      for (std::uint32_t i = 0; i < kRecCount; ++i) {
+        self.SendRecord(Mbo(instrument_id, std::chrono::seconds{i}));
+      }
+    };
+  };
+  const mock::MockLsgServer glbx_server{dataset::kGlbxMdp3, false, serve(1)};
+  const mock::MockLsgServer xnas_server{dataset::kXnasItch, false, serve(2)};
+
+  std::vector<LiveBlocking> sessions;
+  sessions.emplace_back(Build(glbx_server, dataset::kGlbxMdp3));
+  sessions.emplace_back(Build(xnas_server, dataset::kXnasItch));
+  LiveMultiplexer target{std::move(sessions)};
+  ASSERT_EQ(target.Sessions().size(), 2U);
+  ASSERT_EQ(target.MergeConf().order, MergeOrder::Arrival);
+
+  std::vector<std::uint32_t> next_ts(3);
+  for (std::uint32_t i = 0; i < 2 * kRecCount; ++i) {
+    const auto& rec = target.NextRecord();
+    ASSERT_TRUE(rec.Holds<MboMsg>()) << "Failed on call " << i;
+    const auto& mbo = rec.Get<MboMsg>();
+    const auto id = mbo.hd.instrument_id;
+    ASSERT_TRUE(id == 1 || id == 2);
+    // Each session's records are passed on in order
+    EXPECT_EQ(mbo.ts_recv, UnixNanos{std::chrono::seconds{next_ts[id]}});
+    ++next_ts[id];
+  }
+  EXPECT_EQ(next_ts[1], kRecCount);
+  EXPECT_EQ(next_ts[2], kRecCount);
+  EXPECT_EQ(target.NextRecord(std::chrono::milliseconds{10}), nullptr);
+}
+
+TEST_F(LiveMultiplexerTests, TestIndexTsMerge) {
+  constexpr std::uint32_t kRecCount = 10;
+  constexpr std::chrono::seconds kSentinelTs{100};
+  // Only send the records that release the others once both servers have sent all
+  // their earlier records
+  std::atomic<int> sent_count{};
+  const auto serve = [&sent_count](std::uint32_t instrument_id) {
+    return [&sent_count, instrument_id](mock::MockLsgServer& self) {
+      self.Accept();
+      self.Authenticate();
+      self.Start();
+      // Interleaved: 0, 2, 4, ... and 1, 3, 5, ...
+      for (std::uint32_t i = 0; i < kRecCount; ++i) {
+        self.SendRecord(
+            Mbo(instrument_id, std::chrono::seconds{2 * i + instrument_id - 1}));
+      }
+      ++sent_count;
+      while (sent_count < 2) {
+        std::this_thread::yield();
+      }
+      self.SendRecord(Mbo(instrument_id, kSentinelTs));
+    };
+  };
+  const mock::MockLsgServer glbx_server{dataset::kGlbxMdp3, false, serve(1)};
+  const mock::MockLsgServer xnas_server{dataset::kXnasItch, false, serve(2)};
+
+  std::vector<LiveBlocking> sessions;
+  sessions.emplace_back(Build(glbx_server, dataset::kGlbxMdp3));
+  sessions.emplace_back(Build(xnas_server, dataset::kXnasItch));
+  MergeConf merge_conf{};
+  merge_conf.order = MergeOrder::IndexTs;
+  merge_conf.reorder_window = std::chrono::seconds{30};
+  LiveMultiplexer target{std::move(sessions), merge_conf};
+  const auto metadata = target.Start();
+  ASSERT_EQ(metadata.size(), 2U);
+
+  for (std::uint32_t i = 0; i < 2 * kRecCount; ++i) {
+    const auto& rec = target.NextRecord();
+    ASSERT_TRUE(rec.Holds<MboMsg>()) << "Failed on call " << i;
+    EXPECT_EQ(rec.Get<MboMsg>().ts_recv, UnixNanos{std::chrono::seconds{i}});
+  }
+  // The sentinels are only released once they've been held for the reorder window
+  EXPECT_EQ(target.NextRecord(std::chrono::milliseconds{10}), nullptr);
+}
+
+TEST_F(LiveMultiplexerTests, TestMaxHeld) {
+  constexpr std::uint32_t kRecCount = 4;
+  const mock::MockLsgServer mock_server{
+      dataset::kXnasItch, false, [](mock::MockLsgServer& self) {
+        self.Accept();
+        self.Authenticate();
+        for (std::uint32_t i = 0; i < kRecCount; ++i) {
+          self.SendRecord(Mbo(1, std::chrono::seconds{i}));
+        }
+      }};
+
+  std::vector<LiveBlocking> sessions;
+  sessions.emplace_back(Build(mock_server, dataset::kXnasItch));
+  MergeConf merge_conf{};
+  merge_conf.order = MergeOrder::IndexTs;
+  merge_conf.reorder_window = std::chrono::hours{1};
+  merge_conf.max_held = kRecCount - 2;
+  LiveMultiplexer target{std::move(sessions), merge_conf};
+  for (std::uint32_t i = 0; i < 2; ++i) {
+    const auto* rec = target.NextRecord(std::chrono::seconds{5});
+    ASSERT_NE(rec, nullptr) << "Failed on call " << i;
+    EXPECT_EQ(rec->Get<MboMsg>().ts_recv, UnixNanos{std::chrono::seconds{i}});
+  }
+  // The remaining records are within both limits
+  EXPECT_EQ(target.NextRecord(std::chrono::milliseconds{10}), nullptr);
+}
+TEST_F(LiveMultiplexerTests, TestIndexTsMergeExtremeTs) {
+  const auto serve = [](UnixNanos ts_recv) {
+    return [ts_recv](mock::MockLsgServer& self) {
+      self.Accept();
+      self.Authenticate();
+      self.SendRecord(Mbo(1, std::chrono::seconds{1}));
+      self.SendRecord(Mbo(1, ts_recv));
+    };
+  };
+  MergeConf merge_conf{};
+  merge_conf.order = MergeOrder::IndexTs;
+  merge_conf.reorder_window = std::chrono::hours{1};
+  // An undefined timestamp doesn't move the reorder window
+  {
+    const mock::MockLsgServer mock_server{
+        dataset::kXnasItch, false,
+        serve(UnixNanos{UnixNanos::duration{kUndefTimestamp}})};
+    std::vector<LiveBlocking> sessions;
+    sessions.emplace_back(Build(mock_server, dataset::kXnasItch));
+    LiveMultiplexer target{std::move(sessions), merge_conf};
+    EXPECT_EQ(target.NextRecord(std::chrono::milliseconds{50}), nullptr);
+  }
+  // The end of the reorder window doesn't wrap around for timestamps near the
+  // maximum
+  {
+    const mock::MockLsgServer mock_server{
+        dataset::kXnasItch, false,
+        serve(UnixNanos{UnixNanos::duration{kUndefTimestamp - 1}})};
+    std::vector<LiveBlocking> sessions;
+    sessions.emplace_back(Build(mock_server, dataset::kXnasItch));
+    LiveMultiplexer target{std::move(sessions), merge_conf};
+    const auto* rec = target.NextRecord(std::chrono::seconds{5});
+    ASSERT_NE(rec, nullptr);
+    EXPECT_EQ(rec->Get<MboMsg>().ts_recv, UnixNanos{std::chrono::seconds{1}});
+    EXPECT_EQ(target.NextRecord(std::chrono::milliseconds{50}), nullptr);
+  }
+}
+}  // namespace databento::tests
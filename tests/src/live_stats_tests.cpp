@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "databento/datetime.hpp"
+#include "databento/detail/live_stats_recorder.hpp"
+#include "databento/enums.hpp"
+#include "databento/live_stats.hpp"
+#include "databento/record.hpp"
+#include "databento/with_ts_out.hpp"
+
+namespace databento::tests {
+TEST(LiveHistogramTests, TestBucketBounds) {
+  for (std::uint64_t value = 0; value < 1024; ++value) {
+    const auto bucket = LiveHistogram::BucketOf(value);
+    ASSERT_LE(LiveHistogram::BucketLowerBound(bucket), value) << value;
+    ASSERT_GT(LiveHistogram::BucketLowerBound(bucket + 1), value) << value;
+  }
+  // Exact below the sub-bucket count
+  EXPECT_EQ(LiveHistogram::BucketOf(7), 7);
+  EXPECT_EQ(LiveHistogram::BucketOf(8), 8);
+  EXPECT_EQ(LiveHistogram::BucketOf(16), LiveHistogram::BucketOf(17));
+  EXPECT_EQ(LiveHistogram::BucketOf(std::numeric_limits<std::uint64_t>::max()),
+            LiveHistogram::kBucketCount - 1);
+}
+
+TEST(LiveHistogramTests, TestPercentiles) {
+  detail::LiveStatsRecorder target;
+  ASSERT_EQ(target.Snapshot().read_sizes.ValueAtPercentile(50), 0);
+  for (std::size_t size = 1; size <= 1000; ++size) {
+    target.RecordRead(size);
+  }
+  const auto stats = target.Snapshot();
+  EXPECT_EQ(stats.reads, 1000);
+  EXPECT_EQ(stats.bytes_read, 500500);
+  const auto& read_sizes = stats.read_sizes;
+  EXPECT_EQ(read_sizes.Count(), 1000);
+  EXPECT_EQ(read_sizes.Max(), 1000);
+  EXPECT_DOUBLE_EQ(read_sizes.Mean(), 500.5);
+  EXPECT_EQ(read_sizes.ValueAtPercentile(0), 1);
+  EXPECT_EQ(read_sizes.ValueAtPercentile(100), 1000);
+  // Within the bucket width
+  const auto median = read_sizes.ValueAtPercentile(50);
+  EXPECT_GE(median, 500);
+  EXPECT_LE(median, 500 + 500 / LiveHistogram::kSubBucketCount);
+}
+
+TEST(LiveStatsRecorderTests, TestRecordRecord) {
+  constexpr UnixNanos kTsRecv{std::chrono::seconds{1}};
+  constexpr UnixNanos kTsOut{kTsRecv + std::chrono::microseconds{20}};
+  TradeMsg trade{};
+  trade.hd = {sizeof(TradeMsg) / RecordHeader::kLengthMultiplier, RType::Mbp0, 1, 1,
+              UnixNanos{}};
+  trade.ts_recv = kTsRecv;
+  WithTsOut<TradeMsg> rec{trade, kTsOut};
+
+  detail::LiveStatsRecorder target;
+  target.RecordRecord(Record{&rec.rec.hd}, true,
+                      kTsOut + std::chrono::microseconds{100});
+  // Earlier than `ts_out` from clock differences
+  target.RecordRecord(Record{&rec.rec.hd}, true, kTsRecv);
+  target.RecordRecord(Record{&rec.rec.hd}, false, UnixNanos{});
+  const auto stats = target.Snapshot();
+  EXPECT_EQ(stats.records, 3);
+  EXPECT_EQ(stats.records_by_rtype[static_cast<std::uint8_t>(RType::Mbp0)], 3);
+  EXPECT_EQ(stats.bytes_by_rtype[static_cast<std::uint8_t>(RType::Mbp0)],
+            3 * sizeof(rec));
+  EXPECT_EQ(stats.gateway_latencies.Count(), 2);
+  EXPECT_EQ(stats.gateway_latencies.Max(), 20'000);
+  EXPECT_EQ(stats.transit_latencies.Count(), 2);
+  EXPECT_EQ(stats.transit_latencies.Max(), 100'000);
+  EXPECT_EQ(stats.transit_latencies.ValueAtPercentile(0), 0);
+}
+}  // namespace databento::tests
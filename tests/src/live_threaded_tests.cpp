@@ -1,8 +1,10 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <exception>
 #include <memory>
@@ -19,6 +21,8 @@
 #include "databento/live_threaded.hpp"
 #include "databento/log.hpp"
 #include "databento/record.hpp"
+#include "databento/record_queue.hpp"
+#include "databento/record_visitor.hpp"
 #include "databento/symbology.hpp"
 #include "databento/timeseries.hpp"
 #include "mock/mock_log_receiver.hpp"
@@ -78,6 +82,286 @@ TEST_F(LiveThreadedTests, TestBasic) {
   target.BlockForStop();
 }
 
+TEST_F(LiveThreadedTests, TestStartVisitor) {
+  const MboMsg kRec{DummyHeader<MboMsg>(RType::Mbo),
+                    1,
+                    2,
+                    3,
+                    {},
+                    4,
+                    Action::Add,
+                    Side::Bid,
+                    UnixNanos{},
+                    TimeDeltaNanos{},
+                    100};
+  constexpr auto kHeartbeatInterval = std::chrono::seconds{5};
+  const mock::MockLsgServer mock_server{dataset::kGlbxMdp3, kTsOut, kHeartbeatInterval,
+                                        [&kRec](mock::MockLsgServer& self) {
+                                          self.Accept();
+                                          self.Authenticate();
+                                          self.Start();
+                                          self.SendRecord(kRec);
+                                          self.SendRecord(kRec);
+                                        }};
+
+  LiveThreaded target = builder_.SetDataset(dataset::kGlbxMdp3)
+                            .SetSendTsOut(kTsOut)
+                            .SetHeartbeatInterval(kHeartbeatInterval)
+                            .SetAddress(kLocalhost, mock_server.Port())
+                            .BuildThreaded();
+  struct Visitor {
+    KeepGoing operator()(const MboMsg& mbo) {
+      ++*call_count;
+      EXPECT_EQ(mbo, *expected);
+      return *call_count < 2 ? KeepGoing::Continue : KeepGoing::Stop;
+    }
+    void operator()(const TradeMsg&) { ADD_FAILURE() << "Unexpected TradeMsg"; }
+
+    std::uint32_t* call_count;
+    const MboMsg* expected;
+  };
+  std::uint32_t call_count{};
+  bool metadata_called{};
+  target.Start([&metadata_called](Metadata&&) { metadata_called = true; },
+               [visitor = Visitor{&call_count, &kRec}](const Record& record) mutable {
+                 return VisitRecord(record, visitor);
+               });
+  target.BlockForStop();
+  EXPECT_TRUE(metadata_called);
+  EXPECT_EQ(call_count, 2);
+}
+
+TEST_F(LiveThreadedTests, TestStartQueue) {
+  constexpr std::uint32_t kRecordCount = 100;
+  constexpr std::size_t kCapacity = 16;
+  std::atomic<bool> is_done{};
+  auto mock_server = std::make_unique<mock::MockLsgServer>(
+      dataset::kGlbxMdp3, kTsOut, [&is_done](mock::MockLsgServer& self) {
+        self.Accept();
+        self.Authenticate();
+        self.Start();
+        for (std::uint32_t i = 0; i < kRecordCount; ++i) {
+          MboMsg mbo{};
+          mbo.hd = DummyHeader<MboMsg>(RType::Mbo);
+          mbo.sequence = i;
+          self.SendRecord(mbo);
+        }
+        // Keep the connection open until the client is destroyed
+        while (!is_done) {
+          std::this_thread::yield();
+        }
+      });
+
+  RecordQueue queue{kCapacity, RecordQueue::OverflowPolicy::Block};
+  {
+    LiveThreaded target = builder_.SetDataset(dataset::kGlbxMdp3)
+                              .SetSendTsOut(kTsOut)
+                              .SetAddress(kLocalhost, mock_server->Port())
+                              .BuildThreaded();
+    std::atomic<bool> metadata_called{};
+    target.Start([&metadata_called](Metadata&&) { metadata_called = true; }, &queue);
+    std::uint32_t count{};
+    // Popped on a different thread from the one receiving records
+    while (count < kRecordCount) {
+      if (const auto* rec = queue.TryPop()) {
+        ASSERT_TRUE(rec->Holds<MboMsg>());
+        EXPECT_EQ(rec->Get<MboMsg>().sequence, count);
+        ++count;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+    EXPECT_TRUE(metadata_called);
+  }
+  // Closed when the client is destroyed
+  EXPECT_TRUE(queue.IsClosed());
+  const auto stats = queue.Stats();
+  EXPECT_EQ(stats.pushed, kRecordCount);
+  EXPECT_EQ(stats.dropped, 0);
+  EXPECT_LE(stats.high_water_mark, kCapacity);
+  is_done = true;
+  mock_server.reset();
+}
+
+TEST_F(LiveThreadedTests, TestStartSharded) {
+  constexpr std::uint32_t kInstrumentCount = 8;
+  constexpr std::uint32_t kRecordsPerInstrument = 50;
+  constexpr std::size_t kShardCount = 3;
+  std::atomic<bool> is_done{};
+  auto mock_server = std::make_unique<mock::MockLsgServer>(
+      dataset::kOpraPillar, kTsOut, [&is_done](mock::MockLsgServer& self) {
+        self.Accept();
+        self.Authenticate();
+        self.Start();
+        for (std::uint32_t seq = 0; seq < kRecordsPerInstrument; ++seq) {
+          for (std::uint32_t id = 0; id < kInstrumentCount; ++id) {
+            MboMsg mbo{};
+            mbo.hd = DummyHeader<MboMsg>(RType::Mbo);
+            mbo.hd.instrument_id = id;
+            mbo.sequence = seq;
+            self.SendRecord(mbo);
+          }
+          if (seq == kRecordsPerInstrument / 2) {
+            SystemMsg system{};
+            system.hd = DummyHeader<SystemMsg>(RType::System);
+            self.SendRecord(system);
+          }
+        }
+        // Keep the connection open until the client is destroyed
+        while (!is_done) {
+          std::this_thread::yield();
+        }
+      });
+
+  // Only accessed from the shard each instrument is routed to
+  std::array<std::uint32_t, kInstrumentCount> next_seqs{};
+  std::array<std::atomic<std::thread::id>, kInstrumentCount> thread_ids{};
+  std::atomic<std::uint32_t> mbo_count{};
+  std::atomic<std::uint32_t> system_count{};
+  {
+    LiveThreaded target = builder_.SetDataset(dataset::kOpraPillar)
+                              .SetSendTsOut(kTsOut)
+                              .SetAddress(kLocalhost, mock_server->Port())
+                              .BuildThreaded();
+    ShardConf shard_conf{};
+    shard_conf.shard_count = kShardCount;
+    shard_conf.queue_capacity = 16;
+    target.Start(
+        [&](const Record& rec) {
+          if (rec.Holds<SystemMsg>()) {
+            ++system_count;
+            return KeepGoing::Continue;
+          }
+          const auto& mbo = rec.Get<MboMsg>();
+          const auto id = mbo.hd.instrument_id;
+          std::thread::id expected{};
+          const auto this_id = std::this_thread::get_id();
+          if (!thread_ids[id].compare_exchange_strong(expected, this_id)) {
+            EXPECT_EQ(expected, this_id) << "Instrument " << id << " changed shards";
+          }
+          EXPECT_EQ(mbo.sequence, next_seqs[id]);
+          ++next_seqs[id];
+          ++mbo_count;
+          return KeepGoing::Continue;
+        },
+        shard_conf);
+    while (mbo_count < kInstrumentCount * kRecordsPerInstrument ||
+           system_count < kShardCount) {
+      std::this_thread::yield();
+    }
+  }
+  EXPECT_EQ(system_count, kShardCount);
+  for (const auto next_seq : next_seqs) {
+    EXPECT_EQ(next_seq, kRecordsPerInstrument);
+  }
+  is_done = true;
+  mock_server.reset();
+}
+
+TEST_F(LiveThreadedTests, TestStartShardedStop) {
+  const mock::MockLsgServer mock_server{dataset::kGlbxMdp3, kTsOut,
+                                        [](mock::MockLsgServer& self) {
+                                          self.Accept();
+                                          self.Authenticate();
+                                          self.Start();
+                                          MboMsg mbo{};
+                                          mbo.hd = DummyHeader<MboMsg>(RType::Mbo);
+                                          self.SendRecord(mbo);
+                                        }};
+
+  LiveThreaded target = builder_.SetDataset(dataset::kGlbxMdp3)
+                            .SetSendTsOut(kTsOut)
+                            .SetAddress(kLocalhost, mock_server.Port())
+                            .BuildThreaded();
+  ASSERT_THROW(target.Start([](const Record&) { return KeepGoing::Continue; },
+                            ShardConf{0, 16}),
+               InvalidArgumentError);
+  std::atomic<std::uint32_t> call_count{};
+  target.Start(
+      [&call_count](const Record&) {
+        ++call_count;
+        return KeepGoing::Stop;
+      },
+      ShardConf{2, 16});
+  // Stops even though the gateway doesn't send another record
+  ASSERT_EQ(target.BlockForStop(std::chrono::seconds{5}), KeepGoing::Stop);
+  EXPECT_EQ(call_count, 1);
+  // Starting again would add another set of shards
+  ASSERT_THROW(target.Start([](const Record&) { return KeepGoing::Continue; },
+                            ShardConf{2, 16}),
+               InvalidArgumentError);
+}
+
+TEST_F(LiveThreadedTests, TestStartShardedFromCallbackThread) {
+  const mock::MockLsgServer mock_server{dataset::kGlbxMdp3, kTsOut,
+                                        [](mock::MockLsgServer& self) {
+                                          self.Accept();
+                                          self.Authenticate();
+                                          self.Start();
+                                          MboMsg mbo{};
+                                          mbo.hd = DummyHeader<MboMsg>(RType::Mbo);
+                                          self.SendRecord(mbo);
+                                        }};
+  logger_ = mock::MockLogReceiver{
+      LogLevel::Warning, [](auto, databento::LogLevel, const std::string& msg) {
+        EXPECT_THAT(msg, testing::HasSubstr("which would cause a deadlock"));
+      }};
+
+  LiveThreaded target = builder_.SetDataset(dataset::kGlbxMdp3)
+                            .SetSendTsOut(kTsOut)
+                            .SetAddress(kLocalhost, mock_server.Port())
+                            .BuildThreaded();
+  target.Start([&target](const Record&) {
+    const auto shard_cb = [](const Record&) { return KeepGoing::Continue; };
+    // Ignored both times without leaving shards behind
+    EXPECT_NO_THROW(target.Start(shard_cb, ShardConf{2, 16}));
+    EXPECT_NO_THROW(target.Start(shard_cb, ShardConf{2, 16}));
+    return KeepGoing::Stop;
+  });
+  target.BlockForStop();
+  EXPECT_EQ(logger_.CallCount(), 2);
+}
+
+TEST_F(LiveThreadedTests, TestStartShardedException) {
+  const mock::MockLsgServer mock_server{dataset::kGlbxMdp3, kTsOut,
+                                        [](mock::MockLsgServer& self) {
+                                          self.Accept();
+                                          self.Authenticate();
+                                          self.Start();
+                                          MboMsg mbo{};
+                                          mbo.hd = DummyHeader<MboMsg>(RType::Mbo);
+                                          self.SendRecord(mbo);
+                                          self.SendRecord(mbo);
+                                        }};
+  logger_ = mock::MockLogReceiver{LogLevel::Warning,
+                                  [](auto, databento::LogLevel, const std::string&) {}};
+
+  LiveThreaded target = builder_.SetDataset(dataset::kGlbxMdp3)
+                            .SetSendTsOut(kTsOut)
+                            .SetAddress(kLocalhost, mock_server.Port())
+                            .BuildThreaded();
+  std::atomic<std::uint32_t> call_count{};
+  std::atomic<std::uint32_t> exception_count{};
+  // Both records are routed to the same shard
+  target.Start(
+      {},
+      [&call_count](const Record&) -> KeepGoing {
+        ++call_count;
+        throw Exception{"shard failure"};
+      },
+      [&exception_count](const std::exception& exc) {
+        EXPECT_STREQ(exc.what(), "shard failure");
+        // Skip the first record and stop on the second
+        return ++exception_count == 1 ? LiveThreaded::ExceptionAction::Restart
+                                      : LiveThreaded::ExceptionAction::Stop;
+      },
+      ShardConf{2, 16});
+  ASSERT_EQ(target.BlockForStop(std::chrono::seconds{5}), KeepGoing::Stop);
+  EXPECT_EQ(call_count, 2);
+  EXPECT_EQ(exception_count, 2);
+  EXPECT_EQ(logger_.CallCount(), 2);
+}
+
 TEST_F(LiveThreadedTests, TestWithZstdCompression) {
   const MboMsg kRec{DummyHeader<MboMsg>(RType::Mbo),
                     1,
@@ -115,6 +399,49 @@ TEST_F(LiveThreadedTests, TestWithZstdCompression) {
   target.BlockForStop();
 }
 
+TEST_F(LiveThreadedTests, TestStatsWithZstdCompression) {
+  const MboMsg kRec{DummyHeader<MboMsg>(RType::Mbo),
+                    1,
+                    2,
+                    3,
+                    {},
+                    4,
+                    Action::Add,
+                    Side::Bid,
+                    UnixNanos{},
+                    TimeDeltaNanos{},
+                    100};
+  const mock::MockLsgServer mock_server{dataset::kGlbxMdp3, kTsOut, Compression::Zstd,
+                                        [&kRec](mock::MockLsgServer& self) {
+                                          self.Accept();
+                                          self.Authenticate();
+                                          self.StartCompressed();
+                                          self.SendCompressedRecord(kRec);
+                                          self.SendCompressedRecord(kRec);
+                                          self.FlushCompression();
+                                        }};
+
+  LiveThreaded target = builder_.SetDataset(dataset::kGlbxMdp3)
+                            .SetSendTsOut(kTsOut)
+                            .SetCompression(Compression::Zstd)
+                            .SetAddress(kLocalhost, mock_server.Port())
+                            .SetCollectStats(true)
+                            .BuildThreaded();
+  std::uint32_t call_count{};
+  target.Start([&call_count](const Record&) {
+    ++call_count;
+    return call_count < 2 ? KeepGoing::Continue : KeepGoing::Stop;
+  });
+  target.BlockForStop();
+  const auto stats = target.Stats();
+  EXPECT_EQ(stats.records, 2);
+  EXPECT_EQ(stats.records_by_rtype[static_cast<std::uint8_t>(RType::Mbo)], 2);
+  EXPECT_EQ(stats.callback_times.Count(), 2);
+  EXPECT_GT(stats.decompress_time.count(), 0);
+  // Requires `send_ts_out`
+  EXPECT_EQ(stats.gateway_latencies.Count(), 0);
+}
+
 TEST_F(LiveThreadedTests, TestTimeoutRecovery) {
   const MboMsg kRec{DummyHeader<MboMsg>(RType::Mbo),
                     1,
@@ -10,6 +10,7 @@
 #endif
 #include <openssl/sha.h>  // SHA256_DIGEST_LENGTH
 
+#include <algorithm>  // min
 #include <chrono>
 #include <cstddef>
 
@@ -17,6 +18,7 @@
 #include "databento/constants.hpp"
 #include "databento/datetime.hpp"
 #include "databento/dbn_encoder.hpp"
+#include "databento/detail/buffer.hpp"
 #include "databento/enums.hpp"
 #include "databento/exceptions.hpp"
 #include "databento/symbology.hpp"   // JoinSymbolStrings
@@ -200,6 +202,18 @@ void MockLsgServer::Start() {
   DbnEncoder::EncodeMetadata(DummyMetadata(), &writable);
 }
 
+void MockLsgServer::SendRecords(synth::Generator& generator,
+                                std::size_t record_count) {
+  constexpr std::size_t kBatchSize = 1024;
+  detail::Buffer buffer;
+  for (std::size_t sent = 0; sent < record_count; sent += kBatchSize) {
+    generator.WriteRecords((std::min)(kBatchSize, record_count - sent), &buffer);
+    Send(std::string{reinterpret_cast<const char*>(buffer.ReadBegin()),
+                     buffer.ReadCapacity()});
+    buffer.Clear();
+  }
+}
+
 void MockLsgServer::Close() {
   if (compressor_) {
     compressor_.reset();
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>  // min
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>  // runtime_error
+#include <thread>     // sleep_for
+#include <utility>    // move
+#include <vector>
+
+#include "databento/detail/buffer.hpp"
+#include "databento/detail/read_ahead_stream.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/ireadable.hpp"
+
+namespace databento::detail::tests {
+namespace {
+std::unique_ptr<Buffer> MakeInput(const std::vector<std::int32_t>& source_data) {
+  auto res = std::make_unique<Buffer>();
+  res->WriteAll(reinterpret_cast<const std::byte*>(source_data.data()),
+                source_data.size() * sizeof(std::int32_t));
+  return res;
+}
+
+// Mock IReadable that reads from a buffer, waiting `delay` before each read, and
+// throws once the buffer is exhausted
+class ThrowingReader : public IReadable {
+ public:
+  ThrowingReader(std::unique_ptr<Buffer> buffer, std::chrono::milliseconds delay)
+      : buffer_{std::move(buffer)}, delay_{delay} {}
+
+  void ReadExact(std::byte*, std::size_t) override {
+    throw std::runtime_error{"ThrowingReader does not support ReadExact"};
+  }
+  std::size_t ReadSome(std::byte* buffer, std::size_t max_length) override {
+    std::this_thread::sleep_for(delay_);
+    if (buffer_->ReadCapacity() == 0) {
+      throw std::runtime_error{"Test failure"};
+    }
+    // Small reads so the read-ahead thread makes several
+    return buffer_->ReadSome(buffer, std::min<std::size_t>(max_length, 64));
+  }
+  Result ReadSome(std::byte* buffer, std::size_t max_length,
+                  std::chrono::milliseconds) override {
+    return {ReadSome(buffer, max_length), Status::Ok};
+  }
+
+ private:
+  std::unique_ptr<Buffer> buffer_;
+  std::chrono::milliseconds delay_;
+};
+}  // namespace
+
+TEST(ReadAheadStreamTests, TestIdentity) {
+  std::vector<std::int32_t> source_data;
+  for (std::int32_t i = 0; i < 100'000; ++i) {
+    source_data.emplace_back(i);
+  }
+  ReadAheadStream target{MakeInput(source_data), 3, 1000};
+  std::vector<std::int32_t> res(source_data.size());
+  auto* res_bytes = reinterpret_cast<std::byte*>(res.data());
+  const auto size = res.size() * sizeof(std::int32_t);
+  std::size_t pos{};
+  while (pos < size) {
+    // Odd read size so reads straddle buffers
+    const auto read_size =
+        target.ReadSome(&res_bytes[pos], std::min<std::size_t>(777, size - pos));
+    ASSERT_GT(read_size, 0);
+    pos += read_size;
+  }
+  EXPECT_EQ(res, source_data);
+  EXPECT_EQ(target.ReadSome(res_bytes, size), 0);
+  const auto res_with_timeout =
+      target.ReadSome(res_bytes, size, std::chrono::milliseconds{10});
+  EXPECT_EQ(res_with_timeout.read_size, 0);
+  EXPECT_EQ(res_with_timeout.status, IReadable::Status::Closed);
+}
+
+TEST(ReadAheadStreamTests, TestProducerStallsWithSlowConsumer) {
+  const std::vector<std::int32_t> source_data(10'000, 1);
+  ReadAheadStream target{MakeInput(source_data), 2, 1024};
+  std::vector<std::byte> res(source_data.size() * sizeof(std::int32_t));
+  // Give the producer time to fill the ring
+  std::this_thread::sleep_for(std::chrono::milliseconds{50});
+  target.ReadExact(res.data(), res.size());
+  EXPECT_GT(target.ProducerStalls(), 0);
+}
+
+TEST(ReadAheadStreamTests, TestTimeoutWithSlowProducer) {
+  const std::vector<std::int32_t> source_data(16, 1);
+  ReadAheadStream target{
+      std::make_unique<ThrowingReader>(MakeInput(source_data),
+                                       std::chrono::milliseconds{200}),
+      2, 1024};
+  std::vector<std::byte> res(source_data.size() * sizeof(std::int32_t));
+  const auto res_with_timeout =
+      target.ReadSome(res.data(), res.size(), std::chrono::milliseconds{10});
+  EXPECT_EQ(res_with_timeout.read_size, 0);
+  EXPECT_EQ(res_with_timeout.status, IReadable::Status::Timeout);
+  EXPECT_EQ(target.ConsumerStalls(), 1);
+}
+
+TEST(ReadAheadStreamTests, TestRethrowsAfterDataConsumed) {
+  const std::vector<std::int32_t> source_data(1'000, 7);
+  ReadAheadStream target{std::make_unique<ThrowingReader>(
+                             MakeInput(source_data), std::chrono::milliseconds{}),
+                         4, 1024};
+  std::vector<std::byte> res(source_data.size() * sizeof(std::int32_t));
+  // All data read before the exception is still returned
+  target.ReadExact(res.data(), res.size());
+  const auto* source_bytes = reinterpret_cast<const std::byte*>(source_data.data());
+  EXPECT_EQ(res, std::vector<std::byte>(source_bytes, source_bytes + res.size()));
+  EXPECT_THROW(target.ReadSome(res.data(), res.size()), std::runtime_error);
+}
+
+TEST(ReadAheadStreamTests, TestInvalidDepth) {
+  EXPECT_THROW((ReadAheadStream{std::make_unique<Buffer>(), 0, 1024}),
+               InvalidArgumentError);
+}
+}  // namespace databento::detail::tests
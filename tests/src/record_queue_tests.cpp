@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>  // this_thread
+#include <vector>
+
+#include "databento/detail/scoped_thread.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/record.hpp"
+#include "databento/record_queue.hpp"
+#include "databento/timeseries.hpp"
+
+namespace databento::tests {
+namespace {
+MboMsg GenerateMbo(std::uint32_t sequence) {
+  MboMsg mbo{};
+  mbo.hd = {sizeof(MboMsg) / RecordHeader::kLengthMultiplier, RType::Mbo, 1, 1, {}};
+  mbo.sequence = sequence;
+  return mbo;
+}
+
+bool Push(RecordQueue& queue, std::uint32_t sequence) {
+  auto mbo = GenerateMbo(sequence);
+  return queue.Push(Record{&mbo.hd});
+}
+
+std::vector<std::uint32_t> PopAll(RecordQueue& queue) {
+  std::vector<std::uint32_t> res;
+  while (const auto* rec = queue.TryPop()) {
+    res.push_back(rec->Get<MboMsg>().sequence);
+  }
+  return res;
+}
+}  // namespace
+
+TEST(RecordQueueTests, TestZeroCapacity) {
+  ASSERT_THROW((RecordQueue{0, RecordQueue::OverflowPolicy::Block}),
+               InvalidArgumentError);
+}
+
+TEST(RecordQueueTests, TestCapacityRoundsUp) {
+  const RecordQueue target{5, RecordQueue::OverflowPolicy::Block};
+  EXPECT_EQ(target.Capacity(), 8);
+  EXPECT_TRUE(target.Empty());
+}
+
+TEST(RecordQueueTests, TestPushPop) {
+  RecordQueue target{4, RecordQueue::OverflowPolicy::Block};
+  EXPECT_EQ(target.TryPop(), nullptr);
+  for (std::uint32_t i = 0; i < 10; ++i) {
+    ASSERT_TRUE(Push(target, i));
+    ASSERT_TRUE(Push(target, i + 100));
+    EXPECT_EQ(target.Size(), 2);
+    const auto* rec = target.TryPop();
+    ASSERT_NE(rec, nullptr);
+    EXPECT_EQ(rec->Get<MboMsg>(), GenerateMbo(i));
+    rec = target.TryPop();
+    ASSERT_NE(rec, nullptr);
+    EXPECT_EQ(rec->Get<MboMsg>(), GenerateMbo(i + 100));
+  }
+  EXPECT_EQ(target.TryPop(), nullptr);
+  const auto stats = target.Stats();
+  EXPECT_EQ(stats.pushed, 20);
+  EXPECT_EQ(stats.dropped, 0);
+  EXPECT_EQ(stats.producer_stalls, 0);
+  EXPECT_EQ(stats.high_water_mark, 2);
+}
+
+TEST(RecordQueueTests, TestDropNewest) {
+  RecordQueue target{4, RecordQueue::OverflowPolicy::DropNewest};
+  for (std::uint32_t i = 0; i < 6; ++i) {
+    EXPECT_EQ(Push(target, i), i < 4);
+  }
+  EXPECT_EQ(PopAll(target), (std::vector<std::uint32_t>{0, 1, 2, 3}));
+  const auto stats = target.Stats();
+  EXPECT_EQ(stats.pushed, 4);
+  EXPECT_EQ(stats.dropped, 2);
+  EXPECT_EQ(stats.high_water_mark, 4);
+}
+
+TEST(RecordQueueTests, TestDropOldest) {
+  RecordQueue target{4, RecordQueue::OverflowPolicy::DropOldest};
+  for (std::uint32_t i = 0; i < 6; ++i) {
+    EXPECT_TRUE(Push(target, i));
+  }
+  EXPECT_EQ(PopAll(target), (std::vector<std::uint32_t>{2, 3, 4, 5}));
+  const auto stats = target.Stats();
+  EXPECT_EQ(stats.pushed, 6);
+  EXPECT_EQ(stats.dropped, 2);
+  EXPECT_EQ(stats.high_water_mark, 4);
+}
+
+TEST(RecordQueueTests, TestPopBatch) {
+  RecordQueue target{8, RecordQueue::OverflowPolicy::Block};
+  for (std::uint32_t i = 0; i < 8; ++i) {
+    ASSERT_TRUE(Push(target, i));
+  }
+  std::vector<std::uint32_t> sequences;
+  const RecordCallback callback = [&sequences](const Record& rec) {
+    sequences.push_back(rec.Get<MboMsg>().sequence);
+    return rec.Get<MboMsg>().sequence == 4 ? KeepGoing::Stop : KeepGoing::Continue;
+  };
+  EXPECT_EQ(target.PopBatch(callback, 3), 3);
+  // Stops after the record the callback returned `Stop` for
+  EXPECT_EQ(target.PopBatch(callback, 100), 2);
+  EXPECT_EQ(target.PopBatch(callback, 100), 3);
+  EXPECT_EQ(target.PopBatch(callback, 100), 0);
+  EXPECT_EQ(sequences, (std::vector<std::uint32_t>{0, 1, 2, 3, 4, 5, 6, 7}));
+}
+
+TEST(RecordQueueTests, TestPopBatchException) {
+  RecordQueue target{2, RecordQueue::OverflowPolicy::DropNewest};
+  ASSERT_TRUE(Push(target, 0));
+  ASSERT_TRUE(Push(target, 1));
+  const RecordCallback callback = [](const Record& rec) -> KeepGoing {
+    if (rec.Get<MboMsg>().sequence == 0) {
+      throw Exception{"callback failure"};
+    }
+    return KeepGoing::Continue;
+  };
+  ASSERT_THROW(target.PopBatch(callback, 2), Exception);
+  // The slot was released, so the queue isn't stuck at capacity
+  ASSERT_TRUE(Push(target, 2));
+  EXPECT_EQ(PopAll(target), (std::vector<std::uint32_t>{1, 2}));
+}
+
+TEST(RecordQueueTests, TestCloseUnblocksProducer) {
+  RecordQueue target{1, RecordQueue::OverflowPolicy::Block};
+  ASSERT_EQ(target.Capacity(), 2);
+  ASSERT_TRUE(Push(target, 0));
+  ASSERT_TRUE(Push(target, 1));
+  std::atomic<bool> is_pushed{true};
+  {
+    const detail::ScopedThread producer{
+        [&target, &is_pushed] { is_pushed = Push(target, 2); }};
+    while (target.Stats().producer_stalls == 0) {
+      std::this_thread::yield();
+    }
+    target.Close();
+  }
+  EXPECT_FALSE(is_pushed);
+  EXPECT_TRUE(target.IsClosed());
+  // Records pushed before closing can still be popped
+  EXPECT_EQ(PopAll(target), (std::vector<std::uint32_t>{0, 1}));
+}
+
+TEST(RecordQueueTests, TestWaitForRecord) {
+  RecordQueue target{4, RecordQueue::OverflowPolicy::Block};
+  ASSERT_TRUE(Push(target, 0));
+  // Returns immediately with a queued record
+  EXPECT_TRUE(target.WaitForRecord());
+  EXPECT_EQ(PopAll(target), (std::vector<std::uint32_t>{0}));
+  {
+    const detail::ScopedThread producer{[&target] { Push(target, 1); }};
+    EXPECT_TRUE(target.WaitForRecord());
+  }
+  EXPECT_EQ(PopAll(target), (std::vector<std::uint32_t>{1}));
+  {
+    const detail::ScopedThread producer{[&target] { target.Close(); }};
+    EXPECT_FALSE(target.WaitForRecord());
+  }
+}
+
+class RecordQueueConcurrencyTests
+    : public testing::TestWithParam<RecordQueue::OverflowPolicy> {};
+
+INSTANTIATE_TEST_SUITE_P(TestPolicies, RecordQueueConcurrencyTests,
+                         testing::Values(RecordQueue::OverflowPolicy::Block,
+                                         RecordQueue::OverflowPolicy::DropOldest,
+                                         RecordQueue::OverflowPolicy::DropNewest));
+
+TEST_P(RecordQueueConcurrencyTests, TestProducerConsumer) {
+  constexpr std::uint32_t kRecordCount = 200'000;
+  RecordQueue target{64, GetParam()};
+  std::uint64_t popped{};
+  {
+    const detail::ScopedThread producer{[&target] {
+      for (std::uint32_t i = 0; i < kRecordCount; ++i) {
+        Push(target, i);
+      }
+      target.Close();
+    }};
+    std::int64_t last_sequence = -1;
+    // Alternate between both ways of popping
+    const RecordCallback callback = [&last_sequence, &popped](const Record& rec) {
+      const auto sequence = static_cast<std::int64_t>(rec.Get<MboMsg>().sequence);
+      EXPECT_GT(sequence, last_sequence);
+      last_sequence = sequence;
+      ++popped;
+      return KeepGoing::Continue;
+    };
+    while (!target.IsClosed() || !target.Empty()) {
+      if (const auto* rec = target.TryPop()) {
+        callback(*rec);
+      }
+      target.PopBatch(callback, 16);
+    }
+  }
+  const auto stats = target.Stats();
+  EXPECT_LE(stats.high_water_mark, target.Capacity());
+  if (GetParam() == RecordQueue::OverflowPolicy::Block) {
+    EXPECT_EQ(popped, kRecordCount);
+    EXPECT_EQ(stats.dropped, 0);
+  } else {
+    EXPECT_EQ(popped + stats.dropped, kRecordCount);
+  }
+  if (GetParam() == RecordQueue::OverflowPolicy::DropNewest) {
+    EXPECT_EQ(stats.pushed, popped);
+  } else {
+    EXPECT_EQ(stats.pushed, kRecordCount);
+  }
+}
+}  // namespace databento::tests
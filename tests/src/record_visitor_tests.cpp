@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <type_traits>
+
+#include "databento/datetime.hpp"
+#include "databento/enums.hpp"
+#include "databento/record.hpp"
+#include "databento/record_visitor.hpp"
+#include "databento/timeseries.hpp"
+#include "databento/v1.hpp"
+#include "databento/v2.hpp"
+#include "databento/with_ts_out.hpp"
+
+namespace databento::tests {
+namespace {
+template <typename T>
+RecordHeader DummyHeader(RType rtype) {
+  return {sizeof(T) / RecordHeader::kLengthMultiplier, rtype, 1, 1, UnixNanos{}};
+}
+
+template <typename T>
+Record AsRecord(T& rec) {
+  return Record{reinterpret_cast<RecordHeader*>(&rec)};
+}
+
+struct CountingVisitor {
+  void operator()(const MboMsg&) { ++mbo_count; }
+  KeepGoing operator()(const TradeMsg& trade) {
+    ++trade_count;
+    return trade.size > 100 ? KeepGoing::Stop : KeepGoing::Continue;
+  }
+  void operator()(const v1::InstrumentDefMsg&) { ++def_v1_count; }
+  void operator()(const v2::InstrumentDefMsg&) { ++def_v2_count; }
+  void operator()(const InstrumentDefMsg&) { ++def_v3_count; }
+  void operator()(const v1::StatMsg&) { ++stat_v1_count; }
+  void operator()(const StatMsg&) { ++stat_v3_count; }
+
+  std::uint32_t mbo_count{};
+  std::uint32_t trade_count{};
+  std::uint32_t def_v1_count{};
+  std::uint32_t def_v2_count{};
+  std::uint32_t def_v3_count{};
+  std::uint32_t stat_v1_count{};
+  std::uint32_t stat_v3_count{};
+};
+
+// Also convertible to a `RecordCallback` because of the generic fallback
+struct FallbackVisitor {
+  void operator()(const MboMsg&) { ++mbo_count; }
+  template <typename T>
+  KeepGoing operator()(const T&) {
+    ++other_count;
+    return KeepGoing::Continue;
+  }
+
+  std::uint32_t mbo_count{};
+  std::uint32_t other_count{};
+};
+
+const auto kGenericLambda = [](const auto&) { return KeepGoing::Continue; };
+const auto kRecordLambda = [](const Record&) { return KeepGoing::Continue; };
+}  // namespace
+
+static_assert(is_record_visitor_v<CountingVisitor>);
+static_assert(is_record_visitor_v<CountingVisitor&>);
+static_assert(is_record_visitor_v<FallbackVisitor>);
+static_assert(is_record_visitor_v<decltype(kGenericLambda)>);
+static_assert(!is_record_visitor_v<RecordCallback>);
+static_assert(!is_record_visitor_v<KeepGoing (*)(const Record&)>);
+static_assert(!is_record_visitor_v<decltype(kRecordLambda)>);
+
+TEST(RecordVisitorTests, TestDispatchesToMatchingOverload) {
+  MboMsg mbo{};
+  mbo.hd = DummyHeader<MboMsg>(RType::Mbo);
+  TradeMsg trade{};
+  trade.hd = DummyHeader<TradeMsg>(RType::Mbp0);
+  trade.size = 10;
+  OhlcvMsg ohlcv{};
+  ohlcv.hd = DummyHeader<OhlcvMsg>(RType::Ohlcv1S);
+
+  CountingVisitor visitor;
+  EXPECT_EQ(VisitRecord(AsRecord(mbo), visitor), KeepGoing::Continue);
+  EXPECT_EQ(VisitRecord(AsRecord(trade), visitor), KeepGoing::Continue);
+  // No overload for `OhlcvMsg`
+  EXPECT_EQ(VisitRecord(AsRecord(ohlcv), visitor), KeepGoing::Continue);
+  EXPECT_EQ(visitor.mbo_count, 1);
+  EXPECT_EQ(visitor.trade_count, 1);
+}
+
+TEST(RecordVisitorTests, TestStop) {
+  TradeMsg trade{};
+  trade.hd = DummyHeader<TradeMsg>(RType::Mbp0);
+  trade.size = 1000;
+
+  CountingVisitor visitor;
+  EXPECT_EQ(VisitRecord(AsRecord(trade), visitor), KeepGoing::Stop);
+  EXPECT_EQ(visitor.trade_count, 1);
+}
+
+TEST(RecordVisitorTests, TestGenericLambda) {
+  MboMsg mbo{};
+  mbo.hd = DummyHeader<MboMsg>(RType::Mbo);
+  mbo.order_id = 5;
+
+  std::uint64_t order_id{};
+  VisitRecord(AsRecord(mbo), [&order_id](const auto& rec) {
+    if constexpr (std::is_same_v<std::decay_t<decltype(rec)>, MboMsg>) {
+      order_id = rec.order_id;
+    }
+  });
+  EXPECT_EQ(order_id, 5);
+}
+
+TEST(RecordVisitorTests, TestGenericFallback) {
+  MboMsg mbo{};
+  mbo.hd = DummyHeader<MboMsg>(RType::Mbo);
+  TradeMsg trade{};
+  trade.hd = DummyHeader<TradeMsg>(RType::Mbp0);
+
+  FallbackVisitor visitor;
+  VisitRecord(AsRecord(mbo), visitor);
+  VisitRecord(AsRecord(trade), visitor);
+  EXPECT_EQ(visitor.mbo_count, 1);
+  EXPECT_EQ(visitor.other_count, 1);
+}
+
+TEST(RecordVisitorTests, TestVersionedRecords) {
+  v1::InstrumentDefMsg def_v1{};
+  def_v1.hd = DummyHeader<v1::InstrumentDefMsg>(RType::InstrumentDef);
+  v2::InstrumentDefMsg def_v2{};
+  def_v2.hd = DummyHeader<v2::InstrumentDefMsg>(RType::InstrumentDef);
+  InstrumentDefMsg def_v3{};
+  def_v3.hd = DummyHeader<InstrumentDefMsg>(RType::InstrumentDef);
+  v1::StatMsg stat_v1{};
+  stat_v1.hd = DummyHeader<v1::StatMsg>(RType::Statistics);
+  StatMsg stat_v3{};
+  stat_v3.hd = DummyHeader<StatMsg>(RType::Statistics);
+
+  CountingVisitor visitor;
+  VisitRecord(AsRecord(def_v1), visitor);
+  VisitRecord(AsRecord(def_v2), visitor);
+  VisitRecord(AsRecord(def_v3), visitor);
+  VisitRecord(AsRecord(stat_v1), visitor);
+  VisitRecord(AsRecord(stat_v3), visitor);
+  EXPECT_EQ(visitor.def_v1_count, 1);
+  EXPECT_EQ(visitor.def_v2_count, 1);
+  EXPECT_EQ(visitor.def_v3_count, 1);
+  EXPECT_EQ(visitor.stat_v1_count, 1);
+  EXPECT_EQ(visitor.stat_v3_count, 1);
+}
+
+TEST(RecordVisitorTests, TestVersionedRecordsWithTsOut) {
+  v1::InstrumentDefMsg def_v1_rec{};
+  def_v1_rec.hd = DummyHeader<v1::InstrumentDefMsg>(RType::InstrumentDef);
+  v2::InstrumentDefMsg def_v2_rec{};
+  def_v2_rec.hd = DummyHeader<v2::InstrumentDefMsg>(RType::InstrumentDef);
+  v1::StatMsg stat_v1_rec{};
+  stat_v1_rec.hd = DummyHeader<v1::StatMsg>(RType::Statistics);
+  WithTsOut<v1::InstrumentDefMsg> def_v1{def_v1_rec, UnixNanos{}};
+  WithTsOut<v2::InstrumentDefMsg> def_v2{def_v2_rec, UnixNanos{}};
+  WithTsOut<v1::StatMsg> stat_v1{stat_v1_rec, UnixNanos{}};
+
+  CountingVisitor visitor;
+  VisitRecord(AsRecord(def_v1), visitor);
+  VisitRecord(AsRecord(def_v2), visitor);
+  VisitRecord(AsRecord(stat_v1), visitor);
+  EXPECT_EQ(visitor.def_v1_count, 1);
+  EXPECT_EQ(visitor.def_v2_count, 1);
+  EXPECT_EQ(visitor.def_v3_count, 0);
+  EXPECT_EQ(visitor.stat_v1_count, 1);
+  EXPECT_EQ(visitor.stat_v3_count, 0);
+}
+}  // namespace databento::tests
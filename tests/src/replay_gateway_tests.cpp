@@ -0,0 +1,255 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "databento/constants.hpp"
+#include "databento/detail/scoped_thread.hpp"
+#include "databento/detail/zstd_stream.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/file_stream.hpp"
+#include "databento/live.hpp"
+#include "databento/live_blocking.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"
+#include "databento/symbology.hpp"
+#include "databento/synth.hpp"
+#include "databento/with_ts_out.hpp"
+#include "mock/mock_log_receiver.hpp"
+#include "replay_gateway.hpp"
+#include "temp_file.hpp"
+
+namespace databento::tests {
+using tools::ReplayGateway;
+using tools::ReplayGatewayConf;
+
+class ReplayGatewayTests : public testing::Test {
+ protected:
+  static constexpr auto kKey = "32-character-with-lots-of-filler";
+
+  // Writes `record_count` synthetic records to `temp_file_`
+  void WriteFile(Schema schema, const synth::GeneratorConf& conf,
+                 std::size_t record_count, Compression compression) {
+    OutFileStream out_file{temp_file_.Path()};
+    synth::Generator generator{schema, conf};
+    if (compression == Compression::Zstd) {
+      detail::ZstdCompressStream zstd_stream{&out_file};
+      generator.WriteDbn(record_count, &zstd_stream);
+    } else {
+      generator.WriteDbn(record_count, &out_file);
+    }
+  }
+
+  void StartGateway(ReplayGatewayConf conf) {
+    conf.file_path = temp_file_.Path().string();
+    gateway_ = std::make_unique<ReplayGateway>(&logger_, std::move(conf));
+    thread_ = detail::ScopedThread{[this] { gateway_->Run(); }};
+  }
+
+  LiveBuilder Builder() {
+    return LiveBuilder{}
+        .SetLogReceiver(&logger_)
+        .SetKey(kKey)
+        .SetDataset(dataset::kGlbxMdp3)
+        .SetAddress("127.0.0.1", gateway_->Port());
+  }
+
+  void TearDown() override {
+    if (gateway_) {
+      gateway_->Stop();
+      thread_ = {};
+    }
+  }
+
+  // Reads system messages until one with `code`
+  static void AwaitSystem(LiveBlocking& client, SystemCode code) {
+    while (true) {
+      const auto& rec = client.NextRecord();
+      if (const auto* system = rec.GetIf<SystemMsg>()) {
+        if (system->code == code) {
+          return;
+        }
+      } else {
+        ASSERT_TRUE(rec.Holds<SymbolMappingMsg>()) << rec.RType();
+      }
+    }
+  }
+
+  // Rejected clients are logged as warnings
+  mock::MockLogReceiver logger_ = mock::MockLogReceiver::AssertNoLogs(LogLevel::Error);
+  TempFile temp_file_{std::filesystem::temp_directory_path() /
+                      ("test_replay_gateway_" +
+                       std::string{testing::UnitTest::GetInstance()
+                                       ->current_test_info()
+                                       ->name()} +
+                       ".dbn")};
+  std::unique_ptr<ReplayGateway> gateway_;
+  detail::ScopedThread thread_;
+};
+
+TEST_F(ReplayGatewayTests, TestInvalidConf) {
+  ReplayGatewayConf conf{};
+  conf.file_path = temp_file_.Path().string();
+  // Doesn't exist yet
+  ASSERT_THROW((ReplayGateway{&logger_, conf}), InvalidArgumentError);
+  WriteFile(Schema::Mbo, {}, 10, Compression::None);
+  conf.speed = -1;
+  ASSERT_THROW((ReplayGateway{&logger_, conf}), InvalidArgumentError);
+  conf.speed = 1;
+  conf.key = "short";
+  ASSERT_THROW((ReplayGateway{&logger_, conf}), InvalidArgumentError);
+}
+
+TEST_F(ReplayGatewayTests, TestReplayAllSymbols) {
+  constexpr std::size_t kRecordCount = 20'000;
+  synth::GeneratorConf synth_conf{};
+  synth_conf.instrument_count = 4;
+  WriteFile(Schema::Mbo, synth_conf, kRecordCount, Compression::Zstd);
+  ReplayGatewayConf conf{};
+  conf.speed = 0;
+  conf.key = kKey;
+  StartGateway(conf);
+
+  auto client = Builder().BuildBlocking();
+  client.Subscribe(kAllSymbols, Schema::Mbo, SType::RawSymbol);
+  const auto metadata = client.Start();
+  EXPECT_EQ(metadata.dataset, dataset::kGlbxMdp3);
+  EXPECT_EQ(metadata.schema, Schema::Mbo);
+  EXPECT_FALSE(metadata.ts_out);
+
+  std::vector<std::string> mapped_symbols;
+  while (true) {
+    const auto& rec = client.NextRecord();
+    if (const auto* mapping = rec.GetIf<SymbolMappingMsg>()) {
+      mapped_symbols.emplace_back(mapping->STypeOutSymbol());
+      continue;
+    }
+    ASSERT_EQ(rec.Get<SystemMsg>().code, SystemCode::SubscriptionAck);
+    break;
+  }
+  EXPECT_EQ(mapped_symbols.size(), synth_conf.instrument_count);
+  synth::Generator expected{Schema::Mbo, synth_conf};
+  for (std::size_t i = 0; i < kRecordCount; ++i) {
+    const auto& rec = client.NextRecord();
+    ASSERT_EQ(rec.Get<MboMsg>(), expected.NextRecord().Get<MboMsg>()) << i;
+  }
+  EXPECT_EQ(client.NextRecord().Get<SystemMsg>().code, SystemCode::ReplayCompleted);
+}
+
+TEST_F(ReplayGatewayTests, TestFilterSymbolsWithTsOutAndZstd) {
+  constexpr std::size_t kRecordCount = 5'000;
+  const synth::GeneratorConf synth_conf{};
+  WriteFile(Schema::Trades, synth_conf, kRecordCount, Compression::None);
+  ReplayGatewayConf conf{};
+  conf.speed = 0;
+  StartGateway(conf);
+
+  auto client = Builder()
+                    .SetSendTsOut(true)
+                    .SetCompression(Compression::Zstd)
+                    .BuildBlocking();
+  synth::Generator expected{Schema::Trades, synth_conf};
+  client.Subscribe({expected.Symbol(1), expected.Symbol(3)}, Schema::Trades,
+                   SType::RawSymbol);
+  client.Subscribe({"2"}, Schema::Trades, SType::InstrumentId);
+  const UnixNanos start{std::chrono::system_clock::now().time_since_epoch()};
+  EXPECT_TRUE(client.Start().ts_out);
+  AwaitSystem(client, SystemCode::SubscriptionAck);
+  AwaitSystem(client, SystemCode::SubscriptionAck);
+
+  for (std::size_t i = 0; i < kRecordCount; ++i) {
+    const auto& expected_trade = expected.NextRecord().Get<TradeMsg>();
+    if (expected_trade.hd.instrument_id > 3) {
+      continue;
+    }
+    const auto& rec = client.NextRecord();
+    ASSERT_EQ(rec.Size(), sizeof(WithTsOut<TradeMsg>));
+    const auto& trade = rec.Get<WithTsOut<TradeMsg>>();
+    ASSERT_GE(trade.ts_out, start);
+    auto trade_rec = trade.rec;
+    // Includes `ts_out`
+    ASSERT_EQ(trade_rec.hd.length, expected_trade.hd.length + 2);
+    trade_rec.hd.length = expected_trade.hd.length;
+    ASSERT_EQ(trade_rec, expected_trade) << i;
+  }
+  EXPECT_EQ(client.NextRecord().Get<SystemMsg>().code, SystemCode::ReplayCompleted);
+}
+
+TEST_F(ReplayGatewayTests, TestPacing) {
+  constexpr std::size_t kRecordCount = 200;
+  synth::GeneratorConf synth_conf{};
+  // 200 ms of data
+  synth_conf.message_rate = 1'000;
+  WriteFile(Schema::Mbp10, synth_conf, kRecordCount, Compression::None);
+  ReplayGatewayConf conf{};
+  conf.speed = 2;
+  StartGateway(conf);
+
+  auto client = Builder().BuildBlocking();
+  client.Subscribe(kAllSymbols, Schema::Mbp10, SType::RawSymbol);
+  client.Start();
+  AwaitSystem(client, SystemCode::SubscriptionAck);
+  ASSERT_TRUE(client.NextRecord().Holds<Mbp10Msg>());
+  const auto first_time = std::chrono::steady_clock::now();
+  for (std::size_t i = 1; i < kRecordCount; ++i) {
+    ASSERT_TRUE(client.NextRecord().Holds<Mbp10Msg>());
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - first_time;
+  // Twice the original pace
+  EXPECT_GE(elapsed, std::chrono::milliseconds{90});
+  EXPECT_LT(elapsed, std::chrono::seconds{1});
+}
+
+TEST_F(ReplayGatewayTests, TestConcurrentClients) {
+  constexpr std::size_t kClientCount = 4;
+  constexpr std::size_t kRecordCount = 50'000;
+  const synth::GeneratorConf synth_conf{};
+  WriteFile(Schema::Mbo, synth_conf, kRecordCount, Compression::None);
+  ReplayGatewayConf conf{};
+  conf.speed = 0;
+  // Small so clients are interleaved
+  conf.send_buffer_size = 1 << 12;
+  StartGateway(conf);
+
+  std::vector<LiveBlocking> clients;
+  for (std::size_t i = 0; i < kClientCount; ++i) {
+    clients.emplace_back(Builder().BuildBlocking());
+    clients.back().Subscribe(kAllSymbols, Schema::Mbo, SType::RawSymbol);
+    clients.back().Start();
+    AwaitSystem(clients.back(), SystemCode::SubscriptionAck);
+  }
+  std::vector<synth::Generator> expected(kClientCount,
+                                         synth::Generator{Schema::Mbo, synth_conf});
+  // Read from each in turn, so the gateway must keep serving the others while a
+  // client isn't reading
+  constexpr std::size_t kChunk = 1'000;
+  for (std::size_t read = 0; read < kRecordCount; read += kChunk) {
+    for (std::size_t i = 0; i < kClientCount; ++i) {
+      for (std::size_t j = 0; j < kChunk; ++j) {
+        ASSERT_EQ(clients[i].NextRecord().Get<MboMsg>(),
+                  expected[i].NextRecord().Get<MboMsg>());
+      }
+    }
+  }
+  for (auto& client : clients) {
+    EXPECT_EQ(client.NextRecord().Get<SystemMsg>().code,
+              SystemCode::ReplayCompleted);
+  }
+}
+
+TEST_F(ReplayGatewayTests, TestAuthenticationFailure) {
+  WriteFile(Schema::Mbo, {}, 10, Compression::None);
+  ReplayGatewayConf conf{};
+  conf.key = "32-character-with-lots-of-other0";
+  StartGateway(conf);
+  ASSERT_THROW(Builder().BuildBlocking(), LiveApiError);
+  ASSERT_THROW(Builder().SetDataset(dataset::kXnasItch).BuildBlocking(),
+               LiveApiError);
+}
+}  // namespace databento::tests
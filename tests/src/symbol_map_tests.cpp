@@ -4,8 +4,13 @@
 #include <chrono>
 #include <cstdint>
 #include <cstring>
+#include <memory>
+#include <random>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <utility>  // move
 
 #include "databento/compat.hpp"
 #include "databento/constants.hpp"
@@ -212,6 +217,100 @@ TEST(TsSymbolMapTests, TestInsertStartEndDateSame) {
   ASSERT_TRUE(target.Map().empty());
 }
 
+TEST(FlatTsSymbolMapTests, TestMatchesTsSymbolMap) {
+  const auto metadata = GenMetadata();
+  const TsSymbolMap expected{metadata};
+  const FlatTsSymbolMap target{metadata};
+  const FlatTsSymbolMap inverse_target{GenInverseMetadata()};
+  EXPECT_FALSE(target.IsEmpty());
+  EXPECT_LT(target.IntervalCount(), expected.Size());
+  EXPECT_EQ(inverse_target.IntervalCount(), target.IntervalCount());
+  for (const auto& [key, symbol] : expected.Map()) {
+    const auto& [date, instrument_id] = key;
+    ASSERT_NE(target.Find(date, instrument_id), nullptr);
+    EXPECT_EQ(target.At(date, instrument_id), *symbol);
+    EXPECT_EQ(inverse_target.At(date, instrument_id), *symbol);
+  }
+  EXPECT_EQ(target.Find(date::year{2023} / 8 / 1, 32), nullptr);
+  EXPECT_EQ(target.Find(date::year{2023} / 7 / 10, 8029), nullptr);
+  EXPECT_EQ(target.Find(date::year{2023} / 7 / 10, 1), nullptr);
+  ASSERT_THROW(target.At(date::year{2023} / 7 / 10, 8029), std::out_of_range);
+  TradeMsg record{};
+  record.hd.instrument_id = 10172;
+  record.ts_recv =
+      UnixNanos{date::sys_days{date::year{2023} / 7 / 25}} + std::chrono::minutes{155};
+  EXPECT_EQ(target.At(record), "TSLA");
+}
+
+TEST(FlatTsSymbolMapTests, TestSTypeError) {
+  auto metadata = GenMetadata();
+  metadata.stype_out = SType::RawSymbol;
+  ASSERT_THROW(FlatTsSymbolMap{metadata}, InvalidArgumentError);
+}
+
+TEST(FlatTsSymbolMapTests, TestInsert) {
+  FlatTsSymbolMap target;
+  target.Insert(1, date::year{2023} / 12 / 3, date::year{2023} / 12 / 3, "TEST");
+  EXPECT_TRUE(target.IsEmpty());
+  ASSERT_THROW(
+      target.Insert(1, date::year{2023} / 12 / 3, date::year{2023} / 12 / 2, "TEST"),
+      InvalidArgumentError);
+  target.Insert(1, date::year{2023} / 12 / 1, date::year{2023} / 12 / 3, "A");
+  target.Insert(1, date::year{2023} / 12 / 5, date::year{2023} / 12 / 7, "A");
+  EXPECT_EQ(target.IntervalCount(), 2);
+  // Fills the gap and merges with both neighbors, keeping the mapped dates
+  target.Insert(1, date::year{2023} / 11 / 30, date::year{2023} / 12 / 8, "B");
+  EXPECT_EQ(target.IntervalCount(), 5);
+  target.Insert(1, date::year{2023} / 12 / 3, date::year{2023} / 12 / 5, "A");
+  EXPECT_EQ(target.IntervalCount(), 5);
+  EXPECT_EQ(target.At(date::year{2023} / 11 / 30, 1), "B");
+  EXPECT_EQ(target.At(date::year{2023} / 12 / 3, 1), "B");
+  target.Insert(2, date::year{2023} / 12 / 1, date::year{2023} / 12 / 2, "A");
+  target.Insert(2, date::year{2023} / 12 / 2, date::year{2023} / 12 / 3, "A");
+  EXPECT_EQ(target.InstrumentCount(), 2);
+  EXPECT_EQ(target.IntervalCount(), 6);
+  EXPECT_EQ(target.SymbolCount(), 2);
+  // Copies have their own symbols
+  const FlatTsSymbolMap copy{target};
+  target = FlatTsSymbolMap{};
+  target.Insert(3, date::year{2023} / 12 / 1, date::year{2023} / 12 / 2, "C");
+  EXPECT_EQ(copy.At(date::year{2023} / 12 / 2, 2), "A");
+  EXPECT_EQ(copy.Find(date::year{2023} / 12 / 1, 3), nullptr);
+  EXPECT_EQ(target.At(date::year{2023} / 12 / 1, 3), "C");
+}
+
+// Interleaves inserts for many instruments so their intervals are moved and
+// compacted
+TEST(FlatTsSymbolMapTests, TestMatchesTsSymbolMapRandom) {
+  constexpr date::year_month_day kStart{date::year{2023} / 1 / 1};
+  TsSymbolMap expected;
+  FlatTsSymbolMap target;
+  std::mt19937 rng{7};
+  for (std::size_t i = 0; i < 5'000; ++i) {
+    const auto instrument_id = static_cast<std::uint32_t>(rng() % 100);
+    const date::year_month_day start{date::sys_days{kStart} +
+                                     date::days{rng() % 60}};
+    const date::year_month_day end{date::sys_days{start} + date::days{rng() % 10}};
+    const auto symbol = "SYM" + std::to_string(rng() % 3);
+    expected.Insert(instrument_id, start, end, std::make_shared<std::string>(symbol));
+    target.Insert(instrument_id, start, end, symbol);
+  }
+  for (std::uint32_t instrument_id = 0; instrument_id < 100; ++instrument_id) {
+    const auto end = date::sys_days{kStart} + date::days{70};
+    for (auto day = date::sys_days{kStart}; day < end; day += date::days{1}) {
+      const date::year_month_day date{day};
+      const auto it = expected.Find(date, instrument_id);
+      const auto* symbol = target.Find(date, instrument_id);
+      if (it == expected.Map().end()) {
+        ASSERT_EQ(symbol, nullptr);
+      } else {
+        ASSERT_NE(symbol, nullptr);
+        ASSERT_EQ(*symbol, *it->second);
+      }
+    }
+  }
+}
+
 TEST(PitSymbolMapTests, TestFromMetadata) {
   auto metadata = GenMetadata();
   auto target = metadata.CreateSymbolMapForDate(date::year{2023} / 7 / 31);
@@ -273,4 +372,83 @@ TEST(PitSymbolMapTests, TestOnRecord) {
   target.OnRecord(Record{&sm2.hd});
   ASSERT_EQ(target[1], "MSFT");
 }
+
+TEST(FlatPitSymbolMapTests, TestFromMetadata) {
+  const auto metadata = GenMetadata();
+  const FlatPitSymbolMap target{metadata, date::year{2023} / 7 / 31};
+  const auto expected = metadata.CreateSymbolMapForDate(date::year{2023} / 7 / 31);
+  ASSERT_EQ(target.Size(), expected.Size());
+  for (const auto& [instrument_id, symbol] : expected.Map()) {
+    ASSERT_NE(target.Find(instrument_id), nullptr);
+    EXPECT_EQ(target[instrument_id], symbol);
+  }
+  EXPECT_EQ(target.Find(7298), nullptr);
+  EXPECT_EQ(target[7298], "");
+  const FlatPitSymbolMap inverse_target{GenInverseMetadata(),
+                                        date::year{2023} / 7 / 31};
+  EXPECT_EQ(inverse_target[10163], "TSLA");
+  ASSERT_THROW((FlatPitSymbolMap{metadata, date::year{2023} / 8 / 1}),
+               InvalidArgumentError);
+}
+
+TEST(FlatPitSymbolMapTests, TestOnRecord) {
+  FlatPitSymbolMap target;
+  EXPECT_TRUE(target.IsEmpty());
+  auto sm1 = GenMapping<SymbolMappingMsgV1>(1, "AAPL");
+  target.OnRecord(Record{&sm1.hd});
+  auto sm2 = GenMapping<SymbolMappingMsgV2>(2, "TSLA");
+  target.OnRecord(Record{&sm2.hd});
+  target.OnSymbolMapping(GenMapping<SymbolMappingMsgV1>(3, "MSFT"));
+  EXPECT_EQ(target.Size(), 3);
+  EXPECT_EQ(target.At(Record{&sm1.hd}), "AAPL");
+  EXPECT_EQ(target.At(sm2), "TSLA");
+  EXPECT_EQ(target[3], "MSFT");
+  const auto aapl = target[1];
+  sm2 = GenMapping<SymbolMappingMsgV2>(1, "MSFT");
+  target.OnRecord(Record{&sm2.hd});
+  EXPECT_EQ(target[1], "MSFT");
+  // Views of remapped symbols remain valid
+  EXPECT_EQ(aapl, "AAPL");
+  sm1 = GenMapping<SymbolMappingMsgV1>(4, "");
+  ASSERT_THROW(target.At(sm1), std::out_of_range);
+}
+
+TEST(FlatPitSymbolMapTests, TestManySymbols) {
+  FlatPitSymbolMap target{10};
+  for (std::uint32_t i = 0; i < 100'000; ++i) {
+    target.Insert(i, "SYM" + std::to_string(i));
+  }
+  const std::string long_symbol(100'000, 'A');
+  target.Insert(0, long_symbol);
+  // Copies have their own arena
+  FlatPitSymbolMap copy{target};
+  target = FlatPitSymbolMap{};
+  ASSERT_EQ(copy.Size(), 100'000);
+  EXPECT_EQ(copy[0], long_symbol);
+  for (std::uint32_t i = 1; i < 100'000; ++i) {
+    ASSERT_EQ(copy[i], "SYM" + std::to_string(i));
+  }
+  EXPECT_TRUE(target.IsEmpty());
+}
+
+TEST(FlatPitSymbolMapTests, TestMove) {
+  FlatPitSymbolMap target;
+  target.Insert(1, "AAPL");
+  FlatPitSymbolMap moved{std::move(target)};
+  EXPECT_EQ(moved[1], "AAPL");
+  // Inserting into the moved-from map must not write into the other map's arena
+  EXPECT_TRUE(target.IsEmpty());
+  target.Insert(2, "MSFT");
+  EXPECT_EQ(target[2], "MSFT");
+  EXPECT_EQ(target[1], "");
+  EXPECT_EQ(moved[1], "AAPL");
+  EXPECT_EQ(moved.Find(2), nullptr);
+
+  FlatPitSymbolMap assigned;
+  assigned = std::move(moved);
+  moved.Insert(3, "NVDA");
+  EXPECT_EQ(moved[3], "NVDA");
+  EXPECT_EQ(assigned[1], "AAPL");
+  EXPECT_EQ(assigned.Size(), 1);
+}
 }  // namespace databento::tests
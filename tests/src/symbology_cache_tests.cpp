@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "databento/dbn.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/symbol_map.hpp"
+#include "databento/symbology.hpp"
+#include "databento/symbology_cache.hpp"
+
+namespace databento::tests {
+namespace {
+constexpr date::year_month_day kJan1{date::year{2023} / 1 / 1};
+constexpr date::year_month_day kJan3{date::year{2023} / 1 / 3};
+constexpr date::year_month_day kJan5{date::year{2023} / 1 / 5};
+constexpr date::year_month_day kJan7{date::year{2023} / 1 / 7};
+}  // namespace
+
+class SymbologyCacheTests : public testing::Test {
+ protected:
+  void TearDown() override { std::filesystem::remove_all(cache_.Dir()); }
+
+  // Resolves `ES` to a new instrument ID every other day from `kJan1` and `NQ`
+  // from `kJan3`, recording the date ranges requested
+  SymbologyResolution Resolve(date::year_month_day start_date,
+                              date::year_month_day end_date) {
+    requests_.emplace_back(start_date, end_date);
+    SymbologyResolution res{{}, {}, {}, SType::RawSymbol, SType::InstrumentId};
+    for (date::sys_days day{start_date}; day < date::sys_days{end_date};) {
+      const auto idx = (day - date::sys_days{kJan1}).count() / 2;
+      const date::sys_days next{date::sys_days{kJan1} + date::days{2 * (idx + 1)}};
+      const auto instrument_id = idx + 10;
+      res.mappings["ES"].emplace_back(MappingInterval{
+          date::year_month_day{day},
+          date::year_month_day{std::min(next, date::sys_days{end_date})},
+          std::to_string(instrument_id)});
+      day = next;
+    }
+    if (end_date <= kJan3) {
+      res.not_found.emplace_back("NQ");
+    } else {
+      res.mappings["NQ"].emplace_back(
+          MappingInterval{std::max(start_date, kJan3), end_date, "5"});
+      if (start_date < kJan3) {
+        res.partial.emplace_back("NQ");
+      }
+    }
+    res.not_found.emplace_back("YM");
+    return res;
+  }
+
+  SymbologyFile CacheResolve(date::year_month_day start_date,
+                             date::year_month_day end_date) {
+    return cache_.Resolve(
+        "GLBX.MDP3", kSymbols, SType::RawSymbol, SType::InstrumentId, start_date,
+        end_date, [this](date::year_month_day start, date::year_month_day end) {
+          return Resolve(start, end);
+        });
+  }
+
+  const std::vector<std::string> kSymbols{"ES", "NQ", "YM"};
+  SymbologyCache cache_{std::filesystem::temp_directory_path() /
+                        "databento_symbology_cache_tests"};
+  std::vector<std::pair<date::year_month_day, date::year_month_day>> requests_;
+};
+
+TEST_F(SymbologyCacheTests, TestResolveAndReload) {
+  const auto file = CacheResolve(kJan1, kJan5);
+  ASSERT_EQ(requests_.size(), 1);
+  EXPECT_EQ(file.StartDate(), kJan1);
+  EXPECT_EQ(file.EndDate(), kJan5);
+  EXPECT_EQ(file.StypeIn(), SType::RawSymbol);
+  EXPECT_EQ(file.StypeOut(), SType::InstrumentId);
+  EXPECT_EQ(file.MappingCount(), 2);
+  EXPECT_EQ(file.IntervalCount(), 3);
+  // Contained ranges are read from the file
+  const auto reloaded = CacheResolve(kJan3, kJan5);
+  EXPECT_EQ(requests_.size(), 1);
+  EXPECT_EQ(reloaded.Key(), file.Key());
+  const auto res = reloaded.ToResolution();
+  const auto expected = Resolve(kJan1, kJan5);
+  EXPECT_EQ(res.mappings, expected.mappings);
+  EXPECT_EQ(res.partial, expected.partial);
+  EXPECT_EQ(res.not_found, expected.not_found);
+  EXPECT_TRUE(std::filesystem::exists(
+      cache_.FilePath("GLBX.MDP3", kSymbols, SType::RawSymbol, SType::InstrumentId)));
+}
+
+TEST_F(SymbologyCacheTests, TestExtend) {
+  CacheResolve(kJan3, kJan5);
+  requests_.clear();
+  const auto file = CacheResolve(kJan1, kJan7);
+  // Only the missing dates are requested
+  ASSERT_EQ(requests_.size(), 2);
+  EXPECT_EQ(requests_[0], std::make_pair(kJan1, kJan3));
+  EXPECT_EQ(requests_[1], std::make_pair(kJan5, kJan7));
+  EXPECT_EQ(file.StartDate(), kJan1);
+  EXPECT_EQ(file.EndDate(), kJan7);
+  const auto res = file.ToResolution();
+  const auto expected = Resolve(kJan1, kJan7);
+  EXPECT_EQ(res.mappings, expected.mappings);
+  // Not found before `kJan3` and found after
+  EXPECT_EQ(res.partial, std::vector<std::string>{"NQ"});
+  EXPECT_EQ(res.not_found, std::vector<std::string>{"YM"});
+}
+
+TEST_F(SymbologyCacheTests, TestExtendCoalescesIntervals) {
+  CacheResolve(kJan1, date::year{2023} / 1 / 4);
+  const auto file = CacheResolve(kJan1, kJan7);
+  const auto res = file.ToResolution();
+  // The `NQ` interval split across requests is merged
+  ASSERT_EQ(res.mappings.at("NQ").size(), 1);
+  EXPECT_EQ(res.mappings.at("NQ")[0], (MappingInterval{kJan3, kJan7, "5"}));
+  EXPECT_EQ(res.mappings.at("ES"), Resolve(kJan1, kJan7).mappings.at("ES"));
+}
+
+TEST_F(SymbologyCacheTests, TestDifferentSymbolsDifferentFiles) {
+  const auto path =
+      cache_.FilePath("GLBX.MDP3", kSymbols, SType::RawSymbol, SType::InstrumentId);
+  EXPECT_NE(path, cache_.FilePath("GLBX.MDP3", {"ES"}, SType::RawSymbol,
+                                  SType::InstrumentId));
+  EXPECT_NE(path, cache_.FilePath("XNAS.ITCH", kSymbols, SType::RawSymbol,
+                                  SType::InstrumentId));
+  EXPECT_NE(path,
+            cache_.FilePath("GLBX.MDP3", kSymbols, SType::Parent, SType::InstrumentId));
+  EXPECT_EQ(path, cache_.FilePath("GLBX.MDP3", kSymbols, SType::RawSymbol,
+                                  SType::InstrumentId));
+  // The order of the symbols and duplicates don't matter
+  EXPECT_EQ(path, cache_.FilePath("GLBX.MDP3", {"YM", "ES", "NQ", "ES"},
+                                  SType::RawSymbol, SType::InstrumentId));
+}
+
+TEST_F(SymbologyCacheTests, TestReorderedSymbolsReuseFile) {
+  CacheResolve(kJan1, kJan5);
+  const auto file = cache_.Resolve(
+      "GLBX.MDP3", {"YM", "NQ", "ES"}, SType::RawSymbol, SType::InstrumentId, kJan1,
+      kJan5, [this](date::year_month_day start, date::year_month_day end) {
+        return Resolve(start, end);
+      });
+  EXPECT_EQ(requests_.size(), 1);
+  EXPECT_EQ(file.MappingCount(), 2);
+}
+
+TEST_F(SymbologyCacheTests, TestCorruptFileReplaced) {
+  const auto path =
+      cache_.FilePath("GLBX.MDP3", kSymbols, SType::RawSymbol, SType::InstrumentId);
+  CacheResolve(kJan1, kJan5);
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+  ASSERT_THROW(SymbologyFile{path}, DbnResponseError);
+  requests_.clear();
+  const auto file = CacheResolve(kJan1, kJan5);
+  ASSERT_EQ(requests_.size(), 1);
+  EXPECT_EQ(requests_[0], std::make_pair(kJan1, kJan5));
+  EXPECT_EQ(file.MappingCount(), 2);
+}
+
+TEST_F(SymbologyCacheTests, TestInvalidFile) {
+  const auto path = cache_.Dir() / "invalid.dbsym";
+  {
+    std::ofstream out{path};
+    out << "not a symbology file, but long enough to have a header";
+  }
+  ASSERT_THROW(SymbologyFile{path}, DbnResponseError);
+}
+
+TEST_F(SymbologyCacheTests, TestInvalidDates) {
+  ASSERT_THROW(CacheResolve(kJan3, kJan3), InvalidArgumentError);
+  ASSERT_THROW(CacheResolve(kJan3, kJan1), InvalidArgumentError);
+  EXPECT_TRUE(requests_.empty());
+}
+
+TEST_F(SymbologyCacheTests, TestCreateSymbolMap) {
+  const auto file = CacheResolve(kJan1, kJan7);
+  const auto expected = file.ToResolution().CreateSymbolMap();
+  const auto target = file.CreateSymbolMap();
+  ASSERT_EQ(target.Size(), expected.Size());
+  for (const auto& [key, symbol] : expected.Map()) {
+    const auto it = target.Map().find(key);
+    ASSERT_NE(it, target.Map().end());
+    EXPECT_EQ(*it->second, *symbol);
+  }
+  const auto flat_target = file.CreateFlatSymbolMap();
+  for (date::sys_days day{kJan1}; day < date::sys_days{kJan7}; day += date::days{1}) {
+    for (const std::uint32_t instrument_id : {5, 10, 11, 12}) {
+      const auto expected_it = expected.Find(date::year_month_day{day}, instrument_id);
+      const auto* symbol = flat_target.Find(date::year_month_day{day}, instrument_id);
+      if (expected_it == expected.Map().end()) {
+        EXPECT_EQ(symbol, nullptr);
+      } else {
+        ASSERT_NE(symbol, nullptr);
+        EXPECT_EQ(*symbol, *expected_it->second);
+      }
+    }
+  }
+}
+
+TEST_F(SymbologyCacheTests, TestCreateSymbolMapForDate) {
+  const auto file = CacheResolve(kJan1, kJan5);
+  const auto target = file.CreateSymbolMapForDate(kJan3);
+  EXPECT_EQ(target.Size(), 2);
+  EXPECT_EQ(target.Find(11)->second, "ES");
+  EXPECT_EQ(target.Find(5)->second, "NQ");
+  EXPECT_EQ(file.CreateSymbolMapForDate(kJan1).Size(), 1);
+  ASSERT_THROW(file.CreateSymbolMapForDate(kJan5), InvalidArgumentError);
+}
+
+TEST_F(SymbologyCacheTests, TestInverse) {
+  const auto file = cache_.Resolve(
+      "GLBX.MDP3", {"10", "11"}, SType::InstrumentId, SType::RawSymbol, kJan1, kJan5,
+      [](date::year_month_day start_date, date::year_month_day end_date) {
+        SymbologyResolution res{{}, {}, {}, SType::InstrumentId, SType::RawSymbol};
+        res.mappings["10"].emplace_back(MappingInterval{start_date, kJan3, "ESH3"});
+        res.mappings["11"].emplace_back(MappingInterval{kJan3, end_date, "ESM3"});
+        return res;
+      });
+  const auto symbol_map = file.CreateSymbolMap();
+  EXPECT_EQ(symbol_map.At(kJan1, 10), "ESH3");
+  EXPECT_EQ(symbol_map.At(kJan3, 11), "ESM3");
+  const auto pit_map = file.CreateSymbolMapForDate(date::year{2023} / 1 / 4);
+  EXPECT_EQ(pit_map.Size(), 1);
+  EXPECT_EQ(pit_map.Find(11)->second, "ESM3");
+}
+}  // namespace databento::tests
@@ -0,0 +1,276 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>  // max, min
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <utility>  // move
+#include <vector>
+
+#include "databento/constants.hpp"
+#include "databento/datetime.hpp"
+#include "databento/dbn.hpp"
+#include "databento/dbn_decoder.hpp"
+#include "databento/detail/buffer.hpp"
+#include "databento/detail/zstd_stream.hpp"
+#include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
+#include "databento/flag_set.hpp"
+#include "databento/live.hpp"
+#include "databento/live_blocking.hpp"
+#include "databento/log.hpp"
+#include "databento/record.hpp"
+#include "databento/symbol_map.hpp"
+#include "databento/synth.hpp"
+#include "mock/mock_log_receiver.hpp"
+#include "mock/mock_lsg_server.hpp"  // MockLsgServer
+
+namespace databento::synth::tests {
+namespace {
+std::vector<std::byte> GenerateBytes(Schema schema, const GeneratorConf& conf,
+                                     std::size_t record_count) {
+  detail::Buffer buffer;
+  Generator target{schema, conf};
+  target.WriteRecords(record_count, &buffer);
+  return {buffer.ReadBegin(), buffer.ReadEnd()};
+}
+}  // namespace
+
+TEST(SynthTests, TestInvalidConf) {
+  ASSERT_THROW((Generator{Schema::Ohlcv1S, GeneratorConf{}}), InvalidArgumentError);
+  GeneratorConf conf{};
+  conf.instrument_count = 0;
+  ASSERT_THROW((Generator{Schema::Mbo, conf}), InvalidArgumentError);
+  conf = {};
+  conf.message_rate = 0;
+  ASSERT_THROW((Generator{Schema::Trades, conf}), InvalidArgumentError);
+}
+
+TEST(SynthTests, TestDeterministic) {
+  GeneratorConf conf{};
+  conf.seed = 7;
+  for (const auto schema : {Schema::Mbo, Schema::Mbp10, Schema::Trades,
+                            Schema::Definition, Schema::Statistics}) {
+    const auto first = GenerateBytes(schema, conf, 1'000);
+    EXPECT_EQ(first, GenerateBytes(schema, conf, 1'000)) << schema;
+    auto other_conf = conf;
+    other_conf.seed = 8;
+    EXPECT_NE(first, GenerateBytes(schema, other_conf, 1'000)) << schema;
+  }
+}
+
+TEST(SynthTests, TestMboBookConsistency) {
+  constexpr std::size_t kRecordCount = 200'000;
+  GeneratorConf conf{};
+  conf.instrument_count = 8;
+  conf.first_instrument_id = 100;
+  Generator target{Schema::Mbo, conf};
+
+  struct Book {
+    std::unordered_map<std::uint64_t, MboMsg> orders;
+    std::uint32_t sequence{};
+  };
+  std::map<std::uint32_t, Book> books;
+  UnixNanos last_ts_recv{};
+  std::size_t trade_count{};
+  for (std::size_t i = 0; i < kRecordCount; ++i) {
+    const auto& rec = target.NextRecord();
+    ASSERT_TRUE(rec.Holds<MboMsg>());
+    const auto& mbo = rec.Get<MboMsg>();
+    ASSERT_EQ(mbo.hd.publisher_id,
+              static_cast<std::uint16_t>(Publisher::GlbxMdp3Glbx));
+    ASSERT_GE(mbo.hd.instrument_id, 100U);
+    ASSERT_LT(mbo.hd.instrument_id, 108U);
+    ASSERT_LE(mbo.hd.ts_event, mbo.ts_recv);
+    ASSERT_GE(mbo.ts_recv, last_ts_recv);
+    last_ts_recv = mbo.ts_recv;
+    auto& book = books[mbo.hd.instrument_id];
+    ASSERT_GE(mbo.sequence, book.sequence);
+    book.sequence = mbo.sequence;
+    auto& orders = book.orders;
+    switch (mbo.action) {
+      case Action::Add: {
+        ASSERT_TRUE(orders.emplace(mbo.order_id, mbo).second) << i;
+        break;
+      }
+      case Action::Cancel: {
+        const auto it = orders.find(mbo.order_id);
+        ASSERT_NE(it, orders.end()) << i;
+        ASSERT_EQ(it->second.size, mbo.size) << i;
+        orders.erase(it);
+        break;
+      }
+      case Action::Modify: {
+        const auto it = orders.find(mbo.order_id);
+        ASSERT_NE(it, orders.end()) << i;
+        ASSERT_EQ(it->second.price, mbo.price) << i;
+        it->second.size = mbo.size;
+        break;
+      }
+      case Action::Trade: {
+        ++trade_count;
+        ASSERT_FALSE(mbo.flags.IsLast());
+        break;
+      }
+      case Action::Fill: {
+        const auto it = orders.find(mbo.order_id);
+        ASSERT_NE(it, orders.end()) << i;
+        ASSERT_LE(mbo.size, it->second.size) << i;
+        ASSERT_FALSE(mbo.flags.IsLast());
+        break;
+      }
+      default: {
+        FAIL() << "Unexpected action " << mbo.action;
+      }
+    }
+    if (mbo.flags.IsLast()) {
+      std::int64_t best_bid = std::numeric_limits<std::int64_t>::min();
+      std::int64_t best_ask = std::numeric_limits<std::int64_t>::max();
+      for (const auto& [_, order] : orders) {
+        if (order.side == Side::Bid) {
+          best_bid = (std::max)(best_bid, order.price);
+        } else {
+          best_ask = (std::min)(best_ask, order.price);
+        }
+      }
+      ASSERT_LT(best_bid, best_ask) << "Crossed book at record " << i;
+    }
+  }
+  EXPECT_GT(trade_count, 0);
+  EXPECT_EQ(books.size(), 8U);
+  EXPECT_EQ(target.RecordCount(), kRecordCount);
+}
+
+TEST(SynthTests, TestMbp10Levels) {
+  Generator target{Schema::Mbp10, GeneratorConf{}};
+  for (std::size_t i = 0; i < 20'000; ++i) {
+    const auto& rec = target.NextRecord();
+    ASSERT_TRUE(rec.Holds<Mbp10Msg>());
+    const auto& mbp = rec.Get<Mbp10Msg>();
+    ASSERT_LT(mbp.depth, 10);
+    const auto& best = mbp.levels[0];
+    if (best.bid_px != kUndefPrice && best.ask_px != kUndefPrice) {
+      ASSERT_LT(best.bid_px, best.ask_px) << i;
+    }
+    for (std::size_t level = 1; level < mbp.levels.size(); ++level) {
+      const auto& prev = mbp.levels[level - 1];
+      const auto& cur = mbp.levels[level];
+      if (cur.bid_px != kUndefPrice) {
+        ASSERT_LT(cur.bid_px, prev.bid_px) << i;
+        ASSERT_GT(cur.bid_sz, 0);
+        ASSERT_GT(cur.bid_ct, 0);
+      }
+      if (cur.ask_px != kUndefPrice) {
+        ASSERT_GT(cur.ask_px, prev.ask_px) << i;
+      }
+    }
+  }
+}
+
+TEST(SynthTests, TestTrades) {
+  Generator target{Schema::Trades, GeneratorConf{}};
+  for (std::size_t i = 0; i < 10'000; ++i) {
+    const auto& rec = target.NextRecord();
+    ASSERT_TRUE(rec.Holds<TradeMsg>());
+    const auto& trade = rec.Get<TradeMsg>();
+    ASSERT_EQ(trade.action, Action::Trade);
+    ASSERT_NE(trade.side, Side::None);
+    ASSERT_GT(trade.size, 0);
+    ASSERT_TRUE(trade.flags.IsLast());
+  }
+}
+
+TEST(SynthTests, TestDefinitionsAndStatistics) {
+  GeneratorConf conf{};
+  conf.instrument_count = 4;
+  Generator definitions{Schema::Definition, conf};
+  for (std::uint32_t i = 0; i < 8; ++i) {
+    const auto& def = definitions.NextRecord().Get<InstrumentDefMsg>();
+    EXPECT_EQ(def.hd.instrument_id, 1 + i % 4);
+    EXPECT_EQ(def.raw_symbol.data(), definitions.Symbol(def.hd.instrument_id));
+    EXPECT_EQ(def.security_update_action,
+              i < 4 ? SecurityUpdateAction::Add : SecurityUpdateAction::Modify);
+    EXPECT_EQ(def.instrument_class, InstrumentClass::Future);
+  }
+  Generator statistics{Schema::Statistics, conf};
+  for (std::size_t i = 0; i < 1'000; ++i) {
+    const auto& stat = statistics.NextRecord().Get<StatMsg>();
+    if (stat.stat_type == StatType::ClearedVolume ||
+        stat.stat_type == StatType::OpenInterest) {
+      EXPECT_EQ(stat.price, kUndefPrice);
+      EXPECT_GT(stat.quantity, 0);
+    } else {
+      EXPECT_NE(stat.price, kUndefPrice);
+      EXPECT_EQ(stat.quantity, kUndefStatQuantity);
+    }
+  }
+}
+
+TEST(SynthTests, TestWriteDbn) {
+  constexpr std::size_t kRecordCount = 50'000;
+  for (const auto compression : {Compression::None, Compression::Zstd}) {
+    auto logger = databento::tests::mock::MockLogReceiver::AssertNoLogs(
+        LogLevel::Warning);
+    GeneratorConf conf{};
+    conf.message_rate = 1'000;
+    Generator target{Schema::Mbp10, conf};
+    auto buffer =
+        std::make_unique<detail::Buffer>(kRecordCount * sizeof(Mbp10Msg) + 4096);
+    if (compression == Compression::Zstd) {
+      detail::ZstdCompressStream zstd_output{buffer.get()};
+      target.WriteDbn(kRecordCount, &zstd_output);
+    } else {
+      target.WriteDbn(kRecordCount, buffer.get());
+    }
+    DbnDecoder decoder{&logger, std::move(buffer)};
+    const auto metadata = decoder.DecodeMetadata();
+    EXPECT_EQ(metadata.dataset, dataset::kGlbxMdp3);
+    EXPECT_EQ(metadata.schema, Schema::Mbp10);
+    EXPECT_EQ(metadata.start, conf.start);
+    // 50 seconds at 1,000 records per second
+    EXPECT_GT(metadata.end, conf.start + std::chrono::seconds{50});
+    EXPECT_EQ(metadata.limit, kRecordCount);
+    EXPECT_EQ(metadata.mappings.size(), conf.instrument_count);
+    const auto symbol_map = metadata.CreateSymbolMap();
+    std::size_t count{};
+    while (const auto* rec = decoder.DecodeRecord()) {
+      const auto& mbp = rec->Get<Mbp10Msg>();
+      ASSERT_NE(symbol_map.Find(mbp), symbol_map.Map().end());
+      ASSERT_LT(mbp.ts_recv, metadata.end);
+      ++count;
+    }
+    EXPECT_EQ(count, kRecordCount) << compression;
+  }
+}
+
+TEST(SynthTests, TestMockLiveGateway) {
+  constexpr std::size_t kRecordCount = 10'000;
+  const GeneratorConf kConf{};
+  const databento::tests::mock::MockLsgServer mock_server{
+      dataset::kGlbxMdp3, false, [&kConf](databento::tests::mock::MockLsgServer& self) {
+        self.Accept();
+        self.Authenticate();
+        self.Start();
+        Generator generator{Schema::Mbo, kConf};
+        self.SendRecords(generator, kRecordCount);
+      }};
+
+  auto logger =
+      databento::tests::mock::MockLogReceiver::AssertNoLogs(LogLevel::Warning);
+  auto target = LiveBuilder{}
+                    .SetLogReceiver(&logger)
+                    .SetKey("32-character-with-lots-of-filler")
+                    .SetDataset(dataset::kGlbxMdp3)
+                    .SetAddress("127.0.0.1", mock_server.Port())
+                    .BuildBlocking();
+  target.Start();
+  Generator expected{Schema::Mbo, kConf};
+  for (std::size_t i = 0; i < kRecordCount; ++i) {
+    const auto& rec = target.NextRecord();
+    ASSERT_EQ(rec.Get<MboMsg>(), expected.NextRecord().Get<MboMsg>()) << i;
+  }
+}
+}  // namespace databento::synth::tests
@@ -7,6 +7,7 @@
 #include <mutex>
 #include <string>
 
+#include "databento/datetime.hpp"
 #include "databento/detail/tcp_client.hpp"
 #include "databento/exceptions.hpp"
 #include "databento/log.hpp"
@@ -142,6 +143,103 @@ TEST_F(TcpClientTests, TestReadCloseNoTimeout) {
   EXPECT_LT(end - start, kTimeout);
 }
 
+TEST_F(TcpClientTests, TestSpinReadSomeTimeout) {
+  bool has_timed_out{};
+  std::mutex has_timed_out_mutex;
+  std::condition_variable has_timed_out_cv;
+  const mock::MockTcpServer mock_server{
+      [&has_timed_out, &has_timed_out_mutex,
+       &has_timed_out_cv](mock::MockTcpServer& server) {
+        server.Accept();
+        server.SetSend("hello");
+        {
+          std::unique_lock<std::mutex> lock{has_timed_out_mutex};
+          has_timed_out_cv.wait(lock, [&has_timed_out] { return has_timed_out; });
+        }
+        server.Send();
+        server.Close();
+      }};
+  detail::TcpClient::SocketConf socket_conf{};
+  socket_conf.spin = true;
+  target_ =
+      detail::TcpClient{&logger_, "127.0.0.1", mock_server.Port(), {}, socket_conf};
+
+  constexpr std::chrono::milliseconds kTimeout{5};
+  std::array<std::byte, 10> buffer{};
+  const auto start = std::chrono::steady_clock::now();
+  auto res = target_.ReadSome(buffer.data(), buffer.size(), kTimeout);
+  EXPECT_GE(std::chrono::steady_clock::now() - start, kTimeout);
+  EXPECT_EQ(res.status, IReadable::Status::Timeout);
+  EXPECT_EQ(res.read_size, 0);
+  {
+    const std::lock_guard<std::mutex> lock{has_timed_out_mutex};
+    has_timed_out = true;
+    has_timed_out_cv.notify_one();
+  }
+  // A timeout of 0 spins until data arrives
+  res = target_.ReadSome(buffer.data(), buffer.size(), std::chrono::milliseconds{});
+  EXPECT_EQ(res.status, IReadable::Status::Ok);
+  EXPECT_EQ(res.read_size, 5);
+  EXPECT_STREQ(reinterpret_cast<const char*>(buffer.data()), "hello");
+  res = target_.ReadSome(buffer.data(), buffer.size(), std::chrono::milliseconds{});
+  EXPECT_EQ(res.status, IReadable::Status::Closed);
+}
+
+TEST_F(TcpClientTests, TestSocketConfDefaults) {
+  // Opt-in like `LowLatencyConf::io_uring`, whichever constructor is used
+  const detail::TcpClient::SocketConf socket_conf{};
+  EXPECT_FALSE(socket_conf.io_uring);
+  EXPECT_FALSE(socket_conf.spin);
+  EXPECT_FALSE(socket_conf.rx_timestamps);
+}
+
+#ifdef __linux__
+TEST_F(TcpClientTests, TestRxTimestamps) {
+  const std::string kSendData = "Timestamped";
+  const mock::MockTcpServer mock_server{[&kSendData](mock::MockTcpServer& server) {
+    server.Accept();
+    server.SetSend(kSendData);
+    server.Receive();
+    server.Send();
+    server.Close();
+  }};
+  detail::TcpClient::SocketConf socket_conf{};
+  socket_conf.rx_timestamps = true;
+  target_ =
+      detail::TcpClient{&logger_, "127.0.0.1", mock_server.Port(), {}, socket_conf};
+  EXPECT_EQ(target_.LastRxTs(), UnixNanos{});
+  const auto start = UnixNanos{std::chrono::system_clock::now()};
+  target_.WriteAll("start");
+
+  std::array<std::byte, 32> buffer{};
+  const auto res =
+      target_.ReadSome(buffer.data(), buffer.size(), std::chrono::seconds{1});
+  ASSERT_EQ(res.status, IReadable::Status::Ok);
+  ASSERT_EQ(res.read_size, kSendData.size());
+  EXPECT_GE(target_.LastRxTs(), start);
+  EXPECT_LE(target_.LastRxTs(), UnixNanos{std::chrono::system_clock::now()});
+}
+#endif
+
+#ifdef DATABENTO_IO_URING
+TEST_F(TcpClientTests, TestUringHasBufferedData) {
+  const std::string kSendData = "Buffered in io_uring";
+  mock_server_.SetSend(kSendData);
+  target_.WriteAll("start");
+
+  std::array<std::byte, 32> buffer{};
+  auto res = target_.ReadSome(buffer.data(), 6, std::chrono::seconds{1});
+  ASSERT_EQ(res.status, IReadable::Status::Ok);
+  ASSERT_EQ(res.read_size, 6);
+  // The rest of the received data is held by the reader, not the socket
+  ASSERT_TRUE(target_.HasBufferedData());
+  res = target_.ReadSome(&buffer[6], buffer.size() - 6, std::chrono::seconds{1});
+  ASSERT_EQ(res.status, IReadable::Status::Ok);
+  EXPECT_EQ(res.read_size, kSendData.size() - 6);
+  EXPECT_STREQ(reinterpret_cast<const char*>(buffer.data()), kSendData.c_str());
+}
+#endif
+
 TEST_F(TcpClientTests, ReadAfterClose) {
   const std::string kSendData = "Read after close";
   mock_server_.SetSend(kSendData);
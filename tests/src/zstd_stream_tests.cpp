@@ -1,14 +1,19 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>  // min
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <stdexcept>  // runtime_error
+#include <string>
+#include <utility>  // move
 #include <vector>
 
 #include "databento/compat.hpp"
 #include "databento/detail/buffer.hpp"
 #include "databento/detail/zstd_stream.hpp"
 #include "databento/enums.hpp"
+#include "databento/exceptions.hpp"
 #include "databento/file_stream.hpp"
 
 namespace databento::detail::tests {
@@ -46,6 +51,57 @@ TEST(ZstdStreamTests, TestIdentity) {
   decode.ReadExact(res.data(), size);
 }
 
+TEST(ZstdStreamTests, TestLargeWrite) {
+  // Incompressible so the output is larger than Zstd's output buffer
+  std::vector<std::uint64_t> source_data;
+  std::uint64_t state = 88172645463325252;
+  for (std::size_t i = 0; i < 1 << 17; ++i) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    source_data.emplace_back(state);
+  }
+  const auto size = source_data.size() * sizeof(std::uint64_t);
+  detail::Buffer mock_io;
+  {
+    ZstdCompressStream compressor{&mock_io};
+    compressor.WriteAll(reinterpret_cast<const std::byte*>(source_data.data()), size);
+  }
+  std::vector<std::uint64_t> res(source_data.size());
+  ZstdDecodeStream decode{std::make_unique<detail::Buffer>(std::move(mock_io))};
+  decode.ReadExact(reinterpret_cast<std::byte*>(res.data()), size);
+  EXPECT_EQ(res, source_data);
+}
+
+TEST(ZstdStreamTests, TestLargeFlush) {
+  // Incompressible and written in chunks that aren't a multiple of the input size,
+  // so the end of the frame is more than one output buffer of data
+  constexpr std::size_t kChunkLen = 12'500;
+  std::vector<std::uint64_t> source_data;
+  std::uint64_t state = 88172645463325252;
+  for (std::size_t i = 0; i < 3 * kChunkLen; ++i) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    source_data.emplace_back(state);
+  }
+  const auto size = source_data.size() * sizeof(std::uint64_t);
+  detail::Buffer mock_io;
+  ZstdCompressStream compressor{&mock_io};
+  for (std::size_t i = 0; i < source_data.size(); i += kChunkLen) {
+    compressor.WriteAll(reinterpret_cast<const std::byte*>(&source_data[i]),
+                        kChunkLen * sizeof(std::uint64_t));
+  }
+  compressor.Flush();
+  // Everything is readable without destroying the compressor
+  auto flushed = std::make_unique<detail::Buffer>();
+  flushed->WriteAll(mock_io.ReadBegin(), mock_io.ReadCapacity());
+  std::vector<std::uint64_t> res(source_data.size());
+  ZstdDecodeStream decode{std::move(flushed)};
+  decode.ReadExact(reinterpret_cast<std::byte*>(res.data()), size);
+  EXPECT_EQ(res, source_data);
+}
+
 TEST(ZstdStreamTests, TestFlush) {
   // Test that Flush() makes data available for reading without ending the stream
   const std::string kTestData = "DBN\x01\x00\x00\x00TestData123";
@@ -73,6 +129,125 @@ TEST(ZstdStreamTests, TestFlush) {
   EXPECT_EQ(result, kTestData + kTestData);
 }
 
+namespace {
+// Compresses `source_data` into one frame per `frame_len` elements
+template <typename T>
+detail::Buffer CompressFrames(const std::vector<T>& source_data,
+                              std::size_t frame_len) {
+  detail::Buffer res;
+  ZstdCompressStream compressor{&res};
+  // Write in small chunks, like TestIdentity
+  constexpr std::size_t kChunkLen = 100;
+  for (std::size_t i = 0; i < source_data.size(); i += frame_len) {
+    const auto frame_end = std::min(i + frame_len, source_data.size());
+    for (auto j = i; j < frame_end; j += kChunkLen) {
+      const auto len = std::min(kChunkLen, frame_end - j);
+      compressor.WriteAll(reinterpret_cast<const std::byte*>(&source_data[j]),
+                          len * sizeof(T));
+    }
+    compressor.Flush();
+  }
+  return res;
+}
+
+// Mock IReadable that returns at most `chunk_size` bytes per read
+class ChunkedReader : public IReadable {
+ public:
+  ChunkedReader(detail::Buffer buffer, std::size_t chunk_size)
+      : buffer_{std::move(buffer)}, chunk_size_{chunk_size} {}
+
+  void ReadExact(std::byte* buffer, std::size_t length) override {
+    buffer_.ReadExact(buffer, length);
+  }
+  std::size_t ReadSome(std::byte* buffer, std::size_t max_length) override {
+    return buffer_.ReadSome(buffer, std::min(max_length, chunk_size_));
+  }
+  Result ReadSome(std::byte* buffer, std::size_t max_length,
+                  std::chrono::milliseconds) override {
+    return {ReadSome(buffer, max_length), Status::Ok};
+  }
+
+ private:
+  detail::Buffer buffer_;
+  std::size_t chunk_size_;
+};
+}  // namespace
+
+TEST(ParallelZstdDecodeStreamTests, TestMultiFrameFiles) {
+  const std::string file_path = TEST_DATA_DIR "/multi-frame.definition.v1.dbn.frag.zst";
+  ZstdDecodeStream expected_stream{std::make_unique<InFileStream>(file_path)};
+  ParallelZstdDecodeStream target{std::make_unique<InFileStream>(file_path), 4};
+  std::vector<std::byte> expected(1 << 16);
+  std::vector<std::byte> res(expected.size());
+  expected.resize(expected_stream.ReadSome(expected.data(), expected.size()));
+  std::size_t read_size;
+  while ((read_size = expected_stream.ReadSome(res.data(), res.size())) > 0) {
+    expected.insert(expected.end(), res.begin(),
+                    res.begin() + static_cast<std::ptrdiff_t>(read_size));
+  }
+  ASSERT_EQ(expected.size(), 8 * sizeof(InstrumentDefMsgV1));
+  res.resize(expected.size());
+  target.ReadExact(res.data(), res.size());
+  EXPECT_EQ(res, expected);
+  EXPECT_EQ(target.ReadSome(res.data(), res.size()), 0);
+}
+
+TEST(ParallelZstdDecodeStreamTests, TestIdentity) {
+  std::vector<std::int64_t> source_data;
+  for (std::int64_t i = 0; i < 1'000'000; ++i) {
+    source_data.emplace_back(i);
+  }
+  ParallelZstdDecodeStream target{
+      std::make_unique<detail::Buffer>(CompressFrames(source_data, 10'000)), 4};
+  std::vector<std::int64_t> res(source_data.size());
+  // Odd read size so reads straddle frames
+  constexpr std::size_t kReadSize = 999;
+  auto* res_bytes = reinterpret_cast<std::byte*>(res.data());
+  const auto size = res.size() * sizeof(std::int64_t);
+  std::size_t pos{};
+  while (pos < size) {
+    const auto read_size =
+        target.ReadSome(&res_bytes[pos], std::min(kReadSize, size - pos));
+    ASSERT_GT(read_size, 0);
+    pos += read_size;
+  }
+  EXPECT_EQ(res, source_data);
+  EXPECT_EQ(target.ReadSome(res_bytes, size), 0);
+}
+
+TEST(ParallelZstdDecodeStreamTests, TestFallbackToSerialForLargeFrames) {
+  std::vector<std::int64_t> source_data;
+  for (std::int64_t i = 0; i < 100'000; ++i) {
+    source_data.emplace_back(i * i);
+  }
+  // The first frames are small enough to be decompressed in parallel, the last
+  // isn't
+  auto input = CompressFrames(std::vector<std::int64_t>(source_data.begin(),
+                                                        source_data.begin() + 100),
+                              10);
+  auto large_frame = CompressFrames(
+      std::vector<std::int64_t>(source_data.begin() + 100, source_data.end()),
+      source_data.size());
+  input.WriteAll(large_frame.ReadBegin(), large_frame.ReadCapacity());
+  detail::Buffer in_buffer{0};
+  ParallelZstdDecodeStream target{
+      std::make_unique<ChunkedReader>(std::move(input), 1 << 9), in_buffer, 2,
+      1 << 10};
+  std::vector<std::int64_t> res(source_data.size());
+  target.ReadExact(reinterpret_cast<std::byte*>(res.data()),
+                   res.size() * sizeof(std::int64_t));
+  EXPECT_EQ(res, source_data);
+}
+
+TEST(ParallelZstdDecodeStreamTests, TestInvalidInput) {
+  const std::string kInvalid = "not zstd data";
+  auto input = std::make_unique<detail::Buffer>();
+  input->WriteAll(kInvalid.data(), kInvalid.size());
+  ParallelZstdDecodeStream target{std::move(input), 2};
+  std::vector<std::byte> res(100);
+  EXPECT_THROW(target.ReadSome(res.data(), res.size()), DbnResponseError);
+}
+
 // Mock IReadable that always returns a timeout
 class TimeoutReader : public IReadable {
  public:
@@ -85,6 +260,87 @@ class TimeoutReader : public IReadable {
   }
 };
 
+// Mock IReadable that counts how many times it's read from and times out once
+// `data` is exhausted
+class CountingReader : public IReadable {
+ public:
+  CountingReader() = default;
+  explicit CountingReader(detail::Buffer data) : data_{std::move(data)} {}
+
+  void ReadExact(std::byte*, std::size_t) override {
+    throw std::runtime_error{"CountingReader does not support ReadExact"};
+  }
+  std::size_t ReadSome(std::byte* buffer, std::size_t max_length) override {
+    ++read_count_;
+    return data_.ReadSome(buffer, max_length);
+  }
+  Result ReadSome(std::byte* buffer, std::size_t max_length,
+                  std::chrono::milliseconds) override {
+    const auto read_size = ReadSome(buffer, max_length);
+    return {read_size, read_size > 0 ? Status::Ok : Status::Timeout};
+  }
+
+  std::size_t ReadCount() const { return read_count_; }
+
+ private:
+  detail::Buffer data_;
+  std::size_t read_count_{};
+};
+
+TEST(ZstdStreamTests, TestDecodeInitialBufferBeforeReading) {
+  std::vector<std::int64_t> source_data;
+  for (std::int64_t i = 0; i < 10'000; ++i) {
+    source_data.emplace_back(i);
+  }
+  // Like a live session where the compressed data was received with the
+  // authentication response
+  auto in_buffer = CompressFrames(source_data, 10'000);
+  auto reader = std::make_unique<CountingReader>();
+  const auto& reader_ref = *reader;
+  ZstdDecodeStream target{std::move(reader), in_buffer};
+  std::vector<std::int64_t> res(source_data.size());
+  auto* res_bytes = reinterpret_cast<std::byte*>(res.data());
+  // Small reads so decompressed data is left over between reads
+  constexpr std::size_t kReadSize = 64;
+  const auto size = res.size() * sizeof(std::int64_t);
+  for (std::size_t pos = 0; pos < size; pos += kReadSize) {
+    target.ReadExact(&res_bytes[pos], kReadSize);
+  }
+  EXPECT_EQ(res, source_data);
+  // Shouldn't wait on the inner reader while there's buffered data
+  EXPECT_EQ(reader_ref.ReadCount(), 0);
+  EXPECT_EQ(target.ReadSome(res_bytes, kReadSize, std::chrono::milliseconds{1}).status,
+            IReadable::Status::Timeout);
+}
+
+TEST(ZstdStreamTests, TestDecodeReadInputBeforeReading) {
+  std::vector<std::int64_t> source_data;
+  for (std::int64_t i = 0; i < 10'000; ++i) {
+    source_data.emplace_back(i);
+  }
+  // Like a live session where the gateway sent all its data in one read and then
+  // has nothing more to send
+  auto reader = std::make_unique<CountingReader>(CompressFrames(source_data, 10'000));
+  const auto& reader_ref = *reader;
+  ZstdDecodeStream target{std::move(reader)};
+  std::vector<std::int64_t> res(source_data.size());
+  auto* res_bytes = reinterpret_cast<std::byte*>(res.data());
+  constexpr std::size_t kReadSize = 64;
+  const auto size = res.size() * sizeof(std::int64_t);
+  std::size_t pos{};
+  while (pos < size) {
+    const auto read_res = target.ReadSome(
+        &res_bytes[pos], std::min(kReadSize, size - pos), std::chrono::milliseconds{1});
+    ASSERT_EQ(read_res.status, IReadable::Status::Ok) << "at pos = " << pos;
+    pos += read_res.read_size;
+  }
+  EXPECT_EQ(res, source_data);
+  // Only read from the inner reader when out of compressed data
+  EXPECT_LT(reader_ref.ReadCount(), res.size() * sizeof(std::int64_t) / kReadSize);
+  EXPECT_EQ(target.ReadSome(res_bytes, kReadSize, std::chrono::milliseconds{1}).status,
+            IReadable::Status::Timeout);
+}
+
 TEST(ZstdStreamTests, TestDecodeTimeout) {
   ZstdDecodeStream target{std::make_unique<TimeoutReader>()};
 
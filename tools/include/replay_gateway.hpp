@@ -0,0 +1,115 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>  // unique_ptr
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "databento/dbn.hpp"                // Metadata
+#include "databento/detail/scoped_fd.hpp"  // ScopedFd
+#include "databento/enums.hpp"             // ErrorCode, SType, SystemCode
+#include "databento/record.hpp"            // RecordHeader
+
+// Forward declare
+namespace databento {
+class ILogReceiver;
+}  // namespace databento
+
+namespace databento::tools {
+struct ReplayGatewayConf {
+  // The DBN file to serve, optionally Zstd-compressed.
+  std::string file_path;
+  // The IPv4 address to listen on.
+  std::string address{"127.0.0.1"};
+  // The port to listen on. 0 picks a free port, see `ReplayGateway::Port()`.
+  std::uint16_t port{};
+  // The replay speed relative to the spacing of the records' index timestamps, e.g.
+  // 1 for the original pace and 10 for ten times faster. 0 sends records as fast as
+  // the client reads them.
+  double speed{1.0};
+  // When not empty, only clients authenticating with this API key are accepted.
+  // Otherwise any key is accepted.
+  std::string key;
+  // The number of bytes buffered for each client before waiting for the socket to
+  // be writable.
+  std::size_t send_buffer_size{std::size_t{1} << 20};
+};
+
+// A gateway speaking the live subscription gateway protocol that serves the
+// records of a DBN file to `LiveBlocking` and `LiveThreaded` clients. Each client
+// session replays the file from the beginning independently, filtered to the
+// schemas and symbols it subscribed to, with `ts_out` and Zstd compression
+// supported. Sessions are sent a `ReplayCompleted` system message after the last
+// record and heartbeats for as long as they stay connected.
+//
+// Symbols are resolved with the file's symbology mappings, so subscriptions must
+// use the file's `stype_in` or `SType::InstrumentId`. Snapshots aren't supported.
+//
+// Only supported on Linux.
+class ReplayGateway {
+ public:
+  // Binds and listens on the configured address. Throws `InvalidArgumentError` if
+  // the file isn't valid DBN or `conf` is invalid.
+  ReplayGateway(ILogReceiver* log_receiver, ReplayGatewayConf conf);
+  ReplayGateway(const ReplayGateway&) = delete;
+  ReplayGateway& operator=(const ReplayGateway&) = delete;
+  ReplayGateway(ReplayGateway&&) = delete;
+  ReplayGateway& operator=(ReplayGateway&&) = delete;
+  ~ReplayGateway();
+
+  std::uint16_t Port() const { return port_; }
+  const Metadata& FileMetadata() const { return metadata_; }
+
+  // Serves clients on the calling thread until `Stop` is called.
+  void Run();
+  // Signals `Run` to return. Safe to call from any thread and from signal
+  // handlers.
+  void Stop();
+
+ private:
+  struct Session;
+  struct Subscription;
+
+  void Accept();
+  void Close(int fd);
+  // Returns false if the session was closed.
+  bool Receive(Session& session);
+  void HandleRequest(Session& session, const std::string& request);
+  void Authenticate(Session& session, const std::string& request);
+  void Subscribe(Session& session, const std::string& request);
+  void StartSession(Session& session);
+  void Resolve(Session& session, const Subscription& subscription);
+  // Writes records to the session's output buffer until it's full or the next
+  // record isn't due yet.
+  void FillOutput(Session& session, std::chrono::steady_clock::time_point now);
+  void WriteRecord(Session& session, const RecordHeader& record,
+                   std::size_t size) const;
+  void WriteSymbolMapping(Session& session, SType stype_in,
+                          const std::string& stype_in_symbol,
+                          std::uint32_t instrument_id) const;
+  void WriteSystem(Session& session, SystemCode code, const std::string& msg) const;
+  void WriteError(Session& session, ErrorCode code, const std::string& msg) const;
+  // Sends as much to `session` as is due and the socket accepts, and updates which
+  // events it's polled for. Returns false if the session was closed.
+  bool Pump(Session& session, std::chrono::steady_clock::time_point now);
+  void ArmTimer();
+
+  ILogReceiver* log_receiver_;
+  const ReplayGatewayConf conf_;
+  Metadata metadata_;
+  // Instrument IDs for each `stype_in` symbol in the file's mappings
+  std::unordered_map<std::string, std::vector<std::uint32_t>> symbol_ids_;
+  // The `stype_in` symbol of each instrument in the file's mappings
+  std::unordered_map<std::uint32_t, std::string> instrument_symbols_;
+  std::uint16_t port_{};
+  std::uint64_t next_session_id_{1};
+  detail::ScopedFd listen_fd_;
+  detail::ScopedFd epoll_fd_;
+  detail::ScopedFd timer_fd_;
+  detail::ScopedFd stop_fd_;
+  std::unordered_map<int, std::unique_ptr<Session>> sessions_;
+};
+}  // namespace databento::tools
@@ -0,0 +1,103 @@
+// Serves a DBN file to live clients over the live subscription gateway protocol.
+#include <csignal>  // signal, SIGINT, SIGTERM
+#include <cstdint>
+#include <cstdlib>  // EXIT_FAILURE, EXIT_SUCCESS
+#include <exception>
+#include <iostream>
+#include <stdexcept>  // invalid_argument
+#include <string>
+
+#include "databento/dbn.hpp"    // Metadata
+#include "databento/enums.hpp"  // ToString
+#include "databento/log.hpp"    // ConsoleLogReceiver, LogLevel
+#include "replay_gateway.hpp"
+
+namespace db = databento;
+
+namespace {
+db::tools::ReplayGateway* gateway{};
+
+void HandleSignal(int) {
+  if (gateway) {
+    gateway->Stop();
+  }
+}
+
+void PrintUsage(const char* program) {
+  std::cerr
+      << "Usage: " << program << " [OPTIONS] FILE\n"
+      << "Serves the records of the DBN file FILE, optionally Zstd-compressed, to\n"
+      << "live clients.\n\n"
+      << "Options:\n"
+      << "  --address ADDRESS  IPv4 address to listen on [default: 127.0.0.1]\n"
+      << "  --port PORT        Port to listen on, 0 for any free port [default: "
+         "13000]\n"
+      << "  --speed SPEED      Replay speed relative to the records' original pace, "
+         "0 for\n"
+      << "                     as fast as clients can read [default: 1]\n"
+      << "  --key KEY          Only accept clients authenticating with this API key\n"
+      << "  -v, --verbose      Log each request\n"
+      << "  -h, --help         Print this message\n";
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  db::tools::ReplayGatewayConf conf{};
+  conf.port = 13000;
+  auto log_level = db::LogLevel::Info;
+  try {
+    for (int i = 1; i < argc; ++i) {
+      const std::string arg = argv[i];
+      const auto next_value = [&] {
+        if (i + 1 >= argc) {
+          throw std::invalid_argument{"missing value for " + arg};
+        }
+        return std::string{argv[++i]};
+      };
+      if (arg == "-h" || arg == "--help") {
+        PrintUsage(argv[0]);
+        return EXIT_SUCCESS;
+      } else if (arg == "--address") {
+        conf.address = next_value();
+      } else if (arg == "--port") {
+        conf.port = static_cast<std::uint16_t>(std::stoul(next_value()));
+      } else if (arg == "--speed") {
+        conf.speed = std::stod(next_value());
+      } else if (arg == "--key") {
+        conf.key = next_value();
+      } else if (arg == "-v" || arg == "--verbose") {
+        log_level = db::LogLevel::Debug;
+      } else if (conf.file_path.empty() && arg.rfind('-', 0) != 0) {
+        conf.file_path = arg;
+      } else {
+        throw std::invalid_argument{"unexpected argument " + arg};
+      }
+    }
+    if (conf.file_path.empty()) {
+      throw std::invalid_argument{"missing FILE"};
+    }
+  } catch (const std::exception& exc) {
+    std::cerr << "Error: " << exc.what() << "\n\n";
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  try {
+    db::ConsoleLogReceiver log_receiver{log_level};
+    db::tools::ReplayGateway replay_gateway{&log_receiver, conf};
+    gateway = &replay_gateway;
+    std::signal(SIGINT, HandleSignal);
+    std::signal(SIGTERM, HandleSignal);
+    const auto& metadata = replay_gateway.FileMetadata();
+    std::cout << "Serving " << metadata.dataset << ' '
+              << (metadata.schema ? db::ToString(*metadata.schema) : "mixed-schema")
+              << " data from " << conf.file_path << " on " << conf.address << ':'
+              << replay_gateway.Port() << std::endl;
+    replay_gateway.Run();
+    gateway = nullptr;
+  } catch (const std::exception& exc) {
+    std::cerr << "Error: " << exc.what() << '\n';
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
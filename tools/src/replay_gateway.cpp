@@ -0,0 +1,799 @@
+#include "replay_gateway.hpp"
+
+#include <arpa/inet.h>    // htons, inet_pton, ntohs
+#include <netinet/in.h>   // IPPROTO_TCP, sockaddr_in
+#include <netinet/tcp.h>  // TCP_NODELAY
+#include <sys/epoll.h>    // epoll_create1, epoll_ctl, epoll_event, epoll_wait
+#include <sys/eventfd.h>  // eventfd
+#include <sys/socket.h>   // accept4, bind, listen, recv, send, setsockopt, socket
+#include <sys/timerfd.h>  // timerfd_create, timerfd_settime
+#include <unistd.h>       // read, write
+
+#include <algorithm>  // min
+#include <array>
+#include <cerrno>   // errno
+#include <cstring>  // strerror, strncpy
+#include <exception>
+#include <limits>
+#include <optional>
+#include <random>  // mt19937, random_device, uniform_int_distribution
+#include <sstream>
+#include <unordered_set>
+#include <utility>  // move
+
+#include "databento/constants.hpp"     // kApiKeyLength, kUndefTimestamp
+#include "databento/datetime.hpp"      // UnixNanos
+#include "databento/dbn_decoder.hpp"   // DbnDecoder
+#include "databento/dbn_encoder.hpp"   // DbnEncoder
+#include "databento/detail/buffer.hpp"  // Buffer
+#include "databento/detail/sha256_hasher.hpp"  // Sha256Hash
+#include "databento/detail/zstd_stream.hpp"    // ZstdCompressStream
+#include "databento/exceptions.hpp"  // Exception, InvalidArgumentError, TcpError
+#include "databento/file_stream.hpp"     // InFileStream
+#include "databento/log.hpp"             // ILogReceiver, LogLevel
+#include "databento/symbology.hpp"       // kAllSymbols
+#include "databento/version.hpp"         // DATABENTO_VERSION
+
+using databento::tools::ReplayGateway;
+
+namespace {
+constexpr std::size_t kBucketIdLength = 5;
+constexpr std::size_t kChallengeLength = 32;
+// Requests are short lines, so a client sending more without a newline is
+// misbehaving
+constexpr std::size_t kMaxRequestLength = 1 << 16;
+constexpr std::chrono::seconds kDefaultHeartbeatInterval{30};
+
+// Splits a request of `key=value` pairs separated by `|`.
+std::vector<std::pair<std::string, std::string>> ParseRequest(
+    const std::string& request) {
+  std::vector<std::pair<std::string, std::string>> res;
+  std::istringstream stream{request};
+  std::string kv_pair;
+  while (std::getline(stream, kv_pair, '|')) {
+    const auto eq_pos = kv_pair.find('=');
+    if (eq_pos == std::string::npos) {
+      continue;
+    }
+    res.emplace_back(kv_pair.substr(0, eq_pos), kv_pair.substr(eq_pos + 1));
+  }
+  return res;
+}
+
+std::string GenerateChallenge() {
+  static constexpr char kAlphabet[] =
+      "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+  std::mt19937 rng{std::random_device{}()};
+  std::uniform_int_distribution<std::size_t> dist{0, sizeof(kAlphabet) - 2};
+  std::string challenge(kChallengeLength, '\0');
+  for (auto& c : challenge) {
+    c = kAlphabet[dist(rng)];
+  }
+  return challenge;
+}
+
+template <std::size_t N>
+void CopyCStr(std::array<char, N>& dest, const std::string& src) {
+  std::strncpy(dest.data(), src.c_str(), N - 1);
+  dest[N - 1] = '\0';
+}
+
+timespec ToTimespec(std::chrono::steady_clock::time_point time) {
+  const auto since_epoch = time.time_since_epoch();
+  const auto secs = std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+  const auto nanos =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch - secs);
+  return timespec{secs.count(), nanos.count()};
+}
+}  // namespace
+
+namespace databento::tools {
+struct ReplayGateway::Subscription {
+  Schema schema;
+  SType stype_in;
+  std::string id;
+  std::vector<std::string> symbols;
+  std::optional<UnixNanos> start;
+  bool is_last;
+  // Set if the request was invalid
+  std::string error;
+};
+
+struct ReplayGateway::Session {
+  enum class State : std::uint8_t { Authenticating, Subscribing, Streaming };
+  // The instruments subscribed to for an rtype
+  struct Filter {
+    bool all_symbols{};
+    std::unordered_set<std::uint32_t> instrument_ids;
+  };
+
+  Session(detail::ScopedFd fd_, std::uint64_t id_)
+      : fd{std::move(fd_)}, id{id_}, challenge{GenerateChallenge()} {}
+
+  IWritable* Output() {
+    if (zstd) {
+      return zstd.get();
+    }
+    return &out;
+  }
+
+  detail::ScopedFd fd;
+  const std::uint64_t id;
+  const std::string challenge;
+  State state{State::Authenticating};
+  // Close once the output buffer has been sent
+  bool closing{};
+  std::uint32_t events{};
+  // Received bytes not yet terminated by a newline
+  std::string received;
+
+  bool ts_out{};
+  Compression compression{Compression::None};
+  std::chrono::seconds heartbeat_interval{kDefaultHeartbeatInterval};
+  // Subscriptions received before the session was started
+  std::vector<Subscription> subscriptions;
+  std::unordered_map<std::uint8_t, Filter> filters;
+  // Records before the earliest subscription `start` are skipped
+  UnixNanos skip_before{std::chrono::nanoseconds{kUndefTimestamp}};
+
+  std::unique_ptr<DbnDecoder> decoder;
+  // The next record to send, which isn't due yet or didn't fit in the buffer
+  const Record* next{};
+  bool replay_completed{};
+  // The pace is relative to the first record sent
+  std::optional<UnixNanos> first_ts;
+  std::chrono::steady_clock::time_point first_time;
+  std::chrono::steady_clock::time_point last_write_time;
+  // When the next record is due or a heartbeat should be sent
+  std::chrono::steady_clock::time_point deadline{
+      std::chrono::steady_clock::time_point::max()};
+
+  detail::Buffer out;
+  std::unique_ptr<detail::ZstdCompressStream> zstd;
+};
+}  // namespace databento::tools
+
+ReplayGateway::ReplayGateway(ILogReceiver* log_receiver, ReplayGatewayConf conf)
+    : log_receiver_{log_receiver}, conf_{std::move(conf)} {
+  static constexpr auto kMethodName = "ReplayGateway::ReplayGateway";
+  if (!(conf_.speed >= 0)) {
+    throw InvalidArgumentError{kMethodName, "speed", "must be non-negative"};
+  }
+  if (!conf_.key.empty() && conf_.key.length() != kApiKeyLength) {
+    throw InvalidArgumentError{kMethodName, "key",
+                               "must contain " + std::to_string(kApiKeyLength) +
+                                   " characters"};
+  }
+  if (conf_.send_buffer_size == 0) {
+    throw InvalidArgumentError{kMethodName, "send_buffer_size", "must be positive"};
+  }
+  try {
+    DbnDecoder decoder{log_receiver_, std::make_unique<InFileStream>(conf_.file_path),
+                       VersionUpgradePolicy::UpgradeToV3};
+    metadata_ = decoder.DecodeMetadata();
+  } catch (const Exception& exc) {
+    throw InvalidArgumentError{kMethodName, "file_path", exc.what()};
+  }
+  if (metadata_.stype_out == SType::InstrumentId) {
+    for (const auto& mapping : metadata_.mappings) {
+      auto& ids = symbol_ids_[mapping.raw_symbol];
+      for (const auto& interval : mapping.intervals) {
+        try {
+          const auto id = static_cast<std::uint32_t>(std::stoul(interval.symbol));
+          ids.emplace_back(id);
+          instrument_symbols_.emplace(id, mapping.raw_symbol);
+        } catch (const std::exception&) {
+          // Skip intervals without an instrument ID
+        }
+      }
+    }
+  }
+
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(conf_.port);
+  if (::inet_pton(AF_INET, conf_.address.c_str(), &addr.sin_addr) != 1) {
+    throw InvalidArgumentError{kMethodName, "address", "must be an IPv4 address"};
+  }
+  listen_fd_ = detail::ScopedFd{
+      ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)};
+  if (listen_fd_.Get() < 0) {
+    throw TcpError{errno, "Failed to create listening socket"};
+  }
+  const int enable = 1;
+  ::setsockopt(listen_fd_.Get(), SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+  if (::bind(listen_fd_.Get(), reinterpret_cast<const sockaddr*>(&addr),
+             sizeof(addr)) != 0) {
+    throw TcpError{errno, "Failed to bind to " + conf_.address + ':' +
+                              std::to_string(conf_.port)};
+  }
+  if (::listen(listen_fd_.Get(), SOMAXCONN) != 0) {
+    throw TcpError{errno, "Failed to listen"};
+  }
+  auto addr_len = static_cast<socklen_t>(sizeof(addr));
+  ::getsockname(listen_fd_.Get(), reinterpret_cast<sockaddr*>(&addr), &addr_len);
+  port_ = ntohs(addr.sin_port);
+
+  epoll_fd_ = detail::ScopedFd{::epoll_create1(EPOLL_CLOEXEC)};
+  timer_fd_ = detail::ScopedFd{
+      ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)};
+  stop_fd_ = detail::ScopedFd{::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)};
+  if (epoll_fd_.Get() < 0 || timer_fd_.Get() < 0 || stop_fd_.Get() < 0) {
+    throw TcpError{errno, "Failed to create event file descriptors"};
+  }
+  for (const int fd : {listen_fd_.Get(), timer_fd_.Get(), stop_fd_.Get()}) {
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (::epoll_ctl(epoll_fd_.Get(), EPOLL_CTL_ADD, fd, &event) != 0) {
+      throw TcpError{errno, "Failed to register with epoll"};
+    }
+  }
+}
+
+ReplayGateway::~ReplayGateway() = default;
+
+void ReplayGateway::Run() {
+  std::array<epoll_event, 64> events{};
+  while (true) {
+    ArmTimer();
+    const int event_count = ::epoll_wait(epoll_fd_.Get(), events.data(),
+                                         static_cast<int>(events.size()), -1);
+    if (event_count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw TcpError{errno, "Failed to wait on epoll"};
+    }
+    const auto now = std::chrono::steady_clock::now();
+    for (int i = 0; i < event_count; ++i) {
+      const auto& event = events[static_cast<std::size_t>(i)];
+      const int fd = event.data.fd;
+      if (fd == stop_fd_.Get()) {
+        std::uint64_t count{};
+        ::read(stop_fd_.Get(), &count, sizeof(count));
+        return;
+      }
+      if (fd == listen_fd_.Get()) {
+        Accept();
+        continue;
+      }
+      if (fd == timer_fd_.Get()) {
+        std::uint64_t expirations{};
+        ::read(timer_fd_.Get(), &expirations, sizeof(expirations));
+        std::vector<int> due;
+        for (const auto& [session_fd, session] : sessions_) {
+          if (session->deadline <= now) {
+            due.emplace_back(session_fd);
+          }
+        }
+        for (const int session_fd : due) {
+          const auto it = sessions_.find(session_fd);
+          if (it != sessions_.end()) {
+            Pump(*it->second, now);
+          }
+        }
+        continue;
+      }
+      // May have been closed while handling an earlier event
+      const auto it = sessions_.find(fd);
+      if (it == sessions_.end()) {
+        continue;
+      }
+      auto& session = *it->second;
+      if (event.events & (EPOLLERR | EPOLLHUP)) {
+        Close(fd);
+        continue;
+      }
+      if ((event.events & EPOLLIN) && !Receive(session)) {
+        continue;
+      }
+      Pump(session, now);
+    }
+  }
+}
+
+void ReplayGateway::Stop() {
+  const std::uint64_t count = 1;
+  // Can't fail unless the counter overflows
+  static_cast<void>(::write(stop_fd_.Get(), &count, sizeof(count)));
+}
+
+void ReplayGateway::Accept() {
+  while (true) {
+    detail::ScopedFd fd{
+        ::accept4(listen_fd_.Get(), nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)};
+    if (fd.Get() < 0) {
+      if (errno != EAGAIN && errno != EINTR) {
+        log_receiver_->Receive(LogLevel::Warning,
+                               std::string{"[ReplayGateway::Accept] Failed to "
+                                           "accept connection: "} +
+                                   std::strerror(errno));
+      }
+      return;
+    }
+    const int enable = 1;
+    ::setsockopt(fd.Get(), IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    const int raw_fd = fd.Get();
+    auto session = std::make_unique<Session>(std::move(fd), next_session_id_++);
+    const std::string greeting = "lsg_version=" DATABENTO_VERSION "-replay\ncram=" +
+                                 session->challenge + '\n';
+    session->out.WriteAll(greeting.data(), greeting.length());
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = raw_fd;
+    if (::epoll_ctl(epoll_fd_.Get(), EPOLL_CTL_ADD, raw_fd, &event) != 0) {
+      throw TcpError{errno, "Failed to register with epoll"};
+    }
+    session->events = EPOLLIN;
+    auto& session_ref = *session;
+    sessions_.emplace(raw_fd, std::move(session));
+    if (log_receiver_->ShouldLog(LogLevel::Info)) {
+      std::ostringstream log_ss;
+      log_ss << "[ReplayGateway::Accept] Accepted connection for session "
+             << session_ref.id;
+      log_receiver_->Receive(LogLevel::Info, log_ss.str());
+    }
+    Pump(session_ref, std::chrono::steady_clock::now());
+  }
+}
+
+void ReplayGateway::Close(int fd) {
+  const auto it = sessions_.find(fd);
+  if (it == sessions_.end()) {
+    return;
+  }
+  ::epoll_ctl(epoll_fd_.Get(), EPOLL_CTL_DEL, fd, nullptr);
+  if (log_receiver_->ShouldLog(LogLevel::Info)) {
+    std::ostringstream log_ss;
+    log_ss << "[ReplayGateway::Close] Closed session " << it->second->id;
+    log_receiver_->Receive(LogLevel::Info, log_ss.str());
+  }
+  sessions_.erase(it);
+}
+
+bool ReplayGateway::Receive(Session& session) {
+  std::array<char, 4096> buffer{};
+  while (true) {
+    const auto read_size = ::recv(session.fd.Get(), buffer.data(), buffer.size(), 0);
+    if (read_size == 0) {
+      Close(session.fd.Get());
+      return false;
+    }
+    if (read_size < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN) {
+        break;
+      }
+      Close(session.fd.Get());
+      return false;
+    }
+    session.received.append(buffer.data(), static_cast<std::size_t>(read_size));
+  }
+  std::size_t pos{};
+  std::size_t newline_pos;
+  while (!session.closing &&
+         (newline_pos = session.received.find('\n', pos)) != std::string::npos) {
+    HandleRequest(session, session.received.substr(pos, newline_pos - pos));
+    pos = newline_pos + 1;
+  }
+  session.received.erase(0, pos);
+  if (session.received.size() > kMaxRequestLength) {
+    log_receiver_->Receive(LogLevel::Warning,
+                           "[ReplayGateway::Receive] Closing session that sent an "
+                           "overlong request");
+    Close(session.fd.Get());
+    return false;
+  }
+  return true;
+}
+
+void ReplayGateway::HandleRequest(Session& session, const std::string& request) {
+  if (log_receiver_->ShouldLog(LogLevel::Debug)) {
+    std::ostringstream log_ss;
+    log_ss << "[ReplayGateway::HandleRequest] Session " << session.id
+           << " sent: " << request;
+    log_receiver_->Receive(LogLevel::Debug, log_ss.str());
+  }
+  if (session.state == Session::State::Authenticating) {
+    Authenticate(session, request);
+  } else if (request == "start_session") {
+    if (session.state == Session::State::Subscribing) {
+      StartSession(session);
+    }
+  } else if (request.compare(0, 7, "schema=") == 0) {
+    Subscribe(session, request);
+  } else if (session.state == Session::State::Streaming) {
+    WriteError(session, ErrorCode::InvalidSubscription,
+               "Unrecognized request: " + request);
+  } else {
+    // No way to report the error to the client before the session starts
+    session.closing = true;
+  }
+}
+
+void ReplayGateway::Authenticate(Session& session, const std::string& request) {
+  std::string error;
+  bool found_auth{};
+  for (const auto& [key, value] : ParseRequest(request)) {
+    if (key == "auth") {
+      found_auth = true;
+      if (!conf_.key.empty()) {
+        const auto expected =
+            detail::Sha256Hash(session.challenge + '|' + conf_.key) + '-' +
+            conf_.key.substr(kApiKeyLength - kBucketIdLength);
+        if (value != expected) {
+          error = "Authentication failed";
+        }
+      }
+    } else if (key == "dataset") {
+      if (!metadata_.dataset.empty() && value != metadata_.dataset) {
+        error = "Dataset " + value + " isn't available, expected " +
+                metadata_.dataset;
+      }
+    } else if (key == "encoding") {
+      if (value != "dbn") {
+        error = "Unsupported encoding " + value;
+      }
+    } else if (key == "ts_out") {
+      session.ts_out = value == "1";
+    } else if (key == "compression") {
+      try {
+        session.compression = FromString<Compression>(value);
+      } catch (const InvalidArgumentError&) {
+        error = "Unsupported compression " + value;
+      }
+    } else if (key == "heartbeat_interval_s") {
+      try {
+        session.heartbeat_interval = std::chrono::seconds{std::stoul(value)};
+      } catch (const std::exception&) {
+        error = "Invalid heartbeat_interval_s " + value;
+      }
+    }
+  }
+  if (!found_auth) {
+    error = "Expected CRAM reply";
+  }
+  std::string response;
+  if (error.empty()) {
+    session.state = Session::State::Subscribing;
+    response = "success=1|session_id=" + std::to_string(session.id) + "|\n";
+  } else {
+    session.closing = true;
+    response = "success=0|error=" + error + "|\n";
+    log_receiver_->Receive(LogLevel::Warning,
+                           "[ReplayGateway::Authenticate] Rejected session: " + error);
+  }
+  session.out.WriteAll(response.data(), response.length());
+}
+
+void ReplayGateway::Subscribe(Session& session, const std::string& request) {
+  Subscription subscription{Schema::Mbo, SType::RawSymbol, {}, {}, {}, true, {}};
+  bool has_schema{};
+  try {
+    for (const auto& [key, value] : ParseRequest(request)) {
+      if (key == "schema") {
+        subscription.schema = FromString<Schema>(value);
+        has_schema = true;
+      } else if (key == "stype_in") {
+        subscription.stype_in = FromString<SType>(value);
+      } else if (key == "id") {
+        subscription.id = value;
+      } else if (key == "symbols") {
+        std::istringstream stream{value};
+        std::string symbol;
+        while (std::getline(stream, symbol, ',')) {
+          subscription.symbols.emplace_back(std::move(symbol));
+        }
+      } else if (key == "start") {
+        subscription.start = UnixNanos{std::chrono::nanoseconds{std::stoull(value)}};
+      } else if (key == "snapshot" && value == "1") {
+        subscription.error = "Snapshots aren't supported when replaying a file";
+      } else if (key == "is_last") {
+        subscription.is_last = value == "1";
+      }
+    }
+    if (!has_schema) {
+      subscription.error = "Missing schema";
+    }
+  } catch (const std::exception&) {
+    subscription.error = "Invalid subscription request: " + request;
+  }
+  if (session.state == Session::State::Streaming) {
+    Resolve(session, subscription);
+  } else {
+    session.subscriptions.emplace_back(std::move(subscription));
+  }
+}
+
+void ReplayGateway::StartSession(Session& session) {
+  session.decoder = std::make_unique<DbnDecoder>(
+      log_receiver_, std::make_unique<InFileStream>(conf_.file_path),
+      VersionUpgradePolicy::UpgradeToV3);
+  session.decoder->DecodeMetadata();
+  if (session.compression == Compression::Zstd) {
+    session.zstd = std::make_unique<detail::ZstdCompressStream>(&session.out);
+  }
+
+  auto metadata = metadata_;
+  metadata.ts_out = session.ts_out;
+  metadata.end = UnixNanos{std::chrono::nanoseconds{kUndefTimestamp}};
+  metadata.limit = 0;
+  metadata.schema.reset();
+  metadata.stype_in.reset();
+  if (!session.subscriptions.empty()) {
+    metadata.schema = session.subscriptions.front().schema;
+    metadata.stype_in = session.subscriptions.front().stype_in;
+    for (const auto& subscription : session.subscriptions) {
+      if (subscription.schema != metadata.schema) {
+        metadata.schema.reset();
+      }
+      if (subscription.stype_in != metadata.stype_in) {
+        metadata.stype_in.reset();
+      }
+    }
+  }
+  metadata.symbols.clear();
+  metadata.partial.clear();
+  metadata.not_found.clear();
+  metadata.mappings.clear();
+  DbnEncoder::EncodeMetadata(metadata, session.Output());
+
+  session.state = Session::State::Streaming;
+  session.last_write_time = std::chrono::steady_clock::now();
+  for (const auto& subscription : session.subscriptions) {
+    Resolve(session, subscription);
+  }
+  session.subscriptions.clear();
+  if (log_receiver_->ShouldLog(LogLevel::Info)) {
+    std::ostringstream log_ss;
+    log_ss << "[ReplayGateway::StartSession] Started session " << session.id;
+    log_receiver_->Receive(LogLevel::Info, log_ss.str());
+  }
+}
+
+void ReplayGateway::Resolve(Session& session, const Subscription& subscription) {
+  if (!subscription.error.empty()) {
+    WriteError(session, ErrorCode::InvalidSubscription, subscription.error);
+    return;
+  }
+  const auto rtype =
+      static_cast<std::uint8_t>(Record::RTypeFromSchema(subscription.schema));
+  auto& filter = session.filters[rtype];
+  std::vector<std::string> not_found;
+  for (const auto& symbol : subscription.symbols) {
+    if (symbol == kAllSymbols[0]) {
+      filter.all_symbols = true;
+      for (const auto& [instrument_id, file_symbol] : instrument_symbols_) {
+        WriteSymbolMapping(session, subscription.stype_in, file_symbol, instrument_id);
+      }
+    } else if (subscription.stype_in == SType::InstrumentId) {
+      try {
+        const auto instrument_id = static_cast<std::uint32_t>(std::stoul(symbol));
+        filter.instrument_ids.emplace(instrument_id);
+        WriteSymbolMapping(session, subscription.stype_in, symbol, instrument_id);
+      } catch (const std::exception&) {
+        not_found.emplace_back(symbol);
+      }
+    } else if (const auto it = symbol_ids_.find(symbol);
+               subscription.stype_in == metadata_.stype_in && it != symbol_ids_.end()) {
+      for (const auto instrument_id : it->second) {
+        filter.instrument_ids.emplace(instrument_id);
+        WriteSymbolMapping(session, subscription.stype_in, symbol, instrument_id);
+      }
+    } else {
+      not_found.emplace_back(symbol);
+    }
+  }
+  if (!not_found.empty()) {
+    std::ostringstream err_ss;
+    err_ss << "Failed to resolve symbols: ";
+    for (std::size_t i = 0; i < not_found.size(); ++i) {
+      err_ss << (i == 0 ? "" : ", ") << not_found[i];
+    }
+    WriteError(session, ErrorCode::SymbolResolutionFailed, err_ss.str());
+  }
+  session.skip_before =
+      std::min(session.skip_before, subscription.start.value_or(UnixNanos{}));
+  if (subscription.is_last) {
+    WriteSystem(session, SystemCode::SubscriptionAck,
+                "Subscription request " + subscription.id + " for " +
+                    ToString(subscription.schema) + " data succeeded");
+  }
+}
+
+void ReplayGateway::FillOutput(Session& session,
+                               std::chrono::steady_clock::time_point now) {
+  session.deadline = std::chrono::steady_clock::time_point::max();
+  // Records in files written with `ts_out` carry the original `ts_out`, which is
+  // replaced
+  const std::size_t file_ts_out_size = metadata_.ts_out ? sizeof(UnixNanos) : 0;
+  while (session.out.ReadCapacity() < conf_.send_buffer_size) {
+    if (!session.next) {
+      while (const auto* record = session.decoder->DecodeRecord()) {
+        const auto filter_it = session.filters.find(
+            static_cast<std::uint8_t>(record->RType()));
+        if (filter_it == session.filters.end() ||
+            !(filter_it->second.all_symbols ||
+              filter_it->second.instrument_ids.count(
+                  record->Header().instrument_id))) {
+          continue;
+        }
+        if (record->IndexTs() < session.skip_before) {
+          continue;
+        }
+        session.next = record;
+        break;
+      }
+      if (!session.next) {
+        if (!session.replay_completed) {
+          session.replay_completed = true;
+          WriteSystem(session, SystemCode::ReplayCompleted,
+                      "Finished replaying " + metadata_.dataset + " data");
+        }
+        break;
+      }
+    }
+    if (conf_.speed > 0) {
+      const auto ts = session.next->IndexTs();
+      if (!session.first_ts) {
+        session.first_ts = ts;
+        session.first_time = now;
+      }
+      const auto due =
+          session.first_time +
+          std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+              std::chrono::duration<double, std::nano>{
+                  static_cast<double>((ts - *session.first_ts).count()) /
+                  conf_.speed});
+      if (due > now) {
+        session.deadline = due;
+        break;
+      }
+    }
+    WriteRecord(session, session.next->Header(),
+                session.next->Size() - file_ts_out_size);
+    session.next = nullptr;
+  }
+  if (session.out.ReadCapacity() >= conf_.send_buffer_size) {
+    // More to send as soon as the socket is writable
+    session.deadline = now;
+  }
+}
+
+void ReplayGateway::WriteRecord(Session& session, const RecordHeader& record,
+                                std::size_t size) const {
+  auto* output = session.Output();
+  const auto* bytes = reinterpret_cast<const std::byte*>(&record);
+  auto header = record;
+  if (session.ts_out) {
+    header.length = static_cast<std::uint8_t>((size + sizeof(UnixNanos)) /
+                                              RecordHeader::kLengthMultiplier);
+  } else {
+    header.length = static_cast<std::uint8_t>(size / RecordHeader::kLengthMultiplier);
+  }
+  output->WriteAll(reinterpret_cast<const std::byte*>(&header), sizeof(header));
+  output->WriteAll(bytes + sizeof(header), size - sizeof(header));
+  if (session.ts_out) {
+    const UnixNanos ts_out{std::chrono::system_clock::now().time_since_epoch()};
+    output->WriteAll(reinterpret_cast<const std::byte*>(&ts_out), sizeof(ts_out));
+  }
+  session.last_write_time = std::chrono::steady_clock::now();
+}
+
+void ReplayGateway::WriteSymbolMapping(Session& session, SType stype_in,
+                                       const std::string& stype_in_symbol,
+                                       std::uint32_t instrument_id) const {
+  SymbolMappingMsg mapping{};
+  mapping.hd = RecordHeader{
+      static_cast<std::uint8_t>(sizeof(mapping) / RecordHeader::kLengthMultiplier),
+      RType::SymbolMapping, 0, instrument_id, metadata_.start};
+  mapping.stype_in = stype_in;
+  CopyCStr(mapping.stype_in_symbol, stype_in_symbol);
+  mapping.stype_out = metadata_.stype_in.value_or(SType::RawSymbol);
+  const auto it = instrument_symbols_.find(instrument_id);
+  CopyCStr(mapping.stype_out_symbol, it == instrument_symbols_.end()
+                                         ? std::to_string(instrument_id)
+                                         : it->second);
+  mapping.start_ts = metadata_.start;
+  mapping.end_ts = metadata_.end;
+  WriteRecord(session, mapping.hd, sizeof(mapping));
+}
+
+void ReplayGateway::WriteSystem(Session& session, SystemCode code,
+                                const std::string& msg) const {
+  SystemMsg system{};
+  system.hd = RecordHeader{
+      static_cast<std::uint8_t>(sizeof(system) / RecordHeader::kLengthMultiplier),
+      RType::System, 0, 0,
+      UnixNanos{std::chrono::system_clock::now().time_since_epoch()}};
+  CopyCStr(system.msg, msg);
+  system.code = code;
+  WriteRecord(session, system.hd, sizeof(system));
+}
+
+void ReplayGateway::WriteError(Session& session, ErrorCode code,
+                               const std::string& msg) const {
+  ErrorMsg error{};
+  error.hd = RecordHeader{
+      static_cast<std::uint8_t>(sizeof(error) / RecordHeader::kLengthMultiplier),
+      RType::Error, 0, 0,
+      UnixNanos{std::chrono::system_clock::now().time_since_epoch()}};
+  CopyCStr(error.err, msg);
+  error.code = code;
+  error.is_last = 1;
+  WriteRecord(session, error.hd, sizeof(error));
+}
+
+bool ReplayGateway::Pump(Session& session, std::chrono::steady_clock::time_point now) {
+  const int fd = session.fd.Get();
+  if (session.state == Session::State::Streaming) {
+    FillOutput(session, now);
+    if (session.out.ReadCapacity() == 0 &&
+        now - session.last_write_time >= session.heartbeat_interval) {
+      WriteSystem(session, SystemCode::Heartbeat, "Heartbeat");
+    }
+    if (session.zstd) {
+      session.zstd->Flush();
+    }
+    session.deadline = std::min(session.deadline,
+                                session.last_write_time + session.heartbeat_interval);
+  }
+  while (session.out.ReadCapacity() > 0) {
+    const auto write_size = ::send(fd, session.out.ReadBegin(),
+                                   session.out.ReadCapacity(), MSG_NOSIGNAL);
+    if (write_size < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN) {
+        break;
+      }
+      Close(fd);
+      return false;
+    }
+    session.out.Consume(static_cast<std::size_t>(write_size));
+  }
+  if (session.out.ReadCapacity() == 0) {
+    if (session.closing) {
+      Close(fd);
+      return false;
+    }
+    session.out.Clear();
+  }
+  // Wait for the socket to be writable while there's more to send now, otherwise
+  // only for requests
+  const bool has_more =
+      session.out.ReadCapacity() > 0 ||
+      (session.state == Session::State::Streaming && session.deadline <= now);
+  const std::uint32_t events = has_more ? EPOLLIN | EPOLLOUT : EPOLLIN;
+  if (events != session.events) {
+    epoll_event event{};
+    event.events = events;
+    event.data.fd = fd;
+    ::epoll_ctl(epoll_fd_.Get(), EPOLL_CTL_MOD, fd, &event);
+    session.events = events;
+  }
+  return true;
+}
+
+void ReplayGateway::ArmTimer() {
+  auto deadline = std::chrono::steady_clock::time_point::max();
+  for (const auto& [fd, session] : sessions_) {
+    // Sessions waiting on the socket are woken by epoll
+    if (!(session->events & EPOLLOUT)) {
+      deadline = std::min(deadline, session->deadline);
+    }
+  }
+  itimerspec spec{};
+  if (deadline != std::chrono::steady_clock::time_point::max()) {
+    spec.it_value = ToTimespec(deadline);
+    // A zero value disarms the timer
+    if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) {
+      spec.it_value.tv_nsec = 1;
+    }
+  }
+  ::timerfd_settime(timer_fd_.Get(), TFD_TIMER_ABSTIME, &spec, nullptr);
+}